@@ -548,6 +548,46 @@ void CopyContext::updateBuffer(const Buffer* pBuffer, const void* pData, size_t
     mCommandsPending = true;
 }
 
+void CopyContext::updateBufferRegions(const Buffer* pBuffer, const void* pData, const std::vector<BufferRegion>& regions)
+{
+    size_t totalBytes = 0;
+    for (const auto& region : regions)
+    {
+        FALCOR_CHECK(
+            region.offset + region.numBytes <= pBuffer->getSize(),
+            "Region offset ({}) and size ({}) don't fit the buffer size {}.",
+            region.offset,
+            region.numBytes,
+            pBuffer->getSize()
+        );
+        totalBytes += region.numBytes;
+    }
+    if (totalBytes == 0)
+        return;
+
+    // Stage all regions in one allocation.
+    const auto& pUploadHeap = mpDevice->getUploadHeap();
+    auto allocation = pUploadHeap->allocate(totalBytes);
+
+    bufferBarrier(pBuffer, Resource::State::CopyDest);
+    auto resourceEncoder = getLowLevelData()->getResourceCommandEncoder();
+
+    size_t stagingOffset = 0;
+    for (const auto& region : regions)
+    {
+        if (region.numBytes == 0)
+            continue;
+        std::memcpy(allocation.pData + stagingOffset, static_cast<const uint8_t*>(pData) + region.offset, region.numBytes);
+        resourceEncoder->copyBuffer(
+            pBuffer->getGfxBufferResource(), region.offset, allocation.gfxBufferResource, allocation.offset + stagingOffset, region.numBytes
+        );
+        stagingOffset += region.numBytes;
+    }
+    mCommandsPending = true;
+
+    pUploadHeap->release(allocation);
+}
+
 void CopyContext::readBuffer(const Buffer* pBuffer, void* pData, size_t offset, size_t numBytes)
 {
     if (numBytes == 0)
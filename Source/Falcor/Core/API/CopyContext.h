@@ -198,6 +198,20 @@ public:
      */
     void updateBuffer(const Buffer* pBuffer, const void* pData, size_t offset = 0, size_t numBytes = 0);
 
+    /// Byte region of a buffer.
+    struct BufferRegion
+    {
+        size_t offset = 0;
+        size_t numBytes = 0;
+    };
+
+    /**
+     * Update multiple regions of a buffer.
+     * The data of all regions is staged in a single upload heap allocation and copied with one copy command per region.
+     * Each region is read from the same byte offset in `pData` as it is written to in the buffer.
+     */
+    void updateBufferRegions(const Buffer* pBuffer, const void* pData, const std::vector<BufferRegion>& regions);
+
     void readBuffer(const Buffer* pBuffer, void* pData, size_t offset = 0, size_t numBytes = 0);
 
     template<typename T>
@@ -32,6 +32,8 @@
 #include "Core/Error.h"
 #include "Core/Program/ProgramVersion.h"
 #include "Utils/Logger.h"
+#include "Utils/Timing/Profiler.h"
+#include <cstring>
 
 namespace Falcor
 {
@@ -55,6 +57,21 @@ gfx::ShaderOffset getGFXShaderOffset(const ParameterBlock::BindLocation& bindLoc
     return gfxOffset;
 }
 
+/**
+ * Update the binding at `offset` in a binding map.
+ * Returns false if the same object is already bound, in which case the descriptor does not need to be written.
+ */
+template<typename T>
+bool updateBinding(std::map<gfx::ShaderOffset, ref<T>>& bindings, const gfx::ShaderOffset& offset, const ref<T>& pObject, Profiler* pProfiler)
+{
+    auto [it, inserted] = bindings.try_emplace(offset, pObject);
+    bool changed = inserted || it->second != pObject;
+    if (changed)
+        it->second = pObject;
+    pProfiler->recordDescriptorWrite(!changed);
+    return changed;
+}
+
 bool isSrvType(const ReflectionType* pType)
 {
     FALCOR_ASSERT(pType);
@@ -310,7 +327,7 @@ void ParameterBlock::setBlob(const void* pSrc, const BindLocation& bindLocation,
     if (!isConstantBufferType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
-        FALCOR_GFX_CALL(mpShaderObject->setData(gfxOffset, pSrc, size));
+        setUniformData(gfxOffset, pSrc, size);
     }
     else
     {
@@ -322,7 +339,23 @@ void ParameterBlock::setBlob(const void* pSrc, size_t offset, size_t size)
 {
     gfx::ShaderOffset gfxOffset = {};
     gfxOffset.uniformOffset = offset;
-    FALCOR_GFX_CALL(mpShaderObject->setData(gfxOffset, pSrc, size));
+    setUniformData(gfxOffset, pSrc, size);
+}
+
+void ParameterBlock::setUniformData(const gfx::ShaderOffset& offset, const void* pSrc, size_t size)
+{
+    // Skip writes that do not change the data. Writing marks the shader object dirty,
+    // which makes the backend upload its uniform data again on the next bind.
+    const size_t byteOffset = offset.uniformOffset;
+    const uint8_t* pData = static_cast<const uint8_t*>(getRawData());
+    if (pData && byteOffset + size <= getSize() && std::memcmp(pData + byteOffset, pSrc, size) == 0)
+    {
+        mpDevice->getProfiler()->recordUniformWriteSkipped();
+        return;
+    }
+
+    FALCOR_GFX_CALL(mpShaderObject->setData(offset, pSrc, size));
+    mUniformsDirty = true;
 }
 
 //
@@ -357,8 +390,7 @@ void setVariableInternal(
             expectedSize,
             size
         );
-    auto gfxOffset = getGFXShaderOffset(bindLocation);
-    FALCOR_GFX_CALL(pBlock->getShaderObject()->setData(gfxOffset, &value, size));
+    pBlock->setBlob(&value, bindLocation, size);
 }
 
 template<typename T>
@@ -447,8 +479,8 @@ void ParameterBlock::setBuffer(const BindLocation& bindLoc, const ref<Buffer>& p
         if (pBuffer && !is_set(pBuffer->getBindFlags(), ResourceBindFlags::UnorderedAccess))
             FALCOR_THROW("Trying to bind buffer '{}' created without UnorderedAccess flag as a UAV.", pBuffer->getName());
         auto pUAV = pBuffer ? pBuffer->getUAV() : nullptr;
-        mpShaderObject->setResource(gfxOffset, pUAV ? pUAV->getGfxResourceView() : nullptr);
-        mUAVs[gfxOffset] = pUAV;
+        if (updateBinding(mUAVs, gfxOffset, pUAV, mpDevice->getProfiler()))
+            mpShaderObject->setResource(gfxOffset, pUAV ? pUAV->getGfxResourceView() : nullptr);
         mResources[gfxOffset] = pBuffer;
     }
     else if (isSrvType(bindLoc.getType()))
@@ -456,8 +488,8 @@ void ParameterBlock::setBuffer(const BindLocation& bindLoc, const ref<Buffer>& p
         if (pBuffer && !is_set(pBuffer->getBindFlags(), ResourceBindFlags::ShaderResource))
             FALCOR_THROW("Trying to bind buffer '{}' created without ShaderResource flag as an SRV.", pBuffer->getName());
         auto pSRV = pBuffer ? pBuffer->getSRV() : nullptr;
-        mpShaderObject->setResource(gfxOffset, pSRV ? pSRV->getGfxResourceView() : nullptr);
-        mSRVs[gfxOffset] = pSRV;
+        if (updateBinding(mSRVs, gfxOffset, pSRV, mpDevice->getProfiler()))
+            mpShaderObject->setResource(gfxOffset, pSRV ? pSRV->getGfxResourceView() : nullptr);
         mResources[gfxOffset] = pBuffer;
     }
     else
@@ -513,8 +545,8 @@ void ParameterBlock::setTexture(const BindLocation& bindLocation, const ref<Text
         if (pTexture && !is_set(pTexture->getBindFlags(), ResourceBindFlags::UnorderedAccess))
             FALCOR_THROW("Trying to bind texture '{}' created without UnorderedAccess flag as a UAV.", pTexture->getName());
         auto pUAV = pTexture ? pTexture->getUAV() : nullptr;
-        mpShaderObject->setResource(gfxOffset, pUAV ? pUAV->getGfxResourceView() : nullptr);
-        mUAVs[gfxOffset] = pUAV;
+        if (updateBinding(mUAVs, gfxOffset, pUAV, mpDevice->getProfiler()))
+            mpShaderObject->setResource(gfxOffset, pUAV ? pUAV->getGfxResourceView() : nullptr);
         mResources[gfxOffset] = pTexture;
     }
     else if (isSrvType(bindLocation.getType()))
@@ -522,8 +554,8 @@ void ParameterBlock::setTexture(const BindLocation& bindLocation, const ref<Text
         if (pTexture && !is_set(pTexture->getBindFlags(), ResourceBindFlags::ShaderResource))
             FALCOR_THROW("Trying to bind texture '{}' created without ShaderResource flag as an SRV.", pTexture->getName());
         auto pSRV = pTexture ? pTexture->getSRV() : nullptr;
-        mpShaderObject->setResource(gfxOffset, pSRV ? pSRV->getGfxResourceView() : nullptr);
-        mSRVs[gfxOffset] = pSRV;
+        if (updateBinding(mSRVs, gfxOffset, pSRV, mpDevice->getProfiler()))
+            mpShaderObject->setResource(gfxOffset, pSRV ? pSRV->getGfxResourceView() : nullptr);
         mResources[gfxOffset] = pTexture;
     }
     else
@@ -571,8 +603,8 @@ void ParameterBlock::setSrv(const BindLocation& bindLocation, const ref<ShaderRe
     if (isSrvType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
-        mpShaderObject->setResource(gfxOffset, pSrv ? pSrv->getGfxResourceView() : nullptr);
-        mSRVs[gfxOffset] = pSrv;
+        if (updateBinding(mSRVs, gfxOffset, pSrv, mpDevice->getProfiler()))
+            mpShaderObject->setResource(gfxOffset, pSrv ? pSrv->getGfxResourceView() : nullptr);
         // Note: The resource view does not hold a strong reference to the resource, so we need to keep it alive here.
         mResources[gfxOffset] = ref<Resource>(pSrv ? pSrv->getResource() : nullptr);
     }
@@ -603,8 +635,8 @@ void ParameterBlock::setUav(const BindLocation& bindLocation, const ref<Unordere
     if (isUavType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
-        mpShaderObject->setResource(gfxOffset, pUav ? pUav->getGfxResourceView() : nullptr);
-        mUAVs[gfxOffset] = pUav;
+        if (updateBinding(mUAVs, gfxOffset, pUav, mpDevice->getProfiler()))
+            mpShaderObject->setResource(gfxOffset, pUav ? pUav->getGfxResourceView() : nullptr);
         // Note: The resource view does not hold a strong reference to the resource, so we need to keep it alive here.
         mResources[gfxOffset] = ref<Resource>(pUav ? pUav->getResource() : nullptr);
     }
@@ -635,8 +667,8 @@ void ParameterBlock::setAccelerationStructure(const BindLocation& bindLocation,
     if (isAccelerationStructureType(bindLocation.getType()))
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
-        mAccelerationStructures[gfxOffset] = pAccl;
-        FALCOR_GFX_CALL(mpShaderObject->setResource(gfxOffset, pAccl ? pAccl->getGfxAccelerationStructure() : nullptr));
+        if (updateBinding(mAccelerationStructures, gfxOffset, pAccl, mpDevice->getProfiler()))
+            FALCOR_GFX_CALL(mpShaderObject->setResource(gfxOffset, pAccl ? pAccl->getGfxAccelerationStructure() : nullptr));
     }
     else
     {
@@ -675,8 +707,8 @@ void ParameterBlock::setSampler(const BindLocation& bindLocation, const ref<Samp
     {
         gfx::ShaderOffset gfxOffset = getGFXShaderOffset(bindLocation);
         const ref<Sampler>& pBoundSampler = pSampler ? pSampler : mpDevice->getDefaultSampler();
-        mSamplers[gfxOffset] = pBoundSampler;
-        FALCOR_GFX_CALL(mpShaderObject->setSampler(gfxOffset, pBoundSampler->getGfxSamplerState()));
+        if (updateBinding(mSamplers, gfxOffset, pBoundSampler, mpDevice->getProfiler()))
+            FALCOR_GFX_CALL(mpShaderObject->setSampler(gfxOffset, pBoundSampler->getGfxSamplerState()));
     }
     else
     {
@@ -719,8 +751,8 @@ void ParameterBlock::setParameterBlock(const BindLocation& bindLocation, const r
     if (isParameterBlockType(bindLocation.getType()))
     {
         auto gfxOffset = getGFXShaderOffset(bindLocation);
-        mParameterBlocks[gfxOffset] = pBlock;
-        FALCOR_GFX_CALL(mpShaderObject->setObject(gfxOffset, pBlock ? pBlock->mpShaderObject : nullptr));
+        if (updateBinding(mParameterBlocks, gfxOffset, pBlock, mpDevice->getProfiler()))
+            FALCOR_GFX_CALL(mpShaderObject->setObject(gfxOffset, pBlock ? pBlock->mpShaderObject : nullptr));
     }
     else
     {
@@ -761,6 +793,13 @@ bool ParameterBlock::updateSpecialization() const
 
 bool ParameterBlock::prepareDescriptorSets(CopyContext* pCopyContext)
 {
+    // Account for the upload of modified uniform data.
+    if (mUniformsDirty)
+    {
+        mpDevice->getProfiler()->recordUniformUpload(getSize());
+        mUniformsDirty = false;
+    }
+
     // Insert necessary resource barriers for bound resources.
     for (auto& srv : mSRVs)
     {
@@ -385,6 +385,9 @@ protected:
 
     void initializeResourceBindings();
     void createConstantBuffers(const ShaderVar& var);
+
+    /// Write uniform data to the shader object. The write is skipped if the data is unchanged.
+    void setUniformData(const gfx::ShaderOffset& offset, const void* pSrc, size_t size);
     static void prepareResource(CopyContext* pContext, Resource* pResource, bool isUav);
 
     /// Note: We hold an unowned pointer to the device but a strong pointer to the program version.
@@ -403,6 +406,9 @@ protected:
     std::map<gfx::ShaderOffset, ref<Resource>> mResources;
     std::map<gfx::ShaderOffset, ref<Sampler>> mSamplers;
     std::map<gfx::ShaderOffset, ref<RtAccelerationStructure>> mAccelerationStructures;
+
+    /// True if the uniform data was modified since the last call to prepareDescriptorSets().
+    bool mUniformsDirty = true;
 };
 
 template<typename T>
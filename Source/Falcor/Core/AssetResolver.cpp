@@ -43,19 +43,26 @@ std::filesystem::path AssetResolver::resolvePath(const std::filesystem::path& pa
 
     // If this is an existing absolute path, or a relative path to the working directory, return it.
     std::filesystem::path absolute = std::filesystem::absolute(path);
+    std::filesystem::path resolved;
     if (std::filesystem::exists(absolute))
-        return std::filesystem::canonical(absolute);
-
-    // Otherwise, try to resolve using search paths.
-    // First try resolving for the specified asset category.
-    std::filesystem::path resolved = mSearchContexts[size_t(category)].resolvePath(path);
+    {
+        resolved = std::filesystem::canonical(absolute);
+    }
+    else
+    {
+        // Otherwise, try to resolve using search paths.
+        // First try resolving for the specified asset category.
+        resolved = mSearchContexts[size_t(category)].resolvePath(path);
 
-    // If not resolved, try resolving for the Any asset category.
-    if (category != AssetCategory::Any && resolved.empty())
-        resolved = mSearchContexts[size_t(AssetCategory::Any)].resolvePath(path);
+        // If not resolved, try resolving for the Any asset category.
+        if (category != AssetCategory::Any && resolved.empty())
+            resolved = mSearchContexts[size_t(AssetCategory::Any)].resolvePath(path);
+    }
 
     if (resolved.empty())
         logWarning("Failed to resolve path '{}' for asset type '{}'.", path, category);
+    else if (mResolveCallback)
+        mResolveCallback(resolved);
 
     return resolved;
 }
@@ -74,19 +81,22 @@ std::vector<std::filesystem::path> AssetResolver::resolvePathPattern(
     // If this is an existing absolute path, or a relative path to the working directory, search it.
     std::filesystem::path absolute = std::filesystem::absolute(path);
     std::vector<std::filesystem::path> resolved = globFilesInDirectory(absolute, regex, firstMatchOnly);
-    if (!resolved.empty())
-        return resolved;
-
-    // Otherwise, try to resolve using search paths.
-    // First try resolving for the specified asset category.
-    resolved = mSearchContexts[size_t(category)].resolvePathPattern(path, regex, firstMatchOnly);
+    if (resolved.empty())
+    {
+        // Otherwise, try to resolve using search paths.
+        // First try resolving for the specified asset category.
+        resolved = mSearchContexts[size_t(category)].resolvePathPattern(path, regex, firstMatchOnly);
 
-    // If not resolved, try resolving for the Any asset category.
-    if (category != AssetCategory::Any && resolved.empty())
-        resolved = mSearchContexts[size_t(AssetCategory::Any)].resolvePathPattern(path, regex, firstMatchOnly);
+        // If not resolved, try resolving for the Any asset category.
+        if (category != AssetCategory::Any && resolved.empty())
+            resolved = mSearchContexts[size_t(AssetCategory::Any)].resolvePathPattern(path, regex, firstMatchOnly);
+    }
 
     if (resolved.empty())
         logWarning("Failed to resolve path pattern '{}/{}' for asset type '{}'.", path, pattern, category);
+    else if (mResolveCallback)
+        for (const auto& resolvedPath : resolved)
+            mResolveCallback(resolvedPath);
 
     return resolved;
 }
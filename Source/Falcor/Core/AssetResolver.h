@@ -30,6 +30,7 @@
 #include "Macros.h"
 #include "Enum.h"
 #include <filesystem>
+#include <functional>
 #include <regex>
 #include <string>
 #include <vector>
@@ -137,6 +138,16 @@ public:
         AssetCategory category = AssetCategory::Any
     );
 
+    /// Callback invoked with every successfully resolved path.
+    using ResolveCallback = std::function<void(const std::filesystem::path&)>;
+
+    /**
+     * Set a callback that is invoked with every successfully resolved path.
+     * This is used for tracking the files an asset depends on. Copies of the resolver keep the callback.
+     * @param callback Callback function, or an empty function to disable the callback.
+     */
+    void setResolveCallback(ResolveCallback callback) { mResolveCallback = std::move(callback); }
+
     /// Return the global default asset resolver.
     static AssetResolver& getDefaultResolver();
 
@@ -158,5 +169,6 @@ private:
     };
 
     std::vector<SearchContext> mSearchContexts;
+    ResolveCallback mResolveCallback;
 };
 } // namespace Falcor
@@ -0,0 +1,138 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "OS.h"
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/// Heap allocation counting by replacing the global operator new/delete.
+/// This is only compiled in with FALCOR_ENABLE_ALLOCATION_TRACKING, as it affects all allocations of the process.
+
+#if FALCOR_ENABLE_ALLOCATION_TRACKING
+
+namespace
+{
+std::atomic<uint64_t> gAllocationCount{0};
+
+void* allocate(std::size_t size, std::size_t alignment)
+{
+    gAllocationCount.fetch_add(1, std::memory_order_relaxed);
+    if (size == 0)
+        size = 1;
+
+    while (true)
+    {
+        void* ptr = nullptr;
+        if (alignment <= __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+        {
+            ptr = std::malloc(size);
+        }
+        else
+        {
+#if FALCOR_WINDOWS
+            ptr = _aligned_malloc(size, alignment);
+#else
+            // aligned_alloc() requires the size to be a multiple of the alignment.
+            ptr = std::aligned_alloc(alignment, (size + alignment - 1) & ~(alignment - 1));
+#endif
+        }
+        if (ptr)
+            return ptr;
+
+        // Give the new handler a chance to free memory, as required for operator new.
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            throw std::bad_alloc();
+        handler();
+    }
+}
+
+void* allocateNoThrow(std::size_t size, std::size_t alignment) noexcept
+{
+    try
+    {
+        return allocate(size, alignment);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return nullptr;
+    }
+}
+
+void deallocate(void* ptr, std::size_t alignment) noexcept
+{
+#if FALCOR_WINDOWS
+    if (alignment > __STDCPP_DEFAULT_NEW_ALIGNMENT__)
+    {
+        _aligned_free(ptr);
+        return;
+    }
+#endif
+    std::free(ptr);
+}
+
+constexpr std::size_t kDefaultAlignment = __STDCPP_DEFAULT_NEW_ALIGNMENT__;
+} // namespace
+
+// clang-format off
+void* operator new(std::size_t size) { return allocate(size, kDefaultAlignment); }
+void* operator new[](std::size_t size) { return allocate(size, kDefaultAlignment); }
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size, kDefaultAlignment); }
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept { return allocateNoThrow(size, kDefaultAlignment); }
+void* operator new(std::size_t size, std::align_val_t alignment) { return allocate(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment) { return allocate(size, (std::size_t)alignment); }
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateNoThrow(size, (std::size_t)alignment); }
+void* operator new[](std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept { return allocateNoThrow(size, (std::size_t)alignment); }
+
+void operator delete(void* ptr) noexcept { deallocate(ptr, kDefaultAlignment); }
+void operator delete[](void* ptr) noexcept { deallocate(ptr, kDefaultAlignment); }
+void operator delete(void* ptr, std::size_t) noexcept { deallocate(ptr, kDefaultAlignment); }
+void operator delete[](void* ptr, std::size_t) noexcept { deallocate(ptr, kDefaultAlignment); }
+void operator delete(void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr, kDefaultAlignment); }
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept { deallocate(ptr, kDefaultAlignment); }
+void operator delete(void* ptr, std::align_val_t alignment) noexcept { deallocate(ptr, (std::size_t)alignment); }
+void operator delete[](void* ptr, std::align_val_t alignment) noexcept { deallocate(ptr, (std::size_t)alignment); }
+void operator delete(void* ptr, std::size_t, std::align_val_t alignment) noexcept { deallocate(ptr, (std::size_t)alignment); }
+void operator delete[](void* ptr, std::size_t, std::align_val_t alignment) noexcept { deallocate(ptr, (std::size_t)alignment); }
+void operator delete(void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(ptr, (std::size_t)alignment); }
+void operator delete[](void* ptr, std::align_val_t alignment, const std::nothrow_t&) noexcept { deallocate(ptr, (std::size_t)alignment); }
+// clang-format on
+
+#endif // FALCOR_ENABLE_ALLOCATION_TRACKING
+
+namespace Falcor
+{
+uint64_t getAllocationCount()
+{
+#if FALCOR_ENABLE_ALLOCATION_TRACKING
+    return gAllocationCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+} // namespace Falcor
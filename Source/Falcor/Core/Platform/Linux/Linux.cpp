@@ -33,11 +33,14 @@
 
 #include <gtk/gtk.h>
 
+#include <fstream>
 #include <iostream>
+#include <time.h>
 #include <unistd.h>
 #include <signal.h>
 #include <sys/types.h>
 #include <sys/stat.h>
+#include <sys/resource.h>
 #include <pwd.h>
 #ifndef _GNU_SOURCE
 #define _GNU_SOURCE // needed for dladdr()
@@ -579,13 +582,28 @@ void OSServices::stop() {}
 
 size_t getCurrentRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    // The second field of /proc/self/statm is the resident set size in pages.
+    std::ifstream statm("/proc/self/statm");
+    size_t size = 0, resident = 0;
+    if (!(statm >> size >> resident))
+        return 0;
+    return resident * (size_t)sysconf(_SC_PAGESIZE);
 }
 
 size_t getPeakRSS()
 {
-    FALCOR_UNIMPLEMENTED();
-    return 0;
+    // ru_maxrss is reported in kilobytes on Linux.
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return 0;
+    return (size_t)usage.ru_maxrss * 1024;
+}
+
+double getProcessCpuTime()
+{
+    struct timespec ts;
+    if (clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts) != 0)
+        return 0.0;
+    return (double)ts.tv_sec + (double)ts.tv_nsec * 1e-9;
 }
 } // namespace Falcor
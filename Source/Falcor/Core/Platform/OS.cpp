@@ -322,6 +322,84 @@ std::string decompressFile(const std::filesystem::path& path)
     return decompressed;
 }
 
+std::string readFileFromZip(const std::filesystem::path& path, std::string_view name)
+{
+    const std::string archive = readFile(path);
+
+    auto read16 = [&](size_t offset) -> uint32_t
+    {
+        if (offset + 2 > archive.size())
+            FALCOR_THROW("Zip archive '{}' is truncated.", path);
+        return uint32_t(uint8_t(archive[offset])) | uint32_t(uint8_t(archive[offset + 1])) << 8;
+    };
+    auto read32 = [&](size_t offset) { return read16(offset) | read16(offset + 2) << 16; };
+
+    // Find the end of central directory record, which is followed by a comment of at most 64 kB.
+    const size_t kEndRecordSize = 22;
+    if (archive.size() < kEndRecordSize)
+        FALCOR_THROW("File '{}' is not a zip archive.", path);
+    size_t endOffset = archive.size() - kEndRecordSize;
+    const size_t minEndOffset = endOffset > 0xffff ? endOffset - 0xffff : 0;
+    while (read32(endOffset) != 0x06054b50)
+    {
+        if (endOffset == minEndOffset)
+            FALCOR_THROW("File '{}' is not a zip archive.", path);
+        endOffset--;
+    }
+
+    // Search the central directory for the entry.
+    const uint32_t entryCount = read16(endOffset + 10);
+    size_t offset = read32(endOffset + 16);
+    for (uint32_t i = 0; i < entryCount; i++)
+    {
+        if (read32(offset) != 0x02014b50)
+            FALCOR_THROW("Zip archive '{}' has an invalid central directory.", path);
+        const uint32_t method = read16(offset + 10);
+        const uint32_t compressedSize = read32(offset + 20);
+        const uint32_t size = read32(offset + 24);
+        const uint32_t nameLength = read16(offset + 28);
+        const uint32_t localOffset = read32(offset + 42);
+        if (offset + 46 + nameLength > archive.size())
+            FALCOR_THROW("Zip archive '{}' is truncated.", path);
+        const std::string_view entryName(archive.data() + offset + 46, nameLength);
+        offset += 46 + nameLength + read16(offset + 30) + read16(offset + 32);
+        if (entryName != name)
+            continue;
+
+        if (compressedSize == 0xffffffff || size == 0xffffffff || localOffset == 0xffffffff)
+            FALCOR_THROW("Zip64 archive '{}' is not supported.", path);
+        if (read32(localOffset) != 0x04034b50)
+            FALCOR_THROW("Zip archive '{}' has an invalid local header for '{}'.", path, name);
+        const size_t dataOffset = localOffset + 30 + read16(localOffset + 26) + read16(localOffset + 28);
+        if (dataOffset + compressedSize > archive.size())
+            FALCOR_THROW("Zip archive '{}' is truncated.", path);
+
+        if (method == 0)
+            return archive.substr(dataOffset, compressedSize);
+        if (method != 8)
+            FALCOR_THROW("Zip archive '{}' uses unsupported compression method {} for '{}'.", path, method, name);
+
+        // Deflated data is stored as a raw stream without zlib header.
+        z_stream zs = {};
+        if (inflateInit2(&zs, -MAX_WBITS) != Z_OK)
+            FALCOR_THROW("inflateInit2 failed while decompressing.");
+
+        std::string decompressed(size, '\0');
+        zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(archive.data() + dataOffset));
+        zs.avail_in = (uInt)compressedSize;
+        zs.next_out = reinterpret_cast<Bytef*>(decompressed.data());
+        zs.avail_out = (uInt)size;
+        int ret = inflate(&zs, Z_FINISH);
+        inflateEnd(&zs);
+
+        if (ret != Z_STREAM_END || zs.total_out != size)
+            FALCOR_THROW("Failure to decompress '{}' from zip archive '{}' (error: {}).", name, path, ret);
+        return decompressed;
+    }
+
+    FALCOR_THROW("Zip archive '{}' does not contain '{}'.", path, name);
+}
+
 std::string getStackTrace(size_t skip, size_t maxDepth)
 {
     // We need to initialize the resolver before taking the stack trace,
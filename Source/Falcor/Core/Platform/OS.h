@@ -456,6 +456,18 @@ FALCOR_API uint64_t getCurrentRSS();
  */
 FALCOR_API uint64_t getPeakRSS();
 
+/**
+ * Returns the CPU time (user and kernel) consumed by all threads of the process in seconds.
+ */
+FALCOR_API double getProcessCpuTime();
+
+/**
+ * Returns the number of heap allocations made through the global operator new since process start.
+ * Allocations are only counted if Falcor is built with FALCOR_ENABLE_ALLOCATION_TRACKING, otherwise 0 is returned.
+ * On Windows only allocations made by code in the Falcor library are counted.
+ */
+FALCOR_API uint64_t getAllocationCount();
+
 /**
  * Returns index of most significant set bit, or 0 if no bits were set.
  */
@@ -487,6 +499,16 @@ FALCOR_API std::string readFile(const std::filesystem::path& path);
  */
 FALCOR_API std::string decompressFile(const std::filesystem::path& path);
 
+/**
+ * Read and decompress a file stored in a .zip archive into a string.
+ * Only stored and deflated entries are supported, and the archive must not use the zip64 format.
+ * Throws an exception if the archive cannot be read or does not contain the file.
+ * @param[in] path Archive file path.
+ * @param[in] name Path of the file within the archive.
+ * @return The contents of the file.
+ */
+FALCOR_API std::string readFileFromZip(const std::filesystem::path& path, std::string_view name);
+
 /**
  * Load a shared-library
  */
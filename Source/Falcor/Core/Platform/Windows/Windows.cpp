@@ -1018,4 +1018,14 @@ size_t getPeakRSS()
         return memoryCounter.PeakWorkingSetSize;
     return 0;
 }
+
+double getProcessCpuTime()
+{
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetProcessTimes(GetCurrentProcess(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0.0;
+    // FILETIME values are in 100 ns units.
+    auto toSeconds = [](const FILETIME& t) { return (double)((uint64_t(t.dwHighDateTime) << 32) | t.dwLowDateTime) * 1e-7; };
+    return toSeconds(kernelTime) + toSeconds(userTime);
+}
 } // namespace Falcor
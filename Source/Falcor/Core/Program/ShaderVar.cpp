@@ -28,9 +28,16 @@
 #include "ShaderVar.h"
 #include "Core/API/ParameterBlock.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include <algorithm>
+#include <atomic>
 
 namespace Falcor
 {
+namespace
+{
+std::atomic<uint64_t> sStringLookupCount{0};
+}
+
 ShaderVar::ShaderVar() : mpBlock(nullptr) {}
 ShaderVar::ShaderVar(const ShaderVar& other) : mpBlock(other.mpBlock), mOffset(other.mOffset) {}
 ShaderVar::ShaderVar(ParameterBlock* pObject, const TypedShaderVarOffset& offset) : mpBlock(pObject), mOffset(offset) {}
@@ -123,6 +130,8 @@ ShaderVar ShaderVar::findMember(std::string_view name) const
         }
     }
 
+    sStringLookupCount.fetch_add(1, std::memory_order_relaxed);
+
     if (auto pStructType = pType->asStructType())
     {
         if (auto pMember = pStructType->findMember(name))
@@ -301,6 +310,11 @@ ShaderVar ShaderVar::operator[](const TypedShaderVarOffset& offset) const
     return ShaderVar(mpBlock, TypedShaderVarOffset(offset.getType(), mOffset + offset));
 }
 
+ShaderVar ShaderVar::operator[](const ShaderVarHandle& handle) const
+{
+    return handle.resolve(*this);
+}
+
 ShaderVar ShaderVar::operator[](const UniformShaderVarOffset& loc) const
 {
     if (!isValid())
@@ -396,6 +410,106 @@ void ShaderVar::setImpl(const ref<ParameterBlock>& pBlock) const
     mpBlock->setParameterBlock(mOffset, pBlock);
 }
 
+uint64_t ShaderVar::getStringLookupCount()
+{
+    return sStringLookupCount.load(std::memory_order_relaxed);
+}
+
+void ShaderVar::resetStringLookupCount()
+{
+    sStringLookupCount.store(0, std::memory_order_relaxed);
+}
+
+//
+// ShaderVarHandle
+//
+
+static bool isConstantBuffer(const ReflectionType* pType)
+{
+    auto pResourceType = pType->asResourceType();
+    return pResourceType && pResourceType->getType() == ReflectionResourceType::Type::ConstantBuffer;
+}
+
+ShaderVarHandle::ShaderVarHandle(std::string_view path) : mPath(path)
+{
+    size_t start = 0;
+    while (true)
+    {
+        size_t end = std::min(path.find('.', start), path.size());
+        FALCOR_CHECK(end > start, "Invalid shader variable path '{}'.", path);
+        mNames.emplace_back(path.substr(start, end - start));
+        if (end == path.size())
+            break;
+        start = end + 1;
+    }
+}
+
+ShaderVar ShaderVarHandle::find(const ShaderVar& base) const
+{
+    if (!base.isValid() || mNames.empty())
+        return ShaderVar();
+
+    if (base.getType() != mpBaseType.get())
+        update(base);
+
+    // An empty cache means the member was not found.
+    if (mSegments.empty())
+        return ShaderVar();
+
+    ShaderVar var = base;
+    for (const auto& segment : mSegments)
+        var = var[segment];
+    return var;
+}
+
+ShaderVar ShaderVarHandle::resolve(const ShaderVar& base) const
+{
+    FALCOR_CHECK(base.isValid(), "Cannot lookup on invalid ShaderVar.");
+    auto result = find(base);
+    FALCOR_CHECK(result.isValid(), "No member named '{}' found.", mPath);
+    return result;
+}
+
+void ShaderVarHandle::update(const ShaderVar& base) const
+{
+    mpBaseType = ref<const ReflectionType>(base.getType());
+    mSegments.clear();
+
+    // Walk the path by name and record the offsets relative to the base variable.
+    // Applying an offset to a constant buffer dereferences it, so each constant buffer starts a new segment.
+    std::vector<TypedShaderVarOffset> segments;
+    ShaderVar var = base;
+    ShaderVarOffset offset = ShaderVarOffset::kZero;
+    bool segmentEmpty = true;
+
+    for (const auto& name : mNames)
+    {
+        if (isConstantBuffer(var.getType()))
+        {
+            if (!segmentEmpty)
+                segments.push_back(TypedShaderVarOffset(var.getType(), offset));
+            var = var.getParameterBlock()->getRootVar();
+            offset = ShaderVarOffset::kZero;
+        }
+
+        sStringLookupCount.fetch_add(1, std::memory_order_relaxed);
+
+        auto pStructType = var.getType()->asStructType();
+        if (!pStructType)
+            return;
+        auto pMember = pStructType->findMember(name);
+        if (!pMember)
+            return;
+
+        var = var[TypedShaderVarOffset(pMember->getType(), pMember->getBindLocation())];
+        offset = offset + pMember->getBindLocation();
+        segmentEmpty = false;
+    }
+
+    segments.push_back(TypedShaderVarOffset(var.getType(), offset));
+    mSegments = std::move(segments);
+}
+
 FALCOR_SCRIPT_BINDING(ShaderVar)
 {
     FALCOR_SCRIPT_BINDING_DEPENDENCY(Buffer)
@@ -35,12 +35,16 @@
 #include "Core/API/RtAccelerationStructure.h"
 #include "Utils/Math/Vector.h"
 #include <memory>
+#include <string>
 #include <string_view>
+#include <vector>
 #include <cstddef>
+#include <cstdint>
 
 namespace Falcor
 {
 class ParameterBlock;
+class ShaderVarHandle;
 
 /**
  * A "pointer" to a shader variable stored in some parameter block.
@@ -426,6 +430,24 @@ struct FALCOR_API ShaderVar
      */
     ShaderVar operator[](const UniformShaderVarOffset& offset) const;
 
+    /**
+     * Get a shader variable pointer to the member path stored in a `ShaderVarHandle`.
+     * The path is resolved by name on first use and cached in the handle.
+     * Throws an exception if the member is not found.
+     */
+    ShaderVar operator[](const ShaderVarHandle& handle) const;
+
+    /**
+     * Get the number of member lookups by name since the last call to `resetStringLookupCount()`.
+     * This is a debugging aid for finding code that resolves shader variables by name every frame.
+     */
+    static uint64_t getStringLookupCount();
+
+    /**
+     * Reset the counter of member lookups by name.
+     */
+    static void resetStringLookupCount();
+
     /**
      * Get access to the underlying bytes of the variable.
      *
@@ -466,6 +488,65 @@ private:
     template<typename T>
     void setImpl(const T& val) const;
 };
+
+/**
+ * A cached handle to a shader variable.
+ *
+ * A handle stores a path of member names, e.g. "CB.gFrameCount", that is
+ * resolved relative to a base `ShaderVar` on first use. The typed offsets
+ * are cached so that later uses only apply the offsets, instead of looking
+ * up each member by name like `operator[]` does:
+ *
+ * ShaderVarHandle mFrameCountVar{"CB.gFrameCount"}; // Stored in the render pass.
+ * ...
+ * var[mFrameCountVar] = frameCount;
+ *
+ * The cache is keyed on the type of the base variable, so the path is
+ * resolved again automatically when the program vars are recreated,
+ * e.g. after the program was recompiled. A handle should be used with
+ * base variables of a single program, as alternating between programs
+ * resolves the path every time. Handles are not thread-safe.
+ */
+class FALCOR_API ShaderVarHandle
+{
+public:
+    ShaderVarHandle() = default;
+
+    /**
+     * Create a handle for a member path.
+     * @param[in] path Member names separated by '.'.
+     */
+    explicit ShaderVarHandle(std::string_view path);
+
+    /**
+     * Get the path of the handle.
+     */
+    const std::string& getPath() const { return mPath; }
+
+    /**
+     * Get a shader variable pointer to the member relative to `base`.
+     * Unlike `resolve()`, this does not throw an exception if the member is not found,
+     * but returns an invalid shader variable.
+     */
+    ShaderVar find(const ShaderVar& base) const;
+
+    /**
+     * Get a shader variable pointer to the member relative to `base`.
+     * Throws an exception if the member is not found.
+     */
+    ShaderVar resolve(const ShaderVar& base) const;
+
+private:
+    /// Resolve the path by name and update the cache.
+    void update(const ShaderVar& base) const;
+
+    std::string mPath;
+    std::vector<std::string> mNames;
+
+    // Cache. The offsets are relative to the base variable, with one segment per constant buffer on the path.
+    mutable ref<const ReflectionType> mpBaseType;
+    mutable std::vector<TypedShaderVarOffset> mSegments;
+};
 } // namespace Falcor
 
 #include "Core/API/ParameterBlock.h"
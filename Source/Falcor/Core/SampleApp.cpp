@@ -33,6 +33,7 @@
 #include "Core/AssetResolver.h"
 #include "Core/Program/Program.h"
 #include "Core/Program/ProgramManager.h"
+#include "Core/Program/ShaderVar.h"
 #include "Core/Platform/ProgressBar.h"
 #include "Utils/Threading.h"
 #include "Utils/Logger.h"
@@ -413,6 +414,14 @@ void SampleApp::renderGlobalUI(Gui* pGui)
 
         controlsGroup.separator();
 
+        controlsGroup.text(fmt::format("ShaderVar lookups by name: {} / frame", mShaderVarLookupCount));
+        controlsGroup.tooltip(
+            "Number of shader variables resolved by name in the last frame. Use ShaderVarHandle to cache the lookups in passes that run "
+            "every frame."
+        );
+
+        controlsGroup.separator();
+
         mCaptureScreen = controlsGroup.button("Screen Capture");
         if (controlsGroup.button("Save Config"))
             saveConfigToFile();
@@ -528,6 +537,9 @@ void SampleApp::renderFrame()
 
     mpDevice->endFrame();
 
+    mShaderVarLookupCount = ShaderVar::getStringLookupCount();
+    ShaderVar::resetStringLookupCount();
+
     mInputState.endFrame();
 
     mConsole.flush();
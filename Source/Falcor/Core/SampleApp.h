@@ -224,6 +224,12 @@ public:
     FrameRate& getFrameRate() { return mFrameRate; }
     const FrameRate& getFrameRate() const { return mFrameRate; }
 
+    /**
+     * Get the number of shader variable member lookups by name in the last frame.
+     * See ShaderVar::getStringLookupCount().
+     */
+    uint64_t getShaderVarLookupCount() const { return mShaderVarLookupCount; }
+
     /**
      * Resize the main frame buffer.
      */
@@ -337,6 +343,7 @@ private:
     bool mVsyncOn = false;
     bool mShowUI = true;
     bool mCaptureScreen = false;
+    uint64_t mShaderVarLookupCount = 0; ///< Number of shader variable lookups by name in the last frame.
 
     int mReturnCode = 0;
 
@@ -75,6 +75,7 @@
 #include "Core/Program/ProgramReflection.h"
 #include "Core/Program/ProgramVars.h"
 #include "Core/Program/ProgramVersion.h"
+#include "Core/Program/ShaderVar.h"
 
 // Core/State
 #include "Core/State/ComputeState.h"
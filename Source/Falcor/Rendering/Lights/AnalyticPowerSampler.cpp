@@ -0,0 +1,148 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "AnalyticPowerSampler.h"
+#include "Core/Error.h"
+#include "Scene/Scene.h"
+#include "Scene/Lights/Light.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include "Utils/Math/MathConstants.slangh"
+#include <cmath>
+#include <numeric>
+
+namespace Falcor
+{
+    AnalyticPowerSampler::AnalyticPowerSampler(ref<Device> pDevice, float uniformFraction)
+        : mpDevice(pDevice)
+    {
+        FALCOR_CHECK(uniformFraction >= 0.f && uniformFraction <= 1.f, "'uniformFraction' must be in [0,1].");
+        mUniformFraction = uniformFraction;
+    }
+
+    bool AnalyticPowerSampler::update(const ref<Scene>& pScene)
+    {
+        FALCOR_ASSERT(pScene);
+
+        const auto& lights = pScene->getActiveLights();
+        const Scene::UpdateFlags lightChanges = Scene::UpdateFlags::LightIntensityChanged | Scene::UpdateFlags::LightPropertiesChanged | Scene::UpdateFlags::LightCountChanged;
+        bool needsRebuild = is_set(pScene->getUpdates(), lightChanges);
+        needsRebuild |= lights.size() != mPowers.size();
+        if (!needsRebuild) return false;
+
+        const float sceneRadius = pScene->getSceneBounds().valid() ? pScene->getSceneBounds().radius() : 1.f;
+        std::vector<float> powers(lights.size());
+        for (size_t i = 0; i < lights.size(); i++) powers[i] = estimatePower(*lights[i], sceneRadius);
+
+        setLightPowers(powers);
+        return true;
+    }
+
+    void AnalyticPowerSampler::setLightPowers(const std::vector<float>& powers)
+    {
+        mPowers.resize(powers.size());
+        for (size_t i = 0; i < powers.size(); i++) mPowers[i] = std::isfinite(powers[i]) ? std::max(0.f, powers[i]) : 0.f;
+        mTotalPower = std::accumulate(mPowers.begin(), mPowers.end(), 0.0);
+        rebuild();
+    }
+
+    void AnalyticPowerSampler::setUniformFraction(float uniformFraction)
+    {
+        FALCOR_CHECK(uniformFraction >= 0.f && uniformFraction <= 1.f, "'uniformFraction' must be in [0,1].");
+        if (uniformFraction == mUniformFraction) return;
+        mUniformFraction = uniformFraction;
+        rebuild();
+    }
+
+    float AnalyticPowerSampler::getSelectionPdf(uint32_t lightIndex) const
+    {
+        if (!mpTable || lightIndex >= mpTable->getCount()) return 0.f;
+        return (float)(mpTable->getWeights()[lightIndex] / mpTable->getWeightSum());
+    }
+
+    void AnalyticPowerSampler::bindShaderData(const ShaderVar& var) const
+    {
+        FALCOR_ASSERT(var.isValid());
+
+        // The sampler is never invoked without lights.
+        if (!mpTable) return;
+
+        mpTable->bindShaderData(var["lightTable"]);
+    }
+
+    float AnalyticPowerSampler::estimatePower(const Light& light, float sceneRadius)
+    {
+        switch (light.getType())
+        {
+        case LightType::Directional:
+        case LightType::Distant:
+            // Irradiance times the area of a disc covering the scene.
+            return luminance(light.getIntensity()) * (float)M_PI * sceneRadius * sceneRadius;
+        default:
+            return light.getPower();
+        }
+    }
+
+    std::vector<float> AnalyticPowerSampler::computeSelectionWeights(const std::vector<float>& powers, float uniformFraction)
+    {
+        const size_t count = powers.size();
+        std::vector<float> weights(count);
+        if (count == 0) return weights;
+
+        double totalPower = 0.0;
+        for (float power : powers) totalPower += power;
+
+        // Fall back to uniform selection if there is no power to distribute.
+        const double powerFraction = totalPower > 0.0 ? 1.0 - uniformFraction : 0.0;
+        const double uniformWeight = (1.0 - powerFraction) / count;
+        for (size_t i = 0; i < count; i++)
+        {
+            const double powerWeight = totalPower > 0.0 ? powers[i] / totalPower : 0.0;
+            weights[i] = (float)(powerFraction * powerWeight + uniformWeight);
+        }
+        return weights;
+    }
+
+    void AnalyticPowerSampler::rebuild()
+    {
+        if (mPowers.empty())
+        {
+            mpTable.reset();
+            return;
+        }
+
+        auto weights = computeSelectionWeights(mPowers, mUniformFraction);
+        if (mpTable && mpTable->getCount() == weights.size())
+        {
+            // Only rebuild the parts of the table where the weights changed.
+            mpTable->updateWeights(weights);
+        }
+        else
+        {
+            mpTable = std::make_unique<AliasTable>(mpDevice, std::move(weights), mRng);
+        }
+    }
+}
@@ -0,0 +1,135 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Sampling/AliasTable.h"
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace Falcor
+{
+    class Light;
+    class Scene;
+    struct ShaderVar;
+
+    /** Selects analytic lights proportionally to their emitted power.
+
+        The selection weights are a mixture of the normalized light powers and a uniform
+        distribution. The uniform part guarantees a non-zero selection probability for all
+        lights, including lights whose power can only be roughly estimated (e.g. directional
+        lights) and lights that are far away but important for a particular shading point.
+
+        The sampler is used by passes that pick one analytic light out of many, e.g., for
+        generating initial candidates for resampled importance sampling.
+        See AnalyticPowerSampler.slang for the shader side.
+    */
+    class FALCOR_API AnalyticPowerSampler
+    {
+    public:
+        static constexpr float kDefaultUniformFraction = 0.1f;
+
+        /** Creates an AnalyticPowerSampler.
+            \param[in] pDevice GPU device. If nullptr, only the CPU-side table is created.
+            \param[in] uniformFraction Fraction of the selection probability that is distributed uniformly over all lights.
+        */
+        AnalyticPowerSampler(ref<Device> pDevice, float uniformFraction = kDefaultUniformFraction);
+
+        /** Updates the sampler to the active analytic lights of a scene.
+            The selection table is only rebuilt if the lights changed since the last call.
+            \param[in] pScene The scene.
+            \return True if the sampler was updated.
+        */
+        bool update(const ref<Scene>& pScene);
+
+        /** Set the light powers directly and rebuild the selection table.
+            If the number of lights is unchanged, only the parts of the table with changed weights are rebuilt.
+            \param[in] powers Power of each light. Negative or non-finite values are treated as zero.
+        */
+        void setLightPowers(const std::vector<float>& powers);
+
+        /** Set the fraction of the selection probability that is distributed uniformly over all lights.
+            \param[in] uniformFraction Uniform fraction in [0,1].
+        */
+        void setUniformFraction(float uniformFraction);
+        float getUniformFraction() const { return mUniformFraction; }
+
+        /** Returns the number of lights in the selection table.
+        */
+        uint32_t getLightCount() const { return mpTable ? mpTable->getCount() : 0; }
+
+        /** Returns the probability of selecting a light.
+            \param[in] lightIndex Light index.
+            \return Selection probability, or zero if the index is out of range.
+        */
+        float getSelectionPdf(uint32_t lightIndex) const;
+
+        /** Returns the light powers the table was built from.
+        */
+        const std::vector<float>& getLightPowers() const { return mPowers; }
+
+        /** Returns the total power of all lights.
+        */
+        double getTotalPower() const { return mTotalPower; }
+
+        /** Returns the alias table used for selection, or nullptr if there are no lights.
+        */
+        const AliasTable* getTable() const { return mpTable.get(); }
+
+        /** Bind the sampler data to a given shader variable.
+            \param[in] var Shader variable.
+        */
+        void bindShaderData(const ShaderVar& var) const;
+
+        /** Estimate the emitted power of an analytic light.
+            Lights at infinity report zero power. Their power is estimated as the irradiance
+            they deliver onto a disc the size of the scene.
+            \param[in] light The light.
+            \param[in] sceneRadius Radius of the scene bounding sphere.
+            \return Estimated power (luminance).
+        */
+        static float estimatePower(const Light& light, float sceneRadius);
+
+        /** Compute the selection weights for a list of light powers.
+            \param[in] powers Power of each light.
+            \param[in] uniformFraction Fraction of the probability that is distributed uniformly.
+            \return Normalized selection weights. If all powers are zero, the weights are uniform.
+        */
+        static std::vector<float> computeSelectionWeights(const std::vector<float>& powers, float uniformFraction);
+
+    private:
+        void rebuild();
+
+        ref<Device>                     mpDevice;
+        float                           mUniformFraction;
+        std::vector<float>              mPowers;            ///< Power of each light.
+        double                          mTotalPower = 0.0;  ///< Sum of all light powers.
+        std::mt19937                    mRng;
+        std::unique_ptr<AliasTable>     mpTable;            ///< Alias table over the selection weights.
+    };
+}
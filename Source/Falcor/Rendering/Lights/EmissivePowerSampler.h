@@ -29,6 +29,8 @@
 #include "EmissiveLightSampler.h"
 #include "Core/Macros.h"
 #include "Scene/Lights/LightCollection.h"
+#include "Utils/Sampling/AliasTable.h"
+#include <memory>
 #include <random>
 #include <vector>
 
@@ -42,13 +44,6 @@ namespace Falcor
     class FALCOR_API EmissivePowerSampler : public EmissiveLightSampler
     {
     public:
-        struct AliasTable
-        {
-            float weightSum;                ///< Total weight of all elements used to create the alias table
-            uint32_t N;                     ///< Number of entries in the alias table (and # elements in the buffers)
-            ref<Buffer> fullTable;          ///< A compressed/packed merged table.  Max 2^24 (16 million) entries per table.
-        };
-
         /** Creates a EmissivePowerSampler for a given scene.
             \param[in] pRenderContext The render context.
             \param[in] pScene The scene.
@@ -69,18 +64,12 @@ namespace Falcor
         virtual void bindShaderData(const ShaderVar& var) const override;
 
     protected:
-        /** Generate an alias table
-            \param[in] weights  The weights we'd like to sample each entry proportional to
-            \returns The alias table
-        */
-        AliasTable generateAliasTable(std::vector<float> weights);
-
         // Internal state
         bool                            mNeedsRebuild = true;   ///< Trigger rebuild on the next call to update(). We should always build on the first call, so the initial value is true.
 
         ref<const LightCollection>      mpLightCollection;
 
         std::mt19937                    mAliasTableRng;
-        AliasTable                      mTriangleTable;
+        std::unique_ptr<AliasTable>     mpTriangleTable;        ///< Alias table over the emissive triangles. Updated incrementally if only the triangle fluxes change.
     };
 }
@@ -29,6 +29,7 @@
 #include "Core/Error.h"
 #include "Utils/Logger.h"
 #include "Utils/Timing/Profiler.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
 #include "Utils/Math/MathConstants.slangh"
 #include <algorithm>
 
@@ -44,6 +45,9 @@ namespace
     const uint32_t kMaxLeafTriangleCount = 1 << PackedNode::kTriangleCountBits;
     const uint32_t kMaxLeafTriangleOffset = 1 << PackedNode::kTriangleOffsetBits;
 
+    // Nodes with at least this many triangles are processed with the parallel algorithms.
+    const uint32_t kMinParallelTriangleCount = 1 << 14;
+
     inline float safeACos(float v)
     {
         return std::acos(std::clamp(v, -1.0f, 1.0f));
@@ -285,9 +289,12 @@ namespace Falcor
         const uint64_t invalidBitmask = std::numeric_limits<uint64_t>::max();
         data.triangleBitmasks.resize(triangles.size(), invalidBitmask); // This is sized based on input triangle count, as it's indexed by global triangle index.
 
-        // Build the tree.
+        // Build the tree. Large nodes are split on the parallel worker threads, which record their own CPU events.
         SplitHeuristicFunction splitFunc = getSplitFunction(mOptions.splitHeuristicSelection);
-        buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
+        {
+            FALCOR_PROFILE_CPU("LightBVHBuilder::buildInternal");
+            buildInternal(mOptions, splitFunc, 0ull, 0, Range(0, static_cast<uint32_t>(data.trianglesData.size())), data);
+        }
         FALCOR_ASSERT(!data.nodes.empty());
 
         size_t numValid = 0;
@@ -356,10 +363,21 @@ namespace Falcor
         // Compute the AABB and total flux of the node.
         float nodeFlux = 0.f;
         AABB nodeBounds;
-        for (uint32_t dataIndex = triangleRange.begin; dataIndex < triangleRange.end; ++dataIndex)
+        if (triangleRange.length() >= kMinParallelTriangleCount)
         {
-            nodeBounds |= data.trianglesData[dataIndex].bounds;
-            nodeFlux += data.trianglesData[dataIndex].flux;
+            auto boundsAndFlux = parallel::transformReduce(triangleRange.length(), std::make_pair(AABB(), 0.f),
+                [&](size_t i) { const auto& td = data.trianglesData[triangleRange.begin + i]; return std::make_pair(td.bounds, td.flux); },
+                [](const std::pair<AABB, float>& a, const std::pair<AABB, float>& b) { return std::make_pair(a.first | b.first, a.second + b.second); });
+            nodeBounds = boundsAndFlux.first;
+            nodeFlux = boundsAndFlux.second;
+        }
+        else
+        {
+            for (uint32_t dataIndex = triangleRange.begin; dataIndex < triangleRange.end; ++dataIndex)
+            {
+                nodeBounds |= data.trianglesData[dataIndex].bounds;
+                nodeFlux += data.trianglesData[dataIndex].flux;
+            }
         }
         FALCOR_ASSERT(nodeBounds.valid());
 
@@ -374,8 +392,30 @@ namespace Falcor
             FALCOR_ASSERT(triangleRange.begin < splitResult.triangleIndex && splitResult.triangleIndex < triangleRange.end);
 
             // Sort the centroids and update the lists accordingly.
-            auto comp = [dim = splitResult.axis](const TriangleSortData& d1, const TriangleSortData& d2) { return d1.bounds.center()[dim] < d2.bounds.center()[dim]; };
-            std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
+            // Large nodes are fully sorted with a parallel radix sort on the centroids, which also partitions them at the split.
+            if (triangleRange.length() >= kMinParallelTriangleCount)
+            {
+                const uint32_t dim = splitResult.axis;
+                const size_t count = triangleRange.length();
+                auto triangles = data.trianglesData.begin() + triangleRange.begin;
+                std::vector<uint32_t> keys(count);
+                std::vector<uint32_t> order(count);
+                parallel::forEach(count, [&](size_t i)
+                {
+                    keys[i] = parallel::floatToRadixKey(triangles[i].bounds.center()[dim]);
+                    order[i] = (uint32_t)i;
+                });
+                parallel::radixSortKeyValue(keys.data(), order.data(), count);
+
+                std::vector<TriangleSortData> sortedTriangles(count);
+                parallel::forEach(count, [&](size_t i) { sortedTriangles[i] = triangles[order[i]]; });
+                parallel::forEach(count, [&](size_t i) { triangles[i] = sortedTriangles[i]; });
+            }
+            else
+            {
+                auto comp = [dim = splitResult.axis](const TriangleSortData& d1, const TriangleSortData& d2) { return d1.bounds.center()[dim] < d2.bounds.center()[dim]; };
+                std::nth_element(std::begin(data.trianglesData) + triangleRange.begin, std::begin(data.trianglesData) + splitResult.triangleIndex, std::begin(data.trianglesData) + triangleRange.end, comp);
+            }
 
             // Allocate internal node.
             FALCOR_ASSERT(data.nodes.size() < std::numeric_limits<uint32_t>::max());
@@ -0,0 +1,169 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "BlasBuildPlanner.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+    uint64_t BlasBuildPlanner::estimateFinalByteSize(const BlasRecord& record, const Options& options)
+    {
+        if (!record.useCompaction) return record.resultByteSize;
+        double ratio = std::clamp(options.compactionRatio, 0.0, 1.0);
+        return std::max<uint64_t>(1, (uint64_t)(record.resultByteSize * ratio));
+    }
+
+    BlasBuildPlanner::Plan BlasBuildPlanner::plan(const std::vector<BlasRecord>& records, const Options& options)
+    {
+        Plan plan;
+        const uint32_t blasCount = (uint32_t)records.size();
+        if (blasCount == 0) return plan;
+
+        uint64_t totalResult = 0;
+        uint64_t totalScratch = 0;
+        uint64_t maxResult = 0;
+        uint64_t maxScratch = 0;
+        bool needsScratchAfterBuild = false;
+
+        for (const auto& record : records)
+        {
+            totalResult += record.resultByteSize;
+            totalScratch += record.scratchByteSize;
+            maxResult = std::max(maxResult, record.resultByteSize);
+            maxScratch = std::max(maxScratch, record.scratchByteSize);
+            needsScratchAfterBuild |= record.needsScratchAfterBuild;
+        }
+
+        // Split the budget between result and scratch memory proportionally to the total demand.
+        // The shared buffers are sized for the largest group in each category, so bounding both
+        // parts separately bounds the sum of the two buffers by the budget.
+        // A single BLAS is always allowed to exceed its share.
+        const uint64_t totalSize = totalResult + totalScratch;
+        const double resultFraction = totalSize > 0 ? (double)totalResult / (double)totalSize : 0.5;
+        const uint64_t resultCapacity = std::max(maxResult, (uint64_t)(options.memoryBudget * resultFraction));
+        const uint64_t scratchCapacity = std::max(maxScratch, (uint64_t)(options.memoryBudget * (1.0 - resultFraction)));
+
+        // First-fit decreasing bin packing on the combined size.
+        // Ties are broken by BLAS index to keep the plan deterministic.
+        std::vector<uint32_t> order(blasCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [&](uint32_t a, uint32_t b)
+        {
+            uint64_t sizeA = records[a].resultByteSize + records[a].scratchByteSize;
+            uint64_t sizeB = records[b].resultByteSize + records[b].scratchByteSize;
+            return sizeA != sizeB ? sizeA > sizeB : a < b;
+        });
+
+        std::vector<Group> groups;
+        for (uint32_t blasId : order)
+        {
+            const auto& record = records[blasId];
+            auto it = std::find_if(groups.begin(), groups.end(), [&](const Group& group)
+            {
+                return group.resultByteSize + record.resultByteSize <= resultCapacity &&
+                    group.scratchByteSize + record.scratchByteSize <= scratchCapacity;
+            });
+            if (it == groups.end()) it = groups.insert(groups.end(), Group{});
+
+            it->blasIndices.push_back(blasId);
+            it->resultByteSize += record.resultByteSize;
+            it->scratchByteSize += record.scratchByteSize;
+            it->estimatedFinalByteSize += estimateFinalByteSize(record, options);
+        }
+
+        // Keep BLASes in declaration order within each group and order groups by their first BLAS.
+        for (auto& group : groups) std::sort(group.blasIndices.begin(), group.blasIndices.end());
+        std::sort(groups.begin(), groups.end(), [](const Group& a, const Group& b) { return a.blasIndices.front() < b.blasIndices.front(); });
+
+        // If no BLAS needs the scratch buffer after the build, it can be released before the final buffer
+        // of the last group is allocated. Schedule the group with the largest final size last to benefit most.
+        plan.releaseScratchBeforeLastGroup = !needsScratchAfterBuild;
+        if (plan.releaseScratchBeforeLastGroup)
+        {
+            size_t largest = groups.size() - 1;
+            for (size_t i = 0; i < groups.size(); i++)
+            {
+                if (groups[i].estimatedFinalByteSize > groups[largest].estimatedFinalByteSize) largest = i;
+            }
+            std::rotate(groups.begin() + largest, groups.begin() + largest + 1, groups.end());
+        }
+
+        // Assign per-BLAS group indices and buffer offsets.
+        plan.blasGroupIndex.resize(blasCount);
+        plan.resultByteOffset.resize(blasCount);
+        plan.scratchByteOffset.resize(blasCount);
+
+        std::vector<uint64_t> estimatedFinalSizes;
+        for (uint32_t groupIndex = 0; groupIndex < (uint32_t)groups.size(); groupIndex++)
+        {
+            const auto& group = groups[groupIndex];
+            uint64_t resultOffset = 0;
+            uint64_t scratchOffset = 0;
+            for (uint32_t blasId : group.blasIndices)
+            {
+                plan.blasGroupIndex[blasId] = groupIndex;
+                plan.resultByteOffset[blasId] = resultOffset;
+                plan.scratchByteOffset[blasId] = scratchOffset;
+                resultOffset += records[blasId].resultByteSize;
+                scratchOffset += records[blasId].scratchByteSize;
+            }
+            FALCOR_ASSERT(resultOffset == group.resultByteSize && scratchOffset == group.scratchByteSize);
+
+            plan.resultBufferSize = std::max(plan.resultBufferSize, group.resultByteSize);
+            plan.scratchBufferSize = std::max(plan.scratchBufferSize, group.scratchByteSize);
+            plan.estimatedFinalByteSize += group.estimatedFinalByteSize;
+            estimatedFinalSizes.push_back(group.estimatedFinalByteSize);
+        }
+
+        plan.groups = std::move(groups);
+        plan.plannedPeakMemory = computePeakMemory(plan, estimatedFinalSizes);
+
+        return plan;
+    }
+
+    uint64_t BlasBuildPlanner::computePeakMemory(const Plan& plan, const std::vector<uint64_t>& groupFinalByteSizes)
+    {
+        FALCOR_CHECK(groupFinalByteSizes.size() == plan.groups.size(), "Expected one final size per BLAS group.");
+
+        uint64_t peak = 0;
+        uint64_t finalSize = 0;
+        for (size_t i = 0; i < groupFinalByteSizes.size(); i++)
+        {
+            // While building, the result and scratch buffers are live along with all previously compacted groups.
+            // The final buffer of the group is allocated after the build, at which point the scratch buffer
+            // has been released if this is the last group and nothing needs it afterwards.
+            bool releaseScratch = plan.releaseScratchBeforeLastGroup && i + 1 == groupFinalByteSizes.size();
+            uint64_t duringBuild = plan.resultBufferSize + plan.scratchBufferSize + finalSize;
+            finalSize += groupFinalByteSizes[i];
+            uint64_t duringCompaction = plan.resultBufferSize + (releaseScratch ? 0 : plan.scratchBufferSize) + finalSize;
+            peak = std::max({ peak, duringBuild, duringCompaction });
+        }
+        return peak;
+    }
+}
@@ -0,0 +1,114 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Plans how BLASes are grouped and scheduled during the initial BLAS build.
+
+        The BLAS build in `Scene::buildBlas` works on one group at a time:
+        all BLASes of a group are built into a shared intermediate result buffer,
+        using a shared scratch buffer, and are then compacted/cloned into a
+        final per-group buffer. The result and scratch buffers are sized for the
+        largest group and reused across groups, while the final buffers accumulate.
+
+        The peak memory during the build is therefore approximately:
+
+            maxGroupResult + maxGroupScratch + sum(final sizes)
+
+        The planner bin-packs BLASes into groups bounded by a memory budget, keeping
+        both the result and the scratch part of each group within their share of the
+        budget, and orders the groups such that the scratch buffer can be released
+        before the last (largest) group is compacted when no BLAS needs it afterwards.
+
+        This is a pure CPU function operating on prebuild info records,
+        which allows it to be tested without a GPU device.
+    */
+    class FALCOR_API BlasBuildPlanner
+    {
+    public:
+        /** Prebuild info for a single BLAS.
+        */
+        struct BlasRecord
+        {
+            uint64_t resultByteSize = 0;            ///< Maximum result data size, including padding.
+            uint64_t scratchByteSize = 0;           ///< Maximum scratch data size, including padding.
+            bool useCompaction = false;             ///< Whether the BLAS is compacted after build.
+            bool needsScratchAfterBuild = false;    ///< Whether the BLAS is updated later on, i.e. the scratch buffer must be retained.
+        };
+
+        struct Options
+        {
+            uint64_t memoryBudget = 1ull << 29;     ///< Target intermediate memory (result + scratch) per group in bytes. Not a strict limit, single BLASes may exceed it.
+            double compactionRatio = 0.5;           ///< Estimated ratio of compacted size to result size for BLASes using compaction.
+        };
+
+        struct Group
+        {
+            std::vector<uint32_t> blasIndices;      ///< Indices of all BLASes in the group, in ascending order.
+            uint64_t resultByteSize = 0;            ///< Result data size for all BLASes in the group.
+            uint64_t scratchByteSize = 0;           ///< Scratch data size for all BLASes in the group.
+            uint64_t estimatedFinalByteSize = 0;    ///< Estimated size of the final BLASes in the group post-compaction.
+        };
+
+        struct Plan
+        {
+            std::vector<Group> groups;              ///< BLAS groups in build order.
+            std::vector<uint32_t> blasGroupIndex;   ///< Group index per BLAS.
+            std::vector<uint64_t> resultByteOffset; ///< Offset into the result buffer per BLAS.
+            std::vector<uint64_t> scratchByteOffset;///< Offset into the scratch buffer per BLAS.
+
+            uint64_t resultBufferSize = 0;          ///< Required size of the shared result buffer.
+            uint64_t scratchBufferSize = 0;         ///< Required size of the shared scratch buffer.
+            uint64_t estimatedFinalByteSize = 0;    ///< Estimated total size of all final BLASes.
+            bool releaseScratchBeforeLastGroup = false; ///< True if the scratch buffer can be released before the last group is compacted.
+            uint64_t plannedPeakMemory = 0;         ///< Planned peak memory during the build in bytes.
+        };
+
+        /** Compute a build plan.
+            \param[in] records Prebuild info per BLAS.
+            \param[in] options Planner options.
+            \return The build plan.
+        */
+        static Plan plan(const std::vector<BlasRecord>& records, const Options& options);
+
+        /** Estimate the final size of a BLAS from its prebuild info.
+        */
+        static uint64_t estimateFinalByteSize(const BlasRecord& record, const Options& options);
+
+        /** Estimate the peak memory of executing a plan with the given per-group final sizes.
+            \param[in] plan Build plan. Only the groups, buffer sizes and scratch release flag are used.
+            \param[in] groupFinalByteSizes Final size per group, in build order.
+            \return Peak memory in bytes.
+        */
+        static uint64_t computePeakMemory(const Plan& plan, const std::vector<uint64_t>& groupFinalByteSizes);
+    };
+}
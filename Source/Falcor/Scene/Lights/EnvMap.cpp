@@ -40,6 +40,8 @@ namespace Falcor
 
     ref<EnvMap> EnvMap::createFromFile(ref<Device> pDevice, const std::filesystem::path& path)
     {
+        FALCOR_CHECK(pDevice != nullptr, "'pDevice' must be a valid device");
+
         // Load environment map from file. Set it to generate mips and use linear color.
         auto pTexture = Texture::createFromFile(pDevice, path, true, false);
         if (!pTexture) return nullptr;
@@ -581,6 +581,37 @@ namespace Falcor
         return (*this) == (*other);
     }
 
+    uint64_t BasicMaterial::getHash() const
+    {
+        // Hash the fields compared by operator==, except the samplers. Values that compare equal
+        // must hash equally, so all components are hashed as floats with negative zero as zero.
+        auto hashFloat = [](FNVHash64& hash, float value)
+        {
+            if (value == 0.f) value = 0.f;
+            hash.insert(&value, sizeof(value));
+        };
+        auto hashVector = [&](FNVHash64& hash, const auto& v)
+        {
+            for (int i = 0; i < v.length(); i++) hashFloat(hash, float(v[i]));
+        };
+
+        FNVHash64 hash = getBaseHash();
+        hash.insert(&mData.flags, sizeof(mData.flags));
+        hashFloat(hash, mData.displacementScale);
+        hashFloat(hash, mData.displacementOffset);
+        hashVector(hash, mData.baseColor);
+        hashVector(hash, mData.specular);
+        hashVector(hash, mData.emissive);
+        hashFloat(hash, mData.emissiveFactor);
+        hashFloat(hash, float(mData.diffuseTransmission));
+        hashFloat(hash, float(mData.specularTransmission));
+        hashVector(hash, mData.transmission);
+        hashVector(hash, mData.volumeAbsorption);
+        hashFloat(hash, float(mData.volumeAnisotropy));
+        hashVector(hash, mData.volumeScattering);
+        return hash.get();
+    }
+
     bool BasicMaterial::operator==(const BasicMaterial& other) const
     {
         if (!isBaseEqual(other)) return false;
@@ -604,9 +635,9 @@ namespace Falcor
 #undef compare_vec_field
 
         // Compare the sampler descs directly to identify functional differences.
-        if (mpDefaultSampler->getDesc() != other.mpDefaultSampler->getDesc()) return false;
-        if (mpDisplacementMinSampler->getDesc() != other.mpDisplacementMinSampler->getDesc()) return false;
-        if (mpDisplacementMaxSampler->getDesc() != other.mpDisplacementMaxSampler->getDesc()) return false;
+        if (!isSamplerEqual(mpDefaultSampler, other.mpDefaultSampler)) return false;
+        if (!isSamplerEqual(mpDisplacementMinSampler, other.mpDisplacementMinSampler)) return false;
+        if (!isSamplerEqual(mpDisplacementMaxSampler, other.mpDisplacementMaxSampler)) return false;
 
         return true;
     }
@@ -139,6 +139,13 @@ namespace Falcor
         return true;
     }
 
+    uint64_t MERLMaterial::getHash() const
+    {
+        FNVHash64 hash = getBaseHash();
+        hashPath(hash, mPath);
+        return hash.get();
+    }
+
     ProgramDesc::ShaderModuleList MERLMaterial::getShaderModules() const
     {
         return { ProgramDesc::ShaderModule::fromFile(kShaderFile) };
@@ -230,11 +230,22 @@ namespace Falcor
         }
 
         // Compare samplers.
-        if (mpDefaultSampler->getDesc() != other->mpDefaultSampler->getDesc()) return false;
+        if (!isSamplerEqual(mpDefaultSampler, other->mpDefaultSampler)) return false;
 
         return true;
     }
 
+    uint64_t MERLMixMaterial::getHash() const
+    {
+        FNVHash64 hash = getBaseHash();
+        for (const auto& brdf : mBRDFs)
+        {
+            hash.insert(brdf.name.data(), brdf.name.size() + 1);
+            hashPath(hash, brdf.path);
+        }
+        return hash.get();
+    }
+
     ProgramDesc::ShaderModuleList MERLMixMaterial::getShaderModules() const
     {
         return { ProgramDesc::ShaderModule::fromFile(kShaderFile) };
@@ -168,7 +168,7 @@ namespace Falcor
     bool Material::hasTextureSlotData(const TextureSlot slot) const
     {
         FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
-        return mTextureSlotData[(size_t)slot].pTexture != nullptr;
+        return mTextureSlotData[(size_t)slot].hasData();
     }
 
     bool Material::setTexture(const TextureSlot slot, const ref<Texture>& pTexture)
@@ -179,10 +179,12 @@ namespace Falcor
             return false;
         }
 
-        if (pTexture == getTexture(slot)) return false;
-
         FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
-        mTextureSlotData[(size_t)slot].pTexture = pTexture;
+        auto& slotData = mTextureSlotData[(size_t)slot];
+        if (pTexture == slotData.pTexture && slotData.sourcePath.empty()) return false;
+
+        slotData.pTexture = pTexture;
+        slotData.sourcePath.clear();
 
         markUpdates(UpdateFlags::ResourcesChanged);
         if (slot == TextureSlot::Emissive)
@@ -199,6 +201,38 @@ namespace Falcor
         return mTextureSlotData[(size_t)slot].pTexture;
     }
 
+    bool Material::setTextureSourcePath(const TextureSlot slot, const std::filesystem::path& path)
+    {
+        if (!hasTextureSlot(slot))
+        {
+            logWarning("Material '{}' does not have texture slot '{}'. Ignoring call to setTextureSourcePath().", getName(), to_string(slot));
+            return false;
+        }
+
+        FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
+        auto& slotData = mTextureSlotData[(size_t)slot];
+        if (slotData.pTexture == nullptr && slotData.sourcePath == path) return false;
+
+        // Texture-derived material metadata is computed by setTexture() once the texture is loaded.
+        slotData.pTexture = nullptr;
+        slotData.sourcePath = path;
+
+        markUpdates(UpdateFlags::ResourcesChanged);
+        if (slot == TextureSlot::Emissive)
+            markUpdates(UpdateFlags::EmissiveChanged);
+
+        return true;
+    }
+
+    std::filesystem::path Material::getTextureSourcePath(const TextureSlot slot) const
+    {
+        if (!hasTextureSlot(slot)) return {};
+
+        FALCOR_ASSERT((size_t)slot < mTextureSlotInfo.size());
+        const auto& slotData = mTextureSlotData[(size_t)slot];
+        return slotData.pTexture ? slotData.pTexture->getSourcePath() : slotData.sourcePath;
+    }
+
     bool Material::loadTexture(TextureSlot slot, const std::filesystem::path& path, bool useSrgb)
     {
         if (!hasTextureSlot(slot))
@@ -207,6 +241,13 @@ namespace Falcor
             return false;
         }
 
+        // Without a device the texture is only recorded by path (headless scene builds).
+        if (!mpDevice)
+        {
+            setTextureSourcePath(slot, path);
+            return true;
+        }
+
         auto texture = Texture::createFromFile(mpDevice, path, true, useSrgb && getTextureSlotInfo(slot).srgb);
         if (texture)
         {
@@ -328,6 +369,56 @@ namespace Falcor
         return true;
     }
 
+    bool Material::isSamplerEqual(const ref<Sampler>& pA, const ref<Sampler>& pB)
+    {
+        // Samplers are compared by desc to identify functional differences.
+        // Materials created without a device (headless scene builds) have no samplers.
+        if (!pA || !pB) return pA == pB;
+        return pA->getDesc() == pB->getDesc();
+    }
+
+    FNVHash64 Material::getBaseHash() const
+    {
+        // This function hashes the data compared by isBaseEqual() except the texture transform.
+        // Equal materials must have equal hashes, but not all data needs to be included.
+
+        FNVHash64 hash;
+        hash.insert(&mHeader.packedData, sizeof(mHeader.packedData));
+
+        FALCOR_ASSERT(mTextureSlotInfo.size() == mTextureSlotData.size());
+        for (uint32_t i = 0; i < (uint32_t)mTextureSlotData.size(); i++)
+        {
+            const auto& slotData = mTextureSlotData[i];
+            if (!hasTextureSlot((TextureSlot)i) || !slotData.hasData()) continue;
+
+            // Textures recorded by path only are hashed by their path.
+            const auto& pTexture = slotData.pTexture;
+            if (!pTexture)
+            {
+                hash.insert(&i, sizeof(i));
+                hashPath(hash, slotData.sourcePath);
+                continue;
+            }
+
+            // Hash the texture source and properties instead of its address.
+            const uint32_t desc[5] = { i, (uint32_t)pTexture->getFormat(), pTexture->getWidth(), pTexture->getHeight(), pTexture->getDepth() };
+            hash.insert(desc, sizeof(desc));
+            hashPath(hash, pTexture->getSourcePath());
+        }
+
+        return hash;
+    }
+
+    void Material::hashPath(FNVHash64& hash, const std::filesystem::path& path)
+    {
+        // Paths compare equal element-wise, so hash the elements rather than the native string.
+        for (const auto& element : path)
+        {
+            const std::string str = element.string();
+            hash.insert(str.data(), str.size() + 1);
+        }
+    }
+
     NormalMapType Material::detectNormalMapType(const ref<Texture>& pNormalMap)
     {
         NormalMapType type = NormalMapType::None;
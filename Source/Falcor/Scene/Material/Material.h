@@ -38,6 +38,7 @@
 #include "Core/API/Texture.h"
 #include "Core/API/Sampler.h"
 #include "Utils/Image/TextureAnalyzer.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/UI/Gui.h"
 #include "Scene/Transform.h"
 #include "MaterialTypeRegistry.h"
@@ -101,9 +102,10 @@ namespace Falcor
         struct TextureSlotData
         {
             ref<Texture>  pTexture;                           ///< Texture bound to texture slot.
+            std::filesystem::path sourcePath;                 ///< Source path of a texture that is not loaded (materials without a device only).
 
-            bool hasData() const { return pTexture != nullptr; }
-            bool operator==(const TextureSlotData& rhs) const { return pTexture == rhs.pTexture; }
+            bool hasData() const { return pTexture != nullptr || !sourcePath.empty(); }
+            bool operator==(const TextureSlotData& rhs) const { return pTexture == rhs.pTexture && sourcePath == rhs.sourcePath; }
             bool operator!=(const TextureSlotData& rhs) const { return !((*this) == rhs); }
         };
 
@@ -163,6 +165,13 @@ namespace Falcor
         */
         virtual bool isEqual(const ref<Material>& pOther) const = 0;
 
+        /** Compute a hash of the material properties for finding duplicate materials.
+            Materials that are equal according to isEqual() have the same hash. The hash does not depend
+            on object addresses, so it is stable between runs.
+            \return 64-bit hash of all material properties *except* the name.
+        */
+        virtual uint64_t getHash() const = 0;
+
         /** Set the double-sided flag. This flag doesn't affect the cull state, just the shading.
         */
         virtual void setDoubleSided(bool doubleSided);
@@ -257,6 +266,28 @@ namespace Falcor
         */
         virtual ref<Texture> getTexture(const TextureSlot slot) const;
 
+        /** Check if one of the available texture slots has a texture bound or recorded by path.
+            \param[in] slot The texture slot.
+            \return True if the slot has a texture or a texture source path set by setTextureSourcePath().
+        */
+        bool hasTextureSlotData(const TextureSlot slot) const;
+
+        /** Set the source path of one of the available texture slots without loading the texture.
+            This is used by materials created without a GPU device (headless scene builds), which
+            record their textures by path so they can be loaded when the scene cache is read.
+            The call is ignored with a warning if the slot doesn't exist.
+            \param[in] slot The texture slot.
+            \param[in] path Texture file path.
+            \return True if the texture slot was changed, false otherwise.
+        */
+        bool setTextureSourcePath(const TextureSlot slot, const std::filesystem::path& path);
+
+        /** Get the source path of one of the available texture slots.
+            \param[in] slot The texture slot.
+            \return Source path of the bound texture or of the texture recorded by setTextureSourcePath(), or an empty path if the slot is unbound.
+        */
+        std::filesystem::path getTextureSourcePath(const TextureSlot slot) const;
+
         /** Optimize texture usage for the given texture slot.
             This function may replace constant textures by uniform material parameters etc.
             \param[in] slot The texture slot.
@@ -349,11 +380,13 @@ namespace Falcor
         using UpdateCallback = std::function<void(Material::UpdateFlags)>;
         void registerUpdateCallback(const UpdateCallback& updateCallback) { mUpdateCallback = updateCallback; }
         void markUpdates(UpdateFlags updates);
-        bool hasTextureSlotData(const TextureSlot slot) const;
         void updateTextureHandle(MaterialSystem* pOwner, const ref<Texture>& pTexture, TextureHandle& handle);
         void updateTextureHandle(MaterialSystem* pOwner, const TextureSlot slot, TextureHandle& handle);
         void updateDefaultTextureSamplerID(MaterialSystem* pOwner, const ref<Sampler>& pSampler);
         bool isBaseEqual(const Material& other) const;
+        FNVHash64 getBaseHash() const;
+        static void hashPath(FNVHash64& hash, const std::filesystem::path& path);
+        static bool isSamplerEqual(const ref<Sampler>& pA, const ref<Sampler>& pB);
 
         static NormalMapType detectNormalMapType(const ref<Texture>& pNormalMap);
 
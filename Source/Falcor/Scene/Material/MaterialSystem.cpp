@@ -30,7 +30,10 @@
 #include "Core/API/Device.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
+#include "Utils/NumericRange.h"
 #include "MaterialTypeRegistry.h"
+#include <algorithm>
+#include <execution>
 #include <numeric>
 
 namespace Falcor
@@ -63,6 +66,9 @@ namespace Falcor
     MaterialSystem::MaterialSystem(ref<Device> pDevice)
         : mpDevice(pDevice)
     {
+        // Without a device the material system only holds materials on the CPU (headless scene builds).
+        if (!mpDevice) return;
+
         FALCOR_ASSERT(kMaxSamplerCount <= mpDevice->getLimits().maxShaderVisibleSamplers);
 
         mpFence = mpDevice->createFence();
@@ -212,9 +218,9 @@ namespace Falcor
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
         // Reuse previously added materials.
-        if (auto it = std::find(mMaterials.begin(), mMaterials.end(), pMaterial); it != mMaterials.end())
+        if (auto it = mMaterialIDs.find(pMaterial.get()); it != mMaterialIDs.end())
         {
-            return MaterialID{(size_t)std::distance(mMaterials.begin(), it) };
+            return it->second;
         }
 
         // Add material.
@@ -231,6 +237,7 @@ namespace Falcor
 
         pMaterial->registerUpdateCallback([this](auto flags) { mMaterialUpdates |= flags; });
         mMaterials.push_back(pMaterial);
+        mMaterialIDs.emplace(pMaterial.get(), materialID);
         mMaterialsChanged = true;
 
         return materialID;
@@ -256,6 +263,9 @@ namespace Falcor
         pReplacement->registerUpdateCallback([this](auto flags) { mMaterialUpdates |= flags; });
 
         // Replace the material.
+        if (auto it = mMaterialIDs.find(prevMtl.get()); it != mMaterialIDs.end() && it->second == materialID) mMaterialIDs.erase(it);
+        auto [it, inserted] = mMaterialIDs.try_emplace(pReplacement.get(), materialID);
+        if (!inserted && materialID.get() < it->second.get()) it->second = materialID;
         mMaterials[materialID.get()] = pReplacement;
         mMaterialsChanged = true;
     }
@@ -265,10 +275,9 @@ namespace Falcor
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
 
         // Find material to replace.
-        if (auto it = std::find(mMaterials.begin(), mMaterials.end(), pMaterial); it != mMaterials.end())
+        if (auto it = mMaterialIDs.find(pMaterial.get()); it != mMaterialIDs.end())
         {
-            auto materialID = MaterialID{ (size_t)std::distance(mMaterials.begin(), it) };
-            replaceMaterial(materialID, pReplacement);
+            replaceMaterial(it->second, pReplacement);
         }
         else
         {
@@ -318,30 +327,74 @@ namespace Falcor
 
     size_t MaterialSystem::removeDuplicateMaterials(std::vector<MaterialID>& idMap)
     {
-        std::vector<ref<Material>> uniqueMaterials;
-        idMap.resize(mMaterials.size());
+        const uint32_t materialCount = (uint32_t)mMaterials.size();
+        idMap.resize(materialCount);
+
+        // Bucket the materials by content hash. Equal materials have equal hashes, so only materials
+        // within a bucket need to be compared. The buckets are sorted by material ID within each hash.
+        std::vector<uint64_t> hashes(materialCount);
+        NumericRange<uint32_t> range(0, materialCount);
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t i) { hashes[i] = mMaterials[i]->getHash(); });
 
-        // Find unique set of materials.
-        for (MaterialID id{ 0 }; id.get() < mMaterials.size(); ++id)
+        std::vector<uint32_t> order(materialCount);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(std::execution::par, order.begin(), order.end(), [&](uint32_t a, uint32_t b) { return hashes[a] != hashes[b] ? hashes[a] < hashes[b] : a < b; });
+
+        std::vector<uint32_t> bucketOffsets;
+        for (uint32_t i = 0; i < materialCount; i++)
+        {
+            if (i == 0 || hashes[order[i]] != hashes[order[i - 1]]) bucketOffsets.push_back(i);
+        }
+        bucketOffsets.push_back(materialCount);
+
+        // Find the first equal material for each material within the buckets in parallel.
+        // This is the same material as a linear search over the unique materials in ID order would find.
+        std::vector<uint32_t> firstEqual(materialCount);
+        NumericRange<uint32_t> bucketRange(0, (uint32_t)bucketOffsets.size() - 1);
+        std::for_each(std::execution::par, bucketRange.begin(), bucketRange.end(), [&](uint32_t bucket)
+        {
+            std::vector<uint32_t> uniqueIndices;
+            for (uint32_t i = bucketOffsets[bucket]; i < bucketOffsets[bucket + 1]; i++)
+            {
+                const uint32_t index = order[i];
+                const auto& pMaterial = mMaterials[index];
+                auto it = std::find_if(uniqueIndices.begin(), uniqueIndices.end(), [&](uint32_t j) { return mMaterials[j]->isEqual(pMaterial); });
+                if (it == uniqueIndices.end())
+                {
+                    uniqueIndices.push_back(index);
+                    firstEqual[index] = index;
+                }
+                else
+                {
+                    firstEqual[index] = *it;
+                }
+            }
+        });
+
+        // Assign the new material IDs in order.
+        std::vector<ref<Material>> uniqueMaterials;
+        for (MaterialID id{ 0 }; id.get() < materialCount; ++id)
         {
-            const auto& pMaterial = mMaterials[id.get()];
-            auto it = std::find_if(uniqueMaterials.begin(), uniqueMaterials.end(), [&pMaterial](const auto& m) { return m->isEqual(pMaterial); });
-            if (it == uniqueMaterials.end())
+            const uint32_t index = firstEqual[id.get()];
+            if (index == id.get())
             {
                 idMap[id.get()] = MaterialID{ uniqueMaterials.size() };
-                uniqueMaterials.push_back(pMaterial);
+                uniqueMaterials.push_back(mMaterials[id.get()]);
             }
             else
             {
-                logInfo("Removing duplicate material '{}' (duplicate of '{}').", pMaterial->getName(), (*it)->getName());
-                idMap[id.get()] = MaterialID{ (size_t)std::distance(uniqueMaterials.begin(), it) };
+                logDebug("Removing duplicate material '{}' (duplicate of '{}').", mMaterials[id.get()]->getName(), mMaterials[index]->getName());
+                idMap[id.get()] = idMap[index];
             }
         }
 
         size_t removed = mMaterials.size() - uniqueMaterials.size();
         if (removed > 0)
         {
+            logInfo("Removed {} duplicate materials.", removed);
             mMaterials = uniqueMaterials;
+            mMaterialIDs.clear();
+            for (MaterialID id{ 0 }; id.get() < mMaterials.size(); ++id) mMaterialIDs.emplace(mMaterials[id.get()].get(), id);
             mMaterialsChanged = true;
         }
 
@@ -37,6 +37,7 @@
 #include "Utils/Image/TextureManager.h"
 #include "Utils/UI/Gui.h"
 #include <memory>
+#include <unordered_map>
 #include <vector>
 #include <set>
 
@@ -71,6 +72,8 @@ namespace Falcor
         };
 
         /** Constructor. Throws an exception if creation failed.
+            \param[in] pDevice GPU device. If null, the material system only holds materials on the CPU
+                and no GPU resources are created. This is used for headless scene builds.
         */
         MaterialSystem(ref<Device> pDevice);
 
@@ -243,7 +246,7 @@ namespace Falcor
 
         /** Get texture manager. This holds all textures.
         */
-        TextureManager& getTextureManager() { return *mpTextureManager; }
+        TextureManager& getTextureManager() { FALCOR_ASSERT(mpTextureManager); return *mpTextureManager; }
 
 
     private:
@@ -255,6 +258,7 @@ namespace Falcor
         ref<Device> mpDevice;
 
         std::vector<ref<Material>> mMaterials;                      ///< List of all materials.
+        std::unordered_map<const Material*, MaterialID> mMaterialIDs; ///< Map from material to the ID of its first occurrence in the list.
         std::vector<Material::UpdateFlags> mMaterialsUpdateFlags;   ///< List of all material update flags, after the update() calls
         std::unique_ptr<TextureManager> mpTextureManager;           ///< Texture manager holding all material textures.
         ProgramDesc::ShaderModuleList mShaderModules;                   ///< Shader modules for all materials in use.
@@ -133,6 +133,13 @@ namespace Falcor
         return true;
     }
 
+    uint64_t RGLMaterial::getHash() const
+    {
+        FNVHash64 hash = getBaseHash();
+        hashPath(hash, mPath);
+        return hash.get();
+    }
+
     ProgramDesc::ShaderModuleList RGLMaterial::getShaderModules() const
     {
         return { ProgramDesc::ShaderModule::fromFile(kShaderFile) };
@@ -0,0 +1,313 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshDeduplicator.h"
+#include "Core/Error.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include "Utils/Math/FNVHash.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Compute the eigenvector of the largest eigenvalue of a symmetric 4x4 matrix using cyclic Jacobi rotations.
+        */
+        void computeMaxEigenvector(double a[4][4], double v[4])
+        {
+            double e[4][4] = {};
+            for (int i = 0; i < 4; i++) e[i][i] = 1.0;
+
+            for (int sweep = 0; sweep < 50; sweep++)
+            {
+                double off = 0.0, diag = 0.0;
+                for (int i = 0; i < 4; i++)
+                {
+                    diag += a[i][i] * a[i][i];
+                    for (int j = i + 1; j < 4; j++) off += a[i][j] * a[i][j];
+                }
+                if (off <= 1e-30 * diag || off == 0.0) break;
+
+                for (int p = 0; p < 3; p++)
+                {
+                    for (int q = p + 1; q < 4; q++)
+                    {
+                        if (a[p][q] == 0.0) continue;
+
+                        // Rotate rows/columns p and q to annihilate a[p][q].
+                        double theta = (a[q][q] - a[p][p]) / (2.0 * a[p][q]);
+                        double t = (theta >= 0.0 ? 1.0 : -1.0) / (std::abs(theta) + std::sqrt(theta * theta + 1.0));
+                        double c = 1.0 / std::sqrt(t * t + 1.0);
+                        double s = t * c;
+
+                        for (int k = 0; k < 4; k++)
+                        {
+                            double akp = a[k][p], akq = a[k][q];
+                            a[k][p] = c * akp - s * akq;
+                            a[k][q] = s * akp + c * akq;
+                        }
+                        for (int k = 0; k < 4; k++)
+                        {
+                            double apk = a[p][k], aqk = a[q][k];
+                            a[p][k] = c * apk - s * aqk;
+                            a[q][k] = s * apk + c * aqk;
+                        }
+                        for (int k = 0; k < 4; k++)
+                        {
+                            double ekp = e[k][p], ekq = e[k][q];
+                            e[k][p] = c * ekp - s * ekq;
+                            e[k][q] = s * ekp + c * ekq;
+                        }
+                    }
+                }
+            }
+
+            int maxIndex = 0;
+            for (int i = 1; i < 4; i++)
+            {
+                if (a[i][i] > a[maxIndex][maxIndex]) maxIndex = i;
+            }
+            for (int k = 0; k < 4; k++) v[k] = e[k][maxIndex];
+        }
+    }
+
+    std::vector<uint32_t> MeshDeduplicator::findDuplicates(const std::vector<uint64_t>& hashes, const std::function<bool(uint32_t, uint32_t)>& isDuplicate)
+    {
+        const uint32_t count = (uint32_t)hashes.size();
+        std::vector<uint32_t> classes(count);
+        std::iota(classes.begin(), classes.end(), 0);
+
+        // Sort items by hash, keeping equal hashes in item order so that the first item of each class has the smallest index.
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        std::vector<uint64_t> keys = hashes;
+        parallel::radixSortKeyValue(keys.data(), order.data(), count);
+
+        // Find the ranges of items with equal hashes.
+        std::vector<std::pair<uint32_t, uint32_t>> buckets;
+        for (uint32_t begin = 0; begin < count;)
+        {
+            uint32_t end = begin + 1;
+            while (end < count && hashes[order[end]] == hashes[order[begin]]) end++;
+            if (end - begin > 1) buckets.emplace_back(begin, end);
+            begin = end;
+        }
+
+        std::for_each(std::execution::par, buckets.begin(), buckets.end(), [&](const std::pair<uint32_t, uint32_t>& bucket)
+        {
+            std::vector<uint32_t> uniqueItems;
+            for (uint32_t i = bucket.first; i < bucket.second; i++)
+            {
+                const uint32_t item = order[i];
+                auto it = std::find_if(uniqueItems.begin(), uniqueItems.end(), [&](uint32_t other) { return isDuplicate(other, item); });
+                if (it != uniqueItems.end()) classes[item] = *it;
+                else uniqueItems.push_back(item);
+            }
+        });
+
+        return classes;
+    }
+
+    bool MeshDeduplicator::findRigidTransform(const std::vector<float3>& positionsA, const std::vector<float3>& positionsB, float tolerance, float4x4& transform)
+    {
+        FALCOR_CHECK(positionsA.size() == positionsB.size(), "Point sets must have the same size.");
+        if (positionsA.empty()) return false;
+
+        // Compute the centroids in double precision to avoid cancellation for meshes far from the origin.
+        const double n = (double)positionsA.size();
+        double ca[3] = {}, cb[3] = {};
+        for (size_t i = 0; i < positionsA.size(); i++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                ca[k] += positionsA[i][k];
+                cb[k] += positionsB[i][k];
+            }
+        }
+        for (int k = 0; k < 3; k++)
+        {
+            ca[k] /= n;
+            cb[k] /= n;
+        }
+
+        // Cross-covariance matrix S[j][k] = sum of a_j * b_k over the centered points.
+        double S[3][3] = {};
+        for (size_t i = 0; i < positionsA.size(); i++)
+        {
+            double a[3], b[3];
+            for (int k = 0; k < 3; k++)
+            {
+                a[k] = positionsA[i][k] - ca[k];
+                b[k] = positionsB[i][k] - cb[k];
+            }
+            for (int j = 0; j < 3; j++)
+                for (int k = 0; k < 3; k++)
+                    S[j][k] += a[j] * b[k];
+        }
+
+        // The optimal rotation is the unit quaternion given by the eigenvector of the largest eigenvalue of N.
+        double N[4][4] =
+        {
+            { S[0][0] + S[1][1] + S[2][2], S[1][2] - S[2][1], S[2][0] - S[0][2], S[0][1] - S[1][0] },
+            { S[1][2] - S[2][1], S[0][0] - S[1][1] - S[2][2], S[0][1] + S[1][0], S[2][0] + S[0][2] },
+            { S[2][0] - S[0][2], S[0][1] + S[1][0], -S[0][0] + S[1][1] - S[2][2], S[1][2] + S[2][1] },
+            { S[0][1] - S[1][0], S[2][0] + S[0][2], S[1][2] + S[2][1], -S[0][0] - S[1][1] + S[2][2] },
+        };
+        double q[4];
+        computeMaxEigenvector(N, q);
+
+        const double len = std::sqrt(q[0] * q[0] + q[1] * q[1] + q[2] * q[2] + q[3] * q[3]);
+        const double w = q[0] / len, x = q[1] / len, y = q[2] / len, z = q[3] / len;
+        const double R[3][3] =
+        {
+            { 1.0 - 2.0 * (y * y + z * z), 2.0 * (x * y - w * z), 2.0 * (x * z + w * y) },
+            { 2.0 * (x * y + w * z), 1.0 - 2.0 * (x * x + z * z), 2.0 * (y * z - w * x) },
+            { 2.0 * (x * z - w * y), 2.0 * (y * z + w * x), 1.0 - 2.0 * (x * x + y * y) },
+        };
+
+        // Verify that every point maps onto its counterpart.
+        const double toleranceSq = (double)tolerance * tolerance;
+        for (size_t i = 0; i < positionsA.size(); i++)
+        {
+            double distSq = 0.0;
+            for (int j = 0; j < 3; j++)
+            {
+                double p = cb[j];
+                for (int k = 0; k < 3; k++) p += R[j][k] * (positionsA[i][k] - ca[k]);
+                double d = p - positionsB[i][j];
+                distSq += d * d;
+            }
+            if (!(distSq <= toleranceSq)) return false;
+        }
+
+        transform = float4x4::identity();
+        for (int j = 0; j < 3; j++)
+        {
+            double t = cb[j];
+            for (int k = 0; k < 3; k++)
+            {
+                transform[j][k] = (float)R[j][k];
+                t -= R[j][k] * ca[k];
+            }
+            transform[j][3] = (float)t;
+        }
+        return true;
+    }
+
+    uint64_t MeshDeduplicator::computeRigidInvariantHash(const std::vector<float3>& positions)
+    {
+        // Quantization steps of the features. The invariants are quantized logarithmically and the distance ratios linearly.
+        // Both are far coarser than float rounding of transformed positions, which is around 1e-7 relative to the size.
+        const double kLogSteps = 256.0;     // Steps per doubling of an invariant.
+        const double kRatioSteps = 256.0;   // Steps per unit of a distance ratio.
+        const double kDegenerateEpsilon = 1e-9; // Invariants below this fraction of the trace power are treated as zero.
+
+        FNVHash64 hash;
+        if (positions.empty()) return hash.get();
+
+        const double n = (double)positions.size();
+        double c[3] = {};
+        for (const auto& p : positions)
+        {
+            for (int k = 0; k < 3; k++) c[k] += p[k];
+        }
+        for (int k = 0; k < 3; k++) c[k] /= n;
+
+        // Covariance matrix C and the covariance W weighted by the squared distance to the centroid, which depends on the fourth moments.
+        double C[3][3] = {};
+        double W[3][3] = {};
+        double meanDist = 0.0, maxDist = 0.0;
+        for (const auto& p : positions)
+        {
+            double d[3] = { p[0] - c[0], p[1] - c[1], p[2] - c[2] };
+            double dist2 = d[0] * d[0] + d[1] * d[1] + d[2] * d[2];
+            for (int j = 0; j < 3; j++)
+            {
+                for (int k = 0; k < 3; k++)
+                {
+                    C[j][k] += d[j] * d[k];
+                    W[j][k] += dist2 * d[j] * d[k];
+                }
+            }
+            double dist = std::sqrt(dist2);
+            meanDist += dist;
+            maxDist = std::max(maxDist, dist);
+        }
+        for (int j = 0; j < 3; j++)
+        {
+            for (int k = 0; k < 3; k++)
+            {
+                C[j][k] /= n;
+                W[j][k] /= n;
+            }
+        }
+        meanDist /= n;
+
+        // All points coincide.
+        const double trace = C[0][0] + C[1][1] + C[2][2];
+        if (!(trace > 0.0)) return hash.get();
+
+        // Quantize the principal invariants of a symmetric matrix: the sum of the eigenvalues, of their pairwise products and their product.
+        // Each is quantized on its own log scale, so that the smallest eigenvalue (e.g. the height variation of a terrain tile)
+        // contributes to the last two even when it is tiny compared to the extent of the point set.
+        auto quantizeInvariants = [&](const double M[3][3], int64_t* pFeatures)
+        {
+            const double J1 = M[0][0] + M[1][1] + M[2][2];
+            const double J2 =
+                M[0][0] * M[1][1] - M[0][1] * M[1][0] +
+                M[0][0] * M[2][2] - M[0][2] * M[2][0] +
+                M[1][1] * M[2][2] - M[1][2] * M[2][1];
+            const double J3 =
+                M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1]) -
+                M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0]) +
+                M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0]);
+
+            // Collinear and planar point sets have a zero J2 or J3 up to rounding.
+            auto quantizeLog = [&](double value, double scale)
+            {
+                if (!(value > kDegenerateEpsilon * scale)) return std::numeric_limits<int64_t>::min();
+                return (int64_t)std::floor(std::log2(value) * kLogSteps);
+            };
+            pFeatures[0] = quantizeLog(J1, 0.0);
+            pFeatures[1] = quantizeLog(J2, J1 * J1);
+            pFeatures[2] = quantizeLog(J3, J1 * J1 * J1);
+        };
+
+        const double size = std::sqrt(trace);
+        int64_t features[8];
+        quantizeInvariants(C, features);
+        quantizeInvariants(W, features + 3);
+        features[6] = (int64_t)std::floor(meanDist / size * kRatioSteps);
+        features[7] = (int64_t)std::floor(maxDist / size * kRatioSteps);
+        hash.insert(features, sizeof(features));
+        return hash.get();
+    }
+}
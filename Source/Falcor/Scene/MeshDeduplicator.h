@@ -0,0 +1,81 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Matrix.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace Falcor
+{
+    /** Utilities for finding duplicate meshes so that they can be merged into instances of a single mesh.
+
+        Candidates are first bucketed by a content hash and then verified by an exact comparison,
+        so hash collisions never cause meshes to be merged. Meshes can also be matched up to a rigid
+        transform, in which case the vertices of the two meshes are expected to correspond by index.
+
+        These are pure CPU functions, which allows them to be tested without a GPU device.
+    */
+    class FALCOR_API MeshDeduplicator
+    {
+    public:
+        /** Group items into classes of duplicates.
+            Items with equal hashes are compared against the first item of each class found so far.
+            Buckets are processed in parallel, so the comparison function must be thread-safe for distinct items.
+            \param[in] hashes Hash per item.
+            \param[in] isDuplicate Function returning true if item b (second argument) is a duplicate of item a (first argument), where a < b.
+            \return For each item, the index of the first item of its class. Items that are not duplicates map to themselves.
+        */
+        static std::vector<uint32_t> findDuplicates(const std::vector<uint64_t>& hashes, const std::function<bool(uint32_t, uint32_t)>& isDuplicate);
+
+        /** Find the rigid transform that maps one set of points onto another.
+            The optimal rotation in the least squares sense is found with Horn's quaternion method (Horn 1987),
+            and the result is accepted only if every transformed point lies within the tolerance of its counterpart.
+            Reflections are never returned, so mirrored point sets don't match.
+            \param[in] positionsA Points to transform.
+            \param[in] positionsB Target points. Must have the same count as positionsA, with points corresponding by index.
+            \param[in] tolerance Maximum distance between a transformed point and its counterpart.
+            \param[out] transform Rigid transform such that transformPoint(transform, positionsA[i]) is close to positionsB[i]. Only valid if the function returns true.
+            \return True if a transform within the tolerance was found.
+        */
+        static bool findRigidTransform(const std::vector<float3>& positionsA, const std::vector<float3>& positionsB, float tolerance, float4x4& transform);
+
+        /** Compute a hash of rotation and translation invariant features of a point set.
+            The features are the principal invariants (the sum of the eigenvalues, of their pairwise products and their product)
+            of the covariance matrix and of the covariance weighted by the squared distance to the centroid, quantized on a log
+            scale, and the mean and maximum distances to the centroid relative to the size of the point set.
+            Point sets that differ by a rigid transform have equal hashes, unless float rounding moves a feature across
+            a quantization boundary, in which case the duplicate is missed. Mirrored point sets also have equal hashes.
+            \param[in] positions Points.
+            \return Hash of the quantized features.
+        */
+        static uint64_t computeRigidInvariantHash(const std::vector<float3>& positions);
+    };
+}
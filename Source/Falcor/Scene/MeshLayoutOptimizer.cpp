@@ -0,0 +1,230 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshLayoutOptimizer.h"
+#include "Core/Error.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        uint32_t expandBits10(uint32_t v)
+        {
+            // Spread the lower 10 bits of v such that there are two zero bits between each bit.
+            v &= 0x3ff;
+            v = (v | (v << 16)) & 0x030000ff;
+            v = (v | (v << 8)) & 0x0300f00f;
+            v = (v | (v << 4)) & 0x030c30c3;
+            v = (v | (v << 2)) & 0x09249249;
+            return v;
+        }
+    }
+
+    uint64_t MeshLayoutOptimizer::countCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        FALCOR_ASSERT(indices.size() % 3 == 0);
+        FALCOR_CHECK(cacheSize > 0, "'cacheSize' must be positive.");
+
+        // Simulate a FIFO cache. A vertex is in the cache if it was inserted less than cacheSize insertions ago.
+        std::vector<uint64_t> insertTime(vertexCount, 0);
+        uint64_t time = cacheSize + 1;
+        uint64_t misses = 0;
+        for (uint32_t index : indices)
+        {
+            FALCOR_ASSERT(index < vertexCount);
+            if (time - insertTime[index] > cacheSize)
+            {
+                insertTime[index] = time++;
+                misses++;
+            }
+        }
+        return misses;
+    }
+
+    float MeshLayoutOptimizer::computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        size_t triangleCount = indices.size() / 3;
+        if (triangleCount == 0) return 0.f;
+        return (float)((double)countCacheMisses(indices, vertexCount, cacheSize) / triangleCount);
+    }
+
+    std::vector<uint32_t> MeshLayoutOptimizer::optimizeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize)
+    {
+        // Implementation of Tipsify from Sander et al. 2007, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw".
+        // Triangles are emitted by fanning around a vertex. The next fanning vertex is picked among the vertices of the emitted
+        // triangles, preferring the oldest vertex that will still be in the cache after emitting all its remaining triangles.
+
+        FALCOR_ASSERT(indices.size() % 3 == 0);
+        FALCOR_CHECK(cacheSize > 0, "'cacheSize' must be positive.");
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+        if (triangleCount == 0 || vertexCount == 0) return indices;
+
+        // Build vertex-triangle adjacency. The live triangle count is the number of unemitted triangles per vertex.
+        std::vector<uint32_t> liveTriangles(vertexCount, 0);
+        for (uint32_t index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+            liveTriangles[index]++;
+        }
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] = adjacencyOffsets[v] + liveTriangles[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < (uint32_t)indices.size(); i++) adjacency[fill[indices[i]]++] = i / 3;
+
+        std::vector<uint64_t> cacheTime(vertexCount, 0);
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> deadEndStack;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> result;
+        result.reserve(indices.size());
+
+        uint64_t time = cacheSize + 1;
+        uint32_t cursor = 0;
+
+        // Returns a vertex with live triangles from the dead-end stack, or the next one in input order. Returns -1 when done.
+        auto skipDeadEnd = [&]() -> int64_t
+        {
+            while (!deadEndStack.empty())
+            {
+                uint32_t v = deadEndStack.back();
+                deadEndStack.pop_back();
+                if (liveTriangles[v] > 0) return v;
+            }
+            for (; cursor < vertexCount; cursor++)
+            {
+                if (liveTriangles[cursor] > 0) return cursor;
+            }
+            return -1;
+        };
+
+        int64_t fanningVertex = skipDeadEnd();
+        while (fanningVertex >= 0)
+        {
+            candidates.clear();
+
+            // Emit all remaining triangles around the fanning vertex.
+            for (uint32_t i = adjacencyOffsets[fanningVertex]; i < adjacencyOffsets[fanningVertex + 1]; i++)
+            {
+                uint32_t triangle = adjacency[i];
+                if (emitted[triangle]) continue;
+                emitted[triangle] = true;
+
+                for (uint32_t j = 0; j < 3; j++)
+                {
+                    uint32_t v = indices[triangle * 3 + j];
+                    result.push_back(v);
+                    deadEndStack.push_back(v);
+                    candidates.push_back(v);
+                    liveTriangles[v]--;
+                    if (time - cacheTime[v] > cacheSize) cacheTime[v] = time++;
+                }
+            }
+
+            // Pick the next fanning vertex among the candidates.
+            int64_t nextVertex = -1;
+            int64_t bestPriority = -1;
+            for (uint32_t v : candidates)
+            {
+                if (liveTriangles[v] == 0) continue;
+
+                // Prefer the oldest vertex that stays in the cache when fanning around it.
+                int64_t priority = 0;
+                if (time - cacheTime[v] + 2 * liveTriangles[v] <= cacheSize) priority = (int64_t)(time - cacheTime[v]);
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    nextVertex = v;
+                }
+            }
+
+            fanningVertex = nextVertex >= 0 ? nextVertex : skipDeadEnd();
+        }
+
+        FALCOR_ASSERT(result.size() == indices.size());
+        return result;
+    }
+
+    std::vector<uint32_t> MeshLayoutOptimizer::computeVertexFetchRemap(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+    {
+        constexpr uint32_t kUnassigned = uint32_t(-1);
+        std::vector<uint32_t> remap(vertexCount, kUnassigned);
+
+        uint32_t nextIndex = 0;
+        for (uint32_t index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+            if (remap[index] == kUnassigned) remap[index] = nextIndex++;
+        }
+
+        // Place unreferenced vertices last.
+        for (uint32_t& newIndex : remap)
+        {
+            if (newIndex == kUnassigned) newIndex = nextIndex++;
+        }
+
+        FALCOR_ASSERT(nextIndex == vertexCount);
+        return remap;
+    }
+
+    uint32_t MeshLayoutOptimizer::computeMortonCode(float3 p)
+    {
+        auto quantize = [](float x) { return (uint32_t)(std::clamp(x, 0.f, 1.f) * 1023.f + 0.5f); };
+        return (expandBits10(quantize(p.x)) << 2) | (expandBits10(quantize(p.y)) << 1) | expandBits10(quantize(p.z));
+    }
+
+    std::vector<uint32_t> MeshLayoutOptimizer::computeMortonOrder(const std::vector<float3>& points)
+    {
+        std::vector<uint32_t> order(points.size());
+        std::iota(order.begin(), order.end(), 0);
+        if (points.empty()) return order;
+
+        // Normalize the points to the unit cube, using the same scale on all axes to preserve the proportions.
+        float3 minPoint = points[0];
+        float3 maxPoint = points[0];
+        for (const float3& p : points)
+        {
+            minPoint = min(minPoint, p);
+            maxPoint = max(maxPoint, p);
+        }
+        float3 extent = maxPoint - minPoint;
+        float maxExtent = std::max(std::max(extent.x, extent.y), extent.z);
+        float scale = maxExtent > 0.f ? 1.f / maxExtent : 0.f;
+
+        std::vector<uint32_t> codes(points.size());
+        parallel::forEach(points.size(), [&](size_t i) { codes[i] = computeMortonCode((points[i] - minPoint) * scale); });
+
+        // The radix sort is stable, so points with identical codes keep their relative order.
+        parallel::radixSortKeyValue(codes.data(), order.data(), order.size(), 30);
+        return order;
+    }
+}
@@ -0,0 +1,112 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Reorders mesh data for memory locality.
+
+        Triangles are reordered for post-transform vertex cache locality using the Tipsify
+        algorithm [Sander et al. 2007], and vertices are reordered in order of first use
+        by the triangles for vertex fetch locality. Meshes are ordered along a Morton curve.
+
+        The quality of the triangle order is measured by the average cache miss ratio (ACMR),
+        i.e. the number of vertex cache misses per triangle for a FIFO cache. It ranges from
+        0.5 for an ideal order of a large regular mesh to 3.0 when no vertex is ever reused.
+
+        These are pure CPU functions, which allows them to be tested without a GPU device.
+    */
+    class FALCOR_API MeshLayoutOptimizer
+    {
+    public:
+        static constexpr uint32_t kDefaultCacheSize = 32;
+
+        /** Compute the number of vertex cache misses for an indexed triangle list.
+            \param[in] indices Triangle list indices. The count must be a multiple of 3.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+            \param[in] cacheSize Number of entries in the simulated FIFO cache.
+            \return Number of cache misses.
+        */
+        static uint64_t countCacheMisses(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultCacheSize);
+
+        /** Compute the average cache miss ratio (ACMR) for an indexed triangle list.
+            \param[in] indices Triangle list indices. The count must be a multiple of 3.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+            \param[in] cacheSize Number of entries in the simulated FIFO cache.
+            \return Cache misses per triangle, or zero for an empty list.
+        */
+        static float computeACMR(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultCacheSize);
+
+        /** Reorder triangles for vertex cache locality.
+            The vertex order within each triangle is preserved, so the winding is unchanged.
+            \param[in] indices Triangle list indices. The count must be a multiple of 3.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+            \param[in] cacheSize Number of entries in the targeted vertex cache.
+            \return Reordered triangle list indices.
+        */
+        static std::vector<uint32_t> optimizeVertexCache(const std::vector<uint32_t>& indices, uint32_t vertexCount, uint32_t cacheSize = kDefaultCacheSize);
+
+        /** Compute a vertex remapping for vertex fetch locality.
+            Vertices are numbered in the order they are first referenced by the triangles.
+            Unreferenced vertices are placed last in their original order.
+            \param[in] indices Triangle list indices.
+            \param[in] vertexCount Number of vertices referenced by the indices.
+            \return Table mapping old to new vertex indices. This is a permutation of [0, vertexCount).
+        */
+        static std::vector<uint32_t> computeVertexFetchRemap(const std::vector<uint32_t>& indices, uint32_t vertexCount);
+
+        /** Apply a vertex remapping to vertex data.
+            \param[in,out] vertices Vertex data, reordered such that vertex i moves to remap[i].
+            \param[in] remap Table mapping old to new vertex indices.
+        */
+        template<typename T>
+        static void remapVertices(std::vector<T>& vertices, const std::vector<uint32_t>& remap)
+        {
+            std::vector<T> remapped(vertices.size());
+            for (size_t i = 0; i < vertices.size(); i++) remapped[remap[i]] = std::move(vertices[i]);
+            vertices = std::move(remapped);
+        }
+
+        /** Compute a 30-bit Morton code by interleaving 10 bits of each coordinate.
+            \param[in] p Position in the unit cube. Coordinates outside [0,1] are clamped.
+            \return Morton code.
+        */
+        static uint32_t computeMortonCode(float3 p);
+
+        /** Compute an order of points along a Morton curve through their bounding box.
+            Points with identical Morton codes keep their relative order.
+            \param[in] points List of points.
+            \return List of point indices in Morton order.
+        */
+        static std::vector<uint32_t> computeMortonOrder(const std::vector<float3>& points);
+    };
+}
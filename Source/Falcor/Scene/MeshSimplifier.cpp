@@ -0,0 +1,376 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshSimplifier.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    namespace
+    {
+        /** Quadric error metric, i.e., a weighted sum of squared distances to a set of planes.
+        */
+        struct Quadric
+        {
+            double a00 = 0.0, a01 = 0.0, a02 = 0.0, a11 = 0.0, a12 = 0.0, a22 = 0.0;
+            double b0 = 0.0, b1 = 0.0, b2 = 0.0;
+            double c = 0.0;
+            double weight = 0.0;
+
+            /** Add the plane n.p + d = 0 with a unit normal n.
+            */
+            void addPlane(const float3& n, float d, double w)
+            {
+                a00 += w * n.x * n.x; a01 += w * n.x * n.y; a02 += w * n.x * n.z;
+                a11 += w * n.y * n.y; a12 += w * n.y * n.z; a22 += w * n.z * n.z;
+                b0 += w * n.x * d; b1 += w * n.y * d; b2 += w * n.z * d;
+                c += w * d * d;
+                weight += w;
+            }
+
+            Quadric& operator+=(const Quadric& q)
+            {
+                a00 += q.a00; a01 += q.a01; a02 += q.a02; a11 += q.a11; a12 += q.a12; a22 += q.a22;
+                b0 += q.b0; b1 += q.b1; b2 += q.b2;
+                c += q.c;
+                weight += q.weight;
+                return *this;
+            }
+
+            /** Evaluate the weighted mean squared distance to the planes.
+            */
+            double eval(const float3& p) const
+            {
+                if (weight <= 0.0) return 0.0;
+                double x = p.x, y = p.y, z = p.z;
+                double e = a00 * x * x + a11 * y * y + a22 * z * z + 2.0 * (a01 * x * y + a02 * x * z + a12 * y * z) +
+                           2.0 * (b0 * x + b1 * y + b2 * z) + c;
+                return std::max(e, 0.0) / weight;
+            }
+        };
+
+        struct Collapse
+        {
+            double cost;
+            uint32_t from;
+            uint32_t to;
+
+            bool operator<(const Collapse& other) const
+            {
+                if (cost != other.cost) return cost < other.cost;
+                if (from != other.from) return from < other.from;
+                return to < other.to;
+            }
+            bool operator==(const Collapse& other) const { return cost == other.cost && from == other.from && to == other.to; }
+        };
+
+        uint32_t countDistinctVertices(const std::vector<uint32_t>& indices, uint32_t vertexCount)
+        {
+            std::vector<bool> used(vertexCount, false);
+            uint32_t count = 0;
+            for (uint32_t index : indices)
+            {
+                if (!used[index]) count++;
+                used[index] = true;
+            }
+            return count;
+        }
+    }
+
+    std::vector<uint32_t> MeshSimplifier::simplify(
+        const std::vector<uint32_t>& indices,
+        const std::vector<float3>& positions,
+        uint32_t targetIndexCount,
+        float maxError,
+        float* pError
+    )
+    {
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+        FALCOR_CHECK(maxError >= 0.f, "'maxError' must be non-negative.");
+
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        std::vector<bool> referenced(vertexCount, false);
+        for (uint32_t index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+            referenced[index] = true;
+        }
+
+        if (pError) *pError = 0.f;
+        std::vector<uint32_t> result = indices;
+        if (result.size() <= targetIndexCount) return result;
+
+        // Normalize the positions to the bounding box diagonal so that the errors are relative.
+        float3 minPos(std::numeric_limits<float>::max());
+        float3 maxPos(-std::numeric_limits<float>::max());
+        for (uint32_t v = 0; v < vertexCount; v++)
+        {
+            if (!referenced[v]) continue;
+            minPos = min(minPos, positions[v]);
+            maxPos = max(maxPos, positions[v]);
+        }
+        const float extent = length(maxPos - minPos);
+        if (!(extent > 0.f)) return result;
+
+        std::vector<float3> pos(vertexCount);
+        for (uint32_t v = 0; v < vertexCount; v++) pos[v] = referenced[v] ? (positions[v] - minPos) / extent : float3(0.f);
+
+        // Lock vertices on attribute seams, i.e., vertices sharing their position with other vertices.
+        std::vector<bool> locked(vertexCount, false);
+        {
+            std::vector<uint32_t> order;
+            order.reserve(vertexCount);
+            for (uint32_t v = 0; v < vertexCount; v++) if (referenced[v]) order.push_back(v);
+            auto less = [&](uint32_t a, uint32_t b)
+            {
+                const float3& p = positions[a];
+                const float3& q = positions[b];
+                return p.x != q.x ? p.x < q.x : (p.y != q.y ? p.y < q.y : p.z < q.z);
+            };
+            std::sort(order.begin(), order.end(), less);
+            for (size_t i = 1; i < order.size(); i++)
+            {
+                if (!less(order[i - 1], order[i])) locked[order[i - 1]] = locked[order[i]] = true;
+            }
+        }
+
+        // Lock vertices on open borders and non-manifold edges, i.e., directed edges without exactly one opposite edge.
+        {
+            std::vector<std::pair<uint32_t, uint32_t>> edges;
+            edges.reserve(result.size());
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                for (size_t e = 0; e < 3; e++) edges.emplace_back(result[i + e], result[i + (e + 1) % 3]);
+            }
+            std::sort(edges.begin(), edges.end());
+            for (const auto& [a, b] : edges)
+            {
+                auto [first, last] = std::equal_range(edges.begin(), edges.end(), std::make_pair(b, a));
+                auto [firstSame, lastSame] = std::equal_range(edges.begin(), edges.end(), std::make_pair(a, b));
+                if (last - first != 1 || lastSame - firstSame != 1) locked[a] = locked[b] = true;
+            }
+        }
+
+        // Compute the vertex quadrics from the planes of the adjacent triangles weighted by area.
+        std::vector<Quadric> quadrics(vertexCount);
+        for (size_t i = 0; i < result.size(); i += 3)
+        {
+            const float3& p0 = pos[result[i]];
+            float3 n = cross(pos[result[i + 1]] - p0, pos[result[i + 2]] - p0);
+            float area = length(n);
+            if (!(area > 0.f)) continue;
+            n /= area;
+            for (size_t j = 0; j < 3; j++) quadrics[result[i + j]].addPlane(n, -dot(n, p0), 0.5 * area);
+        }
+
+        const double costLimit = double(maxError) * double(maxError);
+        double maxCost = 0.0;
+
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1);
+        std::vector<uint32_t> adjacency;
+        std::vector<uint32_t> remap(vertexCount);
+        std::vector<bool> touched(vertexCount);
+        std::vector<uint32_t> mark(vertexCount, 0);
+        uint32_t stamp = 0;
+        std::vector<Collapse> collapses;
+
+        // Each pass collapses the cheapest edges whose neighborhoods don't overlap, then rebuilds the index list.
+        while (result.size() > targetIndexCount)
+        {
+            const uint32_t triangleCount = (uint32_t)(result.size() / 3);
+
+            // Build vertex-triangle adjacency.
+            std::fill(adjacencyOffsets.begin(), adjacencyOffsets.end(), 0);
+            for (uint32_t index : result) adjacencyOffsets[index + 1]++;
+            for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+            adjacency.resize(result.size());
+            {
+                std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+                for (uint32_t i = 0; i < (uint32_t)result.size(); i++) adjacency[fill[result[i]]++] = i / 3;
+            }
+
+            // Gather the collapses of unlocked vertices onto their neighbors that are within the error limit.
+            collapses.clear();
+            for (uint32_t t = 0; t < triangleCount; t++)
+            {
+                for (uint32_t e = 0; e < 3; e++)
+                {
+                    uint32_t a = result[t * 3 + e];
+                    uint32_t b = result[t * 3 + (e + 1) % 3];
+                    for (uint32_t k = 0; k < 2; k++, std::swap(a, b))
+                    {
+                        if (locked[a]) continue;
+                        Quadric q = quadrics[a];
+                        q += quadrics[b];
+                        double cost = q.eval(pos[b]);
+                        if (cost <= costLimit) collapses.push_back({cost, a, b});
+                    }
+                }
+            }
+            std::sort(collapses.begin(), collapses.end());
+            collapses.erase(std::unique(collapses.begin(), collapses.end()), collapses.end());
+
+            // Checks if collapsing a onto b keeps the mesh manifold and doesn't flip any triangles.
+            auto canCollapse = [&](uint32_t a, uint32_t b, uint32_t& sharedCount)
+            {
+                stamp += 2;
+                sharedCount = 0;
+                for (uint32_t i = adjacencyOffsets[a]; i < adjacencyOffsets[a + 1]; i++)
+                {
+                    const uint32_t* tri = &result[adjacency[i] * 3];
+                    if (tri[0] == b || tri[1] == b || tri[2] == b)
+                    {
+                        sharedCount++;
+                        continue;
+                    }
+                    for (uint32_t j = 0; j < 3; j++) mark[tri[j]] = stamp;
+
+                    // The triangle normal must not flip when a moves to b.
+                    float3 p[3] = {pos[tri[0]], pos[tri[1]], pos[tri[2]]};
+                    float3 oldNormal = cross(p[1] - p[0], p[2] - p[0]);
+                    for (uint32_t j = 0; j < 3; j++) if (tri[j] == a) p[j] = pos[b];
+                    float3 newNormal = cross(p[1] - p[0], p[2] - p[0]);
+                    if (dot(oldNormal, oldNormal) > 0.f && !(dot(oldNormal, newNormal) > 0.f)) return false;
+                }
+
+                // Link condition: the common neighbors of a and b must be the opposite vertices of the shared triangles.
+                for (uint32_t i = adjacencyOffsets[a]; i < adjacencyOffsets[a + 1]; i++)
+                {
+                    const uint32_t* tri = &result[adjacency[i] * 3];
+                    if (tri[0] == b || tri[1] == b || tri[2] == b)
+                    {
+                        for (uint32_t j = 0; j < 3; j++) if (tri[j] != a && tri[j] != b) mark[tri[j]] = stamp;
+                    }
+                }
+                uint32_t commonCount = 0;
+                for (uint32_t i = adjacencyOffsets[b]; i < adjacencyOffsets[b + 1]; i++)
+                {
+                    const uint32_t* tri = &result[adjacency[i] * 3];
+                    for (uint32_t j = 0; j < 3; j++)
+                    {
+                        uint32_t c = tri[j];
+                        if (c != a && c != b && mark[c] == stamp)
+                        {
+                            mark[c] = stamp + 1;
+                            commonCount++;
+                        }
+                    }
+                }
+                return commonCount == sharedCount;
+            };
+
+            std::fill(touched.begin(), touched.end(), false);
+            for (uint32_t v = 0; v < vertexCount; v++) remap[v] = v;
+
+            const size_t removeTriangleCount = (result.size() - targetIndexCount + 2) / 3;
+            size_t removedTriangleCount = 0;
+            for (const Collapse& collapse : collapses)
+            {
+                if (removedTriangleCount >= removeTriangleCount) break;
+                const uint32_t a = collapse.from;
+                const uint32_t b = collapse.to;
+                if (touched[a] || touched[b]) continue;
+
+                uint32_t sharedCount = 0;
+                if (!canCollapse(a, b, sharedCount)) continue;
+
+                remap[a] = b;
+                quadrics[b] += quadrics[a];
+                for (uint32_t i = adjacencyOffsets[a]; i < adjacencyOffsets[a + 1]; i++)
+                {
+                    for (uint32_t j = 0; j < 3; j++) touched[result[adjacency[i] * 3 + j]] = true;
+                }
+                removedTriangleCount += sharedCount;
+                maxCost = std::max(maxCost, collapse.cost);
+            }
+            if (removedTriangleCount == 0) break;
+
+            // Rebuild the index list without the collapsed triangles.
+            size_t writeIndex = 0;
+            for (size_t i = 0; i < result.size(); i += 3)
+            {
+                uint32_t i0 = remap[result[i]], i1 = remap[result[i + 1]], i2 = remap[result[i + 2]];
+                if (i0 == i1 || i0 == i2 || i1 == i2) continue;
+                result[writeIndex++] = i0;
+                result[writeIndex++] = i1;
+                result[writeIndex++] = i2;
+            }
+            result.resize(writeIndex);
+        }
+
+        if (pError) *pError = (float)std::sqrt(maxCost);
+        return result;
+    }
+
+    uint32_t MeshSimplifier::buildLods(const std::vector<uint32_t>& indices, const std::vector<float3>& positions, const Options& options, Lods& lods)
+    {
+        FALCOR_CHECK(options.maxLodCount <= kMaxLodCount, "'maxLodCount' must be at most {}.", kMaxLodCount);
+        FALCOR_CHECK(options.reductionFactor > 0.f && options.reductionFactor < 1.f, "'reductionFactor' must be in the range (0, 1).");
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+
+        std::vector<uint32_t> current = indices;
+        float error = 0.f;
+        uint32_t lodCount = 0;
+
+        while (lodCount < options.maxLodCount && error < options.maxError)
+        {
+            const uint32_t triangleCount = (uint32_t)(current.size() / 3);
+            const uint32_t targetTriangleCount = (uint32_t)(triangleCount * options.reductionFactor);
+            if (targetTriangleCount < options.minTriangleCount) break;
+
+            float stepError = 0.f;
+            std::vector<uint32_t> lodIndices = simplify(current, positions, targetTriangleCount * 3, options.maxError - error, &stepError);
+
+            // Stop if less than half of the targeted reduction was reached, e.g., because most vertices are locked.
+            if (lodIndices.empty() || lodIndices.size() / 3 > (triangleCount + targetTriangleCount) / 2) break;
+
+            error += stepError;
+            MeshLodDesc desc = {};
+            desc.indexOffset = (uint32_t)lods.indices.size();
+            desc.indexCount = (uint32_t)lodIndices.size();
+            desc.vertexCount = countDistinctVertices(lodIndices, (uint32_t)positions.size());
+            desc.error = error;
+            lods.lods.push_back(desc);
+            lods.indices.insert(lods.indices.end(), lodIndices.begin(), lodIndices.end());
+
+            current = std::move(lodIndices);
+            lodCount++;
+        }
+
+        return lodCount;
+    }
+
+    uint32_t MeshSimplifier::selectLod(const MeshLodDesc* pLods, uint32_t lodCount, float projectedSize, float maxPixelError)
+    {
+        // The errors increase monotonically with the LOD index.
+        uint32_t lod = 0;
+        while (lod < lodCount && pLods[lod].error * projectedSize <= maxPixelError) lod++;
+        return lod;
+    }
+}
@@ -0,0 +1,105 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Generates levels of detail (LODs) for triangle meshes.
+
+        Meshes are simplified by collapsing edges in order of increasing quadric error (Garland and Heckbert 1997).
+        Each collapse moves a vertex onto one of its neighbors, so the LODs are index lists that reference the
+        vertices of the full resolution mesh and need no additional vertex data.
+
+        Vertices on open borders, which include material boundaries between meshes, and on attribute seams,
+        where several vertices share a position but differ in normal or texture coordinates, are never removed.
+        This keeps the LODs of adjacent meshes crack-free and preserves the texture mapping.
+
+        These are pure CPU functions, which allows them to be tested without a GPU device.
+    */
+    class FALCOR_API MeshSimplifier
+    {
+    public:
+        static constexpr uint32_t kMaxLodCount = 8; ///< Maximum number of LODs per mesh, excluding the full resolution mesh.
+
+        struct Options
+        {
+            uint32_t maxLodCount = 4;       ///< Maximum number of LODs to generate, excluding the full resolution mesh.
+            float reductionFactor = 0.5f;   ///< Target triangle count of each LOD relative to the previous one.
+            uint32_t minTriangleCount = 64; ///< Don't generate LODs with fewer triangles.
+            float maxError = 0.05f;         ///< Maximum error relative to the diagonal of the mesh bounding box.
+        };
+
+        /** LODs of one or more meshes.
+        */
+        struct Lods
+        {
+            std::vector<MeshLodDesc> lods;  ///< LOD descriptors, ordered from fine to coarse per mesh.
+            std::vector<uint32_t> indices;  ///< Mesh-local vertex indices of all LODs.
+        };
+
+        /** Simplify a triangle mesh.
+            \param[in] indices Triangle list indices. The count must be a multiple of 3.
+            \param[in] positions Vertex positions.
+            \param[in] targetIndexCount Target index count. The result may have more indices if the error limit is reached or no more edges can be collapsed.
+            \param[in] maxError Maximum error relative to the diagonal of the bounding box of the vertices.
+            \param[out] pError Optional. Set to the error of the result relative to the diagonal of the bounding box of the vertices.
+            \return Triangle list indices of the simplified mesh.
+        */
+        static std::vector<uint32_t> simplify(
+            const std::vector<uint32_t>& indices,
+            const std::vector<float3>& positions,
+            uint32_t targetIndexCount,
+            float maxError,
+            float* pError = nullptr
+        );
+
+        /** Generate a chain of LODs for a triangle mesh and append them to a list.
+            Each LOD is simplified from the previous one, and its error is bounded by the sum of the errors of the steps.
+            \param[in] indices Triangle list indices. The count must be a multiple of 3.
+            \param[in] positions Vertex positions.
+            \param[in] options Options.
+            \param[in,out] lods LODs to append to. The offsets of the new LODs are relative to the existing data.
+            \return Number of new LODs.
+        */
+        static uint32_t buildLods(const std::vector<uint32_t>& indices, const std::vector<float3>& positions, const Options& options, Lods& lods);
+
+        /** Select the LOD to render based on the projected size of a mesh.
+            \param[in] pLods LODs of the mesh, ordered from fine to coarse.
+            \param[in] lodCount Number of LODs.
+            \param[in] projectedSize Projected size in pixels of the diagonal of the mesh bounding box.
+            \param[in] maxPixelError Maximum acceptable error in pixels.
+            \return Index of the coarsest LOD with acceptable error, where 0 is the full resolution mesh and i > 0 is pLods[i - 1].
+        */
+        static uint32_t selectLod(const MeshLodDesc* pLods, uint32_t lodCount, float projectedSize, float maxPixelError = 1.f);
+    };
+}
@@ -0,0 +1,210 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "MeshletBuilder.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Falcor
+{
+    uint32_t MeshletBuilder::build(const std::vector<uint32_t>& indices, const std::vector<float3>& positions, const Options& options, Meshlets& meshlets)
+    {
+        FALCOR_CHECK(options.maxVertices >= 3 && options.maxVertices <= kMaxVertexLimit, "'maxVertices' must be in the range [3, {}].", kMaxVertexLimit);
+        FALCOR_CHECK(options.maxTriangles >= 1 && options.maxTriangles <= kMaxTriangleLimit, "'maxTriangles' must be in the range [1, {}].", kMaxTriangleLimit);
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count must be a multiple of 3.");
+
+        constexpr uint32_t kInvalidIndex = uint32_t(-1);
+        const uint32_t vertexCount = (uint32_t)positions.size();
+        const uint32_t triangleCount = (uint32_t)(indices.size() / 3);
+
+        // Build vertex-triangle adjacency.
+        std::vector<uint32_t> adjacencyOffsets(vertexCount + 1, 0);
+        for (uint32_t index : indices)
+        {
+            FALCOR_CHECK(index < vertexCount, "Vertex index {} is out of range.", index);
+            adjacencyOffsets[index + 1]++;
+        }
+        for (uint32_t v = 0; v < vertexCount; v++) adjacencyOffsets[v + 1] += adjacencyOffsets[v];
+
+        std::vector<uint32_t> adjacency(indices.size());
+        std::vector<uint32_t> fill(adjacencyOffsets.begin(), adjacencyOffsets.end() - 1);
+        for (uint32_t i = 0; i < (uint32_t)indices.size(); i++) adjacency[fill[indices[i]]++] = i / 3;
+
+        std::vector<bool> emitted(triangleCount, false);
+        std::vector<uint32_t> localIndex(vertexCount, kInvalidIndex);
+        std::vector<uint32_t> meshletVertices;
+        std::vector<uint32_t> meshletTriangles;
+        std::vector<uint32_t> candidates;
+        std::vector<uint32_t> meshletIndices;
+        uint32_t seedTriangle = 0;
+        uint32_t meshletCount = 0;
+
+        // Returns the number of distinct vertices of a triangle that are not yet in the current meshlet.
+        auto countNewVertices = [&](uint32_t triangle)
+        {
+            uint32_t v0 = indices[triangle * 3], v1 = indices[triangle * 3 + 1], v2 = indices[triangle * 3 + 2];
+            uint32_t count = (localIndex[v0] == kInvalidIndex) ? 1 : 0;
+            count += (localIndex[v1] == kInvalidIndex && v1 != v0) ? 1 : 0;
+            count += (localIndex[v2] == kInvalidIndex && v2 != v0 && v2 != v1) ? 1 : 0;
+            return count;
+        };
+
+        auto addTriangle = [&](uint32_t triangle)
+        {
+            emitted[triangle] = true;
+            meshletTriangles.push_back(triangle);
+            for (uint32_t i = 0; i < 3; i++)
+            {
+                uint32_t v = indices[triangle * 3 + i];
+                if (localIndex[v] != kInvalidIndex) continue;
+                localIndex[v] = (uint32_t)meshletVertices.size();
+                meshletVertices.push_back(v);
+
+                // The triangles around a new vertex are candidates for growing the meshlet.
+                for (uint32_t j = adjacencyOffsets[v]; j < adjacencyOffsets[v + 1]; j++)
+                {
+                    if (!emitted[adjacency[j]]) candidates.push_back(adjacency[j]);
+                }
+            }
+        };
+
+        auto flush = [&]()
+        {
+            if (meshletTriangles.empty()) return;
+
+            MeshletDesc desc = {};
+            desc.vertexOffset = (uint32_t)meshlets.vertices.size();
+            desc.triangleOffset = (uint32_t)meshlets.triangles.size();
+            desc.vertexCount = (uint32_t)meshletVertices.size();
+            desc.triangleCount = (uint32_t)meshletTriangles.size();
+
+            meshlets.vertices.insert(meshlets.vertices.end(), meshletVertices.begin(), meshletVertices.end());
+            meshletIndices.clear();
+            for (uint32_t triangle : meshletTriangles)
+            {
+                uint32_t v0 = indices[triangle * 3], v1 = indices[triangle * 3 + 1], v2 = indices[triangle * 3 + 2];
+                meshlets.triangles.push_back(packTriangle(localIndex[v0], localIndex[v1], localIndex[v2]));
+                meshletIndices.insert(meshletIndices.end(), {v0, v1, v2});
+            }
+
+            computeBounds(meshletIndices, positions, options.isFrontFaceCW, desc);
+            meshlets.meshlets.push_back(desc);
+            meshletCount++;
+
+            for (uint32_t v : meshletVertices) localIndex[v] = kInvalidIndex;
+            meshletVertices.clear();
+            meshletTriangles.clear();
+            candidates.clear();
+        };
+
+        while (true)
+        {
+            // Pick the adjacent triangle that adds the fewest new vertices, preferring the input order on ties.
+            candidates.erase(std::remove_if(candidates.begin(), candidates.end(), [&](uint32_t t) { return emitted[t]; }), candidates.end());
+            uint32_t bestTriangle = kInvalidIndex;
+            uint32_t bestNewVertices = 4;
+            for (uint32_t triangle : candidates)
+            {
+                uint32_t newVertices = countNewVertices(triangle);
+                if (newVertices < bestNewVertices || (newVertices == bestNewVertices && triangle < bestTriangle))
+                {
+                    bestTriangle = triangle;
+                    bestNewVertices = newVertices;
+                }
+            }
+
+            // Continue with the next triangle in input order if there are no adjacent triangles.
+            if (bestTriangle == kInvalidIndex)
+            {
+                while (seedTriangle < triangleCount && emitted[seedTriangle]) seedTriangle++;
+                if (seedTriangle == triangleCount) break;
+                bestTriangle = seedTriangle;
+                bestNewVertices = countNewVertices(bestTriangle);
+            }
+
+            // Start a new meshlet if the triangle does not fit.
+            if (meshletVertices.size() + bestNewVertices > options.maxVertices || meshletTriangles.size() == options.maxTriangles)
+            {
+                flush();
+            }
+
+            addTriangle(bestTriangle);
+        }
+
+        flush();
+        return meshletCount;
+    }
+
+    void MeshletBuilder::computeBounds(const std::vector<uint32_t>& indices, const std::vector<float3>& positions, bool isFrontFaceCW, MeshletDesc& desc)
+    {
+        FALCOR_ASSERT(indices.size() % 3 == 0);
+
+        desc.center = float3(0.f);
+        desc.radius = 0.f;
+        desc.coneAxis = float3(0.f, 0.f, 1.f);
+        desc.coneCutoff = 1.f;
+        if (indices.empty()) return;
+
+        // Use the center of the bounding box as the sphere center.
+        float3 minPos = positions[indices[0]];
+        float3 maxPos = minPos;
+        for (uint32_t index : indices)
+        {
+            minPos = min(minPos, positions[index]);
+            maxPos = max(maxPos, positions[index]);
+        }
+        desc.center = (minPos + maxPos) * 0.5f;
+        for (uint32_t index : indices) desc.radius = std::max(desc.radius, length(positions[index] - desc.center));
+
+        // Compute the normal cone from the average of the triangle normals. Degenerate triangles are ignored.
+        std::vector<float3> normals;
+        normals.reserve(indices.size() / 3);
+        float3 normalSum = float3(0.f);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            float3 p0 = positions[indices[i]];
+            float3 n = cross(positions[indices[i + 1]] - p0, positions[indices[i + 2]] - p0);
+            float len = length(n);
+            if (!(len > 0.f)) continue;
+            n = (isFrontFaceCW ? -n : n) / len;
+            normals.push_back(n);
+            normalSum += n;
+        }
+
+        float sumLength = length(normalSum);
+        if (normals.empty() || !(sumLength > 1e-6f)) return;
+
+        float3 axis = normalSum / sumLength;
+        float minDot = 1.f;
+        for (const float3& n : normals) minDot = std::min(minDot, dot(axis, n));
+
+        // The cone can only be used for culling if all normals are within 90 degrees of the axis.
+        desc.coneAxis = axis;
+        desc.coneCutoff = minDot > 0.f ? std::sqrt(std::max(0.f, 1.f - minDot * minDot)) : 1.f;
+    }
+}
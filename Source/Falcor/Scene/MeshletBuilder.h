@@ -0,0 +1,96 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "SceneTypes.slang"
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    /** Partitions triangle meshes into meshlets.
+
+        A meshlet is a cluster of triangles with a bounded number of vertices and triangles,
+        which is the unit of work for cluster culling and mesh shaders. Each meshlet stores
+        a list of mesh-local vertex indices and a list of triangles with 8-bit indices into
+        that list, along with a bounding sphere and a normal cone for culling.
+
+        Meshlets are grown greedily from a seed triangle, preferring adjacent triangles that
+        add the fewest new vertices. This works best on meshes with a cache-optimized triangle order.
+
+        These are pure CPU functions, which allows them to be tested without a GPU device.
+    */
+    class FALCOR_API MeshletBuilder
+    {
+    public:
+        static constexpr uint32_t kMaxVertexLimit = 256;   ///< Limit for the vertex count due to the 8-bit local indices.
+        static constexpr uint32_t kMaxTriangleLimit = 512; ///< Limit for the triangle count.
+
+        struct Options
+        {
+            uint32_t maxVertices = 64;      ///< Maximum number of vertices per meshlet.
+            uint32_t maxTriangles = 124;    ///< Maximum number of triangles per meshlet.
+            bool isFrontFaceCW = false;     ///< True if front-facing triangles have clockwise winding. This flips the normal cones.
+        };
+
+        /** Meshlets of one or more meshes.
+        */
+        struct Meshlets
+        {
+            std::vector<MeshletDesc> meshlets;  ///< Meshlet descriptors.
+            std::vector<uint32_t> vertices;     ///< Mesh-local vertex indices of all meshlets.
+            std::vector<uint32_t> triangles;    ///< Meshlet-local vertex indices of all triangles, packed as three 8-bit values.
+        };
+
+        /** Partition a triangle mesh into meshlets and append them to a list.
+            \param[in] indices Triangle list indices. The count must be a multiple of 3.
+            \param[in] positions Vertex positions.
+            \param[in] options Options.
+            \param[in,out] meshlets Meshlets to append to. The offsets of the new meshlets are relative to the existing data.
+            \return Number of new meshlets.
+        */
+        static uint32_t build(const std::vector<uint32_t>& indices, const std::vector<float3>& positions, const Options& options, Meshlets& meshlets);
+
+        /** Compute the bounding sphere and normal cone of a set of triangles.
+            \param[in] indices Triangle list indices.
+            \param[in] positions Vertex positions.
+            \param[in] isFrontFaceCW True if front-facing triangles have clockwise winding.
+            \param[in,out] desc Meshlet descriptor to write the bounds to.
+        */
+        static void computeBounds(const std::vector<uint32_t>& indices, const std::vector<float3>& positions, bool isFrontFaceCW, MeshletDesc& desc);
+
+        /** Pack three meshlet-local vertex indices into a triangle.
+        */
+        static uint32_t packTriangle(uint32_t i0, uint32_t i1, uint32_t i2) { return i0 | (i1 << 8) | (i2 << 16); }
+
+        /** Unpack the meshlet-local vertex index of a triangle corner.
+        */
+        static uint32_t unpackTriangle(uint32_t triangle, uint32_t corner) { return (triangle >> (corner * 8)) & 0xff; }
+    };
+}
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "SDFGrid.h"
+#include "SDFMeshBaker.h"
 #include "GlobalState.h"
 #include "NormalizedDenseSDFGrid/NDSDFGrid.h"
 #include "SparseVoxelSet/SDFSVS.h"
@@ -38,6 +39,7 @@
 #include "Utils/Math/Common.h"
 #include "Utils/Math/Matrix.h"
 #include "Utils/Scripting/ScriptBindings.h"
+#include "Scene/TriangleMesh.h"
 #include "GlobalState.h"
 #include <nlohmann/json.hpp>
 #include <random>
@@ -151,6 +153,7 @@ namespace Falcor
 
     SDFGrid::SDFGrid(ref<Device> pDevice) : mpDevice(pDevice)
     {
+        FALCOR_CHECK(mpDevice != nullptr, "'pDevice' must be a valid device");
         if (!mpDevice->isShaderModelSupported(ShaderModel::SM6_5))
             FALCOR_THROW("SDFGrid requires Shader Model 6.5 support.");
     }
@@ -297,6 +300,14 @@ namespace Falcor
         setValuesInternal(cornerValues);
     }
 
+    float4x4 SDFGrid::setValuesFromMesh(const TriangleMesh& mesh, uint32_t gridWidth)
+    {
+        auto result = SDFMeshBaker::bake(mesh, gridWidth, SDFMeshBaker::Options());
+        setValues(result.cornerValues, gridWidth);
+        mInitializedWithPrimitives = false;
+        return result.meshToGrid;
+    }
+
     bool SDFGrid::loadValuesFromFile(const std::filesystem::path& path)
     {
         std::ifstream file(path, std::ios::in | std::ios::binary);
@@ -526,6 +537,10 @@ namespace Falcor
             "path"_a, "gridWidth"_a
         ); // PYTHONDEPRECATED
         sdfGrid.def("generateCheeseValues", &SDFGrid::generateCheeseValues, "gridWidth"_a, "seed"_a);
+        sdfGrid.def("setValuesFromMesh",
+            [](SDFGrid& self, const ref<TriangleMesh>& pMesh, uint32_t gridWidth) { return self.setValuesFromMesh(*pMesh, gridWidth); },
+            "mesh"_a, "gridWidth"_a
+        );
         sdfGrid.def_property("name", &SDFGrid::getName, &SDFGrid::setName);
     }
 
@@ -41,6 +41,7 @@
 namespace Falcor
 {
     class RenderContext;
+    class TriangleMesh;
     struct ShaderVar;
 
     /** SDF grid base class, stored by distance values at grid cell/voxel corners.
@@ -123,6 +124,14 @@ namespace Falcor
         */
         void setValues(const std::vector<float>& cornerValues, uint32_t gridWidth);
 
+        /** Set the signed distance values of the SDF grid by baking a triangle mesh on the CPU, see SDFMeshBaker.
+            The mesh is uniformly scaled and translated to fit in the grid.
+            \param[in] mesh The triangle mesh.
+            \param[in] gridWidth The grid width, note that this represents the grid width in voxels, not in values.
+            \return Transform from mesh space to the grid's local space. Its inverse places the grid over the mesh.
+        */
+        float4x4 setValuesFromMesh(const TriangleMesh& mesh, uint32_t gridWidth);
+
         /** Set the signed distance values of the SDF grid from a file.
             \param[in] path The path of a .sdfg file.
             \return true if the values could be set, otherwise false.
@@ -0,0 +1,433 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SDFMeshBaker.h"
+#include "Core/Error.h"
+#include "Scene/TriangleMesh.h"
+#include "Scene/MeshLayoutOptimizer.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include "Utils/Math/AABB.h"
+#include "Utils/Math/MathConstants.slangh"
+#include <fstd/bit.h>
+#include <algorithm>
+#include <numeric>
+
+namespace Falcor
+{
+    namespace
+    {
+        const uint32_t kMaxLeafTriangleCount = 4;
+        const uint32_t kMaxTraversalStackSize = 128;
+
+        // Margin for reusing the sign of a neighboring value, relative to the distance between the values.
+        const float kSignReuseScale = 1.01f;
+
+        struct Triangle
+        {
+            float3 v0, v1, v2;
+        };
+
+        /** BVH node. Internal nodes store their left child at the next index.
+            The winding number data is the dipole of all triangles below the node.
+        */
+        struct BVHNode
+        {
+            AABB bounds;
+            uint32_t rightChild = 0;            ///< Index of the right child for internal nodes.
+            uint32_t triangleOffset = 0;        ///< Index of the first triangle for leaf nodes.
+            uint32_t triangleCount = 0;         ///< Number of triangles for leaf nodes, zero for internal nodes.
+            float3 windingCenter = float3(0.f); ///< Area-weighted centroid of the triangles.
+            float3 windingNormal = float3(0.f); ///< Sum of the area-weighted triangle normals.
+            float windingArea = 0.f;            ///< Total triangle area.
+            float windingRadius = 0.f;          ///< Radius of a sphere around the centroid enclosing the triangles.
+
+            bool isLeaf() const { return triangleCount > 0; }
+        };
+
+        float distanceSquared(const AABB& bounds, const float3& p)
+        {
+            float3 d = max(max(bounds.minPoint - p, p - bounds.maxPoint), float3(0.f));
+            return dot(d, d);
+        }
+
+        /** Squared distance from a point to a triangle.
+            See Ericson, "Real-Time Collision Detection", Section 5.1.5.
+        */
+        float distanceSquared(const Triangle& tri, const float3& p)
+        {
+            const float3 ab = tri.v1 - tri.v0;
+            const float3 ac = tri.v2 - tri.v0;
+            const float3 ap = p - tri.v0;
+            auto distanceTo = [&p](const float3& q) { float3 d = p - q; return dot(d, d); };
+
+            float d1 = dot(ab, ap);
+            float d2 = dot(ac, ap);
+            if (d1 <= 0.f && d2 <= 0.f) return distanceTo(tri.v0);
+
+            const float3 bp = p - tri.v1;
+            float d3 = dot(ab, bp);
+            float d4 = dot(ac, bp);
+            if (d3 >= 0.f && d4 <= d3) return distanceTo(tri.v1);
+
+            float vc = d1 * d4 - d3 * d2;
+            if (vc <= 0.f && d1 >= 0.f && d3 <= 0.f) return distanceTo(tri.v0 + ab * (d1 / (d1 - d3)));
+
+            const float3 cp = p - tri.v2;
+            float d5 = dot(ab, cp);
+            float d6 = dot(ac, cp);
+            if (d6 >= 0.f && d5 <= d6) return distanceTo(tri.v2);
+
+            float vb = d5 * d2 - d1 * d6;
+            if (vb <= 0.f && d2 >= 0.f && d6 <= 0.f) return distanceTo(tri.v0 + ac * (d2 / (d2 - d6)));
+
+            float va = d3 * d6 - d5 * d4;
+            if (va <= 0.f && (d4 - d3) >= 0.f && (d5 - d6) >= 0.f) return distanceTo(tri.v1 + (tri.v2 - tri.v1) * ((d4 - d3) / ((d4 - d3) + (d5 - d6))));
+
+            float denom = 1.f / (va + vb + vc);
+            return distanceTo(tri.v0 + ab * (vb * denom) + ac * (vc * denom));
+        }
+
+        /** Signed solid angle of a triangle seen from a point. Positive if the point is behind the triangle.
+            See Van Oosterom and Strackee, "The Solid Angle of a Plane Triangle", 1983.
+        */
+        float solidAngle(const Triangle& tri, const float3& p)
+        {
+            const float3 a = tri.v0 - p;
+            const float3 b = tri.v1 - p;
+            const float3 c = tri.v2 - p;
+            const float la = length(a), lb = length(b), lc = length(c);
+            const float numerator = dot(a, cross(b, c));
+            const float denominator = la * lb * lc + dot(a, b) * lc + dot(b, c) * la + dot(c, a) * lb;
+            return 2.f * std::atan2(numerator, denominator);
+        }
+
+        class TriangleBVH
+        {
+        public:
+            TriangleBVH(std::vector<Triangle> triangles)
+                : mTriangles(std::move(triangles))
+            {
+                FALCOR_ASSERT(!mTriangles.empty());
+
+                // Sort the triangles along a Morton curve through their centroids.
+                AABB centroidBounds;
+                for (const auto& tri : mTriangles) centroidBounds.include((tri.v0 + tri.v1 + tri.v2) / 3.f);
+                float3 extent = centroidBounds.extent();
+                float maxExtent = std::max(std::max(extent.x, extent.y), extent.z);
+                float scale = maxExtent > 0.f ? 1.f / maxExtent : 0.f;
+
+                const size_t triangleCount = mTriangles.size();
+                std::vector<uint32_t> codes(triangleCount);
+                std::vector<uint32_t> order(triangleCount);
+                parallel::forEach(triangleCount, [&](size_t i)
+                {
+                    const auto& tri = mTriangles[i];
+                    codes[i] = MeshLayoutOptimizer::computeMortonCode(((tri.v0 + tri.v1 + tri.v2) / 3.f - centroidBounds.minPoint) * scale);
+                    order[i] = (uint32_t)i;
+                });
+                parallel::radixSortKeyValue(codes.data(), order.data(), triangleCount, 30);
+
+                std::vector<Triangle> sortedTriangles(triangleCount);
+                parallel::forEach(triangleCount, [&](size_t i) { sortedTriangles[i] = mTriangles[order[i]]; });
+                mTriangles = std::move(sortedTriangles);
+
+                mNodes.reserve(2 * triangleCount / kMaxLeafTriangleCount + 1);
+                build(0, (uint32_t)triangleCount, codes);
+            }
+
+            /** Returns the squared distance to the closest triangle, or maxDistanceSquared if there is no closer triangle.
+            */
+            float closestDistanceSquared(const float3& p, float maxDistanceSquared) const
+            {
+                // The stack holds node indices and their squared distances.
+                float bestDistanceSquared = maxDistanceSquared;
+                std::pair<uint32_t, float> stack[kMaxTraversalStackSize];
+                uint32_t stackSize = 0;
+                stack[stackSize++] = { 0, distanceSquared(mNodes[0].bounds, p) };
+
+                while (stackSize > 0)
+                {
+                    const auto [nodeIndex, nodeDistanceSquared] = stack[--stackSize];
+                    if (nodeDistanceSquared >= bestDistanceSquared) continue;
+
+                    const BVHNode& node = mNodes[nodeIndex];
+                    if (node.isLeaf())
+                    {
+                        for (uint32_t i = node.triangleOffset; i < node.triangleOffset + node.triangleCount; ++i)
+                        {
+                            bestDistanceSquared = std::min(bestDistanceSquared, distanceSquared(mTriangles[i], p));
+                        }
+                    }
+                    else
+                    {
+                        // Push the farther child first so that the closer child is visited first.
+                        std::pair<uint32_t, float> left = { nodeIndex + 1, distanceSquared(mNodes[nodeIndex + 1].bounds, p) };
+                        std::pair<uint32_t, float> right = { node.rightChild, distanceSquared(mNodes[node.rightChild].bounds, p) };
+                        if (left.second < right.second) std::swap(left, right);
+                        FALCOR_ASSERT(stackSize + 2 <= kMaxTraversalStackSize);
+                        if (left.second < bestDistanceSquared) stack[stackSize++] = left;
+                        if (right.second < bestDistanceSquared) stack[stackSize++] = right;
+                    }
+                }
+
+                return bestDistanceSquared;
+            }
+
+            /** Returns the generalized winding number of the mesh at a point.
+                Nodes further away than accuracy times their radius use the dipole approximation.
+            */
+            float windingNumber(const float3& p, float accuracy) const
+            {
+                float solidAngleSum = 0.f;
+                uint32_t stack[kMaxTraversalStackSize];
+                uint32_t stackSize = 0;
+                stack[stackSize++] = 0;
+
+                while (stackSize > 0)
+                {
+                    const uint32_t nodeIndex = stack[--stackSize];
+                    const BVHNode& node = mNodes[nodeIndex];
+                    const float3 d = node.windingCenter - p;
+                    const float distance = length(d);
+
+                    if (distance > accuracy * node.windingRadius)
+                    {
+                        solidAngleSum += dot(d, node.windingNormal) / (distance * distance * distance);
+                    }
+                    else if (node.isLeaf())
+                    {
+                        for (uint32_t i = node.triangleOffset; i < node.triangleOffset + node.triangleCount; ++i)
+                        {
+                            solidAngleSum += solidAngle(mTriangles[i], p);
+                        }
+                    }
+                    else
+                    {
+                        FALCOR_ASSERT(stackSize + 2 <= kMaxTraversalStackSize);
+                        stack[stackSize++] = nodeIndex + 1;
+                        stack[stackSize++] = node.rightChild;
+                    }
+                }
+
+                return solidAngleSum * float(0.25 * M_1_PI);
+            }
+
+        private:
+            uint32_t build(uint32_t begin, uint32_t end, const std::vector<uint32_t>& codes)
+            {
+                const uint32_t nodeIndex = (uint32_t)mNodes.size();
+                mNodes.push_back({});
+
+                if (end - begin <= kMaxLeafTriangleCount)
+                {
+                    BVHNode node;
+                    node.triangleOffset = begin;
+                    node.triangleCount = end - begin;
+
+                    float3 weightedCentroid = float3(0.f);
+                    for (uint32_t i = begin; i < end; ++i)
+                    {
+                        const auto& tri = mTriangles[i];
+                        node.bounds.include(tri.v0).include(tri.v1).include(tri.v2);
+                        float3 areaNormal = 0.5f * cross(tri.v1 - tri.v0, tri.v2 - tri.v0);
+                        float area = length(areaNormal);
+                        node.windingNormal += areaNormal;
+                        node.windingArea += area;
+                        weightedCentroid += area * (tri.v0 + tri.v1 + tri.v2) / 3.f;
+                    }
+                    node.windingCenter = node.windingArea > 0.f ? weightedCentroid / node.windingArea : node.bounds.center();
+                    for (uint32_t i = begin; i < end; ++i)
+                    {
+                        const auto& tri = mTriangles[i];
+                        node.windingRadius = std::max({ node.windingRadius, length(tri.v0 - node.windingCenter), length(tri.v1 - node.windingCenter), length(tri.v2 - node.windingCenter) });
+                    }
+
+                    mNodes[nodeIndex] = node;
+                    return nodeIndex;
+                }
+
+                // Split at the highest bit that differs between the Morton codes in the range.
+                // If all codes are equal, split in the middle.
+                uint32_t split = (begin + end) / 2;
+                uint32_t diff = codes[begin] ^ codes[end - 1];
+                if (diff != 0)
+                {
+                    uint32_t bit = 1u << (31 - fstd::countl_zero(diff));
+                    split = (uint32_t)(std::partition_point(codes.begin() + begin, codes.begin() + end, [bit](uint32_t code) { return (code & bit) == 0; }) - codes.begin());
+                }
+                FALCOR_ASSERT(begin < split && split < end);
+
+                const uint32_t leftChild = build(begin, split, codes);
+                const uint32_t rightChild = build(split, end, codes);
+                const BVHNode& left = mNodes[leftChild];
+                const BVHNode& right = mNodes[rightChild];
+
+                BVHNode node;
+                node.rightChild = rightChild;
+                node.bounds = left.bounds | right.bounds;
+                node.windingNormal = left.windingNormal + right.windingNormal;
+                node.windingArea = left.windingArea + right.windingArea;
+                node.windingCenter = node.windingArea > 0.f ? (left.windingArea * left.windingCenter + right.windingArea * right.windingCenter) / node.windingArea : node.bounds.center();
+                node.windingRadius = std::max(length(left.windingCenter - node.windingCenter) + left.windingRadius, length(right.windingCenter - node.windingCenter) + right.windingRadius);
+
+                mNodes[nodeIndex] = node;
+                return nodeIndex;
+            }
+
+            std::vector<Triangle> mTriangles;
+            std::vector<BVHNode> mNodes;
+        };
+    }
+
+    SDFMeshBaker::Result SDFMeshBaker::bake(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, uint32_t gridWidth, const Options& options)
+    {
+        FALCOR_CHECK(gridWidth > 0, "'gridWidth' must be larger than zero");
+        FALCOR_CHECK(indices.size() % 3 == 0, "Index count ({}) must be a multiple of 3", indices.size());
+        FALCOR_CHECK(options.tileWidth > 0, "'tileWidth' must be larger than zero");
+
+        Result result;
+        result.gridWidth = gridWidth;
+        result.meshToGrid = float4x4::identity();
+
+        // Compute the transform to the grid's local space [-0.5, 0.5]^3.
+        if (options.fitToGrid)
+        {
+            // The padding on both sides must leave room for the mesh, otherwise it would be scaled to zero.
+            FALCOR_CHECK(options.padding >= 0.f && 2.f * options.padding < gridWidth, "'padding' ({}) must be non-negative and less than half the grid width ({})", options.padding, gridWidth);
+
+            AABB bounds;
+            for (uint32_t index : indices)
+            {
+                FALCOR_CHECK(index < positions.size(), "Vertex index ({}) is out of range", index);
+                bounds.include(positions[index]);
+            }
+            float3 extent = bounds.extent();
+            float maxExtent = bounds.valid() ? std::max(std::max(extent.x, extent.y), extent.z) : 0.f;
+            float fitWidth = 1.f - 2.f * options.padding / gridWidth;
+            float scale = maxExtent > 0.f ? fitWidth / maxExtent : 1.f;
+            if (bounds.valid())
+                result.meshToGrid = mul(math::matrixFromScaling(float3(scale)), math::matrixFromTranslation(-bounds.center()));
+        }
+
+        // Gather the triangles in grid space, skipping degenerate ones.
+        std::vector<Triangle> triangles;
+        triangles.reserve(indices.size() / 3);
+        for (size_t i = 0; i < indices.size(); i += 3)
+        {
+            FALCOR_CHECK(std::max({ indices[i], indices[i + 1], indices[i + 2] }) < positions.size(), "Vertex index is out of range");
+            Triangle tri;
+            tri.v0 = transformPoint(result.meshToGrid, positions[indices[i]]);
+            tri.v1 = transformPoint(result.meshToGrid, positions[indices[i + 1]]);
+            tri.v2 = transformPoint(result.meshToGrid, positions[indices[i + 2]]);
+            if (options.frontFaceCW) std::swap(tri.v1, tri.v2);
+            if (length(cross(tri.v1 - tri.v0, tri.v2 - tri.v0)) > 0.f) triangles.push_back(tri);
+        }
+        FALCOR_CHECK(!triangles.empty(), "Mesh has no non-degenerate triangles");
+
+        TriangleBVH bvh(std::move(triangles));
+
+        const uint32_t gridWidthInValues = gridWidth + 1;
+        const uint32_t tileWidth = options.tileWidth;
+        const uint32_t tilesPerAxis = (gridWidthInValues + tileWidth - 1) / tileWidth;
+        const float voxelSize = 1.f / gridWidth;
+        const float narrowBand = options.narrowBand * voxelSize;
+        const float maxDistance = float(M_SQRT3);
+
+        auto valuePosition = [gridWidth](uint32_t x, uint32_t y, uint32_t z) { return float3(x, y, z) / float(gridWidth) - 0.5f; };
+
+        result.cornerValues.resize((size_t)gridWidthInValues * gridWidthInValues * gridWidthInValues);
+        parallel::forEach((size_t)tilesPerAxis * tilesPerAxis * tilesPerAxis, [&](size_t tileIndex)
+        {
+            const uint3 tile = uint3(uint32_t(tileIndex % tilesPerAxis), uint32_t((tileIndex / tilesPerAxis) % tilesPerAxis), uint32_t(tileIndex / (tilesPerAxis * tilesPerAxis)));
+            const uint3 tileBegin = tile * tileWidth;
+            const uint3 tileEnd = min(tileBegin + tileWidth, uint3(gridWidthInValues));
+
+            const float3 tileMin = valuePosition(tileBegin.x, tileBegin.y, tileBegin.z);
+            const float3 tileMax = valuePosition(tileEnd.x - 1, tileEnd.y - 1, tileEnd.z - 1);
+            const float3 tileCenter = 0.5f * (tileMin + tileMax);
+            const float tileRadius = 0.5f * length(tileMax - tileMin);
+
+            // The distance to the surface from any value in the tile is within tileRadius of the distance from the center.
+            const float centerDistance = std::sqrt(bvh.closestDistanceSquared(tileCenter, std::numeric_limits<float>::infinity()));
+            const bool isFarTile = centerDistance - tileRadius > narrowBand;
+            const float farSign = isFarTile && bvh.windingNumber(tileCenter, options.windingNumberAccuracy) > 0.5f ? -1.f : 1.f;
+
+            for (uint32_t z = tileBegin.z; z < tileEnd.z; ++z)
+            {
+                for (uint32_t y = tileBegin.y; y < tileEnd.y; ++y)
+                {
+                    // Distance and sign of the previous value in the row.
+                    float prevDistance = -1.f;
+                    float prevSign = 1.f;
+
+                    for (uint32_t x = tileBegin.x; x < tileEnd.x; ++x)
+                    {
+                        const float3 p = valuePosition(x, y, z);
+                        const float offset = length(p - tileCenter);
+                        float sd;
+
+                        if (isFarTile)
+                        {
+                            // The surface does not intersect the tile, so the sign is the same for the whole tile.
+                            sd = farSign * (centerDistance - offset);
+                        }
+                        else
+                        {
+                            // The distance changes by at most the distance between values, which bounds the closest triangle search.
+                            float upperBound = centerDistance + offset;
+                            if (prevDistance >= 0.f) upperBound = std::min(upperBound, prevDistance + voxelSize);
+                            float distance = std::sqrt(bvh.closestDistanceSquared(p, upperBound * upperBound));
+
+                            // If the previous value is further away from the surface than the current value,
+                            // the surface does not pass between them and the sign stays the same.
+                            float sign = prevDistance > kSignReuseScale * voxelSize ? prevSign : (bvh.windingNumber(p, options.windingNumberAccuracy) > 0.5f ? -1.f : 1.f);
+                            sd = sign * distance;
+                            prevDistance = distance;
+                            prevSign = sign;
+                        }
+
+                        // We don't care about distance further away than the length of the diagonal of the unit cube where the SDF grid is defined.
+                        result.cornerValues[x + (size_t)gridWidthInValues * (y + (size_t)gridWidthInValues * z)] = std::clamp(sd, -maxDistance, maxDistance);
+                    }
+                }
+            }
+        }, 1);
+
+        return result;
+    }
+
+    SDFMeshBaker::Result SDFMeshBaker::bake(const TriangleMesh& mesh, uint32_t gridWidth, const Options& options)
+    {
+        std::vector<float3> positions;
+        positions.reserve(mesh.getVertices().size());
+        for (const auto& vertex : mesh.getVertices()) positions.push_back(vertex.position);
+
+        Options meshOptions = options;
+        meshOptions.frontFaceCW = mesh.getFrontFaceCW();
+        return bake(positions, mesh.getIndices(), gridWidth, meshOptions);
+    }
+}
@@ -0,0 +1,87 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Math/Vector.h"
+#include "Utils/Math/Matrix.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+    class TriangleMesh;
+
+    /** Bakes triangle meshes into signed distance values at the voxel corners of an SDF grid on the CPU.
+        The result is the input expected by SDFGrid::setValues(), i.e., (gridWidth + 1)^3 values in the grid's local space [-0.5, 0.5]^3.
+
+        Closest distances are found with a BVH over the triangles. The sign is determined by the generalized winding number
+        (Jacobson et al. 2013), evaluated hierarchically with the dipole approximation of Barill et al. 2018, which gives robust
+        results for meshes with holes and self-intersections. The grid is evaluated in parallel in tiles of values.
+        Tiles further away from the surface than the narrow band only compute a single distance and sign at the tile center
+        and store conservative lower bounds for the rest of the tile.
+
+        The mesh is expected to use counter-clockwise winding for outward facing triangles (or clockwise if specified).
+    */
+    class FALCOR_API SDFMeshBaker
+    {
+    public:
+        struct Options
+        {
+            bool fitToGrid = true;                  ///< Uniformly scale and translate the mesh to fit in the grid. Otherwise the mesh is assumed to be in the grid's local space.
+            float padding = 2.f;                    ///< Distance in voxels between the mesh bounds and the grid boundary when fitting the mesh to the grid. Must be less than half the grid width.
+            float narrowBand = 4.f;                 ///< Width of the narrow band around the surface in voxels. Values outside the band may be lower bounds of the distance.
+            float windingNumberAccuracy = 2.f;      ///< Triangle clusters further away than this times their radius use the far-field approximation of the winding number.
+            uint32_t tileWidth = 8;                 ///< Width of the tiles of values that are evaluated in parallel.
+            bool frontFaceCW = false;               ///< Set if outward facing triangles use clockwise winding.
+        };
+
+        struct Result
+        {
+            std::vector<float> cornerValues;        ///< Signed distances at the (gridWidth + 1)^3 voxel corners, negative inside the mesh.
+            uint32_t gridWidth = 0;                 ///< Grid width in voxels.
+            float4x4 meshToGrid;                    ///< Transform from mesh space to the grid's local space.
+        };
+
+        /** Bake a triangle mesh.
+            \param[in] positions Vertex positions.
+            \param[in] indices Triangle vertex indices, three per triangle.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] options Bake options.
+            \return The corner values and the transform used to place the mesh in the grid.
+        */
+        static Result bake(const std::vector<float3>& positions, const std::vector<uint32_t>& indices, uint32_t gridWidth, const Options& options);
+
+        /** Bake a triangle mesh. The winding order is taken from the mesh.
+            \param[in] mesh Triangle mesh.
+            \param[in] gridWidth The grid width in voxels.
+            \param[in] options Bake options.
+            \return The corner values and the transform used to place the mesh in the grid.
+        */
+        static Result bake(const TriangleMesh& mesh, uint32_t gridWidth, const Options& options);
+    };
+}
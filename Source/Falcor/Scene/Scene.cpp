@@ -28,6 +28,7 @@
 #include "Scene.h"
 #include "SceneDefines.slangh"
 #include "SceneBuilder.h"
+#include "MeshSimplifier.h"
 #include "Importer.h"
 #include "Scene/Material/SerializedMaterialParams.h"
 #include "Curves/CurveConfig.h"
@@ -65,6 +66,7 @@ namespace Falcor
     {
         // Large scenes are split into multiple BLAS groups in order to reduce build memory usage.
         // The target is max 0.5GB intermediate memory per BLAS group. Note that this is not a strict limit.
+        // See BlasBuildPlanner for how BLASes are assigned to groups.
         const size_t kMaxBLASBuildMemory = 1ull << 29;
 
         const std::string kParameterBlockName = "gScene";
@@ -193,6 +195,15 @@ namespace Falcor
         mMeshIdToInstanceIds = std::move(sceneData.meshIdToInstanceIds);
         mMeshGroups = std::move(sceneData.meshGroups);
 
+        mMeshlets = std::move(sceneData.meshlets);
+        mMeshletOffsets = std::move(sceneData.meshletOffsets);
+        mMeshletVertices = std::move(sceneData.meshletVertices);
+        mMeshletTriangles = std::move(sceneData.meshletTriangles);
+        mMeshLods = std::move(sceneData.meshLods);
+        mMeshLodOffsets = std::move(sceneData.meshLodOffsets);
+        mMeshLodIndices = std::move(sceneData.meshLodIndices);
+        mDeduplicatedMeshCount = sceneData.deduplicatedMeshCount;
+
         mUseCompressedHitInfo = sceneData.useCompressedHitInfo;
         mHas16BitIndices = sceneData.has16BitIndices;
         mHas32BitIndices = sceneData.has32BitIndices;
@@ -1328,6 +1339,8 @@ namespace Falcor
         auto& s = mSceneStats;
 
         s.meshCount = getMeshCount();
+        s.deduplicatedMeshCount = mDeduplicatedMeshCount;
+        s.meshDeduplicationRatio = s.meshCount > 0 ? float(s.meshCount + s.deduplicatedMeshCount) / s.meshCount : 1.f;
         s.meshInstanceCount = 0;
         s.meshInstanceOpaqueCount = 0;
         s.transformCount = getAnimationController()->getGlobalMatrices().size();
@@ -1394,6 +1407,51 @@ namespace Falcor
             s.uniqueCurveSegmentCount += curve.getSegmentCount();
         }
 
+        // Calculate mesh LOD stats. Level 0 is the full resolution mesh.
+        s.lodUniqueTriangleCount.clear();
+        s.lodInstancedTriangleCount.clear();
+        s.lodIndexMemoryInBytes.clear();
+
+        if (!mMeshLods.empty())
+        {
+            uint32_t levelCount = 1;
+            for (MeshID meshID{ 0 }; meshID.get() < getMeshCount(); ++meshID) levelCount = std::max(levelCount, getMeshLodRange(meshID).y + 1);
+
+            s.lodUniqueTriangleCount.resize(levelCount, 0);
+            s.lodInstancedTriangleCount.resize(levelCount, 0);
+            s.lodIndexMemoryInBytes.resize(levelCount, 0);
+
+            std::vector<uint32_t> meshInstanceCount(getMeshCount(), 0);
+            for (uint32_t instanceID = 0; instanceID < getGeometryInstanceCount(); instanceID++)
+            {
+                const auto& instance = getGeometryInstance(instanceID);
+                if (instance.getType() == GeometryType::TriangleMesh || instance.getType() == GeometryType::DisplacedTriangleMesh)
+                {
+                    meshInstanceCount[instance.geometryID]++;
+                }
+            }
+
+            for (MeshID meshID{ 0 }; meshID.get() < getMeshCount(); ++meshID)
+            {
+                const auto& mesh = getMesh(meshID);
+                const uint2 range = getMeshLodRange(meshID);
+                for (uint32_t level = 0; level < levelCount; level++)
+                {
+                    uint64_t triangleCount = mesh.getTriangleCount();
+                    uint64_t indexMemoryInBytes = (uint64_t)mesh.indexCount * (mesh.use16BitIndices() ? sizeof(uint16_t) : sizeof(uint32_t));
+                    if (level > 0 && range.y > 0)
+                    {
+                        const auto& lod = mMeshLods[range.x + std::min(level, range.y) - 1];
+                        triangleCount = lod.indexCount / 3;
+                        indexMemoryInBytes = lod.indexCount * sizeof(uint32_t);
+                    }
+                    s.lodUniqueTriangleCount[level] += triangleCount;
+                    s.lodInstancedTriangleCount[level] += triangleCount * meshInstanceCount[meshID.get()];
+                    s.lodIndexMemoryInBytes[level] += indexMemoryInBytes;
+                }
+            }
+        }
+
         // Calculate memory usage.
         s.indexMemoryInBytes = 0;
         s.vertexMemoryInBytes = 0;
@@ -1445,6 +1503,26 @@ namespace Falcor
         s.animationMemoryInBytes += getAnimationController()->getMemoryUsageInBytes();
     }
 
+    uint32_t Scene::selectMeshLod(uint32_t instanceID, const ref<Camera>& pCamera, uint32_t viewportHeight, float maxPixelError) const
+    {
+        const auto& instance = getGeometryInstance(instanceID);
+        if (instance.getType() != GeometryType::TriangleMesh && instance.getType() != GeometryType::DisplacedTriangleMesh) return 0;
+
+        const MeshID meshID = MeshID::fromSlang(instance.geometryID);
+        const uint2 range = getMeshLodRange(meshID);
+        if (range.y == 0 || !pCamera || pCamera->getFocalLength() <= 0.f) return 0;
+
+        // Project the diagonal of the world space bounding box at the distance of the nearest point of its bounding sphere.
+        const auto& globalMatrices = mpAnimationController->getGlobalMatrices();
+        FALCOR_ASSERT(instance.globalMatrixID < globalMatrices.size());
+        const AABB bounds = mMeshBBs[meshID.get()].transform(globalMatrices[instance.globalMatrixID]);
+        const float distance = length(bounds.center() - pCamera->getPosition()) - bounds.radius();
+        if (distance <= 0.f) return 0;
+
+        const float projectedSize = 2.f * bounds.radius() * viewportHeight * pCamera->getFocalLength() / (distance * pCamera->getFrameHeight());
+        return MeshSimplifier::selectLod(&mMeshLods[range.x], range.y, projectedSize, maxPixelError);
+    }
+
     void Scene::updateMaterialStats()
     {
         mSceneStats.materials = mpMaterials->getStats();
@@ -1480,6 +1558,9 @@ namespace Falcor
             s.blasOpaqueGeometryCount += opaque;
         }
 
+        s.blasBuildPlannedPeakMemoryInBytes = mBlasBuildPlan.plannedPeakMemory;
+        s.blasBuildPeakMemoryInBytes = mBlasBuildPeakMemory;
+
         if (mpBlasScratch) s.blasScratchMemoryInBytes += mpBlasScratch->getSize();
         if (mpBlasStaticWorldMatrices) s.blasScratchMemoryInBytes += mpBlasStaticWorldMatrices->getSize();
     }
@@ -2178,6 +2259,7 @@ namespace Falcor
             // Geometry stats.
             oss << "Geometry stats:" << std::endl
                 << "  Mesh count: " << s.meshCount << std::endl
+                << "  Deduplicated mesh count: " << s.deduplicatedMeshCount << " (ratio " << s.meshDeduplicationRatio << ")" << std::endl
                 << "  Mesh instance count (total): " << s.meshInstanceCount << std::endl
                 << "  Mesh instance count (opaque): " << s.meshInstanceOpaqueCount << std::endl
                 << "  Mesh instance count (non-opaque): " << (s.meshInstanceCount - s.meshInstanceOpaqueCount) << std::endl
@@ -2189,7 +2271,13 @@ namespace Falcor
                 << "  Index  buffer memory: " << formatByteSize(s.indexMemoryInBytes) << std::endl
                 << "  Vertex buffer memory: " << formatByteSize(s.vertexMemoryInBytes) << std::endl
                 << "  Geometry data memory: " << formatByteSize(s.geometryMemoryInBytes) << std::endl
-                << "  Animation data memory: " << formatByteSize(s.animationMemoryInBytes) << std::endl
+                << "  Animation data memory: " << formatByteSize(s.animationMemoryInBytes) << std::endl;
+            for (size_t level = 0; level < s.lodUniqueTriangleCount.size(); level++)
+            {
+                oss << "  LOD " << level << " triangle count (unique/instanced): " << s.lodUniqueTriangleCount[level] << "/" << s.lodInstancedTriangleCount[level]
+                    << ", index memory: " << formatByteSize(s.lodIndexMemoryInBytes[level]) << std::endl;
+            }
+            oss
                 << "  Curve count: " << s.curveCount << std::endl
                 << "  Curve instance count: " << s.curveInstanceCount << std::endl
                 << "  Unique curve segment count: " << s.uniqueCurveSegmentCount << std::endl
@@ -2217,6 +2305,8 @@ namespace Falcor
                 << "  BLAS geometries (non-opaque): " << (s.blasGeometryCount - s.blasOpaqueGeometryCount) << std::endl
                 << "  BLAS memory (final): " << formatByteSize(s.blasMemoryInBytes) << std::endl
                 << "  BLAS memory (scratch): " << formatByteSize(s.blasScratchMemoryInBytes) << std::endl
+                << "  BLAS build peak memory (planned): " << formatByteSize(s.blasBuildPlannedPeakMemoryInBytes) << std::endl
+                << "  BLAS build peak memory (actual): " << formatByteSize(s.blasBuildPeakMemoryInBytes) << std::endl
                 << "  TLAS count: " << s.tlasCount << std::endl
                 << "  TLAS memory (final): " << formatByteSize(s.tlasMemoryInBytes) << std::endl
                 << "  TLAS memory (scratch): " << formatByteSize(s.tlasScratchMemoryInBytes) << std::endl
@@ -3130,33 +3220,37 @@ namespace Falcor
     void Scene::computeBlasGroups()
     {
         mBlasGroups.clear();
-        uint64_t groupSize = 0;
 
-        for (uint32_t blasId = 0; blasId < mBlasData.size(); blasId++)
+        std::vector<BlasBuildPlanner::BlasRecord> records(mBlasData.size());
+        for (size_t blasId = 0; blasId < mBlasData.size(); blasId++)
         {
-            auto& blas = mBlasData[blasId];
-            size_t blasSize = blas.resultByteSize + blas.scratchByteSize;
-
-            // Start new BLAS group on first iteration or if group size would exceed the target.
-            if (groupSize == 0 || groupSize + blasSize > kMaxBLASBuildMemory)
-            {
-                mBlasGroups.push_back({});
-                groupSize = 0;
-            }
+            const auto& blas = mBlasData[blasId];
+            auto& record = records[blasId];
+            record.resultByteSize = blas.resultByteSize;
+            record.scratchByteSize = blas.scratchByteSize;
+            record.useCompaction = blas.useCompaction;
+            record.needsScratchAfterBuild = blas.hasDynamicGeometry() || blas.hasProceduralPrimitives;
+        }
 
-            // Add BLAS to current group.
-            FALCOR_ASSERT(mBlasGroups.size() > 0);
-            auto& group = mBlasGroups.back();
-            group.blasIndices.push_back(blasId);
-            blas.blasGroupIndex = (uint32_t)mBlasGroups.size() - 1;
+        BlasBuildPlanner::Options options;
+        options.memoryBudget = kMaxBLASBuildMemory;
+        mBlasBuildPlan = BlasBuildPlanner::plan(records, options);
 
-            // Update data offsets and sizes.
-            blas.resultByteOffset = group.resultByteSize;
-            blas.scratchByteOffset = group.scratchByteSize;
-            group.resultByteSize += blas.resultByteSize;
-            group.scratchByteSize += blas.scratchByteSize;
+        for (const auto& plannedGroup : mBlasBuildPlan.groups)
+        {
+            BlasGroup group;
+            group.blasIndices = plannedGroup.blasIndices;
+            group.resultByteSize = plannedGroup.resultByteSize;
+            group.scratchByteSize = plannedGroup.scratchByteSize;
+            mBlasGroups.push_back(std::move(group));
+        }
 
-            groupSize += blasSize;
+        for (uint32_t blasId = 0; blasId < mBlasData.size(); blasId++)
+        {
+            auto& blas = mBlasData[blasId];
+            blas.blasGroupIndex = mBlasBuildPlan.blasGroupIndex[blasId];
+            blas.resultByteOffset = mBlasBuildPlan.resultByteOffset[blasId];
+            blas.scratchByteOffset = mBlasBuildPlan.scratchByteOffset[blasId];
         }
 
         // Validation that all offsets and sizes are correct.
@@ -3276,7 +3370,7 @@ namespace Falcor
                 preparePrebuildInfo(pRenderContext);
                 computeBlasGroups();
 
-                logInfo("BLAS build split into {} groups", mBlasGroups.size());
+                logInfo("BLAS build split into {} groups (planned peak memory: {})", mBlasGroups.size(), formatByteSize(mBlasBuildPlan.plannedPeakMemory));
 
                 // Compute the required maximum size of the result and scratch buffers.
                 uint64_t resultByteSize = 0;
@@ -3306,6 +3400,10 @@ namespace Falcor
                 ref<Buffer> pResultBuffer = mpDevice->createBuffer(resultByteSize, ResourceBindFlags::AccelerationStructure, MemoryType::DeviceLocal);
                 FALCOR_ASSERT(pResultBuffer && mpBlasScratch);
 
+                // Track the memory actually allocated during the build to compare against the plan.
+                uint64_t finalBlasMemory = 0;
+                mBlasBuildPeakMemory = mpBlasScratch->getSize() + pResultBuffer->getSize();
+
                 // Create post-build info pool for readback.
                 RtAccelerationStructurePostBuildInfoPool::Desc compactedSizeInfoPoolDesc;
                 compactedSizeInfoPoolDesc.queryType = RtAccelerationStructurePostBuildInfoQueryType::CompactedSize;
@@ -3411,6 +3509,15 @@ namespace Falcor
 
                     logInfo("BLAS group " + std::to_string(blasGroupIndex) + " final size: " + formatByteSize(group.finalByteSize));
 
+                    // Release the scratch buffer before allocating the last final buffer if the planner determined
+                    // that no BLAS needs it after the build. The post-build info readback above flushed the GPU work,
+                    // so waiting on the device releases the memory immediately.
+                    if (blasGroupIndex + 1 == mBlasGroups.size() && mBlasBuildPlan.releaseScratchBeforeLastGroup && mpBlasScratch)
+                    {
+                        mpBlasScratch.reset();
+                        mpDevice->wait();
+                    }
+
                     // Allocate final BLAS buffer.
                     auto& pBlas = group.pBlas;
                     if (pBlas == nullptr || pBlas->getSize() < group.finalByteSize)
@@ -3447,8 +3554,14 @@ namespace Falcor
 
                     // Insert barrier. The BLAS buffer is now ready for use.
                     pRenderContext->uavBarrier(pBlas.get());
+
+                    finalBlasMemory += pBlas->getSize();
+                    uint64_t currentMemory = pResultBuffer->getSize() + (mpBlasScratch ? mpBlasScratch->getSize() : 0) + finalBlasMemory;
+                    mBlasBuildPeakMemory = std::max(mBlasBuildPeakMemory, currentMemory);
                 }
 
+                logInfo("BLAS build peak memory: {} (planned {})", formatByteSize(mBlasBuildPeakMemory), formatByteSize(mBlasBuildPlan.plannedPeakMemory));
+
                 // Release scratch buffer if there is no animated content. We will not need it.
                 if (!hasDynamicGeometry && !hasProceduralPrimitives) mpBlasScratch.reset();
             }
@@ -4067,21 +4180,32 @@ namespace Falcor
     void Scene::getMeshVerticesAndIndices(MeshID meshID, const std::map<std::string, ref<Buffer>>& buffers)
     {
         if (!mpLoadMeshPass)
+        {
             mpLoadMeshPass = ComputePass::create(mpDevice, kMeshIOShaderFilename, "getMeshVerticesAndIndices", getSceneDefines());
+            mLoadMeshVars.vertexCount = ShaderVarHandle("meshLoader.vertexCount");
+            mLoadMeshVars.vbOffset = ShaderVarHandle("meshLoader.vbOffset");
+            mLoadMeshVars.triangleCount = ShaderVarHandle("meshLoader.triangleCount");
+            mLoadMeshVars.ibOffset = ShaderVarHandle("meshLoader.ibOffset");
+            mLoadMeshVars.use16BitIndices = ShaderVarHandle("meshLoader.use16BitIndices");
+            mLoadMeshVars.scene = ShaderVarHandle("meshLoader.scene");
+            for (const auto& name : kMeshLoaderRequiredBufferNames)
+                mLoadMeshVars.buffers.emplace_back("meshLoader." + name);
+        }
         const auto& meshDesc = getMesh(meshID);
 
         // Bind variables.
-        auto var = mpLoadMeshPass->getRootVar()["meshLoader"];
-        var["vertexCount"] = meshDesc.vertexCount;
-        var["vbOffset"] = meshDesc.vbOffset;
-        var["triangleCount"] = meshDesc.getTriangleCount();
-        var["ibOffset"] = meshDesc.ibOffset;
-        var["use16BitIndices"] = meshDesc.use16BitIndices();
-        bindShaderData(var["scene"]);
-        for (const auto& name : kMeshLoaderRequiredBufferNames)
-        {
+        auto var = mpLoadMeshPass->getRootVar();
+        var[mLoadMeshVars.vertexCount] = meshDesc.vertexCount;
+        var[mLoadMeshVars.vbOffset] = meshDesc.vbOffset;
+        var[mLoadMeshVars.triangleCount] = meshDesc.getTriangleCount();
+        var[mLoadMeshVars.ibOffset] = meshDesc.ibOffset;
+        var[mLoadMeshVars.use16BitIndices] = meshDesc.use16BitIndices();
+        bindShaderData(var[mLoadMeshVars.scene]);
+        for (size_t i = 0; i < std::size(kMeshLoaderRequiredBufferNames); ++i)
+        {
+            const auto& name = kMeshLoaderRequiredBufferNames[i];
             FALCOR_CHECK(buffers.find(name) != buffers.end(), "Mesh data buffer '{}' is missing.", name);
-            var[name] = buffers.at(name);
+            var[mLoadMeshVars.buffers[i]] = buffers.at(name);
         }
 
         mpLoadMeshPass->execute(mpDevice->getRenderContext(), std::max(meshDesc.vertexCount, meshDesc.getTriangleCount()), 1, 1);
@@ -4090,18 +4214,26 @@ namespace Falcor
     void Scene::setMeshVertices(MeshID meshID, const std::map<std::string, ref<Buffer>>& buffers)
     {
         if (!mpUpdateMeshPass)
+        {
             mpUpdateMeshPass = ComputePass::create(mpDevice, kMeshIOShaderFilename, "setMeshVertices", getSceneDefines());
+            mUpdateMeshVars.vertexCount = ShaderVarHandle("meshUpdater.vertexCount");
+            mUpdateMeshVars.vbOffset = ShaderVarHandle("meshUpdater.vbOffset");
+            mUpdateMeshVars.vertexData = ShaderVarHandle("meshUpdater.vertexData");
+            for (const auto& name : kMeshUpdaterRequiredBufferNames)
+                mUpdateMeshVars.buffers.emplace_back("meshUpdater." + name);
+        }
         const auto& meshDesc = getMesh(meshID);
 
         // Bind variables.
-        auto var = mpUpdateMeshPass->getRootVar()["meshUpdater"];
-        var["vertexCount"] = meshDesc.vertexCount;
-        var["vbOffset"] = meshDesc.vbOffset;
-        var["vertexData"] = getMeshVao()->getVertexBuffer(kStaticDataBufferIndex);
-        for (const auto& name : kMeshUpdaterRequiredBufferNames)
+        auto var = mpUpdateMeshPass->getRootVar();
+        var[mUpdateMeshVars.vertexCount] = meshDesc.vertexCount;
+        var[mUpdateMeshVars.vbOffset] = meshDesc.vbOffset;
+        var[mUpdateMeshVars.vertexData] = getMeshVao()->getVertexBuffer(kStaticDataBufferIndex);
+        for (size_t i = 0; i < std::size(kMeshUpdaterRequiredBufferNames); ++i)
         {
+            const auto& name = kMeshUpdaterRequiredBufferNames[i];
             FALCOR_CHECK(buffers.find(name) != buffers.end(), "Mesh data buffer '{}' is missing.", name);
-            var[name] = buffers.at(name);
+            var[mUpdateMeshVars.buffers[i]] = buffers.at(name);
         }
 
         mpUpdateMeshPass->execute(mpDevice->getRenderContext(), meshDesc.vertexCount, 1, 1);
@@ -4118,6 +4250,8 @@ namespace Falcor
         d["meshCount"] = stats.meshCount;
         d["meshInstanceCount"] = stats.meshInstanceCount;
         d["meshInstanceOpaqueCount"] = stats.meshInstanceOpaqueCount;
+        d["deduplicatedMeshCount"] = stats.deduplicatedMeshCount;
+        d["meshDeduplicationRatio"] = stats.meshDeduplicationRatio;
         d["transformCount"] = stats.transformCount;
         d["uniqueTriangleCount"] = stats.uniqueTriangleCount;
         d["uniqueVertexCount"] = stats.uniqueVertexCount;
@@ -4127,6 +4261,9 @@ namespace Falcor
         d["vertexMemoryInBytes"] = stats.vertexMemoryInBytes;
         d["geometryMemoryInBytes"] = stats.geometryMemoryInBytes;
         d["animationMemoryInBytes"] = stats.animationMemoryInBytes;
+        d["lodUniqueTriangleCount"] = stats.lodUniqueTriangleCount;
+        d["lodInstancedTriangleCount"] = stats.lodInstancedTriangleCount;
+        d["lodIndexMemoryInBytes"] = stats.lodIndexMemoryInBytes;
 
         // Curve stats
         d["curveCount"] = stats.curveCount;
@@ -4166,6 +4303,8 @@ namespace Falcor
         d["blasOpaqueGeometryCount"] = stats.blasOpaqueGeometryCount;
         d["blasMemoryInBytes"] = stats.blasMemoryInBytes;
         d["blasScratchMemoryInBytes"] = stats.blasScratchMemoryInBytes;
+        d["blasBuildPlannedPeakMemoryInBytes"] = stats.blasBuildPlannedPeakMemoryInBytes;
+        d["blasBuildPeakMemoryInBytes"] = stats.blasBuildPeakMemoryInBytes;
         d["tlasCount"] = stats.tlasCount;
         d["tlasMemoryInBytes"] = stats.tlasMemoryInBytes;
         d["tlasScratchMemoryInBytes"] = stats.tlasScratchMemoryInBytes;
@@ -4327,6 +4466,9 @@ namespace Falcor
         pybind11::class_<Scene, ref<Scene>> scene(m, "Scene");
 
         scene.def_property_readonly(kStats.c_str(), [](const Scene* pScene) { return toPython(pScene->getSceneStats()); });
+        // The build report is passed as the parsed JSON report, so it matches the written report files.
+        scene.def_property_readonly("build_report", [](const Scene* pScene) { return pybind11::module_::import("json").attr("loads")(pScene->getBuildReport().toJsonString()); });
+        scene.def("write_build_report", [](const Scene* pScene, const std::filesystem::path& path) { pScene->getBuildReport().writeToFile(path); }, "path"_a);
         scene.def_property_readonly(kBounds.c_str(), &Scene::getSceneBounds, pybind11::return_value_policy::copy);
         scene.def_property(kCamera.c_str(), &Scene::getCamera, &Scene::setCamera);
         scene.def_property(kEnvMap.c_str(), &Scene::getEnvMap, &Scene::setEnvMap);
@@ -26,9 +26,11 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #pragma once
+#include "SceneBuildReport.h"
 #include "SceneIDs.h"
 #include "SceneTypes.slang"
 #include "HitInfo.h"
+#include "BlasBuildPlanner.h"
 #include "Animation/Animation.h"
 #include "Animation/AnimationController.h"
 #include "Displacement/DisplacementUpdateTask.slang"
@@ -47,6 +49,7 @@
 #include "Core/Object.h"
 #include "Core/API/VAO.h"
 #include "Core/API/RtAccelerationStructure.h"
+#include "Core/Program/ShaderVar.h"
 #include "Utils/Math/AABB.h"
 #include "Utils/Math/Rectangle.h"
 #include "Utils/Math/Vector.h"
@@ -334,11 +337,24 @@ namespace Falcor
             bool has16BitIndices = false;                           ///< True if 16-bit mesh indices are used.
             bool has32BitIndices = false;                           ///< True if 32-bit mesh indices are used.
             uint32_t meshDrawCount = 0;                             ///< Number of meshes to draw.
+            uint32_t deduplicatedMeshCount = 0;                     ///< Number of meshes that were merged into instances of identical meshes by the scene builder.
+            bool deferMaterialOptimization = false;                 ///< True if material texture optimization was skipped in a headless build and has to run when the scene is loaded on a device.
 
             std::vector<uint32_t> meshIndexData;                    ///< Vertex indices for all meshes in either 32-bit or 16-bit format packed tightly, decided per mesh.
             std::vector<PackedStaticVertexData> meshStaticData;     ///< Vertex attributes for all meshes in packed format.
             std::vector<SkinningVertexData> meshSkinningData;       ///< Additional vertex attributes for skinned meshes.
 
+            // Meshlet data
+            std::vector<MeshletDesc> meshlets;                      ///< List of meshlets for all meshes, ordered by mesh ID. Empty unless meshlets are generated.
+            std::vector<uint32_t> meshletOffsets;                   ///< Offset of the first meshlet per mesh, followed by the total meshlet count.
+            std::vector<uint32_t> meshletVertices;                  ///< Mesh-local vertex indices for all meshlets.
+            std::vector<uint32_t> meshletTriangles;                 ///< Meshlet-local vertex indices for all meshlet triangles, packed as three 8-bit values.
+
+            // Mesh LOD data
+            std::vector<MeshLodDesc> meshLods;                      ///< List of LODs for all meshes, ordered by mesh ID and from fine to coarse. Empty unless LODs are generated.
+            std::vector<uint32_t> meshLodOffsets;                   ///< Offset of the first LOD per mesh, followed by the total LOD count.
+            std::vector<uint32_t> meshLodIndices;                   ///< Mesh-local vertex indices for all LODs.
+
             // Curve data
             std::vector<CurveDesc> curveDesc;                       ///< List of curve descriptors.
             std::vector<AABB> curveBBs;                             ///< List of curve bounding boxes in object space. Each curve consists of many segments, each with its own AABB. The bounding boxes here are the unions of those.
@@ -367,6 +383,8 @@ namespace Falcor
             uint64_t meshCount = 0;                     ///< Number of meshes.
             uint64_t meshInstanceCount = 0;             ///< Number if mesh instances.
             uint64_t meshInstanceOpaqueCount = 0;       ///< Number if mesh instances that are opaque.
+            uint64_t deduplicatedMeshCount = 0;         ///< Number of imported meshes that were merged into instances of identical meshes.
+            float meshDeduplicationRatio = 1.f;         ///< Ratio of the number of meshes before deduplication to the number of meshes after.
             uint64_t transformCount = 0;                ///< Number of transform matrices.
             uint64_t uniqueTriangleCount = 0;           ///< Number of unique triangles. A triangle can exist in multiple instances.
             uint64_t uniqueVertexCount = 0;             ///< Number of unique vertices. A vertex can be referenced by multiple triangles/instances.
@@ -377,6 +395,11 @@ namespace Falcor
             uint64_t geometryMemoryInBytes = 0;         ///< Total memory in bytes used by the geometry data (meshes, curves, custom primitives, instances etc.).
             uint64_t animationMemoryInBytes = 0;        ///< Total memory in bytes used by the animation system (transforms, skinning buffers).
 
+            // Mesh LOD stats, indexed by LOD level. Meshes with fewer LODs contribute their coarsest LOD. Empty unless LODs are generated.
+            std::vector<uint64_t> lodUniqueTriangleCount;       ///< Number of unique triangles per LOD level.
+            std::vector<uint64_t> lodInstancedTriangleCount;    ///< Number of instanced triangles per LOD level. This is the number of rasterized triangles if all instances use the level.
+            std::vector<uint64_t> lodIndexMemoryInBytes;        ///< Memory in bytes used by the indices per LOD level.
+
             // Curve stats
             uint64_t curveCount = 0;                    ///< Number of curves.
             uint64_t curveInstanceCount = 0;            ///< Number of curve instances.
@@ -408,6 +431,8 @@ namespace Falcor
             uint64_t blasOpaqueGeometryCount = 0;       ///< Number of geometries that are opaque.
             uint64_t blasMemoryInBytes = 0;             ///< Total memory in bytes used by the BLASes.
             uint64_t blasScratchMemoryInBytes = 0;      ///< Additional memory in bytes kept around for BLAS updates etc.
+            uint64_t blasBuildPlannedPeakMemoryInBytes = 0; ///< Peak memory in bytes predicted by the BLAS build planner.
+            uint64_t blasBuildPeakMemoryInBytes = 0;    ///< Peak memory in bytes actually allocated during the last full BLAS build.
             uint64_t tlasCount = 0;                     ///< Number of TLASes.
             uint64_t tlasMemoryInBytes = 0;             ///< Total memory in bytes used by the TLASes.
             uint64_t tlasScratchMemoryInBytes = 0;      ///< Additional memory in bytes kept around for TLAS updates etc.
@@ -502,6 +527,10 @@ namespace Falcor
         */
         const SceneStats& getSceneStats() const { return mSceneStats; }
 
+        /** Get the time and memory statistics of the scene build.
+        */
+        const SceneBuildReport& getBuildReport() const { return mBuildReport; }
+
         /** Get the render settings.
         */
         const RenderSettings& getRenderSettings() const { return mRenderSettings; }
@@ -902,6 +931,56 @@ namespace Falcor
         */
         const AABB& getCurveBounds(uint32_t curveID) const { return mCurveBBs[curveID]; }
 
+        /** Get the meshlets of all meshes. This is empty unless the scene was built with SceneBuilder::Flags::GenerateMeshlets.
+        */
+        const std::vector<MeshletDesc>& getMeshlets() const { return mMeshlets; }
+
+        /** Get the range of meshlets of a mesh.
+            \return Offset of the first meshlet and the meshlet count.
+        */
+        uint2 getMeshletRange(MeshID meshID) const
+        {
+            if (mMeshletOffsets.empty()) return uint2(0);
+            FALCOR_ASSERT(meshID.get() + 1 < mMeshletOffsets.size());
+            return uint2(mMeshletOffsets[meshID.get()], mMeshletOffsets[meshID.get() + 1] - mMeshletOffsets[meshID.get()]);
+        }
+
+        /** Get the mesh-local vertex indices of all meshlets.
+        */
+        const std::vector<uint32_t>& getMeshletVertices() const { return mMeshletVertices; }
+
+        /** Get the triangles of all meshlets, with three 8-bit meshlet-local vertex indices each.
+        */
+        const std::vector<uint32_t>& getMeshletTriangles() const { return mMeshletTriangles; }
+
+        /** Get the levels of detail (LODs) of all meshes. This is empty unless the scene was built with SceneBuilder::Flags::GenerateMeshLods.
+        */
+        const std::vector<MeshLodDesc>& getMeshLods() const { return mMeshLods; }
+
+        /** Get the range of LODs of a mesh, ordered from fine to coarse. The full resolution mesh is not included.
+            \return Offset of the first LOD and the LOD count.
+        */
+        uint2 getMeshLodRange(MeshID meshID) const
+        {
+            if (mMeshLodOffsets.empty()) return uint2(0);
+            FALCOR_ASSERT(meshID.get() + 1 < mMeshLodOffsets.size());
+            return uint2(mMeshLodOffsets[meshID.get()], mMeshLodOffsets[meshID.get() + 1] - mMeshLodOffsets[meshID.get()]);
+        }
+
+        /** Get the mesh-local vertex indices of all LODs.
+        */
+        const std::vector<uint32_t>& getMeshLodIndices() const { return mMeshLodIndices; }
+
+        /** Select the LOD of a triangle mesh instance based on its projected size.
+            The LOD is the coarsest one whose error, projected with the size of the instance bounding box, is acceptable.
+            \param[in] instanceID Geometry instance ID.
+            \param[in] pCamera Camera.
+            \param[in] viewportHeight Viewport height in pixels.
+            \param[in] maxPixelError Maximum acceptable error in pixels.
+            \return LOD index, where 0 is the full resolution mesh and i > 0 is getMeshLods()[getMeshLodRange(meshID).x + i - 1].
+        */
+        uint32_t selectMeshLod(uint32_t instanceID, const ref<Camera>& pCamera, uint32_t viewportHeight, float maxPixelError = 1.f) const;
+
         /** Get a list of all lights in the scene.
         */
         const std::vector<ref<Light>>& getLights() const { return mLights; };
@@ -1122,6 +1201,7 @@ namespace Falcor
     private:
         friend class AnimationController;
         friend class AnimatedVertexCache;
+        friend class SceneBuilder;
 
         static constexpr uint32_t kStaticDataBufferIndex = 0;
         static constexpr uint32_t kDrawIdBufferIndex = kStaticDataBufferIndex + 1;
@@ -1279,6 +1359,19 @@ namespace Falcor
         /// For Python bindings of triangle meshes.
         ref<ComputePass> mpLoadMeshPass;
         ref<ComputePass> mpUpdateMeshPass;
+        struct MeshIOVars                                           ///< Cached handles to the mesh IO shader variables.
+        {
+            ShaderVarHandle vertexCount;
+            ShaderVarHandle vbOffset;
+            ShaderVarHandle triangleCount;
+            ShaderVarHandle ibOffset;
+            ShaderVarHandle use16BitIndices;
+            ShaderVarHandle vertexData;
+            ShaderVarHandle scene;
+            std::vector<ShaderVarHandle> buffers;                   ///< Mesh data buffers in the order of the required buffer names.
+        };
+        MeshIOVars mLoadMeshVars;
+        MeshIOVars mUpdateMeshVars;
 
         // Displacement mapping.
         struct
@@ -1334,9 +1427,18 @@ namespace Falcor
         std::vector<std::vector<uint32_t>> mMeshIdToInstanceIds;    ///< Mapping of what instances belong to which mesh. The instanceID are sorted in ascending order.
         std::vector<AABB> mCurveBBs;                                ///< Bounding boxes for curves (not instances) in object space.
         std::vector<std::vector<uint32_t>> mCurveIdToInstanceIds;   ///< Mapping of what instances belong to which curve.
+        std::vector<MeshletDesc> mMeshlets;                         ///< Meshlets for all meshes, ordered by mesh ID.
+        std::vector<uint32_t> mMeshletOffsets;                      ///< Offset of the first meshlet per mesh, followed by the total meshlet count.
+        std::vector<uint32_t> mMeshletVertices;                     ///< Mesh-local vertex indices for all meshlets.
+        std::vector<uint32_t> mMeshletTriangles;                    ///< Packed meshlet-local vertex indices for all meshlet triangles.
+        std::vector<MeshLodDesc> mMeshLods;                         ///< LODs for all meshes, ordered by mesh ID and from fine to coarse.
+        std::vector<uint32_t> mMeshLodOffsets;                      ///< Offset of the first LOD per mesh, followed by the total LOD count.
+        std::vector<uint32_t> mMeshLodIndices;                      ///< Mesh-local vertex indices for all LODs.
+        uint32_t mDeduplicatedMeshCount = 0;                        ///< Number of meshes merged into instances of identical meshes by the scene builder.
         HitInfo mHitInfo;                                           ///< Geometry hit info requirements.
         AABB mSceneBB;                                              ///< Bounding boxes of the entire scene in world space.
         SceneStats mSceneStats;                                     ///< Scene statistics.
+        SceneBuildReport mBuildReport;                              ///< Build statistics, set by the scene builder.
         Metadata mMetadata;                                         ///< Importer-provided metadata.
         RenderSettings mRenderSettings;                             ///< Render settings.
         RenderSettings mPrevRenderSettings;
@@ -1450,6 +1552,8 @@ namespace Falcor
         std::vector<ref<RtAccelerationStructure>> mBlasObjects; ///< BLAS API objects.
         std::vector<BlasData> mBlasData;                    ///< All data related to the scene's BLASes.
         std::vector<BlasGroup> mBlasGroups;                 ///< BLAS group data.
+        BlasBuildPlanner::Plan mBlasBuildPlan;              ///< Plan used for the last full BLAS build.
+        uint64_t mBlasBuildPeakMemory = 0;                  ///< Peak memory allocated during the last full BLAS build.
         ref<Buffer> mpBlasScratch;                          ///< Scratch buffer used for BLAS builds.
         ref<Buffer> mpBlasStaticWorldMatrices;              ///< Object-to-world transform matrices in row-major format. Only valid for static meshes.
         bool mBlasDataValid = false;                        ///< Flag to indicate if the BLAS data is valid. This will be reset when geometry is changed.
@@ -0,0 +1,158 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "SceneBuildReport.h"
+#include "Core/Error.h"
+#include "Core/Platform/OS.h"
+#include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+#include <cstdlib>
+#include <fstream>
+
+namespace Falcor
+{
+    namespace
+    {
+        std::string formatSignedByteSize(int64_t size)
+        {
+            return (size < 0 ? "-" : "+") + formatByteSize((size_t)std::abs(size));
+        }
+
+        nlohmann::json toJson(const SceneBuildReport::Stage& stage, bool hasAllocationCount)
+        {
+            return {
+                {"name", stage.name},
+                {"wallTime", stage.wallTime},
+                {"cpuTime", stage.cpuTime},
+                {"allocationCount", hasAllocationCount ? nlohmann::json(stage.allocationCount) : nlohmann::json()},
+                {"rssDelta", stage.rssDelta},
+                {"peakRSSDelta", stage.peakRSSDelta},
+            };
+        }
+    }
+
+    SceneBuildReport::SceneBuildReport()
+    {
+        reset();
+    }
+
+    void SceneBuildReport::reset()
+    {
+        mStages.clear();
+        mLastSample = sample();
+    }
+
+    void SceneBuildReport::measure(const std::string& name)
+    {
+        Sample current = sample();
+
+        Stage stage;
+        stage.name = name;
+        stage.wallTime = std::chrono::duration<double>(current.time - mLastSample.time).count();
+        stage.cpuTime = current.cpuTime - mLastSample.cpuTime;
+        stage.allocationCount = current.allocationCount - mLastSample.allocationCount;
+        stage.rssDelta = (int64_t)current.rss - (int64_t)mLastSample.rss;
+        stage.peakRSSDelta = current.peakRSS > mLastSample.peakRSS ? current.peakRSS - mLastSample.peakRSS : 0;
+        mStages.push_back(std::move(stage));
+
+        mLastSample = current;
+    }
+
+    SceneBuildReport::Stage SceneBuildReport::getTotal() const
+    {
+        Stage total;
+        total.name = "Total";
+        for (const auto& stage : mStages)
+        {
+            total.wallTime += stage.wallTime;
+            total.cpuTime += stage.cpuTime;
+            total.allocationCount += stage.allocationCount;
+            total.rssDelta += stage.rssDelta;
+            total.peakRSSDelta += stage.peakRSSDelta;
+        }
+        return total;
+    }
+
+    bool SceneBuildReport::isAllocationTrackingEnabled()
+    {
+        return FALCOR_ENABLE_ALLOCATION_TRACKING != 0;
+    }
+
+    void SceneBuildReport::printToLog() const
+    {
+        const Stage total = getTotal();
+        auto print = [&](const Stage& stage)
+        {
+            std::string line = fmt::format("{} {:.3f} s", padStringToLength(stage.name + ":", 25), stage.wallTime);
+            if (total.wallTime > 0.0) line += fmt::format(" ({:.1f}%)", 100.0 * stage.wallTime / total.wallTime);
+            line += fmt::format(", cpu {:.3f} s, rss {}, peak rss +{}", stage.cpuTime, formatSignedByteSize(stage.rssDelta), formatByteSize(stage.peakRSSDelta));
+            if (isAllocationTrackingEnabled()) line += fmt::format(", {} allocations", stage.allocationCount);
+            logInfo(line);
+        };
+
+        for (const auto& stage : mStages) print(stage);
+        print(total);
+    }
+
+    std::string SceneBuildReport::toJsonString() const
+    {
+        const bool hasAllocationCount = isAllocationTrackingEnabled();
+
+        nlohmann::json stages = nlohmann::json::array();
+        for (const auto& stage : mStages) stages.push_back(toJson(stage, hasAllocationCount));
+
+        nlohmann::json report = {
+            {"scene", mScenePath.string()},
+            {"allocationTracking", hasAllocationCount},
+            {"peakRSS", mLastSample.peakRSS},
+            {"stages", std::move(stages)},
+            {"total", toJson(getTotal(), hasAllocationCount)},
+        };
+        return report.dump(4);
+    }
+
+    void SceneBuildReport::writeToFile(const std::filesystem::path& path) const
+    {
+        auto json = toJsonString();
+        std::ofstream ofs(path);
+        if (!ofs) FALCOR_THROW("Failed to write scene build report to '{}'.", path);
+        ofs.write(json.data(), json.size());
+    }
+
+    SceneBuildReport::Sample SceneBuildReport::sample()
+    {
+        Sample s;
+        s.time = CpuTimer::getCurrentTimePoint();
+        s.cpuTime = getProcessCpuTime();
+        s.rss = getCurrentRSS();
+        s.peakRSS = getPeakRSS();
+        s.allocationCount = getAllocationCount();
+        return s;
+    }
+}
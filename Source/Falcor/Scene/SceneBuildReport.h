@@ -0,0 +1,117 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+namespace Falcor
+{
+    /** Records CPU time and memory statistics for the stages of a scene build.
+        Each call to measure() records the statistics since the previous call, similar to TimeReport.
+        Allocation counts are only available if Falcor is built with FALCOR_ENABLE_ALLOCATION_TRACKING.
+    */
+    class FALCOR_API SceneBuildReport
+    {
+    public:
+        struct Stage
+        {
+            std::string name;               ///< Stage name.
+            double wallTime = 0.0;          ///< Elapsed wall-clock time in seconds.
+            double cpuTime = 0.0;           ///< CPU time consumed by all threads of the process in seconds.
+            uint64_t allocationCount = 0;   ///< Number of heap allocations.
+            int64_t rssDelta = 0;           ///< Change of the resident set size in bytes.
+            uint64_t peakRSSDelta = 0;      ///< Increase of the peak resident set size in bytes.
+        };
+
+        SceneBuildReport();
+
+        /** Clear the recorded stages and restart measuring.
+        */
+        void reset();
+
+        /** Record a stage. Measures the statistics since the last call to reset() or measure().
+            \param[in] name Name of the stage.
+        */
+        void measure(const std::string& name);
+
+        /** Get the recorded stages in order.
+        */
+        const std::vector<Stage>& getStages() const { return mStages; }
+
+        /** Get the sum over all recorded stages.
+        */
+        Stage getTotal() const;
+
+        /** Get the scene path.
+        */
+        const std::filesystem::path& getScenePath() const { return mScenePath; }
+
+        /** Set the scene path included in the report.
+        */
+        void setScenePath(const std::filesystem::path& path) { mScenePath = path; }
+
+        /** Check if allocation counts are recorded.
+        */
+        static bool isAllocationTrackingEnabled();
+
+        /** Print the recorded stages to the log.
+        */
+        void printToLog() const;
+
+        /** Serialize the report to JSON.
+            The report contains the scene path, the peak resident set size at the end of the build,
+            the list of stages and their total. Allocation counts are null if not recorded.
+        */
+        std::string toJsonString() const;
+
+        /** Write the report as JSON to a file.
+            \param[in] path File path.
+        */
+        void writeToFile(const std::filesystem::path& path) const;
+
+    private:
+        struct Sample
+        {
+            CpuTimer::TimePoint time;
+            double cpuTime = 0.0;
+            uint64_t allocationCount = 0;
+            uint64_t rss = 0;
+            uint64_t peakRSS = 0;
+        };
+
+        static Sample sample();
+
+        std::filesystem::path mScenePath;
+        Sample mLastSample;
+        std::vector<Stage> mStages;
+    };
+}
@@ -27,20 +27,28 @@
  **************************************************************************/
 #include "SceneBuilder.h"
 #include "SceneCache.h"
+#include "MeshDeduplicator.h"
+#include "MeshLayoutOptimizer.h"
+#include "MeshletBuilder.h"
+#include "MeshSimplifier.h"
 #include "Importer.h"
 #include "Curves/CurveConfig.h"
 #include "Material/StandardMaterial.h"
 #include "Utils/Logger.h"
+#include "Utils/StringUtils.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Image/TextureAnalyzer.h"
-#include "Utils/Timing/TimeReport.h"
+#include "Utils/Timing/CpuEventRecorder.h"
 #include "Utils/Scripting/ScriptBindings.h"
 #include "Utils/Math/MathHelpers.h"
+#include "Utils/Math/FNVHash.h"
 #include "Utils/ObjectIDPython.h"
 #include "Utils/NumericRange.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
 #include <mikktspace.h>
 #include <filesystem>
 #include <cmath>
+#include <cstring>
 #include <execution>
 
 namespace Falcor
@@ -55,6 +63,9 @@ namespace Falcor
         // We'll log a warning if the maximum quantization error exceeds this value.
         const float kMaxTexelError = 0.5f;
 
+        // Static meshes with at least this many vertices are pre-transformed in parallel over their vertices.
+        const size_t kMinParallelPretransformVertexCount = 1ull << 16;
+
         int largestAxis(const float3& v)
         {
             if (v.x >= v.y && v.x >= v.z) return 0;
@@ -209,6 +220,7 @@ namespace Falcor
         , mFlags(flags)
     {
         mAssetResolver = AssetResolver::getDefaultResolver();
+        mAssetResolver.setResolveCallback([this](const std::filesystem::path& path) { addDependency(path); });
         mSceneData.pMaterials = std::make_unique<MaterialSystem>(mpDevice);
     }
 
@@ -230,11 +242,26 @@ namespace Falcor
         mWriteSceneCache = useCache || rebuildCache;
 
         // Try to load scene cache if supported, available and requested.
-        if (useCache && !rebuildCache && SceneCache::hasValidCache(mSceneCacheKey))
+        // Headless builds always import the scene, as the cache can only be loaded with a device.
+        if (pDevice && useCache && !rebuildCache && SceneCache::hasValidCache(mSceneCacheKey))
         {
             try
             {
-                mpScene = Scene::create(pDevice, SceneCache::readCache(pDevice, mSceneCacheKey));
+                mBuildReport.setScenePath(resolvedPath);
+                auto sceneData = SceneCache::readCache(pDevice, mSceneCacheKey);
+                mBuildReport.measure("Read scene cache");
+                // Caches written by headless builds have unoptimized materials, as the texture analysis needs a device.
+                // Duplicate materials resulting from the optimization are not merged, as that would require remapping the mesh data.
+                if (sceneData.deferMaterialOptimization)
+                {
+                    sceneData.pMaterials->optimizeMaterials();
+                    sceneData.deferMaterialOptimization = false;
+                    mBuildReport.measure("Optimize materials");
+                }
+                mpScene = Scene::create(pDevice, std::move(sceneData));
+                mBuildReport.measure("Create scene resources");
+                mBuildReport.printToLog();
+                mpScene->mBuildReport = mBuildReport;
                 return;
             }
             catch (const std::exception& e)
@@ -271,6 +298,7 @@ namespace Falcor
 
     void SceneBuilder::import(const std::filesystem::path& path, const pybind11::dict& dict)
     {
+        FALCOR_PROFILE_CPU("SceneBuilder::import");
         logInfo("Importing scene: {}", path);
         std::map<std::string, std::string> materialToShortName = convertDictToMap(dict);
 
@@ -319,10 +347,63 @@ namespace Falcor
         mAssetResolverStack.pop_back();
     }
 
+    void SceneBuilder::addDependency(const std::filesystem::path& path)
+    {
+        std::error_code ec;
+        if (!std::filesystem::is_regular_file(path, ec)) return;
+        auto absolutePath = std::filesystem::absolute(path, ec);
+        if (!ec) mDependencies.insert(absolutePath);
+    }
+
     ref<Scene> SceneBuilder::getScene()
     {
         if (mpScene) return mpScene;
 
+        FALCOR_CHECK(mpDevice, "Can't create a scene without a GPU device. Use writeSceneCache() to finish a headless build.");
+
+        FALCOR_PROFILE_CPU("SceneBuilder::getScene");
+
+        buildSceneData();
+
+        // Write scene cache if requested.
+        if (mWriteSceneCache) writeSceneCacheFile();
+
+        // Create the scene object.
+        mpScene = Scene::create(mpDevice, std::move(mSceneData));
+        mSceneData = {};
+
+        mBuildReport.measure("Create scene resources");
+        mBuildReport.printToLog();
+        mpScene->mBuildReport = mBuildReport;
+
+        return mpScene;
+    }
+
+    std::filesystem::path SceneBuilder::writeSceneCache()
+    {
+        FALCOR_CHECK(!mpScene, "Scene was already created.");
+        FALCOR_CHECK(!mSceneData.path.empty(), "Scene cache can only be written for scenes imported from a file.");
+
+        FALCOR_PROFILE_CPU("SceneBuilder::writeSceneCache");
+
+        buildSceneData();
+        auto cachePath = writeSceneCacheFile();
+
+        mBuildReport.printToLog();
+
+        return cachePath;
+    }
+
+    void SceneBuilder::buildSceneData()
+    {
+        // The build stages transform the builder state in place and can only run once.
+        FALCOR_CHECK(!mSceneDataBuilt, "Scene data was already built.");
+        mSceneDataBuilt = true;
+
+        // Everything since the builder was created is accounted to the import.
+        mBuildReport.setScenePath(mSceneData.path);
+        mBuildReport.measure("Import");
+
         // Finish loading textures. This blocks until all textures are loaded and assigned.
         mpMaterialTextureLoader.reset();
 
@@ -341,42 +422,48 @@ namespace Falcor
         }
 
         // Post-process the scene data.
-        TimeReport timeReport;
+        // Each stage is measured separately (time and memory) and reported in the log and build report
+        // to show which stages dominate the build.
+        auto runStage = [&](const char* name, void (SceneBuilder::*stage)())
+        {
+            (this->*stage)();
+            mBuildReport.measure(name);
+        };
 
         // Prepare displacement maps. This either removes them (if requested in build flags)
         // or makes sure that normal maps are removed if displacement is in use.
-        prepareDisplacementMaps();
-
-        prepareSceneGraph();
-        prepareMeshes();
-        removeUnusedMeshes();
-        flattenStaticMeshInstances();
-        pretransformStaticMeshes();
-        unifyTriangleWinding();
-        optimizeSceneGraph();
-        calculateMeshBoundingBoxes();
-        createMeshGroups();
-        optimizeGeometry();
-        sortMeshes();
-        createGlobalBuffers();
-        createCurveGlobalBuffers();
-        collectVolumeGrids();
-        removeDuplicateSDFGrids();
-
-        timeReport.measure("Post processing geometry");
-
-        optimizeMaterials();
-        removeDuplicateMaterials();
-        quantizeTexCoords();
-
-        timeReport.measure("Optimizing materials");
+        runStage("Displacement maps", &SceneBuilder::prepareDisplacementMaps);
+
+        runStage("Prepare scene graph", &SceneBuilder::prepareSceneGraph);
+        runStage("Prepare meshes", &SceneBuilder::prepareMeshes);
+        runStage("Remove unused meshes", &SceneBuilder::removeUnusedMeshes);
+        runStage("Deduplicate meshes", &SceneBuilder::deduplicateMeshes);
+        runStage("Flatten instances", &SceneBuilder::flattenStaticMeshInstances);
+        runStage("Pretransform meshes", &SceneBuilder::pretransformStaticMeshes);
+        runStage("Unify triangle winding", &SceneBuilder::unifyTriangleWinding);
+        runStage("Optimize scene graph", &SceneBuilder::optimizeSceneGraph);
+        runStage("Mesh bounding boxes", &SceneBuilder::calculateMeshBoundingBoxes);
+        runStage("Create mesh groups", &SceneBuilder::createMeshGroups);
+        runStage("Optimize geometry", &SceneBuilder::optimizeGeometry);
+        runStage("Optimize mesh layout", &SceneBuilder::optimizeMeshLayout);
+        runStage("Sort meshes", &SceneBuilder::sortMeshes);
+        runStage("Create meshlets", &SceneBuilder::createMeshlets);
+        runStage("Create mesh LODs", &SceneBuilder::createMeshLods);
+        runStage("Global buffers", &SceneBuilder::createGlobalBuffers);
+        runStage("Curve global buffers", &SceneBuilder::createCurveGlobalBuffers);
+        runStage("Collect volume grids", &SceneBuilder::collectVolumeGrids);
+        runStage("Remove duplicate SDFs", &SceneBuilder::removeDuplicateSDFGrids);
+
+        runStage("Optimize materials", &SceneBuilder::optimizeMaterials);
+        runStage("Remove dup. materials", &SceneBuilder::removeDuplicateMaterials);
+        runStage("Quantize tex coords", &SceneBuilder::quantizeTexCoords);
 
         // Prepare scene resources.
-        createSceneGraph();
-        createMeshData();
-        createMeshBoundingBoxes();
-        createCurveData();
-        calculateCurveBoundingBoxes();
+        runStage("Create scene graph", &SceneBuilder::createSceneGraph);
+        runStage("Create mesh data", &SceneBuilder::createMeshData);
+        runStage("Mesh GPU bounding boxes", &SceneBuilder::createMeshBoundingBoxes);
+        runStage("Create curve data", &SceneBuilder::createCurveData);
+        runStage("Curve bounding boxes", &SceneBuilder::calculateCurveBoundingBoxes);
 
         // Create instance data.
         uint32_t tlasInstanceIndex = 0;
@@ -385,23 +472,22 @@ namespace Falcor
         // Adjust instance indices of SDF grid instances.
         for (auto& sdfInstanceData : mSceneData.sdfGridInstances) sdfInstanceData.instanceIndex = tlasInstanceIndex++;
 
-        mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
+        mBuildReport.measure("Create instance data");
 
-        // Write scene cache if requested.
-        if (mWriteSceneCache)
-        {
-            SceneCache::writeCache(mSceneData, mSceneCacheKey);
-            timeReport.measure("Writing cache");
-        }
+        mSceneData.useCompressedHitInfo = is_set(mFlags, Flags::UseCompressedHitInfo);
+    }
 
-        // Create the scene object.
-        mpScene = Scene::create(mpDevice, std::move(mSceneData));
-        mSceneData = {};
+    std::filesystem::path SceneBuilder::writeSceneCacheFile()
+    {
+        // Compute the key here, as the scene may have been imported after construction.
+        mSceneCacheKey = computeSceneCacheKey(mSceneData.path, mFlags);
 
-        timeReport.measure("Creating resources");
-        timeReport.printToLog();
+        auto dependencies = SceneCache::collectDependencies({mDependencies.begin(), mDependencies.end()});
+        mBuildReport.measure("Hash cache dependencies");
+        SceneCache::writeCache(mSceneData, mSceneCacheKey, dependencies);
+        mBuildReport.measure("Write scene cache");
 
-        return mpScene;
+        return SceneCache::getCachePath(mSceneCacheKey);
     }
 
     // Meshes
@@ -455,6 +541,8 @@ namespace Falcor
         //  - Validate final vertex data
         //  - Compact vertices/indices into runtime format
 
+        FALCOR_PROFILE_CPU("SceneBuilder::processMesh");
+
         // Copy the mesh desc so we can update it. The caller retains the ownership of the data.
         Mesh mesh = mesh_;
         ProcessedMesh processedMesh;
@@ -936,11 +1024,19 @@ namespace Falcor
     void SceneBuilder::loadMaterialTexture(const ref<Material>& pMaterial, Material::TextureSlot slot, const std::filesystem::path& path)
     {
         FALCOR_CHECK(pMaterial != nullptr, "'pMaterial' is missing");
+        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
+
+        // Headless builds only record the texture path, the texture is loaded when the scene cache is read.
+        if (!mpDevice)
+        {
+            pMaterial->setTextureSourcePath(slot, resolvedPath);
+            return;
+        }
+
         if (!mpMaterialTextureLoader)
         {
             mpMaterialTextureLoader.reset(new MaterialTextureLoader(mSceneData.pMaterials->getTextureManager(), !is_set(mFlags, Flags::AssumeLinearSpaceTextures)));
         }
-        std::filesystem::path resolvedPath = mAssetResolver.resolvePath(path);
         mpMaterialTextureLoader->loadTexture(pMaterial, slot, resolvedPath);
     }
 
@@ -997,6 +1093,7 @@ namespace Falcor
 
     void SceneBuilder::loadLightProfile(const std::string& filename, bool normalize)
     {
+        FALCOR_CHECK(mpDevice, "Light profiles are not supported in headless builds.");
         mSceneData.pLightProfile = LightProfile::createFromIesProfile(mpDevice, mAssetResolver.resolvePath(std::filesystem::path(filename)), normalize);
     }
 
@@ -1166,6 +1263,52 @@ namespace Falcor
 
     // Internal
 
+    std::vector<bool> SceneBuilder::computeAnimatedNodes(bool includeParents) const
+    {
+        // Flags the nodes that have an animation, and optionally the nodes with an animated parent node.
+        // This replaces per-node calls to doesNodeHaveAnimation() and isNodeAnimated() in the build passes.
+        std::vector<bool> animated(mSceneGraph.size(), false);
+        for (const auto& pAnimation : mSceneData.animations)
+        {
+            NodeID nodeID = pAnimation->getNodeID();
+            if (nodeID != NodeID::Invalid() && nodeID.get() < animated.size()) animated[nodeID.get()] = true;
+        }
+
+        // Parent nodes always have lower IDs than their children, so a single pass propagates the flags.
+        if (includeParents)
+        {
+            for (size_t i = 0; i < mSceneGraph.size(); ++i)
+            {
+                NodeID parentID = mSceneGraph[i].parent;
+                FALCOR_ASSERT(parentID == NodeID::Invalid() || parentID.get() < i);
+                if (parentID != NodeID::Invalid() && animated[parentID.get()]) animated[i] = true;
+            }
+        }
+
+        return animated;
+    }
+
+    std::vector<float4x4> SceneBuilder::computeGlobalTransforms() const
+    {
+        // Computes the object->world transform of all nodes in a single pass,
+        // relying on parent nodes always having lower IDs than their children.
+        std::vector<float4x4> globalTransforms(mSceneGraph.size());
+        for (size_t i = 0; i < mSceneGraph.size(); ++i)
+        {
+            const auto& node = mSceneGraph[i];
+            if (node.parent != NodeID::Invalid())
+            {
+                FALCOR_ASSERT(node.parent.get() < i);
+                globalTransforms[i] = mul(globalTransforms[node.parent.get()], node.transform);
+            }
+            else
+            {
+                globalTransforms[i] = node.transform;
+            }
+        }
+        return globalTransforms;
+    }
+
     void SceneBuilder::updateLinkedObjects(NodeID nodeID, NodeID newNodeID)
     {
         // Helper function to update all objects linked from a node to point to newNodeID.
@@ -1207,57 +1350,26 @@ namespace Falcor
         }
     }
 
-    bool SceneBuilder::collapseNodes(NodeID parentNodeID, NodeID childNodeID)
+    size_t SceneBuilder::collapseNodes(NodeID parentNodeID, NodeID childNodeID, const float4x4& transform)
     {
-        // Collapses the nodes from parent...child node into the parent node if possible.
-        // The transform of the parent node is updated to account for the combined transform.
-        // The prerequisite for this is that the parent..child-1 nodes have no other children and that
-        // all the nodes are static. The function returns false if the necessary conditions are not met.
-
-        // Check that nodes are valid.
-        if (parentNodeID == NodeID::Invalid() || childNodeID == NodeID::Invalid()) return false;
-        FALCOR_ASSERT(parentNodeID.get() < mSceneGraph.size() && childNodeID.get() < mSceneGraph.size());
-
-        if (mSceneGraph[parentNodeID.get()].dontOptimize || mSceneGraph[childNodeID.get()].dontOptimize) return false;
-        if (doesNodeHaveAnimation(childNodeID)) return false;
-
-        // Compute the combined transform.
-        auto& child = mSceneGraph[childNodeID.get()];
-        float4x4 transform = child.transform;
-        NodeID prevNodeID = childNodeID;
-        NodeID nodeID = child.parent;
-
-        while (nodeID != NodeID::Invalid())
-        {
-            FALCOR_ASSERT(nodeID.get() < mSceneGraph.size());
-            const auto& node = mSceneGraph[nodeID.get()];
-
-            // Check that node is a static interior node with a single child.
-            if (node.children.size() > 1 ||
-                node.hasObjects() ||
-                doesNodeHaveAnimation(nodeID) ||
-                mSceneGraph[nodeID.get()].dontOptimize) return false;
-
-            FALCOR_ASSERT(node.children.size() == 1);
-            FALCOR_ASSERT(node.children[0] == prevNodeID);
-
-            // Update the transform and step to the parent.
-            transform = mul(node.transform, transform);
+        // Collapses the nodes from parent...child node into the parent node.
+        // The parent node takes over the child's data and holds the given combined transform.
+        // The prerequisite for this is that the parent..child-1 nodes are static nodes with no other children
+        // and no attached objects, and that the child node is static. This is checked by the caller.
+        // The function returns the number of removed nodes.
 
-            if (nodeID == parentNodeID) break;
-            prevNodeID = nodeID;
-            nodeID = mSceneGraph[nodeID.get()].parent;
-        }
-
-        if (nodeID == NodeID::Invalid()) return false; // We didn't find the parent.
+        FALCOR_ASSERT(parentNodeID != NodeID::Invalid() && childNodeID != NodeID::Invalid());
+        FALCOR_ASSERT(parentNodeID.get() < childNodeID.get() && childNodeID.get() < mSceneGraph.size());
 
         // Update all linked objects to point to the new parent node.
         updateLinkedObjects(childNodeID, parentNodeID);
 
         // Update the parent node to the child's data.
         // The new parent node will hold the combined transform.
+        auto& child = mSceneGraph[childNodeID.get()];
         auto& parent = mSceneGraph[parentNodeID.get()];
         auto oldParentID = parent.parent;
+        NodeID nodeID = child.parent;
 
         parent = std::move(child);
         parent.parent = oldParentID;
@@ -1265,15 +1377,19 @@ namespace Falcor
 
         // Reset the now unused nodes below the parent to a valid empty state.
         // TODO: Run a separate optimization pass to compact the node list.
-        nodeID = childNodeID;
+        child = InternalNode();
+        size_t removedNodes = 1;
         while (nodeID != parentNodeID)
         {
+            FALCOR_ASSERT(nodeID != NodeID::Invalid());
             auto& node = mSceneGraph[nodeID.get()];
+            FALCOR_ASSERT(node.children.size() == 1 && !node.hasObjects());
             nodeID = node.parent;
             node = InternalNode();
+            removedNodes++;
         }
 
-        return true;
+        return removedNodes;
     }
 
     bool SceneBuilder::mergeNodes(NodeID dstNodeID, NodeID srcNodeID)
@@ -1317,7 +1433,7 @@ namespace Falcor
     {
         for (const auto& pMaterial : mSceneData.pMaterials->getMaterials())
         {
-            if (pMaterial->getTexture(Material::TextureSlot::Displacement) != nullptr)
+            if (pMaterial->hasTextureSlotData(Material::TextureSlot::Displacement))
             {
                 // Remove displacement maps if requested by scene flags.
                 if (is_set(mFlags, Flags::DontUseDisplacement))
@@ -1410,52 +1526,253 @@ namespace Falcor
         if (unusedCount > 0)
         {
             logWarning("Scene has {} unused meshes that will be removed.", unusedCount);
+            size_t removedCount = removeMeshesWithoutInstances();
+            FALCOR_ASSERT(removedCount == unusedCount);
+        }
+    }
 
-            const size_t meshCount = mMeshes.size();
-            MeshList meshes;
-            meshes.reserve(meshCount);
+    size_t SceneBuilder::removeMeshesWithoutInstances()
+    {
+        // Compact the mesh list and build a table mapping old to new mesh IDs.
+        const size_t meshCount = mMeshes.size();
+        MeshList meshes;
+        meshes.reserve(meshCount);
+        std::vector<MeshID> meshIDMap(meshCount, MeshID::Invalid());
 
-            for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)meshCount; ++meshID)
+        {
+            auto& mesh = mMeshes[meshID.get()];
+            if (mesh.instances.empty()) continue; // Skip unused meshes
+
+            meshIDMap[meshID.get()] = MeshID(meshes.size());
+            meshes.push_back(std::move(mesh));
+        }
+
+        const size_t removedCount = meshCount - meshes.size();
+        if (removedCount == 0) return 0;
+        mMeshes = std::move(meshes);
+
+        // Update the mesh IDs in the scene graph nodes.
+        // Unused meshes are not referenced by any nodes, so all referenced IDs map to valid new IDs.
+        parallel::forEach(mSceneGraph.size(), [&](size_t i)
+        {
+            for (MeshID& meshID : mSceneGraph[i].meshes) meshID = meshIDMap[meshID.get()];
+        });
+
+        // Update the mesh IDs of cached meshes. IDs of removed meshes are left unchanged.
+        auto remapMeshID = [&](MeshID meshID)
+        {
+            return meshID.get() < meshCount && meshIDMap[meshID.get()].isValid() ? meshIDMap[meshID.get()] : meshID;
+        };
+        for (auto& cachedMesh : mSceneData.cachedMeshes)
+        {
+            cachedMesh.meshID = remapMeshID(cachedMesh.meshID);
+        }
+        for (auto& cache : mSceneData.cachedCurves)
+        {
+            if (cache.tessellationMode != CurveTessellationMode::LinearSweptSphere)
             {
-                auto& mesh = mMeshes[meshID.get()];
-                if (mesh.instances.empty()) continue; // Skip unused meshes
+                cache.geometryID = CurveOrMeshID{ remapMeshID(MeshID{ cache.geometryID }) };
+            }
+        }
 
-                // Get new mesh ID.
-                const MeshID newMeshID(meshes.size());
+        // Validate scene graph.
+        for (const auto& node : mSceneGraph)
+        {
+            for (MeshID meshID : node.meshes) FALCOR_ASSERT_LT(meshID.get(), mMeshes.size());
+        }
 
-                // Update the mesh IDs in the scene graph nodes.
-                for (const auto& nodeID : mesh.instances)
-                {
-                    FALCOR_ASSERT(nodeID.get() < mSceneGraph.size());
-                    auto& node = mSceneGraph[nodeID.get()];
-                    std::replace(node.meshes.begin(), node.meshes.end(), meshID, newMeshID);
-                }
+        return removedCount;
+    }
+
+    void SceneBuilder::deduplicateMeshes()
+    {
+        // This function optionally merges static meshes with identical content into instances of a single mesh.
+        // Importers often emit duplicated meshes under different nodes, which would otherwise be treated as
+        // separate non-instanced meshes and pretransformed into the static BLAS. With rigid matching, meshes
+        // whose vertices differ by a rigid transform are merged too, and the transform is applied by new nodes.
+
+        const bool rigid = is_set(mFlags, Flags::DeduplicateMeshesRigid);
+        if (!is_set(mFlags, Flags::DeduplicateMeshes) && !rigid)
+        {
+            return;
+        }
+
+        const size_t meshCount = mMeshes.size();
 
-                // Update the mesh IDs of cached meshes.
-                for (auto &cachedMesh : mSceneData.cachedMeshes)
+        // Dynamic meshes are excluded as their vertices are modified at runtime.
+        auto isCandidate = [&](const MeshSpec& mesh) { return !mesh.isDynamic() && !mesh.instances.empty(); };
+
+        auto getPositions = [&](const MeshSpec& mesh)
+        {
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t i = 0; i < positions.size(); i++) positions[i] = mesh.staticData[i].position;
+            return positions;
+        };
+
+        // Hash all properties that must match exactly. Vertex positions, normals and tangents are included only for exact matching.
+        // For rigid matching, rotation invariant features of the positions are hashed instead, so that meshes that only share
+        // their topology and texture coordinates (e.g. terrain tiles) don't all land in one bucket.
+        auto hashMesh = [&](const MeshSpec& mesh, bool includeFrame)
+        {
+            FNVHash64 hash;
+            auto insert = [&](const auto& value) { hash.insert(&value, sizeof(value)); };
+            insert(mesh.topology);
+            insert(mesh.materialId);
+            insert(mesh.isFrontFaceCW);
+            insert(mesh.use16BitIndices);
+            insert(mesh.indexCount);
+            insert(mesh.vertexCount);
+            hash.insert(mesh.indexData.data(), mesh.indexData.size() * sizeof(uint32_t));
+            if (includeFrame)
+            {
+                hash.insert(mesh.staticData.data(), mesh.staticData.size() * sizeof(StaticVertexData));
+            }
+            else
+            {
+                for (const auto& v : mesh.staticData)
                 {
-                    if (cachedMesh.meshID == meshID) cachedMesh.meshID = newMeshID;
+                    insert(v.texCrd);
+                    insert(v.tangent.w);
+                    insert(v.curveRadius);
                 }
-                for (auto& cache : mSceneData.cachedCurves)
+                insert(MeshDeduplicator::computeRigidInvariantHash(getPositions(mesh)));
+            }
+            return hash.get();
+        };
+
+        auto isSameTopology = [&](const MeshSpec& a, const MeshSpec& b)
+        {
+            return a.topology == b.topology && a.materialId == b.materialId && a.isFrontFaceCW == b.isFrontFaceCW &&
+                a.use16BitIndices == b.use16BitIndices && a.indexCount == b.indexCount && a.vertexCount == b.vertexCount &&
+                a.indexData == b.indexData && a.staticData.size() == b.staticData.size();
+        };
+
+        // Find classes of duplicate meshes. Non-candidates get distinct hashes and are rejected if they collide with a candidate.
+        auto findDuplicates = [&](bool includeFrame, const std::function<bool(uint32_t, uint32_t)>& isDuplicate)
+        {
+            std::vector<uint64_t> hashes(meshCount);
+            NumericRange<uint32_t> range(0, (uint32_t)meshCount);
+            std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t i)
+            {
+                const auto& mesh = mMeshes[i];
+                hashes[i] = isCandidate(mesh) ? hashMesh(mesh, includeFrame) : std::numeric_limits<uint64_t>::max() - i;
+            });
+            return MeshDeduplicator::findDuplicates(hashes, [&](uint32_t a, uint32_t b)
+            {
+                return isCandidate(mMeshes[a]) && isCandidate(mMeshes[b]) && isDuplicate(a, b);
+            });
+        };
+
+        // Merge meshes that are exact duplicates by replacing them in the nodes that instantiate them.
+        size_t exactCount = 0;
+        {
+            auto classes = findDuplicates(true, [&](uint32_t a, uint32_t b)
+            {
+                const auto& meshA = mMeshes[a];
+                const auto& meshB = mMeshes[b];
+                return isSameTopology(meshA, meshB) &&
+                    std::memcmp(meshA.staticData.data(), meshB.staticData.data(), meshA.staticData.size() * sizeof(StaticVertexData)) == 0;
+            });
+
+            for (uint32_t i = 0; i < meshCount; i++)
+            {
+                if (classes[i] == i) continue;
+                const MeshID meshID{ classes[i] };
+                auto& mesh = mMeshes[i];
+                auto& target = mMeshes[meshID.get()];
+
+                std::set<NodeID> remainingInstances;
+                for (NodeID nodeID : mesh.instances)
                 {
-                    if (cache.tessellationMode != CurveTessellationMode::LinearSweptSphere)
+                    auto& node = mSceneGraph[nodeID.get()];
+                    // A node can't reference the same mesh twice, so keep duplicates that overlap within a node.
+                    if (std::find(node.meshes.begin(), node.meshes.end(), meshID) != node.meshes.end())
                     {
-                        if (cache.geometryID == CurveOrMeshID{ meshID }) cache.geometryID = CurveOrMeshID{ newMeshID };
+                        remainingInstances.insert(nodeID);
+                        continue;
                     }
+                    std::replace(node.meshes.begin(), node.meshes.end(), MeshID{ i }, meshID);
+                    target.instances.insert(nodeID);
+                }
+                mesh.instances = std::move(remainingInstances);
+                if (mesh.instances.empty())
+                {
+                    logDebug("Mesh '{}' is a duplicate of mesh '{}'.", mesh.name, target.name);
+                    exactCount++;
                 }
-
-                meshes.push_back(std::move(mesh));
             }
+        }
+
+        // Merge meshes that are duplicates up to a rigid transform.
+        // The mesh is replaced by a new child node with the transform in each node that instantiates it.
+        size_t rigidCount = 0;
+        if (rigid)
+        {
+            std::vector<float4x4> transforms(meshCount);
+            auto classes = findDuplicates(false, [&](uint32_t a, uint32_t b)
+            {
+                const auto& meshA = mMeshes[a];
+                const auto& meshB = mMeshes[b];
+                if (!isSameTopology(meshA, meshB)) return false;
+
+                // The positions must match within a small tolerance relative to the mesh size.
+                const auto positionsA = getPositions(meshA);
+                AABB bounds;
+                for (const auto& p : positionsA) bounds.include(p);
+                const float tolerance = 1e-4f * length(bounds.extent());
+
+                float4x4 transform;
+                if (!MeshDeduplicator::findRigidTransform(positionsA, getPositions(meshB), tolerance, transform)) return false;
+
+                // Normals and tangents are rotated with the mesh, and the remaining attributes must match exactly.
+                const float3x3 rotation(transform);
+                for (size_t i = 0; i < meshA.staticData.size(); i++)
+                {
+                    const auto& va = meshA.staticData[i];
+                    const auto& vb = meshB.staticData[i];
+                    if (any(va.texCrd != vb.texCrd) || va.tangent.w != vb.tangent.w || va.curveRadius != vb.curveRadius) return false;
+                    if (length(mul(rotation, va.normal) - vb.normal) > 1e-3f) return false;
+                    if (length(mul(rotation, va.tangent.xyz()) - vb.tangent.xyz()) > 1e-3f) return false;
+                }
 
-            mMeshes = std::move(meshes);
+                // Each mesh is compared against the first mesh of each class until a match is found, so this is the final transform.
+                transforms[b] = transform;
+                return true;
+            });
 
-            // Validate scene graph.
-            FALCOR_ASSERT(mMeshes.size() == meshCount - unusedCount);
-            for (const auto& node : mSceneGraph)
+            for (uint32_t i = 0; i < meshCount; i++)
             {
-                for (MeshID meshID : node.meshes) FALCOR_ASSERT_LT(meshID.get(), mMeshes.size());
+                if (classes[i] == i) continue;
+                const MeshID meshID{ classes[i] };
+
+                // Copy the instance list, as adding nodes may invalidate references to the scene graph.
+                const std::set<NodeID> instances = std::move(mMeshes[i].instances);
+                mMeshes[i].instances.clear();
+                for (NodeID nodeID : instances)
+                {
+                    auto& meshes = mSceneGraph[nodeID.get()].meshes;
+                    meshes.erase(std::remove(meshes.begin(), meshes.end(), MeshID{ i }), meshes.end());
+
+                    NodeID newNodeID = addNode(Node{ mMeshes[i].name, transforms[i], float4x4::identity(), float4x4::identity(), nodeID });
+                    mSceneGraph[newNodeID.get()].meshes.push_back(meshID);
+                    mMeshes[meshID.get()].instances.insert(newNodeID);
+                }
+                logDebug("Mesh '{}' is a transformed duplicate of mesh '{}'.", mMeshes[i].name, mMeshes[meshID.get()].name);
+                rigidCount++;
             }
         }
+
+        // Remove the merged meshes.
+        const size_t removedCount = removeMeshesWithoutInstances();
+        FALCOR_ASSERT(removedCount == exactCount + rigidCount);
+        mSceneData.deduplicatedMeshCount = (uint32_t)removedCount;
+
+        if (removedCount > 0)
+        {
+            logInfo("Merged {} duplicate meshes ({} exact, {} transformed) into instances. Mesh count reduced from {} to {} (ratio {:.2f}).",
+                removedCount, exactCount, rigidCount, meshCount, mMeshes.size(), (float)meshCount / mMeshes.size());
+        }
     }
 
     void SceneBuilder::flattenStaticMeshInstances()
@@ -1469,6 +1786,10 @@ namespace Falcor
             return;
         }
 
+        // Nodes added below are top-level nodes, so the transforms and animation flags of the existing nodes stay valid.
+        const std::vector<float4x4> globalTransforms = computeGlobalTransforms();
+        const std::vector<bool> animatedNodes = computeAnimatedNodes(true);
+
         size_t flattenedInstanceCount = 0;
         std::vector<MeshSpec> newMeshes;
 
@@ -1491,7 +1812,7 @@ namespace Falcor
             {
                 NodeID nodeID = *instIter;
                 // Skip animated/skinned instances.
-                if (isNodeAnimated(nodeID))
+                if (animatedNodes[nodeID.get()])
                 {
                     // Keep this instance by inserting it into the new set
                     newInstances.insert(nodeID);
@@ -1516,18 +1837,10 @@ namespace Falcor
                     newMesh = &meshCopy;
                 }
 
-                // Compute the object->world transform for the node.
+                // Get the object->world transform for the node.
                 FALCOR_ASSERT(nodeID != NodeID::Invalid());
-
-                float4x4 transform = float4x4::identity();
-                NodeID curID = nodeID;
-                while (curID != NodeID::Invalid())
-                {
-                    FALCOR_ASSERT_LT(curID.get(), mSceneGraph.size());
-                    transform = mul(mSceneGraph[curID.get()].transform, transform);
-
-                    curID = mSceneGraph[curID.get()].parent;
-                }
+                FALCOR_ASSERT_LT(nodeID.get(), globalTransforms.size());
+                const float4x4 transform = globalTransforms[nodeID.get()];
 
                 flattenedInstanceCount++;
 
@@ -1583,22 +1896,63 @@ namespace Falcor
     void SceneBuilder::optimizeSceneGraph()
     {
         // This function optimizes the scene graph to flatten transform hierarchies
-        // where possible by merging nodes.
+        // where possible by merging nodes. Candidates are found in parallel and the
+        // graph is modified in node ID order, so the result is deterministic.
         if (is_set(mFlags, Flags::DontOptimizeGraph)) return;
 
-        // Iterate over all nodes to collapse sub-trees of static nodes.
+        const uint32_t nodeCount = (uint32_t)mSceneGraph.size();
+        const std::vector<bool> nodeHasAnimation = computeAnimatedNodes(false);
+
+        // Collapse sub-trees of static nodes.
+        // A static node is collapsed into its parent if the parent is a static interior node with a single child
+        // and no attached objects. Chains of such nodes are collapsed into the topmost node of the chain.
+        std::vector<uint8_t> isInterior(nodeCount);
+        std::vector<uint8_t> isCollapsible(nodeCount);
+        parallel::forEach(nodeCount, [&](size_t i)
+        {
+            const auto& node = mSceneGraph[i];
+            bool isStatic = !node.dontOptimize && !nodeHasAnimation[i];
+            isInterior[i] = isStatic && node.children.size() == 1 && !node.hasObjects();
+            isCollapsible[i] = isStatic;
+        });
+
+        auto collapsesIntoParent = [&](uint32_t i)
+        {
+            NodeID parentID = mSceneGraph[i].parent;
+            return isCollapsible[i] && parentID != NodeID::Invalid() && isInterior[parentID.get()];
+        };
+
+        // Find the bottom node of each chain and compute the topmost node and the combined transform.
+        std::vector<NodeID> collapseTargets(nodeCount, NodeID::Invalid());
+        std::vector<float4x4> collapsedTransforms(nodeCount);
+        parallel::forEach(nodeCount, [&](size_t i)
+        {
+            if (!collapsesIntoParent((uint32_t)i)) return;
+            if (isInterior[i] && collapsesIntoParent(mSceneGraph[i].children[0].get())) return;
+
+            float4x4 transform = mSceneGraph[i].transform;
+            uint32_t nodeID = (uint32_t)i;
+            while (collapsesIntoParent(nodeID))
+            {
+                nodeID = mSceneGraph[nodeID].parent.get();
+                transform = mul(mSceneGraph[nodeID].transform, transform);
+            }
+            collapseTargets[i] = NodeID(nodeID);
+            collapsedTransforms[i] = transform;
+        });
+
         size_t removedNodes = 0;
-        for (NodeID nodeID{ 0 }; nodeID.get() < mSceneGraph.size(); ++nodeID)
+        for (uint32_t i = 0; i < nodeCount; ++i)
         {
-            const auto& node = mSceneGraph[nodeID.get()];
-            if (collapseNodes(node.parent, nodeID)) removedNodes++;
+            if (collapseTargets[i] != NodeID::Invalid()) removedNodes += collapseNodes(collapseTargets[i], NodeID(i), collapsedTransforms[i]);
         }
 
         if (removedNodes > 0) logInfo("Optimized scene graph by removing {} internal static nodes.", removedNodes);
 
         // Merge identical static nodes.
-        // We build a set of unique nodes. If a node is identical to one of the
-        // existing nodes, its contents are merged into the matching node.
+        // Nodes with identical parent, transform and bind pose are merged into the node with the lowest ID.
+        // Merging nodes changes the parent of their children, so the nodes are processed one hierarchy
+        // level at a time. Within each level, the nodes are sorted by these fields in parallel.
 
         auto lessThan = [](const float4x4& lhs, const float4x4& rhs) {
             return math::lex_lt(lhs, rhs);
@@ -1614,29 +1968,49 @@ namespace Falcor
             return false;
         };
 
-        std::set<NodeID, decltype(cmp)> uniqueStaticNodes(cmp); // In C++20 we can drop the constructor argument.
-
-        size_t mergedNodesCount = 0;
-        for (NodeID nodeID{ 0 }; nodeID.get() < mSceneGraph.size(); ++nodeID)
+        // Group the nodes by hierarchy level. Parent nodes always have lower IDs than their children.
+        std::vector<uint32_t> nodeDepth(nodeCount, 0);
+        std::vector<std::vector<NodeID>> levels;
+        for (uint32_t i = 0; i < nodeCount; ++i)
         {
-            const auto& node = mSceneGraph[nodeID.get()];
+            const auto& node = mSceneGraph[i];
+            if (node.parent != NodeID::Invalid())
+            {
+                FALCOR_ASSERT(node.parent.get() < i);
+                nodeDepth[i] = nodeDepth[node.parent.get()] + 1;
+            }
 
             // Skip over unused or animated nodes.
             if (node.children.empty() && !node.hasObjects()) continue;
-            if (doesNodeHaveAnimation(nodeID)) continue;
-            if (mSceneGraph[nodeID.get()].dontOptimize) continue;
+            if (nodeHasAnimation[i]) continue;
+            if (node.dontOptimize) continue;
 
-            // Look for an identical node and merge current node into it if found.
-            auto it = uniqueStaticNodes.find(nodeID);
-            if (it != uniqueStaticNodes.end())
-            {
-                bool merged = mergeNodes(*it, nodeID);
-                if (!merged) FALCOR_THROW("Unexpectedly failed to merge nodes");
-                mergedNodesCount++;
-            }
-            else
+            if (nodeDepth[i] >= levels.size()) levels.resize(nodeDepth[i] + 1);
+            levels[nodeDepth[i]].push_back(NodeID(i));
+        }
+
+        size_t mergedNodesCount = 0;
+        for (auto& level : levels)
+        {
+            // Sort by the merge key, and by ID for nodes with identical keys. This is a strict total order, so the result
+            // doesn't depend on the sort being parallel.
+            std::sort(std::execution::par, level.begin(), level.end(), [&cmp](NodeID lhsID, NodeID rhsID) {
+                if (cmp(lhsID, rhsID)) return true;
+                if (cmp(rhsID, lhsID)) return false;
+                return lhsID < rhsID;
+            });
+
+            // Merge each run of identical nodes into its first node.
+            for (size_t first = 0; first < level.size();)
             {
-                uniqueStaticNodes.insert(nodeID);
+                size_t next = first + 1;
+                for (; next < level.size() && !cmp(level[first], level[next]); ++next)
+                {
+                    bool merged = mergeNodes(level[first], level[next]);
+                    if (!merged) FALCOR_THROW("Unexpectedly failed to merge nodes");
+                    mergedNodesCount++;
+                }
+                first = next;
             }
         }
 
@@ -1651,75 +2025,102 @@ namespace Falcor
 
         // Add an identity transform node.
         NodeID identityNodeID = addNode(Node{ "Identity", float4x4::identity(), float4x4::identity() });
-        auto& identityNode = mSceneGraph[identityNodeID.get()];
 
-        size_t transformedMeshCount = 0;
+        const std::vector<float4x4> globalTransforms = computeGlobalTransforms();
+        const std::vector<bool> animatedNodes = computeAnimatedNodes(true);
+
+        // Select the static meshes and compute their object->world transforms.
+        std::vector<std::pair<MeshID, float4x4>> transformedMeshes;
+        std::vector<bool> isPretransformed(mMeshes.size(), false);
         for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
         {
             auto& mesh = mMeshes[meshID.get()];
 
             // Skip instanced/animated/skinned meshes.
             FALCOR_ASSERT(!mesh.instances.empty());
-            if (mesh.instances.size() > 1 || isNodeAnimated(*mesh.instances.begin()) || mesh.isDynamic()) continue;
+            if (mesh.instances.size() > 1 || animatedNodes[mesh.instances.begin()->get()] || mesh.isDynamic()) continue;
 
             FALCOR_ASSERT(mesh.skinningData.empty());
             mesh.isStatic = true;
+            isPretransformed[meshID.get()] = true;
 
-            // Compute the object->world transform for the node.
             auto nodeID = *mesh.instances.begin();
-            FALCOR_ASSERT(nodeID != NodeID::Invalid());
-
-            float4x4 transform = float4x4::identity();
-            while (nodeID != NodeID::Invalid())
-            {
-                FALCOR_ASSERT_LT(nodeID.get(), mSceneGraph.size());
-                transform = mul(mSceneGraph[nodeID.get()].transform, transform);
-
-                nodeID = mSceneGraph[nodeID.get()].parent;
-            }
+            FALCOR_ASSERT(nodeID != NodeID::Invalid() && nodeID.get() < globalTransforms.size());
+            const float4x4& transform = globalTransforms[nodeID.get()];
 
             // Flip triangle winding flag if the transform flips the coordinate system handedness (negative determinant).
             bool flippedWinding = determinant(float3x3(transform)) < 0.f;
             if (flippedWinding) mesh.isFrontFaceCW = !mesh.isFrontFaceCW;
 
-            // Transform vertices to world space if not already identity transform.
+            // Vertices are transformed to world space below if not already identity transform.
             if (transform != float4x4::identity())
             {
                 FALCOR_ASSERT(!mesh.staticData.empty());
                 FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
+                transformedMeshes.emplace_back(meshID, transform);
+            }
 
-                float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
-                float3x3 transform3x3 = float3x3(transform);
+            // Link mesh to the identity transform node.
+            mesh.instances.clear();
+            mesh.instances.insert(identityNodeID);
+        }
 
-                for (auto& v : mesh.staticData)
-                {
-                    v.position = transformPoint(transform, v.position);
-                    v.normal = normalize(transformVector(invTranspose3x3, v.normal));
-                    v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
-                    // TODO: We should flip the sign of v.tangent.w if flippedWinding is true.
-                    // Leaving that out for now for consistency with the shader code that needs the same fix.
+        // Unlink the meshes from their previous transform nodes.
+        // TODO: This will leave some nodes unused. We could run a separate pass to compact the node list.
+        parallel::forEach(mSceneGraph.size(), [&](size_t i)
+        {
+            auto& node = mSceneGraph[i];
+            auto isRemoved = [&](MeshID meshID) { return isPretransformed[meshID.get()]; };
+            node.meshes.erase(std::remove_if(node.meshes.begin(), node.meshes.end(), isRemoved), node.meshes.end());
+        });
 
-                    v.curveRadius = length(transformVector(transform3x3, float3(v.curveRadius, 0.f, 0.f)));
-                }
+        auto& identityNode = mSceneGraph[identityNodeID.get()];
+        for (MeshID meshID{ 0 }; meshID.get() < (uint32_t)mMeshes.size(); ++meshID)
+        {
+            if (isPretransformed[meshID.get()]) identityNode.meshes.push_back(meshID);
+        }
 
-                transformedMeshCount++;
-            }
+        // Transform the vertices in parallel over meshes. Large meshes are transformed afterwards in parallel over vertices,
+        // as parallel calls nested in the loop over meshes run serially.
+        auto transformMesh = [&](const std::pair<MeshID, float4x4>& meshTransform, bool parallelVertices)
+        {
+            auto& mesh = mMeshes[meshTransform.first.get()];
+            const float4x4& transform = meshTransform.second;
 
-            // Unlink mesh from its previous transform node.
-            // TODO: This will leave some nodes unused. We could run a separate pass to compact the node list.
-            FALCOR_ASSERT(mesh.instances.size() == 1);
-            auto& prevNode = mSceneGraph[mesh.instances.begin()->get()];
-            auto it = std::find(prevNode.meshes.begin(), prevNode.meshes.end(), meshID);
-            FALCOR_ASSERT(it != prevNode.meshes.end());
-            prevNode.meshes.erase(it);
+            float3x3 invTranspose3x3 = float3x3(transpose(inverse(transform)));
+            float3x3 transform3x3 = float3x3(transform);
 
-            // Link mesh to the identity transform node.
-            identityNode.meshes.push_back(meshID);
-            mesh.instances.clear();
-            mesh.instances.insert(identityNodeID);
+            auto transformVertex = [&](StaticVertexData& v)
+            {
+                v.position = transformPoint(transform, v.position);
+                v.normal = normalize(transformVector(invTranspose3x3, v.normal));
+                v.tangent = float4(normalize(transformVector(transform3x3, v.tangent.xyz())), v.tangent.w);
+                // TODO: We should flip the sign of v.tangent.w if the transform flips the winding.
+                // Leaving that out for now for consistency with the shader code that needs the same fix.
+
+                v.curveRadius = length(transformVector(transform3x3, float3(v.curveRadius, 0.f, 0.f)));
+            };
+
+            if (parallelVertices)
+                parallel::forEach(mesh.staticData.size(), [&](size_t i) { transformVertex(mesh.staticData[i]); });
+            else
+                std::for_each(mesh.staticData.begin(), mesh.staticData.end(), transformVertex);
+        };
+
+        auto isLargeMesh = [&](const std::pair<MeshID, float4x4>& meshTransform)
+        {
+            return mMeshes[meshTransform.first.get()].staticData.size() >= kMinParallelPretransformVertexCount;
+        };
+        parallel::forEach(transformedMeshes.size(), [&](size_t i)
+        {
+            if (!isLargeMesh(transformedMeshes[i])) transformMesh(transformedMeshes[i], false);
+        }, 1);
+        for (const auto& meshTransform : transformedMeshes)
+        {
+            if (isLargeMesh(meshTransform)) transformMesh(meshTransform, true);
         }
 
-        if (transformedMeshCount > 0) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshCount);
+        if (!transformedMeshes.empty()) logInfo("Pre-transformed {} static meshes to world space.", transformedMeshes.size());
     }
 
     void SceneBuilder::flipTriangleWinding(MeshSpec& mesh)
@@ -2219,13 +2620,14 @@ namespace Falcor
         // Sort the meshes by centroid along the largest axis.
         AABB bb = calculateBoundingBox(meshGroup);
         const int axis = largestAxis(bb.extent());
-        auto compareCentroids = [this, axis](MeshID leftMeshID, MeshID rightMeshID)
-        {
-            return mMeshes[leftMeshID.get()].boundingBox.center()[axis] < mMeshes[rightMeshID.get()].boundingBox.center()[axis];
-        };
-
+        // The radix sort is stable, so meshes with identical centroids keep their order.
         std::vector<MeshID> meshes = std::move(meshGroup.meshList);
-        std::sort(meshes.begin(), meshes.end(), compareCentroids);
+        std::vector<uint32_t> keys(meshes.size());
+        for (size_t i = 0; i < meshes.size(); ++i)
+        {
+            keys[i] = parallel::floatToRadixKey(mMeshes[meshes[i].get()].boundingBox.center()[axis]);
+        }
+        parallel::radixSortKeyValue(keys.data(), meshes.data(), meshes.size());
 
         // Find the median mesh in terms of triangle count.
         size_t triangles = 0;
@@ -2338,6 +2740,95 @@ namespace Falcor
         mMeshGroups = std::move(optimizedGroups);
     }
 
+    void SceneBuilder::optimizeMeshLayout()
+    {
+        // This function optionally reorders the mesh data for memory locality.
+        // The triangles of each mesh are reordered for vertex cache locality and the vertices in order of first use,
+        // which improves the locality of vertex fetches in both rasterization and ray tracing. The meshes in each
+        // mesh group are ordered along a Morton curve, which places nearby meshes close together in the global buffers.
+        // Animated meshes are skipped as their vertex data is referenced by vertex index from the animation caches.
+
+        if (!is_set(mFlags, Flags::OptimizeMeshLayout)) return;
+
+        struct MeshStats
+        {
+            uint64_t triangleCount = 0;
+            uint64_t missesBefore = 0;
+            uint64_t missesAfter = 0;
+            bool optimized = false;
+        };
+        std::vector<MeshStats> meshStats(mMeshes.size());
+
+        std::for_each(std::execution::par, mMeshes.begin(), mMeshes.end(), [&](MeshSpec& mesh)
+        {
+            if (mesh.topology != Vao::Topology::TriangleList || mesh.indexCount == 0 || mesh.isAnimated) return;
+            FALCOR_ASSERT(!mesh.indexData.empty() && mesh.indexCount % 3 == 0);
+            FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
+
+            std::vector<uint32_t> indices(mesh.indexCount);
+            for (uint32_t i = 0; i < mesh.indexCount; i++) indices[i] = mesh.getIndex(i);
+
+            auto& stats = meshStats[&mesh - mMeshes.data()];
+            stats.triangleCount = mesh.indexCount / 3;
+            stats.missesBefore = MeshLayoutOptimizer::countCacheMisses(indices, mesh.vertexCount);
+
+            // Keep the original triangle order if it is already better.
+            std::vector<uint32_t> optimizedIndices = MeshLayoutOptimizer::optimizeVertexCache(indices, mesh.vertexCount);
+            stats.missesAfter = MeshLayoutOptimizer::countCacheMisses(optimizedIndices, mesh.vertexCount);
+            if (stats.missesAfter < stats.missesBefore) indices = std::move(optimizedIndices);
+            else stats.missesAfter = stats.missesBefore;
+
+            // Reorder the vertices in order of first use.
+            std::vector<uint32_t> remap = MeshLayoutOptimizer::computeVertexFetchRemap(indices, mesh.vertexCount);
+            MeshLayoutOptimizer::remapVertices(mesh.staticData, remap);
+            if (!mesh.skinningData.empty())
+            {
+                FALCOR_ASSERT(mesh.skinningData.size() == mesh.staticData.size());
+                MeshLayoutOptimizer::remapVertices(mesh.skinningData, remap);
+            }
+            for (uint32_t& index : indices) index = remap[index];
+
+            mesh.indexData = mesh.use16BitIndices ? compact16BitIndices(indices) : std::move(indices);
+            stats.optimized = true;
+        });
+
+        MeshStats total;
+        size_t optimizedMeshCount = 0;
+        for (const auto& stats : meshStats)
+        {
+            if (!stats.optimized) continue;
+            total.triangleCount += stats.triangleCount;
+            total.missesBefore += stats.missesBefore;
+            total.missesAfter += stats.missesAfter;
+            optimizedMeshCount++;
+        }
+
+        if (total.triangleCount > 0)
+        {
+            logInfo(
+                "Optimized vertex and triangle order of {} meshes. ACMR (cache size {}): {:.3f} before, {:.3f} after.",
+                optimizedMeshCount, MeshLayoutOptimizer::kDefaultCacheSize,
+                (double)total.missesBefore / total.triangleCount, (double)total.missesAfter / total.triangleCount
+            );
+        }
+
+        // Order the meshes in each mesh group along a Morton curve through their bounding box centers.
+        // All meshes in a group share the same instance transforms, so their bounding boxes are in the same space.
+        for (auto& meshGroup : mMeshGroups)
+        {
+            auto& meshList = meshGroup.meshList;
+            if (meshList.size() < 2) continue;
+
+            std::vector<float3> centers(meshList.size());
+            for (size_t i = 0; i < meshList.size(); i++) centers[i] = mMeshes[meshList[i].get()].boundingBox.center();
+
+            std::vector<uint32_t> order = MeshLayoutOptimizer::computeMortonOrder(centers);
+            std::vector<MeshID> sortedMeshList(meshList.size());
+            for (size_t i = 0; i < order.size(); i++) sortedMeshList[i] = meshList[order[i]];
+            meshList = std::move(sortedMeshList);
+        }
+    }
+
     void SceneBuilder::sortMeshes()
     {
         // This function sorts meshes by the order they are used in the mesh groups.
@@ -2345,42 +2836,204 @@ namespace Falcor
         // to use consecutive indices (e.g. mesh IDs).
 
         // Generate a mapping from old to new mesh IDs.
-        std::unordered_map<MeshID, MeshID> old2newMeshMap;
+        std::vector<MeshID> old2newMeshMap(mMeshes.size(), MeshID::Invalid());
         MeshID newMeshID{ 0 };
         for (const auto &meshGroup : mMeshGroups) {
             for (MeshID meshID : meshGroup.meshList) {
-                old2newMeshMap[meshID] = newMeshID++;
+                FALCOR_ASSERT(old2newMeshMap[meshID.get()] == MeshID::Invalid());
+                old2newMeshMap[meshID.get()] = newMeshID++;
             }
         }
 
         // Sort meshes by new IDs.
-        FALCOR_ASSERT_EQ(old2newMeshMap.size(), mMeshes.size());
+        FALCOR_ASSERT_EQ(newMeshID.get(), mMeshes.size());
         std::vector<MeshSpec> sortedMeshes(mMeshes.size());
-        for (MeshID i{ 0 }; i.get() < mMeshes.size(); ++i) {
-            sortedMeshes[old2newMeshMap[i].get()] = std::move(mMeshes[i.get()]);
-        }
+        parallel::forEach(mMeshes.size(), [&](size_t i) {
+            sortedMeshes[old2newMeshMap[i].get()] = std::move(mMeshes[i]);
+        }, 1);
         mMeshes = std::move(sortedMeshes);
 
         // Remap mesh lists in mesh groups.
         for (auto &meshGroup : mMeshGroups) {
-            auto &meshList = meshGroup.meshList;
-            for (size_t i = 0 ; i < meshList.size(); ++i) {
-                meshList[i] = old2newMeshMap[meshList[i]];
+            for (MeshID& meshID : meshGroup.meshList) {
+                meshID = old2newMeshMap[meshID.get()];
             }
         }
 
         // Remap cached meshes.
         for (auto &cachedMesh : mSceneData.cachedMeshes)
         {
-            cachedMesh.meshID = old2newMeshMap[cachedMesh.meshID];
+            cachedMesh.meshID = old2newMeshMap[cachedMesh.meshID.get()];
         }
         for (auto& cache : mSceneData.cachedCurves)
         {
             if (cache.tessellationMode != CurveTessellationMode::LinearSweptSphere)
             {
-                cache.geometryID = CurveOrMeshID{ old2newMeshMap[MeshID{ cache.geometryID }] };
+                cache.geometryID = CurveOrMeshID{ old2newMeshMap[cache.geometryID.get()] };
+            }
+        }
+    }
+
+    void SceneBuilder::createMeshlets()
+    {
+        // This function optionally partitions the triangle meshes into meshlets.
+        // The meshlets reference the mesh-local vertex data, so this runs before the mesh data is moved into the global buffers.
+
+        if (!is_set(mFlags, Flags::GenerateMeshlets)) return;
+
+        std::vector<MeshletBuilder::Meshlets> meshMeshlets(mMeshes.size());
+        NumericRange<uint32_t> range(0, (uint32_t)mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshIndex)
+        {
+            const auto& mesh = mMeshes[meshIndex];
+            if (mesh.topology != Vao::Topology::TriangleList) return;
+            FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
+
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t i = 0; i < positions.size(); i++) positions[i] = mesh.staticData[i].position;
+
+            std::vector<uint32_t> indices(mesh.indexCount > 0 ? mesh.indexCount : mesh.vertexCount);
+            for (uint32_t i = 0; i < (uint32_t)indices.size(); i++) indices[i] = mesh.indexCount > 0 ? mesh.getIndex(i) : i;
+
+            MeshletBuilder::Options options;
+            options.isFrontFaceCW = mesh.isFrontFaceCW;
+            MeshletBuilder::build(indices, positions, options, meshMeshlets[meshIndex]);
+        });
+
+        // Concatenate the meshlets of all meshes.
+        size_t totalMeshletCount = 0;
+        size_t totalVertexCount = 0;
+        size_t totalTriangleCount = 0;
+        for (const auto& meshlets : meshMeshlets)
+        {
+            totalMeshletCount += meshlets.meshlets.size();
+            totalVertexCount += meshlets.vertices.size();
+            totalTriangleCount += meshlets.triangles.size();
+        }
+        if (totalMeshletCount > std::numeric_limits<uint32_t>::max() ||
+            totalVertexCount > std::numeric_limits<uint32_t>::max() ||
+            totalTriangleCount > std::numeric_limits<uint32_t>::max())
+        {
+            FALCOR_THROW("Trying to build a scene that exceeds supported meshlet data size.");
+        }
+
+        mSceneData.meshlets.reserve(totalMeshletCount);
+        mSceneData.meshletOffsets.reserve(mMeshes.size() + 1);
+        mSceneData.meshletVertices.reserve(totalVertexCount);
+        mSceneData.meshletTriangles.reserve(totalTriangleCount);
+
+        for (const auto& meshlets : meshMeshlets)
+        {
+            const uint32_t vertexOffset = (uint32_t)mSceneData.meshletVertices.size();
+            const uint32_t triangleOffset = (uint32_t)mSceneData.meshletTriangles.size();
+            mSceneData.meshletOffsets.push_back((uint32_t)mSceneData.meshlets.size());
+
+            for (auto desc : meshlets.meshlets)
+            {
+                desc.vertexOffset += vertexOffset;
+                desc.triangleOffset += triangleOffset;
+                mSceneData.meshlets.push_back(desc);
             }
+            mSceneData.meshletVertices.insert(mSceneData.meshletVertices.end(), meshlets.vertices.begin(), meshlets.vertices.end());
+            mSceneData.meshletTriangles.insert(mSceneData.meshletTriangles.end(), meshlets.triangles.begin(), meshlets.triangles.end());
         }
+        mSceneData.meshletOffsets.push_back((uint32_t)mSceneData.meshlets.size());
+
+        logInfo("Created {} meshlets for {} meshes.", totalMeshletCount, mMeshes.size());
+    }
+
+    void SceneBuilder::createMeshLods()
+    {
+        // This function optionally generates a chain of simplified LODs for the triangle meshes.
+        // The LODs are index lists referencing the mesh-local vertex data, so this runs before the mesh data is moved into the global buffers.
+
+        if (!is_set(mFlags, Flags::GenerateMeshLods)) return;
+
+        std::vector<MeshSimplifier::Lods> meshLods(mMeshes.size());
+        NumericRange<uint32_t> range(0, (uint32_t)mMeshes.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](uint32_t meshIndex)
+        {
+            const auto& mesh = mMeshes[meshIndex];
+            if (mesh.topology != Vao::Topology::TriangleList) return;
+            FALCOR_ASSERT((size_t)mesh.vertexCount == mesh.staticData.size());
+
+            std::vector<float3> positions(mesh.staticData.size());
+            for (size_t i = 0; i < positions.size(); i++) positions[i] = mesh.staticData[i].position;
+
+            std::vector<uint32_t> indices(mesh.indexCount > 0 ? mesh.indexCount : mesh.vertexCount);
+            for (uint32_t i = 0; i < (uint32_t)indices.size(); i++) indices[i] = mesh.indexCount > 0 ? mesh.getIndex(i) : i;
+
+            MeshSimplifier::buildLods(indices, positions, MeshSimplifier::Options(), meshLods[meshIndex]);
+        });
+
+        // Concatenate the LODs of all meshes.
+        size_t totalLodCount = 0;
+        size_t totalIndexCount = 0;
+        for (const auto& lods : meshLods)
+        {
+            totalLodCount += lods.lods.size();
+            totalIndexCount += lods.indices.size();
+        }
+        if (totalIndexCount > std::numeric_limits<uint32_t>::max())
+        {
+            FALCOR_THROW("Trying to build a scene that exceeds supported mesh LOD index count.");
+        }
+
+        mSceneData.meshLods.reserve(totalLodCount);
+        mSceneData.meshLodOffsets.reserve(mMeshes.size() + 1);
+        mSceneData.meshLodIndices.reserve(totalIndexCount);
+
+        for (const auto& lods : meshLods)
+        {
+            const uint32_t indexOffset = (uint32_t)mSceneData.meshLodIndices.size();
+            mSceneData.meshLodOffsets.push_back((uint32_t)mSceneData.meshLods.size());
+
+            for (auto desc : lods.lods)
+            {
+                desc.indexOffset += indexOffset;
+                mSceneData.meshLods.push_back(desc);
+            }
+            mSceneData.meshLodIndices.insert(mSceneData.meshLodIndices.end(), lods.indices.begin(), lods.indices.end());
+        }
+        mSceneData.meshLodOffsets.push_back((uint32_t)mSceneData.meshLods.size());
+
+        // Report the triangle count and index memory per LOD level. Meshes with fewer LODs contribute their coarsest LOD.
+        std::string report;
+        uint64_t baseTriangleCount = 0;
+        for (uint32_t level = 0; level <= MeshSimplifier::kMaxLodCount; level++)
+        {
+            uint64_t triangleCount = 0;
+            uint64_t indexMemoryInBytes = 0;
+            bool hasLevel = level == 0;
+            for (size_t meshIndex = 0; meshIndex < mMeshes.size(); meshIndex++)
+            {
+                const auto& mesh = mMeshes[meshIndex];
+                const auto& lods = meshLods[meshIndex].lods;
+                if (level > 0 && level <= lods.size())
+                {
+                    hasLevel = true;
+                    triangleCount += lods[level - 1].indexCount / 3;
+                    indexMemoryInBytes += lods[level - 1].indexCount * sizeof(uint32_t);
+                }
+                else if (level > 0 && !lods.empty())
+                {
+                    triangleCount += lods.back().indexCount / 3;
+                    indexMemoryInBytes += lods.back().indexCount * sizeof(uint32_t);
+                }
+                else
+                {
+                    triangleCount += mesh.getTriangleCount();
+                    indexMemoryInBytes += (uint64_t)mesh.indexCount * (mesh.use16BitIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+                }
+            }
+            if (!hasLevel) break;
+            if (level == 0) baseTriangleCount = triangleCount;
+
+            double percentage = baseTriangleCount > 0 ? 100.0 * triangleCount / baseTriangleCount : 100.0;
+            report += fmt::format("\n  LOD {}: {} triangles ({:.1f}%), {} index memory", level, triangleCount, percentage, formatByteSize(indexMemoryInBytes));
+        }
+
+        logInfo("Created {} LODs for {} meshes.{}", totalLodCount, mMeshes.size(), report);
     }
 
     void SceneBuilder::createGlobalBuffers()
@@ -2424,8 +3077,9 @@ namespace Falcor
             mesh.prevVertexOffset = mesh.skinningVertexOffset;
 
             // Insert the static vertex data in the global array.
-            // The vertices are automatically converted to their packed format in this step.
-            mSceneData.meshStaticData.insert(mSceneData.meshStaticData.end(), mesh.staticData.begin(), mesh.staticData.end());
+            // The vertices are converted to their packed format in this step.
+            mSceneData.meshStaticData.resize(mesh.staticVertexOffset + mesh.staticData.size());
+            PackedStaticVertexData::packArray(mesh.staticData, fstd::span<PackedStaticVertexData>(mSceneData.meshStaticData.data() + mesh.staticVertexOffset, mesh.staticData.size()));
 
             if (isIndexed)
             {
@@ -2518,6 +3172,13 @@ namespace Falcor
 
         if (is_set(mFlags, Flags::DontOptimizeMaterials)) return;
 
+        // The texture analysis runs on the GPU. Headless builds defer it to when the scene cache is loaded on a device.
+        if (!mpDevice)
+        {
+            mSceneData.deferMaterialOptimization = true;
+            return;
+        }
+
         mSceneData.pMaterials->optimizeMaterials();
     }
 
@@ -2573,21 +3234,32 @@ namespace Falcor
         for (auto& mesh : mMeshes)
         {
             const auto& pMaterial = mSceneData.pMaterials->getMaterial(mesh.materialId)->toBasicMaterial();
-            if (pMaterial && pMaterial->getEmissiveTexture() != nullptr)
+            if (pMaterial && pMaterial->hasTextureSlotData(Material::TextureSlot::Emissive))
             {
                 // Quantize texture coordinates to fp16. Also track the bounds and max error.
                 float2 minTexCrd = float2(std::numeric_limits<float>::infinity());
                 float2 maxTexCrd = float2(-std::numeric_limits<float>::infinity());
                 float2 maxError = float2(0);
 
+                // Gather the texture coordinates and round trip them through fp16 in a batch.
+                std::vector<float2> texCrds(mesh.staticVertexCount);
+                for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
+                {
+                    texCrds[i] = mSceneData.meshStaticData[mesh.staticVertexOffset + i].texCrd;
+                }
+
+                std::vector<uint16_t> halfs(texCrds.size() * 2);
+                std::vector<float2> quantizedTexCrds(texCrds.size());
+                math::float32ToFloat16(fstd::span<const float>(&texCrds.data()->x, halfs.size()), halfs);
+                math::float16ToFloat32(halfs, fstd::span<float>(&quantizedTexCrds.data()->x, halfs.size()));
+
                 for (uint32_t i = 0; i < mesh.staticVertexCount; ++i)
                 {
-                    auto& v = mSceneData.meshStaticData[mesh.staticVertexOffset + i];
-                    float2 texCrd = v.texCrd;
+                    float2 texCrd = texCrds[i];
                     minTexCrd = min(minTexCrd, texCrd);
                     maxTexCrd = max(maxTexCrd, texCrd);
-                    v.texCrd = f16tof32(f32tof16(texCrd));
-                    maxError = max(maxError, abs(v.texCrd - texCrd));
+                    mSceneData.meshStaticData[mesh.staticVertexOffset + i].texCrd = quantizedTexCrds[i];
+                    maxError = max(maxError, abs(quantizedTexCrds[i] - texCrd));
                 }
 
                 // Issue warning if quantization errors are too large.
@@ -2939,6 +3611,11 @@ namespace Falcor
         flags.value("DontUseDisplacement", SceneBuilder::Flags::DontUseDisplacement);
         flags.value("UseCompressedHitInfo", SceneBuilder::Flags::UseCompressedHitInfo);
         flags.value("TessellateCurvesIntoPolyTubes", SceneBuilder::Flags::TessellateCurvesIntoPolyTubes);
+        flags.value("OptimizeMeshLayout", SceneBuilder::Flags::OptimizeMeshLayout);
+        flags.value("GenerateMeshlets", SceneBuilder::Flags::GenerateMeshlets);
+        flags.value("GenerateMeshLods", SceneBuilder::Flags::GenerateMeshLods);
+        flags.value("DeduplicateMeshes", SceneBuilder::Flags::DeduplicateMeshes);
+        flags.value("DeduplicateMeshesRigid", SceneBuilder::Flags::DeduplicateMeshesRigid);
         flags.value("UseCache", SceneBuilder::Flags::UseCache);
         flags.value("RebuildCache", SceneBuilder::Flags::RebuildCache);
         ScriptBindings::addEnumBinaryOperators(flags);
@@ -27,6 +27,7 @@
  **************************************************************************/
 #pragma once
 #include "Scene.h"
+#include "SceneBuildReport.h"
 #include "SceneCache.h"
 #include "SceneIDs.h"
 #include "Transform.h"
@@ -47,6 +48,7 @@
 
 #include <filesystem>
 #include <memory>
+#include <set>
 #include <string>
 #include <vector>
 
@@ -77,6 +79,11 @@ namespace Falcor
             DontUseDisplacement             = 0x4000,   ///< Don't use displacement mapping.
             UseCompressedHitInfo            = 0x8000,   ///< Use compressed hit info (on scenes with triangle meshes only).
             TessellateCurvesIntoPolyTubes   = 0x10000,  ///< Tessellate curves into poly-tubes (the default is linear swept spheres).
+            OptimizeMeshLayout              = 0x20000,  ///< Reorder triangles and vertices of static meshes for cache locality, and order meshes spatially within mesh groups.
+            GenerateMeshlets                = 0x40000,  ///< Partition triangle meshes into meshlets with bounding spheres and normal cones for cluster culling.
+            GenerateMeshLods                = 0x80000,  ///< Generate a chain of simplified levels of detail for triangle meshes.
+            DeduplicateMeshes               = 0x100000, ///< Merge static meshes with identical vertex and index data into instances of a single mesh.
+            DeduplicateMeshesRigid          = 0x200000, ///< Merge static meshes that are identical up to a rigid transform into instances of a single mesh. Implies DeduplicateMeshes.
 
             UseCache                        = 0x10000000, ///< Enable scene caching. This caches the runtime scene representation on disk to reduce load time.
             RebuildCache                    = 0x20000000, ///< Rebuild scene cache.
@@ -328,6 +335,8 @@ namespace Falcor
         };
 
         /** Constructor.
+            The device may be null for a headless build. Headless builds run the CPU build stages only,
+            record material textures by path and are finished with writeSceneCache() instead of getScene().
         */
         SceneBuilder(ref<Device> pDevice, const Settings& settings, Flags flags = Flags::Default);
 
@@ -367,13 +376,42 @@ namespace Falcor
         /// Pop the state of the asset resolver from the stack.
         void popAssetResolver();
 
+        /** Add a file the scene depends on. Dependencies are recorded in the scene cache,
+            which is invalidated whenever one of them changes.
+            Paths resolved through the builder's asset resolver are added automatically.
+            Importers loading files by other means should add them explicitly.
+            \param[in] path File path. Paths not referring to regular files are ignored.
+        */
+        void addDependency(const std::filesystem::path& path);
+
+        /// Get the set of files the scene depends on.
+        const std::set<std::filesystem::path>& getDependencies() const { return mDependencies; }
+
         /** Get the scene. Make sure to add all the objects before calling this function
             \return nullptr if something went wrong, otherwise a new Scene object
         */
         ref<Scene> getScene();
 
+        /** Run the build stages and write the scene cache without creating a scene.
+            This is used to prebuild scene caches offline, typically in a headless build.
+            The cache is keyed by the resolved scene path and build flags, so render nodes loading
+            the scene from the same path with the same flags and the UseCache flag pick it up.
+            Only scenes imported from a file can be cached. The builder can't be used afterwards.
+            \return Path of the written scene cache file.
+        */
+        std::filesystem::path writeSceneCache();
+
         const ref<Device>& getDevice() const { return mpDevice; }
 
+        /** Check if this is a headless build without a GPU device.
+        */
+        bool isHeadless() const { return mpDevice == nullptr; }
+
+        /** Get the time and memory statistics of the build stages.
+            The report is complete after getScene() or writeSceneCache() returned.
+        */
+        const SceneBuildReport& getBuildReport() const { return mBuildReport; }
+
         const Settings& getSettings() const { return mSettings; }
         Settings& getSettings() { return mSettings; }
 
@@ -773,6 +811,9 @@ namespace Falcor
         ref<Scene> mpScene;
         SceneCache::Key mSceneCacheKey;
         bool mWriteSceneCache = false;  ///< True if scene cache should be written after import.
+        bool mSceneDataBuilt = false;   ///< True if the build stages have run.
+        SceneBuildReport mBuildReport;  ///< Time and memory statistics of the build stages.
+        std::set<std::filesystem::path> mDependencies; ///< Files the scene depends on (absolute paths).
 
         SceneGraph mSceneGraph;
 
@@ -785,8 +826,10 @@ namespace Falcor
 
         // Helpers
         bool doesNodeHaveAnimation(NodeID nodeID) const;
+        std::vector<bool> computeAnimatedNodes(bool includeParents) const;
+        std::vector<float4x4> computeGlobalTransforms() const;
         void updateLinkedObjects(NodeID oldNodeID, NodeID newNodeID);
-        bool collapseNodes(NodeID parentNodeID, NodeID childNodeID);
+        size_t collapseNodes(NodeID parentNodeID, NodeID childNodeID, const float4x4& transform);
         bool mergeNodes(NodeID dstNodeID, NodeID srcNodeID);
         void flipTriangleWinding(MeshSpec& mesh);
         void updateSDFGridID(SdfGridID oldID, SdfGridID newID);
@@ -807,11 +850,17 @@ namespace Falcor
         MeshGroupList splitMeshGroupMedian(MeshGroup& meshGroup) const;
         MeshGroupList splitMeshGroupMidpointMeshes(MeshGroup& meshGroup);
 
+        // Build
+        void buildSceneData();
+        std::filesystem::path writeSceneCacheFile();
+
         // Post processing
         void prepareDisplacementMaps();
         void prepareSceneGraph();
         void prepareMeshes();
         void removeUnusedMeshes();
+        size_t removeMeshesWithoutInstances();
+        void deduplicateMeshes();
         void flattenStaticMeshInstances();
         void optimizeSceneGraph();
         void pretransformStaticMeshes();
@@ -819,7 +868,10 @@ namespace Falcor
         void calculateMeshBoundingBoxes();
         void createMeshGroups();
         void optimizeGeometry();
+        void optimizeMeshLayout();
         void sortMeshes();
+        void createMeshlets();
+        void createMeshLods();
         void createGlobalBuffers();
         void createCurveGlobalBuffers();
         void optimizeMaterials();
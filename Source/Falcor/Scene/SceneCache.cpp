@@ -31,9 +31,13 @@
 #include "Material/ClothMaterial.h"
 #include "Material/MaterialTextureLoader.h"
 #include "Utils/Logger.h"
+#include "Utils/NumericRange.h"
 
 #include <lz4_stream/lz4_stream.h>
 
+#include <algorithm>
+#include <atomic>
+#include <execution>
 #include <fstream>
 
 namespace Falcor
@@ -43,7 +47,7 @@ namespace Falcor
         /** Specfies the current cache file version.
             This needs to be incremented every time the file format changes!
         */
-        const uint32_t kVersion = 25;
+        const uint32_t kVersion = 30;
 
         /** Scene cache directory (subdirectory in the application data directory).
         */
@@ -62,6 +66,11 @@ namespace Falcor
                 return std::memcmp(magic, kMagic, sizeof(Header::magic)) == 0 && version == kVersion;
             }
         };
+
+        int64_t getLastWriteTime(const std::filesystem::path& path, std::error_code& ec)
+        {
+            return std::filesystem::last_write_time(path, ec).time_since_epoch().count();
+        }
     }
 
     /** Wrapper around std::ostream to ease serialization of basic types.
@@ -204,10 +213,16 @@ namespace Falcor
         // Verify header.
         Header header;
         fs.read(reinterpret_cast<char*>(&header), sizeof(header));
-        return !fs.eof() && header.isValid();
+        if (fs.eof() || !header.isValid()) return false;
+
+        // Verify dependencies.
+        InputStream stream(fs);
+        auto dependencies = readDependencies(stream);
+        if (!fs.good()) return false;
+        return validateDependencies(dependencies);
     }
 
-    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key)
+    void SceneCache::writeCache(const Scene::SceneData& sceneData, const Key& key, const std::vector<Dependency>& dependencies)
     {
         auto cachePath = getCachePath(key);
 
@@ -226,6 +241,12 @@ namespace Falcor
         header.version = kVersion;
         fs.write(reinterpret_cast<const char*>(&header), sizeof(header));
 
+        // Write dependencies (uncompressed) so they can be validated without decompressing the cache.
+        {
+            OutputStream stream(fs);
+            writeDependencies(stream, dependencies);
+        }
+
         // Write cache (compressed).
         lz4_stream::basic_ostream<kBlockSize> zs(fs);
         OutputStream stream(zs);
@@ -248,6 +269,12 @@ namespace Falcor
         fs.read(reinterpret_cast<char*>(&header), sizeof(header));
         if (!header.isValid()) FALCOR_THROW("Invalid header in scene cache file '{}'.", cachePath);
 
+        // Skip dependencies (uncompressed).
+        {
+            InputStream stream(fs);
+            readDependencies(stream);
+        }
+
         // Read cache (compressed).
         lz4_stream::basic_istream<kBlockSize, kBlockSize> zs(fs);
         InputStream stream(zs);
@@ -256,6 +283,107 @@ namespace Falcor
         return sceneData;
     }
 
+    std::vector<SceneCache::Dependency> SceneCache::collectDependencies(const std::vector<std::filesystem::path>& paths)
+    {
+        std::vector<Dependency> dependencies(paths.size());
+        std::vector<uint8_t> valid(paths.size(), 0);
+
+        auto range = NumericRange<size_t>(0, paths.size());
+        std::for_each(std::execution::par, range.begin(), range.end(), [&](size_t i)
+        {
+            auto& dependency = dependencies[i];
+            dependency.path = std::filesystem::absolute(paths[i]);
+
+            std::error_code ec;
+            dependency.size = std::filesystem::file_size(dependency.path, ec);
+            if (!ec) dependency.lastWriteTime = getLastWriteTime(dependency.path, ec);
+            if (ec)
+            {
+                logWarning("Failed to query scene dependency '{}'. The scene cache will not track it.", dependency.path);
+                return;
+            }
+
+            try
+            {
+                dependency.hash = ContentHash::computeFile(dependency.path);
+                valid[i] = 1;
+            }
+            catch (const std::exception& e)
+            {
+                logWarning("Failed to hash scene dependency '{}': {}", dependency.path, e.what());
+            }
+        });
+
+        std::vector<Dependency> result;
+        result.reserve(paths.size());
+        for (size_t i = 0; i < paths.size(); ++i)
+        {
+            if (valid[i]) result.push_back(std::move(dependencies[i]));
+        }
+        return result;
+    }
+
+    bool SceneCache::validateDependencies(const std::vector<Dependency>& dependencies)
+    {
+        std::atomic<bool> valid{true};
+
+        auto invalidate = [&](const Dependency& dependency, const char* reason)
+        {
+            // Only report the first outdated dependency.
+            if (valid.exchange(false)) logInfo("Scene cache is outdated: '{}' {}.", dependency.path, reason);
+        };
+
+        std::for_each(std::execution::par, dependencies.begin(), dependencies.end(), [&](const Dependency& dependency)
+        {
+            if (!valid.load(std::memory_order_relaxed)) return;
+
+            // Fast path: compare size and last write time.
+            std::error_code ec;
+            uint64_t size = std::filesystem::file_size(dependency.path, ec);
+            if (ec) return invalidate(dependency, "is missing");
+            if (size != dependency.size) return invalidate(dependency, "has changed");
+            int64_t lastWriteTime = getLastWriteTime(dependency.path, ec);
+            if (!ec && lastWriteTime == dependency.lastWriteTime) return;
+
+            // Slow path: the file was touched, compare its content.
+            try
+            {
+                if (ContentHash::computeFile(dependency.path) != dependency.hash) invalidate(dependency, "has changed");
+            }
+            catch (const std::exception&)
+            {
+                invalidate(dependency, "is not readable");
+            }
+        });
+
+        return valid.load();
+    }
+
+    void SceneCache::writeDependencies(OutputStream& stream, const std::vector<Dependency>& dependencies)
+    {
+        stream.write((uint64_t)dependencies.size());
+        for (const auto& dependency : dependencies)
+        {
+            stream.write(dependency.path);
+            stream.write(dependency.size);
+            stream.write(dependency.lastWriteTime);
+            stream.write(dependency.hash);
+        }
+    }
+
+    std::vector<SceneCache::Dependency> SceneCache::readDependencies(InputStream& stream)
+    {
+        std::vector<Dependency> dependencies(stream.read<uint64_t>());
+        for (auto& dependency : dependencies)
+        {
+            stream.read(dependency.path);
+            stream.read(dependency.size);
+            stream.read(dependency.lastWriteTime);
+            stream.read(dependency.hash);
+        }
+        return dependencies;
+    }
+
     std::filesystem::path SceneCache::getCachePath(const Key& key)
     {
         return getAppDataDirectory() / kDirectory / SHA1::toString(key);
@@ -347,9 +475,18 @@ namespace Falcor
         stream.write(sceneData.has16BitIndices);
         stream.write(sceneData.has32BitIndices);
         stream.write(sceneData.meshDrawCount);
+        stream.write(sceneData.deduplicatedMeshCount);
+        stream.write(sceneData.deferMaterialOptimization);
         stream.write(sceneData.meshIndexData);
         stream.write(sceneData.meshStaticData);
         stream.write(sceneData.meshSkinningData);
+        stream.write(sceneData.meshlets);
+        stream.write(sceneData.meshletOffsets);
+        stream.write(sceneData.meshletVertices);
+        stream.write(sceneData.meshletTriangles);
+        stream.write(sceneData.meshLods);
+        stream.write(sceneData.meshLodOffsets);
+        stream.write(sceneData.meshLodIndices);
 
         writeMarker(stream, "Curves");
         stream.write(sceneData.curveDesc);
@@ -468,9 +605,18 @@ namespace Falcor
         stream.read(sceneData.has16BitIndices);
         stream.read(sceneData.has32BitIndices);
         stream.read(sceneData.meshDrawCount);
+        stream.read(sceneData.deduplicatedMeshCount);
+        stream.read(sceneData.deferMaterialOptimization);
         stream.read(sceneData.meshIndexData);
         stream.read(sceneData.meshStaticData);
         stream.read(sceneData.meshSkinningData);
+        stream.read(sceneData.meshlets);
+        stream.read(sceneData.meshletOffsets);
+        stream.read(sceneData.meshletVertices);
+        stream.read(sceneData.meshletTriangles);
+        stream.read(sceneData.meshLods);
+        stream.read(sceneData.meshLodOffsets);
+        stream.read(sceneData.meshLodIndices);
 
         readMarker(stream, "Curves");
         stream.read(sceneData.curveDesc);
@@ -670,14 +816,14 @@ namespace Falcor
         stream.write(pMaterial->mUpdates);
         writeTransform(stream, pMaterial->mTextureTransform);
 
+        // Textures are stored by source path. Materials from headless builds only have the path.
         auto writeTextureSlot = [&stream, &pMaterial](Material::TextureSlot slot)
         {
-            auto pTexture = pMaterial->getTexture(slot);
-            bool hasTexture = pTexture != nullptr;
+            bool hasTexture = pMaterial->hasTextureSlotData(slot);
             stream.write(hasTexture);
             if (hasTexture)
             {
-                stream.write(pTexture->getSourcePath());
+                stream.write(pMaterial->getTextureSourcePath(slot));
             }
         };
 
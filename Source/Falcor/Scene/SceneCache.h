@@ -56,7 +56,19 @@ namespace Falcor
     public:
         using Key = SHA1::MD;
 
+        /** Describes a file the scene cache was built from.
+            The cache is invalidated if any of its dependencies changed.
+        */
+        struct Dependency
+        {
+            std::filesystem::path path;     ///< Absolute file path.
+            uint64_t size = 0;              ///< File size in bytes.
+            int64_t lastWriteTime = 0;      ///< Last write time in file clock ticks.
+            uint64_t hash = 0;              ///< Content hash (see ContentHash).
+        };
+
         /** Check if there is a valid scene cache for a given cache key.
+            The cache is valid if its header matches and all recorded dependencies are unchanged.
             \param[in] key Cache key.
             \return Returns true if a valid cache exists.
         */
@@ -65,8 +77,9 @@ namespace Falcor
         /** Write a scene cache.
             \param[in] sceneData Scene data.
             \param[in] key Cache key.
+            \param[in] dependencies List of files the scene was built from (see collectDependencies()).
         */
-        static void writeCache(const Scene::SceneData& sceneData, const Key& key);
+        static void writeCache(const Scene::SceneData& sceneData, const Key& key, const std::vector<Dependency>& dependencies = {});
 
         /** Read a scene cache.
             \param[in] pDevice GPU device.
@@ -75,11 +88,34 @@ namespace Falcor
         */
         static Scene::SceneData readCache(ref<Device> pDevice, const Key& key);
 
+        /** Record size, last write time and content hash of a list of files.
+            Files are processed in parallel. Files that cannot be read are skipped with a warning.
+            \param[in] paths List of file paths.
+            \return Returns the list of dependencies.
+        */
+        static std::vector<Dependency> collectDependencies(const std::vector<std::filesystem::path>& paths);
+
+        /** Check if a list of dependencies is unchanged.
+            Only file size and last write time are checked for files that were not touched.
+            If the size matches but the last write time differs, the content hash is compared.
+            Files are checked in parallel.
+            \param[in] dependencies List of dependencies.
+            \return Returns true if all dependencies are unchanged.
+        */
+        static bool validateDependencies(const std::vector<Dependency>& dependencies);
+
+        /** Get the path of the scene cache file for a given cache key.
+            \param[in] key Cache key.
+            \return Returns the cache file path.
+        */
+        static std::filesystem::path getCachePath(const Key& key);
+
     private:
         class OutputStream;
         class InputStream;
 
-        static std::filesystem::path getCachePath(const Key& key);
+        static void writeDependencies(OutputStream& stream, const std::vector<Dependency>& dependencies);
+        static std::vector<Dependency> readDependencies(InputStream& stream);
 
         static void writeSceneData(OutputStream& stream, const Scene::SceneData& sceneData);
         static Scene::SceneData readSceneData(InputStream& stream, ref<Device> pDevice);
@@ -208,6 +208,8 @@ namespace Falcor
         , mpFloatGrid(mGridHandle.grid<float>())
         , mAccessor(mpFloatGrid->getAccessor())
     {
+        FALCOR_CHECK(mpDevice != nullptr, "'pDevice' must be a valid device");
+
         if (!mpFloatGrid->hasMinMax())
         {
             nanovdb::gridStats(*mpFloatGrid);
@@ -32,6 +32,7 @@
 #include "Utils/Logger.h"
 #include "Utils/HostDeviceShared.slangh"
 #include "Utils/NumericRange.h"
+#include "Utils/Math/Float16.h"
 #include "Utils/Math/Vector.h"
 #include "Utils/Timing/CpuTimer.h"
 
@@ -90,12 +91,6 @@ namespace Falcor
             return float2(std::max(a.x, b.x), std::min(a.y, b.y));
         }
 
-        inline float2 unpackMajMin(const uint32_t* data)
-        {
-            const uint16_t* data16 = (const uint16_t*)data;
-            return float2(f16tof32(data16[0]), f16tof32(data16[1]));
-        }
-
         inline void expandMinorantMajorant(float value, float& min_inout, float& maj_inout)
         {
             if (value < min_inout) min_inout = value;
@@ -250,15 +245,27 @@ namespace Falcor
     template <typename TexelType, unsigned int kBitsPerTexel>
     void NanoVDBToBricksConverter<TexelType, kBitsPerTexel>::computeMip(int mip)
     {
-        uint32_t* rangedst = mRangeData.data() + mLeafCount[mip - 1];
-        uint32_t* rangesrc = mRangeData.data() + ((mip > 1) ? mLeafCount[mip - 2] : 0);
+        const uint32_t srcOffset = (mip > 1) ? mLeafCount[mip - 2] : 0;
+        const uint32_t srcCount = mLeafCount[mip - 1] - srcOffset;
+        const uint32_t dstOffset = mLeafCount[mip - 1];
+        const uint32_t dstCount = mLeafCount[mip] - dstOffset;
+
+        // Unpack the source mip to (major, minor) float pairs in one batch.
+        std::vector<float2> src(srcCount);
+        math::float16ToFloat32(
+            fstd::span<const uint16_t>(reinterpret_cast<const uint16_t*>(mRangeData.data() + srcOffset), srcCount * 2),
+            fstd::span<float>(&src.data()->x, srcCount * 2)
+        );
+
         int3 leafdim_src = mLeafDim[mip - 1];
         uint32_t rowstride_src = leafdim_src.x;
         uint32_t slicestride_src = leafdim_src.y * rowstride_src;
 
         int3 leafdim_tgt = mLeafDim[mip];
-        uint32_t rowstride_tgt = leafdim_tgt.x;
-        uint32_t slicestride_tgt = leafdim_tgt.y * rowstride_tgt;
+
+        std::vector<float2> dst(dstCount);
+        const float2* rangesrc = src.data();
+        float2* rangedst = dst.data();
 
         for (int z = 0; z < leafdim_tgt.z; ++z, rangesrc += slicestride_src)
         {
@@ -266,20 +273,25 @@ namespace Falcor
             {
                 for (int x = 0; x < leafdim_tgt.x; ++x, rangesrc += 2)
                 {
-                    float2 majmin_dst = combineMajMin(
+                    *rangedst++ = combineMajMin(
                         combineMajMin(
-                            combineMajMin(unpackMajMin(rangesrc), unpackMajMin(rangesrc + 1)),
-                            combineMajMin(unpackMajMin(rangesrc + rowstride_src), unpackMajMin(rangesrc + 1 + rowstride_src))
+                            combineMajMin(rangesrc[0], rangesrc[1]),
+                            combineMajMin(rangesrc[rowstride_src], rangesrc[1 + rowstride_src])
                         ),
                         combineMajMin(
-                            combineMajMin(unpackMajMin(rangesrc + slicestride_src), unpackMajMin(rangesrc + slicestride_src + 1)),
-                            combineMajMin(unpackMajMin(rangesrc + slicestride_src + rowstride_src), unpackMajMin(rangesrc + slicestride_src + 1 + rowstride_src))
+                            combineMajMin(rangesrc[slicestride_src], rangesrc[slicestride_src + 1]),
+                            combineMajMin(rangesrc[slicestride_src + rowstride_src], rangesrc[slicestride_src + 1 + rowstride_src])
                         )
                     );
-                    *rangedst++ = f32tof16(majmin_dst.x) + (f32tof16(majmin_dst.y) << 16);
                 } // x
             } // y
         } // z
+
+        // Pack the results with the major value in the low 16 bits.
+        math::float32ToFloat16(
+            fstd::span<const float>(&dst.data()->x, dstCount * 2),
+            fstd::span<uint16_t>(reinterpret_cast<uint16_t*>(mRangeData.data() + dstOffset), dstCount * 2)
+        );
     }
 
     template <typename TexelType, unsigned int kBitsPerTexel>
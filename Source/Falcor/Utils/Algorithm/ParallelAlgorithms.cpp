@@ -0,0 +1,143 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ParallelAlgorithms.h"
+#include "Utils/Timing/CpuEventRecorder.h"
+#include <BS_thread_pool.hpp>
+#include <atomic>
+#include <exception>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace Falcor
+{
+namespace parallel
+{
+namespace
+{
+/// Set while a thread executes blocks or is in a ScopedSerialExecution scope.
+/// Nested calls on such threads run serially to avoid waiting on the pool from within it.
+thread_local bool sInParallelRegion = false;
+
+BS::thread_pool& getThreadPool()
+{
+    // The calling thread participates in the work, so the pool has one thread less than the hardware.
+    // The pool is created on first use and intentionally never destroyed, as joining threads during
+    // static destruction can deadlock when the library is unloaded.
+    static BS::thread_pool* spThreadPool = new BS::thread_pool(std::max(2u, std::thread::hardware_concurrency()) - 1);
+    return *spThreadPool;
+}
+} // namespace
+
+uint32_t getThreadCount()
+{
+    return getThreadPool().get_thread_count() + 1;
+}
+
+ScopedSerialExecution::ScopedSerialExecution() : mWasSerial(sInParallelRegion)
+{
+    sInParallelRegion = true;
+}
+
+ScopedSerialExecution::~ScopedSerialExecution()
+{
+    sInParallelRegion = mWasSerial;
+}
+
+namespace detail
+{
+void runBlocks(size_t blockCount, const std::function<void(size_t)>& func)
+{
+    if (blockCount == 0)
+        return;
+
+    if (blockCount == 1 || sInParallelRegion)
+    {
+        for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+            func(blockIndex);
+        return;
+    }
+
+    std::atomic<size_t> nextBlock{0};
+    std::atomic<bool> abort{false};
+    std::exception_ptr exception;
+    std::mutex exceptionMutex;
+
+    // Each participating thread processes blocks until all blocks have been taken.
+    auto work = [&]()
+    {
+        bool wasInParallelRegion = sInParallelRegion;
+        sInParallelRegion = true;
+        size_t blockIndex;
+        while (!abort.load(std::memory_order_relaxed) && (blockIndex = nextBlock.fetch_add(1)) < blockCount)
+        {
+            try
+            {
+                func(blockIndex);
+            }
+            catch (...)
+            {
+                std::lock_guard<std::mutex> lock(exceptionMutex);
+                if (!exception)
+                    exception = std::current_exception();
+                abort.store(true, std::memory_order_relaxed);
+            }
+        }
+        sInParallelRegion = wasInParallelRegion;
+    };
+
+    // Pool threads record a CPU event for their share of the work so that they show up in CPU traces.
+    auto helperWork = [&]()
+    {
+        thread_local bool sThreadNamed = false;
+        if (!sThreadNamed)
+        {
+            CpuEventRecorder::setThreadName("Parallel worker");
+            sThreadNamed = true;
+        }
+        FALCOR_PROFILE_CPU("parallel::runBlocks");
+        work();
+    };
+
+    BS::thread_pool& threadPool = getThreadPool();
+    size_t helperCount = std::min<size_t>(threadPool.get_thread_count(), blockCount - 1);
+    std::vector<std::future<void>> helpers;
+    helpers.reserve(helperCount);
+    for (size_t i = 0; i < helperCount; ++i)
+        helpers.push_back(threadPool.submit(helperWork));
+
+    work();
+    for (auto& helper : helpers)
+        helper.wait();
+
+    if (exception)
+        std::rethrow_exception(exception);
+}
+} // namespace detail
+} // namespace parallel
+} // namespace Falcor
@@ -0,0 +1,474 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Error.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Parallel algorithms on the host.
+ *
+ * These are the CPU counterparts of the GPU primitives in this directory (PrefixSum, BitonicSort, ParallelReduction)
+ * with the same semantics, so results can be cross-checked. Work is split into blocks of a fixed number of elements
+ * that are processed on a persistent thread pool, with the calling thread participating. The block partition only
+ * depends on the element count and grain size, not on the number of threads, so all results are deterministic.
+ *
+ * Calls made from within a parallel algorithm (nested parallelism) are executed serially on the calling thread.
+ */
+namespace parallel
+{
+/// Default number of elements processed per block.
+constexpr size_t kDefaultGrainSize = 4096;
+
+/// Returns the number of threads used by the parallel algorithms, including the calling thread.
+FALCOR_API uint32_t getThreadCount();
+
+/**
+ * Runs the parallel algorithms called on this thread serially while in scope.
+ * Results don't depend on the number of threads, so this is used to check parallel code against serial execution.
+ */
+class FALCOR_API ScopedSerialExecution
+{
+public:
+    ScopedSerialExecution();
+    ~ScopedSerialExecution();
+
+    ScopedSerialExecution(const ScopedSerialExecution&) = delete;
+    ScopedSerialExecution& operator=(const ScopedSerialExecution&) = delete;
+
+private:
+    bool mWasSerial;
+};
+
+namespace detail
+{
+/**
+ * Runs func(blockIndex) for all blocks in [0, blockCount) on the thread pool and waits for completion.
+ * The first exception thrown by func is rethrown on the calling thread after all running blocks have finished.
+ */
+FALCOR_API void runBlocks(size_t blockCount, const std::function<void(size_t)>& func);
+
+struct NoValues
+{};
+} // namespace detail
+
+/// Returns the number of blocks needed to process count elements in blocks of blockSize elements.
+inline size_t getBlockCount(size_t count, size_t blockSize)
+{
+    FALCOR_ASSERT(blockSize > 0);
+    return (count + blockSize - 1) / blockSize;
+}
+
+/**
+ * Processes count elements in parallel in blocks of blockSize elements.
+ * @param[in] count Number of elements.
+ * @param[in] blockSize Number of elements per block.
+ * @param[in] func Function called as func(blockIndex, begin, end) for each block.
+ */
+template<typename F>
+void forEachBlock(size_t count, size_t blockSize, F&& func)
+{
+    detail::runBlocks(
+        getBlockCount(count, blockSize),
+        [&](size_t blockIndex)
+        {
+            size_t begin = blockIndex * blockSize;
+            size_t end = std::min(begin + blockSize, count);
+            func(blockIndex, begin, end);
+        }
+    );
+}
+
+/**
+ * Calls func(i) for all i in [0, count) in parallel.
+ */
+template<typename F>
+void forEach(size_t count, F&& func, size_t grainSize = kDefaultGrainSize)
+{
+    forEachBlock(
+        count,
+        grainSize,
+        [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+                func(i);
+        }
+    );
+}
+
+/**
+ * Parallel reduction over transformed elements.
+ * The elements of each block are reduced in order, and the block results are then reduced in order onto init.
+ * @param[in] count Number of elements.
+ * @param[in] init Initial value.
+ * @param[in] map Function returning the value of element i.
+ * @param[in] op Associative reduction operator.
+ * @return The reduced value, or init if count is zero.
+ */
+template<typename T, typename MapFunc, typename ReduceOp>
+T transformReduce(size_t count, T init, MapFunc&& map, ReduceOp&& op, size_t grainSize = kDefaultGrainSize)
+{
+    std::vector<T> partials(getBlockCount(count, grainSize), init);
+    forEachBlock(
+        count,
+        grainSize,
+        [&](size_t blockIndex, size_t begin, size_t end)
+        {
+            T value = map(begin);
+            for (size_t i = begin + 1; i < end; ++i)
+                value = op(value, map(i));
+            partials[blockIndex] = value;
+        }
+    );
+
+    T result = init;
+    for (const T& value : partials)
+        result = op(result, value);
+    return result;
+}
+
+/**
+ * Parallel reduction over an array, e.g. the sum (default) or min/max of all elements.
+ */
+template<typename T, typename ReduceOp = std::plus<T>>
+T reduce(const T* data, size_t count, T init, ReduceOp op = {}, size_t grainSize = kDefaultGrainSize)
+{
+    return transformReduce(
+        count, init, [data](size_t i) { return data[i]; }, op, grainSize
+    );
+}
+
+/**
+ * Parallel exclusive scan (prefix sum), y[i] = x[0] + ... + x[i-1] and y[0] = 0.
+ * For unsigned integer types the sums wrap around like on the GPU (see PrefixSum).
+ * @param[in] input Input elements.
+ * @param[out] output Output elements. May be equal to input to compute the scan in place.
+ * @param[in] count Number of elements.
+ * @return The sum of all elements.
+ */
+template<typename T>
+T exclusiveScan(const T* input, T* output, size_t count, size_t grainSize = kDefaultGrainSize)
+{
+    // Compute the sum of each block, then scan the blocks with the block sums as offsets.
+    std::vector<T> blockSums(getBlockCount(count, grainSize), T(0));
+    forEachBlock(
+        count,
+        grainSize,
+        [&](size_t blockIndex, size_t begin, size_t end)
+        {
+            T sum = T(0);
+            for (size_t i = begin; i < end; ++i)
+                sum += input[i];
+            blockSums[blockIndex] = sum;
+        }
+    );
+
+    T total = T(0);
+    for (T& sum : blockSums)
+    {
+        T tmp = sum;
+        sum = total;
+        total += tmp;
+    }
+
+    forEachBlock(
+        count,
+        grainSize,
+        [&](size_t blockIndex, size_t begin, size_t end)
+        {
+            T sum = blockSums[blockIndex];
+            for (size_t i = begin; i < end; ++i)
+            {
+                T tmp = input[i];
+                output[i] = sum;
+                sum += tmp;
+            }
+        }
+    );
+
+    return total;
+}
+
+/**
+ * Parallel in-place exclusive scan. See exclusiveScan() above.
+ */
+template<typename T>
+T exclusiveScan(T* data, size_t count, size_t grainSize = kDefaultGrainSize)
+{
+    return exclusiveScan(static_cast<const T*>(data), data, count, grainSize);
+}
+
+/**
+ * Parallel stream compaction. Copies the elements for which the predicate is true to the output, preserving their order.
+ * @param[in] input Input elements.
+ * @param[in] count Number of input elements.
+ * @param[out] output Output elements. Must have space for count elements and must not overlap the input.
+ * @param[in] pred Predicate called once per element as pred(input[i]).
+ * @return The number of elements written to the output.
+ */
+template<typename T, typename Pred>
+size_t compact(const T* input, size_t count, T* output, Pred&& pred, size_t grainSize = kDefaultGrainSize)
+{
+    std::vector<uint8_t> flags(count);
+    std::vector<size_t> offsets(getBlockCount(count, grainSize), 0);
+    forEachBlock(
+        count,
+        grainSize,
+        [&](size_t blockIndex, size_t begin, size_t end)
+        {
+            size_t selected = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                flags[i] = pred(input[i]) ? 1 : 0;
+                selected += flags[i];
+            }
+            offsets[blockIndex] = selected;
+        }
+    );
+
+    size_t total = exclusiveScan(offsets.data(), offsets.size());
+
+    forEachBlock(
+        count,
+        grainSize,
+        [&](size_t blockIndex, size_t begin, size_t end)
+        {
+            size_t dst = offsets[blockIndex];
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (flags[i])
+                    output[dst++] = input[i];
+            }
+        }
+    );
+
+    return total;
+}
+
+/**
+ * Parallel stream compaction of a vector. See compact() above.
+ */
+template<typename T, typename Pred>
+std::vector<T> compact(const std::vector<T>& input, Pred&& pred, size_t grainSize = kDefaultGrainSize)
+{
+    std::vector<T> output(input.size());
+    output.resize(compact(input.data(), input.size(), output.data(), std::forward<Pred>(pred), grainSize));
+    return output;
+}
+
+/**
+ * Parallel histogram.
+ * @param[in] count Number of elements.
+ * @param[in] binCount Number of bins.
+ * @param[in] binIndex Function returning the bin index in [0, binCount) of element i.
+ * @return Number of elements in each bin.
+ */
+template<typename F>
+std::vector<uint32_t> histogram(size_t count, uint32_t binCount, F&& binIndex, size_t grainSize = kDefaultGrainSize)
+{
+    // Each block builds a local histogram, so make the blocks at least as large as the histogram.
+    const size_t blockSize = std::max(grainSize, (size_t)binCount);
+    const size_t blockCount = getBlockCount(count, blockSize);
+    std::vector<uint32_t> blockBins(blockCount * binCount, 0);
+    forEachBlock(
+        count,
+        blockSize,
+        [&](size_t blockIndex, size_t begin, size_t end)
+        {
+            uint32_t* bins = &blockBins[blockIndex * binCount];
+            for (size_t i = begin; i < end; ++i)
+            {
+                uint32_t bin = binIndex(i);
+                FALCOR_ASSERT(bin < binCount);
+                bins[bin]++;
+            }
+        }
+    );
+
+    std::vector<uint32_t> bins(binCount, 0);
+    forEach(
+        binCount,
+        [&](size_t bin)
+        {
+            for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+                bins[bin] += blockBins[blockIndex * binCount + bin];
+        }
+    );
+    return bins;
+}
+
+namespace detail
+{
+template<typename K, typename V>
+void radixSort(K* keys, V* values, size_t count, uint32_t keyBits, size_t grainSize)
+{
+    static_assert(std::is_integral_v<K> && std::is_unsigned_v<K>, "Radix sort keys must be unsigned integers");
+    constexpr bool kHasValues = !std::is_same_v<V, NoValues>;
+    constexpr uint32_t kDigitBits = 8;
+    constexpr uint32_t kDigitCount = 1u << kDigitBits;
+    FALCOR_CHECK(keyBits <= sizeof(K) * 8, "Radix sort key bits ({}) exceed the key size", keyBits);
+
+    if (count <= 1)
+        return;
+
+    // Each block counts its digits in a local histogram, so make the blocks large compared to the histogram.
+    const size_t blockSize = std::max(grainSize, (size_t)kDigitCount * 16);
+    const size_t blockCount = getBlockCount(count, blockSize);
+    std::vector<size_t> offsets(blockCount * kDigitCount);
+
+    std::vector<K> tmpKeys(count);
+    std::vector<V> tmpValues(kHasValues ? count : 0);
+    K* srcKeys = keys;
+    K* dstKeys = tmpKeys.data();
+    V* srcValues = values;
+    V* dstValues = tmpValues.data();
+
+    // Stable least-significant-digit radix sort. Each pass scatters the elements by one digit.
+    for (uint32_t shift = 0; shift < keyBits; shift += kDigitBits)
+    {
+        const K mask = K((1u << std::min(kDigitBits, keyBits - shift)) - 1);
+
+        forEachBlock(
+            count,
+            blockSize,
+            [&](size_t blockIndex, size_t begin, size_t end)
+            {
+                size_t* blockOffsets = &offsets[blockIndex * kDigitCount];
+                std::fill(blockOffsets, blockOffsets + kDigitCount, 0);
+                for (size_t i = begin; i < end; ++i)
+                    blockOffsets[(srcKeys[i] >> shift) & mask]++;
+            }
+        );
+
+        // Skip the pass if all keys have the same digit.
+        bool uniformDigit = false;
+        for (uint32_t digit = 0; digit < kDigitCount && !uniformDigit; ++digit)
+        {
+            size_t digitCount = 0;
+            for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+                digitCount += offsets[blockIndex * kDigitCount + digit];
+            uniformDigit = digitCount == count;
+        }
+        if (uniformDigit)
+            continue;
+
+        // Convert the counts to output offsets. Elements are ordered by digit, then by block.
+        size_t offset = 0;
+        for (uint32_t digit = 0; digit < kDigitCount; ++digit)
+        {
+            for (size_t blockIndex = 0; blockIndex < blockCount; ++blockIndex)
+            {
+                size_t& blockOffset = offsets[blockIndex * kDigitCount + digit];
+                size_t digitCount = blockOffset;
+                blockOffset = offset;
+                offset += digitCount;
+            }
+        }
+
+        forEachBlock(
+            count,
+            blockSize,
+            [&](size_t blockIndex, size_t begin, size_t end)
+            {
+                size_t* blockOffsets = &offsets[blockIndex * kDigitCount];
+                for (size_t i = begin; i < end; ++i)
+                {
+                    size_t dst = blockOffsets[(srcKeys[i] >> shift) & mask]++;
+                    dstKeys[dst] = srcKeys[i];
+                    if constexpr (kHasValues)
+                        dstValues[dst] = std::move(srcValues[i]);
+                }
+            }
+        );
+
+        std::swap(srcKeys, dstKeys);
+        std::swap(srcValues, dstValues);
+    }
+
+    // Copy the result back if it ended up in the temporary buffers.
+    if (srcKeys != keys)
+    {
+        forEach(
+            count,
+            [&](size_t i)
+            {
+                keys[i] = srcKeys[i];
+                if constexpr (kHasValues)
+                    values[i] = std::move(srcValues[i]);
+            }
+        );
+    }
+}
+} // namespace detail
+
+/**
+ * Parallel radix sort of unsigned integer keys in ascending order.
+ * @param[in,out] keys Keys to sort in place.
+ * @param[in] count Number of keys.
+ * @param[in] keyBits Number of low key bits to sort by. Higher bits are ignored.
+ */
+template<typename K>
+void radixSort(K* keys, size_t count, uint32_t keyBits = sizeof(K) * 8, size_t grainSize = kDefaultGrainSize)
+{
+    detail::radixSort<K, detail::NoValues>(keys, nullptr, count, keyBits, grainSize);
+}
+
+/**
+ * Parallel stable radix sort of key-value pairs by unsigned integer keys in ascending order.
+ * Values with equal keys keep their relative order, which makes this usable for sorting indices
+ * by e.g. 64-bit Morton codes or hashes with the same result as std::stable_sort.
+ * @param[in,out] keys Keys to sort in place.
+ * @param[in,out] values Values to reorder together with the keys.
+ * @param[in] count Number of key-value pairs.
+ * @param[in] keyBits Number of low key bits to sort by. Higher bits are ignored.
+ */
+template<typename K, typename V>
+void radixSortKeyValue(K* keys, V* values, size_t count, uint32_t keyBits = sizeof(K) * 8, size_t grainSize = kDefaultGrainSize)
+{
+    detail::radixSort<K, V>(keys, values, count, keyBits, grainSize);
+}
+
+/**
+ * Converts a float to an unsigned integer key with the same ordering, for use with radixSort().
+ * Negative zero orders before positive zero.
+ */
+inline uint32_t floatToRadixKey(float f)
+{
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+} // namespace parallel
+} // namespace Falcor
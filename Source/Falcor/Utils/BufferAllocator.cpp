@@ -73,7 +73,7 @@ void BufferAllocator::modified(size_t byteOffset, size_t byteSize)
 void BufferAllocator::clear()
 {
     mBuffer.clear();
-    mDirty = {};
+    mDirtyRanges.clear();
 }
 
 ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
@@ -104,24 +104,68 @@ ref<Buffer> BufferAllocator::getGPUBuffer(ref<Device> pDevice)
             mpGpuBuffer = pDevice->createBuffer(bufSize, mBindFlags, MemoryType::DeviceLocal, nullptr);
         }
 
-        mDirty = Range(0, mBuffer.size()); // Mark entire buffer as dirty so the data gets uploaded.
+        // Mark entire buffer as dirty so the data gets uploaded.
+        mDirtyRanges.clear();
+        markAsDirty(Range(0, mBuffer.size()));
     }
 
     // If any range is dirty, upload the data from the CPU to the GPU.
-    if (mDirty.start < mDirty.end)
+    if (!mDirtyRanges.empty())
     {
-        size_t byteSize = mDirty.end - mDirty.start;
-        size_t byteOffset = mDirty.start;
-        FALCOR_ASSERT(byteOffset + byteSize <= mBuffer.size());
         FALCOR_ASSERT(mBuffer.size() <= mpGpuBuffer->getSize());
-        mpGpuBuffer->setBlob(mBuffer.data() + byteOffset, byteOffset, byteSize);
 
-        mDirty = {mBuffer.size(), 0}; // Reset dirty range to inverted range. Any min/max operation on it will work.
+        std::vector<Range> uploadRanges = getUploadRanges();
+        FALCOR_ASSERT(!uploadRanges.empty() && uploadRanges.back().end <= mBuffer.size());
+
+        if (uploadRanges.size() == 1)
+        {
+            const Range& range = uploadRanges[0];
+            mpGpuBuffer->setBlob(mBuffer.data() + range.start, range.start, range.size());
+        }
+        else
+        {
+            std::vector<CopyContext::BufferRegion> regions;
+            regions.reserve(uploadRanges.size());
+            for (const Range& range : uploadRanges)
+                regions.push_back({range.start, range.size()});
+            pDevice->getRenderContext()->updateBufferRegions(mpGpuBuffer.get(), mBuffer.data(), regions);
+        }
+
+        mStats.uploadCount++;
+        mStats.regionCount += uploadRanges.size();
+        for (const auto& [start, end] : mDirtyRanges)
+            mStats.bytesDirty += end - start;
+        for (const Range& range : uploadRanges)
+            mStats.bytesUploaded += range.size();
+
+        mDirtyRanges.clear();
     }
 
     return mpGpuBuffer;
 }
 
+std::vector<BufferAllocator::Range> BufferAllocator::getDirtyRanges() const
+{
+    std::vector<Range> ranges;
+    ranges.reserve(mDirtyRanges.size());
+    for (const auto& [start, end] : mDirtyRanges)
+        ranges.emplace_back(start, end);
+    return ranges;
+}
+
+std::vector<BufferAllocator::Range> BufferAllocator::getUploadRanges() const
+{
+    std::vector<Range> ranges;
+    for (const auto& [start, end] : mDirtyRanges)
+    {
+        if (!ranges.empty() && start - ranges.back().end < mUploadGapThreshold)
+            ranges.back().end = end;
+        else
+            ranges.emplace_back(start, end);
+    }
+    return ranges;
+}
+
 // Private
 
 void BufferAllocator::computeAndAllocatePadding(size_t byteSize)
@@ -162,8 +206,22 @@ size_t BufferAllocator::allocInternal(size_t byteSize)
 
 void BufferAllocator::markAsDirty(const Range& range)
 {
-    FALCOR_ASSERT(range.start < range.end);
-    mDirty.start = std::min(mDirty.start, range.start);
-    mDirty.end = std::max(mDirty.end, range.end);
+    if (range.start >= range.end)
+        return;
+
+    // Find the first dirty range that overlaps or is adjacent to the new range.
+    Range merged = range;
+    auto it = mDirtyRanges.upper_bound(range.start);
+    if (it != mDirtyRanges.begin() && std::prev(it)->second >= range.start)
+        --it;
+
+    // Merge all overlapping and adjacent ranges into the new range.
+    while (it != mDirtyRanges.end() && it->first <= merged.end)
+    {
+        merged.start = std::min(merged.start, it->first);
+        merged.end = std::max(merged.end, it->second);
+        it = mDirtyRanges.erase(it);
+    }
+    mDirtyRanges.emplace(merged.start, merged.end);
 }
 } // namespace Falcor
@@ -30,6 +30,7 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 
+#include <map>
 #include <vector>
 
 namespace Falcor
@@ -49,10 +50,38 @@ namespace Falcor
  * It is assumed that the base pointer of the GPU buffer starts at a
  * cache line. The implementation doesn't provide any alignment
  * guarantees for the CPU side buffer (where it doesn't matter anyway).
+ *
+ * Modified memory is tracked as a set of disjoint dirty ranges. When the
+ * GPU buffer is updated, dirty ranges separated by less than the upload gap
+ * threshold are coalesced and uploaded together as a batch of copy regions.
  */
 class FALCOR_API BufferAllocator
 {
 public:
+    /// Default upload gap threshold in bytes. Dirty ranges closer than this are uploaded as one copy region.
+    static constexpr size_t kDefaultUploadGapThreshold = 256;
+
+    /// Byte range [start, end).
+    struct Range
+    {
+        size_t start = 0;
+        size_t end = 0;
+        Range(){};
+        Range(size_t s, size_t e) : start(s), end(e) {}
+
+        size_t size() const { return end - start; }
+        bool operator==(const Range& other) const { return start == other.start && end == other.end; }
+    };
+
+    /// Upload statistics accumulated over calls to getGPUBuffer().
+    struct Stats
+    {
+        uint64_t uploadCount = 0;   ///< Number of GPU buffer updates.
+        uint64_t regionCount = 0;   ///< Number of copy regions uploaded.
+        uint64_t bytesDirty = 0;    ///< Number of bytes that were marked dirty.
+        uint64_t bytesUploaded = 0; ///< Number of bytes uploaded, including the clean gaps between coalesced dirty ranges.
+    };
+
     /**
      * Create a buffer allocator.
      * @param[in] alignment Minimum alignment in bytes for any allocation.
@@ -197,18 +226,47 @@ public:
      */
     ref<Buffer> getGPUBuffer(ref<Device> pDevice);
 
+    /**
+     * Set the upload gap threshold. Dirty ranges separated by less than this number of bytes are coalesced
+     * into a single copy region when the GPU buffer is updated.
+     * @param[in] byteSize Gap threshold in bytes. A value of zero only coalesces adjacent ranges.
+     */
+    void setUploadGapThreshold(size_t byteSize) { mUploadGapThreshold = byteSize; }
+
+    /**
+     * Get the upload gap threshold.
+     * @return Gap threshold in bytes.
+     */
+    size_t getUploadGapThreshold() const { return mUploadGapThreshold; }
+
+    /**
+     * Get the disjoint, sorted ranges of the buffer that are dirty and need to be updated on the GPU.
+     * Overlapping and adjacent ranges are merged.
+     * @return List of dirty ranges.
+     */
+    std::vector<Range> getDirtyRanges() const;
+
+    /**
+     * Get the copy regions for the next GPU buffer update.
+     * These are the dirty ranges with gaps below the upload gap threshold coalesced.
+     * @return List of upload ranges.
+     */
+    std::vector<Range> getUploadRanges() const;
+
+    /**
+     * Get the upload statistics.
+     */
+    const Stats& getStats() const { return mStats; }
+
+    /**
+     * Reset the upload statistics.
+     */
+    void resetStats() { mStats = {}; }
+
 private:
     void computeAndAllocatePadding(size_t byteSize);
     size_t allocInternal(size_t byteSize);
 
-    struct Range
-    {
-        size_t start = 0;
-        size_t end = 0;
-        Range(){};
-        Range(size_t s, size_t e) : start(s), end(e) {}
-    };
-
     void markAsDirty(const Range& range);
     void markAsDirty(size_t byteOffset, size_t byteSize) { markAsDirty(Range(byteOffset, byteOffset + byteSize)); }
 
@@ -224,9 +282,13 @@ private:
     /// Bind flags for the GPU buffer.
     const ResourceBindFlags mBindFlags;
 
-    /// Range of buffer that is dirty and needs to be updatd on the GPU. We track a single dirty range for now to minimize the number of
-    /// uploads, but this could be changed.
-    Range mDirty;
+    /// Disjoint ranges of the buffer that are dirty and need to be updated on the GPU, stored as a map from start to end offset.
+    std::map<size_t, size_t> mDirtyRanges;
+
+    /// Dirty ranges separated by less than this number of bytes are uploaded as a single copy region.
+    size_t mUploadGapThreshold = kDefaultUploadGapThreshold;
+
+    Stats mStats;
 
     std::vector<uint8_t> mBuffer; ///< CPU buffer holding a copy of the data.
     ref<Buffer> mpGpuBuffer;      ///< GPU buffer holding the data.
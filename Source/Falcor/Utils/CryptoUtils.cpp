@@ -26,8 +26,16 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "CryptoUtils.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include "Utils/StringFormatters.h"
+#include <algorithm>
+#include <cstring>
+#include <execution>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
+#include <vector>
 
 namespace Falcor
 {
@@ -257,4 +265,168 @@ void SHA1::processBlock(const uint8_t* ptr)
     mState[3] += d;
     mState[4] += e;
 }
+
+namespace
+{
+// Constants and round functions of the XXH64 hash.
+const uint64_t kPrime1 = 0x9e3779b185ebca87ull;
+const uint64_t kPrime2 = 0xc2b2ae3d27d4eb4full;
+const uint64_t kPrime3 = 0x165667b19e3779f9ull;
+const uint64_t kPrime4 = 0x85ebca77c2b2ae63ull;
+const uint64_t kPrime5 = 0x27d4eb2f165667c5ull;
+
+/// Number of chunks read from a file at once.
+const size_t kFileBlockChunks = 64;
+
+inline uint64_t rol64(uint64_t x, uint32_t n)
+{
+    return (x << n) | (x >> (64 - n));
+}
+
+inline uint64_t read64(const uint8_t* p)
+{
+    uint64_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint32_t read32(const uint8_t* p)
+{
+    uint32_t value;
+    std::memcpy(&value, p, sizeof(value));
+    return value;
+}
+
+inline uint64_t round64(uint64_t acc, uint64_t input)
+{
+    acc += input * kPrime2;
+    acc = rol64(acc, 31);
+    return acc * kPrime1;
+}
+
+inline uint64_t mergeRound64(uint64_t acc, uint64_t value)
+{
+    acc ^= round64(0, value);
+    return acc * kPrime1 + kPrime4;
+}
+
+/// Hash a chunk of data using four independent lanes processing 32 byte stripes.
+uint64_t hashChunk(const uint8_t* p, size_t len, uint64_t seed)
+{
+    const uint8_t* const pEnd = p + len;
+    uint64_t h;
+
+    if (len >= 32)
+    {
+        uint64_t lanes[4] = {seed + kPrime1 + kPrime2, seed + kPrime2, seed, seed - kPrime1};
+        const uint8_t* const pLimit = pEnd - 32;
+        do
+        {
+            for (uint32_t i = 0; i < 4; i++)
+                lanes[i] = round64(lanes[i], read64(p + 8 * i));
+            p += 32;
+        } while (p <= pLimit);
+
+        h = rol64(lanes[0], 1) + rol64(lanes[1], 7) + rol64(lanes[2], 12) + rol64(lanes[3], 18);
+        for (uint32_t i = 0; i < 4; i++)
+            h = mergeRound64(h, lanes[i]);
+    }
+    else
+    {
+        h = seed + kPrime5;
+    }
+
+    h += (uint64_t)len;
+
+    // Process remaining bytes.
+    for (; p + 8 <= pEnd; p += 8)
+        h = rol64(h ^ round64(0, read64(p)), 27) * kPrime1 + kPrime4;
+    if (p + 4 <= pEnd)
+    {
+        h = rol64(h ^ ((uint64_t)read32(p) * kPrime1), 23) * kPrime2 + kPrime3;
+        p += 4;
+    }
+    for (; p < pEnd; p++)
+        h = rol64(h ^ ((uint64_t)*p * kPrime5), 11) * kPrime1;
+
+    // Avalanche.
+    h ^= h >> 33;
+    h *= kPrime2;
+    h ^= h >> 29;
+    h *= kPrime3;
+    h ^= h >> 32;
+    return h;
+}
+
+/// Hash consecutive chunks of data, in parallel if there is more than one.
+void hashChunks(const uint8_t* p, size_t len, std::vector<uint64_t>& chunkHashes)
+{
+    const size_t firstChunk = chunkHashes.size();
+    const size_t chunkCount = std::max<size_t>(1, (len + ContentHash::kChunkSize - 1) / ContentHash::kChunkSize);
+    chunkHashes.resize(firstChunk + chunkCount);
+
+    auto hash = [&](size_t i)
+    {
+        const size_t offset = i * ContentHash::kChunkSize;
+        const size_t size = std::min(ContentHash::kChunkSize, len - offset);
+        chunkHashes[firstChunk + i] = hashChunk(p + offset, size, (uint64_t)(firstChunk + i));
+    };
+
+    if (chunkCount == 1)
+    {
+        hash(0);
+    }
+    else
+    {
+        auto range = NumericRange<size_t>(0, chunkCount);
+        std::for_each(std::execution::par, range.begin(), range.end(), hash);
+    }
+}
+
+/// Combine the chunk hashes into the final hash.
+uint64_t hashRoot(const std::vector<uint64_t>& chunkHashes, uint64_t totalLength)
+{
+    return hashChunk(reinterpret_cast<const uint8_t*>(chunkHashes.data()), chunkHashes.size() * sizeof(uint64_t), totalLength);
+}
+} // namespace
+
+uint64_t ContentHash::compute(const void* data, size_t len)
+{
+    FALCOR_CHECK(data || len == 0, "Invalid data pointer.");
+    std::vector<uint64_t> chunkHashes;
+    hashChunks(reinterpret_cast<const uint8_t*>(data), len, chunkHashes);
+    return hashRoot(chunkHashes, len);
+}
+
+uint64_t ContentHash::computeFile(const std::filesystem::path& path)
+{
+    std::ifstream fs(path, std::ios_base::binary);
+    if (!fs.good())
+        FALCOR_THROW("Failed to open file '{}' for hashing.", path);
+
+    // Read the file in blocks of whole chunks, which keeps the chunk boundaries equal to compute().
+    std::vector<uint8_t> block(kFileBlockChunks * kChunkSize);
+    std::vector<uint64_t> chunkHashes;
+    uint64_t totalLength = 0;
+    while (true)
+    {
+        fs.read(reinterpret_cast<char*>(block.data()), block.size());
+        const size_t len = (size_t)fs.gcount();
+        if (fs.bad())
+            FALCOR_THROW("Failed to read file '{}' for hashing.", path);
+        if (len > 0 || totalLength == 0)
+            hashChunks(block.data(), len, chunkHashes);
+        totalLength += len;
+        if (len < block.size())
+            break;
+    }
+    return hashRoot(chunkHashes, totalLength);
+}
+
+std::string ContentHash::toString(uint64_t hash)
+{
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0') << std::setw(16) << hash;
+    return ss.str();
+}
 } // namespace Falcor
@@ -28,6 +28,7 @@
 #pragma once
 #include "Core/Macros.h"
 #include <array>
+#include <filesystem>
 #include <string>
 #include <cstdint>
 #include <cstdlib>
@@ -100,4 +101,39 @@ private:
     uint32_t mState[5];
     uint8_t mBuf[64];
 };
+
+/**
+ * Helper to compute a fast non-cryptographic 64-bit content hash.
+ * Data is split into fixed size chunks, which are hashed independently (in parallel for large inputs)
+ * using four independent 64-bit lanes. The chunk hashes are then hashed into the final value.
+ * The result only depends on the data, not on the number of threads used.
+ * This is meant for detecting file changes, use SHA1 if a cryptographic hash is required.
+ */
+class FALCOR_API ContentHash
+{
+public:
+    /// Size of the independently hashed chunks.
+    static constexpr size_t kChunkSize = 64 * 1024;
+
+    /**
+     * Compute the content hash of the given data.
+     * @param[in] data Data to hash.
+     * @param[in] len Length of data in bytes.
+     * @return Returns the hash value.
+     */
+    static uint64_t compute(const void* data, size_t len);
+
+    /**
+     * Compute the content hash of a file. The result is equal to hashing the file content with compute().
+     * Throws if the file cannot be read.
+     * @param[in] path File path.
+     * @return Returns the hash value.
+     */
+    static uint64_t computeFile(const std::filesystem::path& path);
+
+    /**
+     * Convert hash to 16-character string in hexadecimal notation.
+     */
+    static std::string toString(uint64_t hash);
+};
 }; // namespace Falcor
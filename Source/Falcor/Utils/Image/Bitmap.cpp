@@ -29,6 +29,7 @@
 #include "Core/Macros.h"
 #include "Core/API/Texture.h"
 #include "Core/Platform/MemoryMappedFile.h"
+#include "Utils/Math/Float16.h"
 #include "Utils/Math/ScalarMath.h"
 #include "Utils/Logger.h"
 #include "Utils/StringUtils.h"
@@ -66,15 +67,27 @@ static bool isConvertibleToRGBA32Float(ResourceFormat format)
  */
 static std::vector<float> convertHalfToRGBA32Float(uint32_t width, uint32_t height, uint32_t channelCount, const void* pData)
 {
-    std::vector<float> newData(width * height * 4u, 0.f);
-    const float16_t* pSrc = reinterpret_cast<const float16_t*>(pData);
+    const size_t pixelCount = size_t(width) * height;
+    std::vector<float> newData(pixelCount * 4u, 0.f);
+    fstd::span<const uint16_t> src(reinterpret_cast<const uint16_t*>(pData), pixelCount * channelCount);
+
+    if (channelCount == 4)
+    {
+        math::float16ToFloat32(src, newData);
+        return newData;
+    }
+
+    // Batch convert into a temporary buffer and expand to RGBA.
+    std::vector<float> tmp(src.size());
+    math::float16ToFloat32(src, tmp);
+    const float* pSrc = tmp.data();
     float* pDst = newData.data();
 
-    for (uint32_t i = 0; i < width * height; ++i)
+    for (size_t i = 0; i < pixelCount; ++i)
     {
         for (uint32_t c = 0; c < channelCount; ++c)
         {
-            *pDst++ = float(*pSrc++);
+            *pDst++ = *pSrc++;
         }
         pDst += (4 - channelCount);
     }
@@ -0,0 +1,679 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "FLIP.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include "Utils/Math/MathConstants.slangh"
+#include "Utils/Scripting/ScriptBindings.h"
+#include "Utils/Scripting/ndarray.h"
+#include <algorithm>
+#include <cmath>
+#include <execution>
+#include <limits>
+#include <memory>
+
+namespace Falcor
+{
+namespace
+{
+/// Number of preprocessed input channels: Y, Cx, Cz and normalized luminance for feature detection.
+const uint32_t kInputChannels = 4;
+/// Index of the normalized luminance channel.
+const uint32_t kFeatureChannel = 3;
+/// Number of feature planes after the vertical pass: point x/y and edge x/y.
+const uint32_t kFeaturePlanes = 4;
+
+/// Normalized 1D Gaussian of a single term of a contrast sensitivity function, applied to one color channel.
+struct ColorFilterTerm
+{
+    uint32_t channel;
+    /// Weight of the term among all terms of the same channel.
+    float weight;
+    std::vector<float> kernel;
+};
+
+/**
+ * Separable 1D filter kernels of size 2 * radius + 1.
+ * All FLIP filters are separable (or sums of separable Gaussians) and use clamp-to-edge addressing,
+ * which is separable as well. The kernels are normalized such that the separable filters compute
+ * the same values as the 2D filters in FLIPPass.cs.slang.
+ */
+struct Filters
+{
+    int radius = 0;
+    std::vector<ColorFilterTerm> colorTerms;
+    std::vector<float> gaussian; ///< Feature detection Gaussian, normalized to sum to one.
+    std::vector<float> point;    ///< Point detection second derivative, normalized by the positive/negative lobe sums.
+    std::vector<float> edge;     ///< Edge detection first derivative, normalized by the positive lobe sum.
+
+    uint32_t kernelSize() const { return 2 * radius + 1; }
+    /// Number of planes after the horizontal pass: one per color term and the Gaussian, point and edge filtered luminance.
+    uint32_t horizontalPlanes() const { return (uint32_t)colorTerms.size() + 3; }
+    /// Number of planes after the vertical pass: one per color term and the feature planes.
+    uint32_t verticalPlanes() const { return (uint32_t)colorTerms.size() + kFeaturePlanes; }
+};
+
+Filters createFilters(float pixelsPerDegree)
+{
+    Filters filters;
+
+    // Use radius of the spatial filter kernel, as it is always greater than or equal to the radius of the feature detection kernel.
+    // See FLIP paper for explanation of the 0.04 and 3.0 factors.
+    filters.radius = (int)std::ceil(3.f * std::sqrt(0.04f / (2.f * (float)M_PI * (float)M_PI)) * pixelsPerDegree);
+    const int r = filters.radius;
+    const uint32_t size = filters.kernelSize();
+    const float dx = 1.f / pixelsPerDegree;
+
+    // The 2D CSF weight a1 * sqrt(pi / b1) * exp(-pi^2 * d^2 / b1) + a2 * sqrt(pi / b2) * exp(-pi^2 * d^2 / b2)
+    // is a sum of separable Gaussians. Each Gaussian is normalized separately and weighted by its share
+    // of the 2D kernel sum.
+    auto addChannel = [&](uint32_t channel, const float4& ab)
+    {
+        float coefficients[2] = {ab.x * std::sqrt((float)M_PI / ab.z), ab.y * std::sqrt((float)M_PI / ab.w)};
+        float b[2] = {ab.z, ab.w};
+        std::vector<ColorFilterTerm> terms;
+        float totalWeight = 0.f;
+        for (uint32_t i = 0; i < 2; i++)
+        {
+            if (coefficients[i] == 0.f)
+                continue;
+            ColorFilterTerm term{channel, 0.f, std::vector<float>(size)};
+            float sum = 0.f;
+            for (int x = -r; x <= r; x++)
+            {
+                float p = x * dx;
+                float value = std::exp(-p * p * (float)M_PI * (float)M_PI / b[i]);
+                term.kernel[x + r] = value;
+                sum += value;
+            }
+            for (float& value : term.kernel)
+                value /= sum;
+            term.weight = coefficients[i] * sum * sum;
+            totalWeight += term.weight;
+            terms.push_back(std::move(term));
+        }
+        for (auto& term : terms)
+        {
+            term.weight /= totalWeight;
+            filters.colorTerms.push_back(std::move(term));
+        }
+    };
+    addChannel(0, kFLIPCSFParamsA);
+    addChannel(1, kFLIPCSFParamsRG);
+    addChannel(2, kFLIPCSFParamsBY);
+
+    // Feature detection kernels. The 2D point and edge kernels are products of a 1D derivative and a 1D Gaussian.
+    // Their positive and negative lobe sums factor into the 1D lobe sums times the 1D Gaussian sum.
+    const float sigma = 0.5f * kFLIPw * pixelsPerDegree;
+    const float sigmaSquared = sigma * sigma;
+    filters.gaussian.resize(size);
+    filters.point.resize(size);
+    filters.edge.resize(size);
+    float gaussianSum = 0.f;
+    float positivePointSum = 0.f;
+    float negativePointSum = 0.f;
+    float edgeSum = 0.f;
+    for (int x = -r; x <= r; x++)
+    {
+        float g = std::exp(-(float)(x * x) / (2.f * sigmaSquared));
+        float point = ((float)(x * x) / sigmaSquared - 1.f) * g;
+        float edge = -(float)x * g;
+        filters.gaussian[x + r] = g;
+        filters.point[x + r] = point;
+        filters.edge[x + r] = edge;
+        gaussianSum += g;
+        (point >= 0.f ? positivePointSum : negativePointSum) += std::abs(point);
+        edgeSum += std::max(edge, 0.f);
+    }
+    for (uint32_t i = 0; i < size; i++)
+    {
+        filters.gaussian[i] /= gaussianSum;
+        filters.point[i] /= filters.point[i] >= 0.f ? positivePointSum : negativePointSum;
+        filters.edge[i] /= edgeSum;
+    }
+
+    return filters;
+}
+
+float HyAB(float3 a, float3 b)
+{
+    float3 diff = a - b;
+    return std::abs(diff.x) + std::sqrt(diff.y * diff.y + diff.z * diff.z);
+}
+
+float3 Hunt(float3 color)
+{
+    float huntValue = 0.01f * color.x;
+    return float3(color.x, huntValue * color.y, huntValue * color.z);
+}
+
+float3 toneMap(float3 col, FLIPToneMapperType toneMapper, const FLIPToneMapperCoefficients& k)
+{
+    if (toneMapper == FLIPToneMapperType::Reinhard)
+    {
+        float Y = luminance(col);
+        return clamp(col / (Y + 1.f), float3(0.f), float3(1.f));
+    }
+
+    float3 result;
+    for (int i = 0; i < 3; i++)
+    {
+        float c = col[i];
+        float nom = k.k0 * c * c + k.k1 * c + k.k2;
+        float denom = k.k3 * c * c + k.k4 * c + k.k5;
+        if (std::isinf(denom))
+            denom = 1.f; // avoid inf / inf division
+        result[i] = std::clamp(nom / denom, 0.f, 1.f);
+    }
+    return result;
+}
+
+/// Filter a padded row: pDst[x] = sum_k pKernel[k] * pSrc[x + k].
+void filterRow(const float* pSrc, const float* pKernel, uint32_t kernelSize, float* pDst, uint32_t width)
+{
+    std::fill(pDst, pDst + width, 0.f);
+    for (uint32_t k = 0; k < kernelSize; k++)
+    {
+        const float weight = pKernel[k];
+        const float* pS = pSrc + k;
+        for (uint32_t x = 0; x < width; x++)
+            pDst[x] += weight * pS[x];
+    }
+}
+
+/// Filter a column of rows: pDst[x] = sum_k pKernel[k] * rows[k][x].
+void filterColumns(const float* const* rows, const float* pKernel, uint32_t kernelSize, float* pDst, uint32_t width)
+{
+    std::fill(pDst, pDst + width, 0.f);
+    for (uint32_t k = 0; k < kernelSize; k++)
+    {
+        const float weight = pKernel[k];
+        const float* pS = rows[k];
+        for (uint32_t x = 0; x < width; x++)
+            pDst[x] += weight * pS[x];
+    }
+}
+
+class FLIPEvaluator
+{
+public:
+    FLIPEvaluator(const float* pReference, const float* pTest, uint32_t width, uint32_t height, const FLIP::Options& options)
+        : mWidth(width), mHeight(height), mOptions(options)
+    {
+        mpImages[0] = pReference;
+        mpImages[1] = pTest;
+        mFilters = createFilters(
+            FLIP::computePixelsPerDegree(options.monitorWidthPixels, options.monitorWidthMeters, options.monitorDistanceMeters)
+        );
+        mToneMapperCoefficients = getFLIPToneMapperCoefficients(options.toneMapper);
+        mMaxDistance = std::pow(
+            HyAB(Hunt(linearRGBToCIELab(float3(0.f, 1.f, 0.f))), Hunt(linearRGBToCIELab(float3(0.f, 0.f, 1.f)))), kFLIPqc
+        );
+    }
+
+    void setExposures(const FLIP::ExposureParameters& exposure) { mExposure = exposure; }
+
+    /// Evaluate the FLIP error of rows [y0, y1). For HDR-FLIP, also stores the index of the exposure with the largest error.
+    void processBand(uint32_t y0, uint32_t y1, float* pErrors, uint32_t* pExposureIndices) const
+    {
+        const int r = mFilters.radius;
+        const uint32_t kernelSize = mFilters.kernelSize();
+        const uint32_t paddedWidth = mWidth + 2 * r;
+        const uint32_t colorTermCount = (uint32_t)mFilters.colorTerms.size();
+        const uint32_t hPlanes = mFilters.horizontalPlanes();
+        const uint32_t vPlanes = mFilters.verticalPlanes();
+
+        // Ring buffer holding the last kernelSize horizontally filtered rows of all planes of both images.
+        std::vector<float> ring(2 * hPlanes * kernelSize * mWidth);
+        std::vector<float> padded(kInputChannels * paddedWidth);
+        std::vector<float> vertical(2 * vPlanes * mWidth);
+        std::vector<const float*> rows(kernelSize);
+
+        auto ringRow = [&](uint32_t image, uint32_t plane, int y) -> float*
+        {
+            uint32_t slot = (uint32_t)(((y % (int)kernelSize) + (int)kernelSize) % (int)kernelSize);
+            return ring.data() + ((image * hPlanes + plane) * kernelSize + slot) * mWidth;
+        };
+        auto verticalRow = [&](uint32_t image, uint32_t plane) -> float* { return vertical.data() + (image * vPlanes + plane) * mWidth; };
+
+        const uint32_t exposureCount = mOptions.isHDR ? mExposure.numExposures : 1;
+        for (uint32_t exposureIndex = 0; exposureIndex < exposureCount; exposureIndex++)
+        {
+            const float exposure = mOptions.isHDR ? mExposure.startExposure + exposureIndex * mExposure.exposureDelta : 0.f;
+            const float exposureScale = std::exp2(exposure);
+
+            for (int y = (int)y0 - r; y < (int)y1 + r; y++)
+            {
+                // Horizontal pass on input row y (clamp-to-edge).
+                const uint32_t sourceY = (uint32_t)std::clamp(y, 0, (int)mHeight - 1);
+                for (uint32_t image = 0; image < 2; image++)
+                {
+                    preprocessRow(mpImages[image] + (size_t)sourceY * mWidth * 4, exposureScale, padded.data(), paddedWidth);
+                    for (uint32_t t = 0; t < colorTermCount; t++)
+                    {
+                        const auto& term = mFilters.colorTerms[t];
+                        filterRow(padded.data() + term.channel * paddedWidth, term.kernel.data(), kernelSize, ringRow(image, t, y), mWidth);
+                    }
+                    const float* pFeature = padded.data() + kFeatureChannel * paddedWidth;
+                    filterRow(pFeature, mFilters.gaussian.data(), kernelSize, ringRow(image, colorTermCount + 0, y), mWidth);
+                    filterRow(pFeature, mFilters.point.data(), kernelSize, ringRow(image, colorTermCount + 1, y), mWidth);
+                    filterRow(pFeature, mFilters.edge.data(), kernelSize, ringRow(image, colorTermCount + 2, y), mWidth);
+                }
+
+                // Vertical pass once all rows of the kernel footprint of output row y - r are available.
+                const int outputY = y - r;
+                if (outputY < (int)y0)
+                    continue;
+
+                auto filterPlane = [&](uint32_t image, uint32_t hPlane, const std::vector<float>& kernel, uint32_t vPlane)
+                {
+                    for (uint32_t k = 0; k < kernelSize; k++)
+                        rows[k] = ringRow(image, hPlane, outputY - r + (int)k);
+                    filterColumns(rows.data(), kernel.data(), kernelSize, verticalRow(image, vPlane), mWidth);
+                };
+                for (uint32_t image = 0; image < 2; image++)
+                {
+                    for (uint32_t t = 0; t < colorTermCount; t++)
+                        filterPlane(image, t, mFilters.colorTerms[t].kernel, t);
+                    filterPlane(image, colorTermCount + 1, mFilters.gaussian, colorTermCount + 0); // Point x.
+                    filterPlane(image, colorTermCount + 0, mFilters.point, colorTermCount + 1);    // Point y.
+                    filterPlane(image, colorTermCount + 2, mFilters.gaussian, colorTermCount + 2); // Edge x.
+                    filterPlane(image, colorTermCount + 0, mFilters.edge, colorTermCount + 3);     // Edge y.
+                }
+
+                float* pErrorRow = pErrors + (size_t)outputY * mWidth;
+                uint32_t* pExposureRow = pExposureIndices ? pExposureIndices + (size_t)outputY * mWidth : nullptr;
+                for (uint32_t x = 0; x < mWidth; x++)
+                {
+                    float value = computePixelError(verticalRow, x);
+                    if (!mOptions.isHDR)
+                    {
+                        pErrorRow[x] = value;
+                    }
+                    else
+                    {
+                        // HDR-FLIP is maximum LDR-FLIP over a range of exposures.
+                        if (exposureIndex == 0)
+                        {
+                            pErrorRow[x] = 0.f;
+                            if (pExposureRow)
+                                pExposureRow[x] = 0;
+                        }
+                        if (value > pErrorRow[x])
+                        {
+                            pErrorRow[x] = value;
+                            if (pExposureRow)
+                                pExposureRow[x] = exposureIndex;
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+private:
+    /// Convert a row of RGBA pixels to YCxCz and normalized luminance, padded by the filter radius on both sides.
+    void preprocessRow(const float* pRow, float exposureScale, float* pPadded, uint32_t paddedWidth) const
+    {
+        const int r = mFilters.radius;
+        for (uint32_t x = 0; x < mWidth; x++)
+        {
+            float3 color(pRow[4 * x + 0], pRow[4 * x + 1], pRow[4 * x + 2]);
+            if (mOptions.isHDR)
+            {
+                color = mOptions.clampInput ? max(color, float3(0.f)) : color;
+                color = exposureScale * color; // Exposure compensation.
+                color = toneMap(color, mOptions.toneMapper, mToneMapperCoefficients);
+            }
+            else
+            {
+                color = mOptions.clampInput ? clamp(color, float3(0.f), float3(1.f)) : color;
+            }
+            float3 ycxcz = linearRGBToYCxCz(color);
+            pPadded[0 * paddedWidth + x + r] = ycxcz.x;
+            pPadded[1 * paddedWidth + x + r] = ycxcz.y;
+            pPadded[2 * paddedWidth + x + r] = ycxcz.z;
+            pPadded[kFeatureChannel * paddedWidth + x + r] = (ycxcz.x + 16.f) / 116.f; // Normalized Y from YCxCz.
+        }
+        for (uint32_t c = 0; c < kInputChannels; c++)
+        {
+            float* pChannel = pPadded + c * paddedWidth;
+            std::fill(pChannel, pChannel + r, pChannel[r]);
+            std::fill(pChannel + r + mWidth, pChannel + paddedWidth, pChannel[r + mWidth - 1]);
+        }
+    }
+
+    template<typename VerticalRow>
+    float computePixelError(const VerticalRow& verticalRow, uint32_t x) const
+    {
+        const uint32_t colorTermCount = (uint32_t)mFilters.colorTerms.size();
+
+        // **************** COLOR PIPELINE ******************** //
+        float3 filtered[2];
+        float2 point[2];
+        float2 edge[2];
+        for (uint32_t image = 0; image < 2; image++)
+        {
+            float3 ycxcz(0.f);
+            for (uint32_t t = 0; t < colorTermCount; t++)
+                ycxcz[mFilters.colorTerms[t].channel] += mFilters.colorTerms[t].weight * verticalRow(image, t)[x];
+            filtered[image] = clamp(YCxCzToLinearRGB(ycxcz), float3(0.f), float3(1.f));
+            point[image] = float2(verticalRow(image, colorTermCount + 0)[x], verticalRow(image, colorTermCount + 1)[x]);
+            edge[image] = float2(verticalRow(image, colorTermCount + 2)[x], verticalRow(image, colorTermCount + 3)[x]);
+        }
+        float colorDiff = HyAB(Hunt(linearRGBToCIELab(filtered[0])), Hunt(linearRGBToCIELab(filtered[1])));
+
+        // **************** FEATURE PIPELINE ******************** //
+        float edgeDifference = std::abs(length(edge[0]) - length(edge[1]));
+        float pointDifference = std::abs(length(point[0]) - length(point[1]));
+        float featureDiff = std::pow(std::max(pointDifference, edgeDifference) * (float)M_SQRT1_2, kFLIPqf);
+
+        return redistributeErrors(colorDiff, featureDiff);
+    }
+
+    float redistributeErrors(float colorDifference, float featureDifference) const
+    {
+        float error = std::pow(colorDifference, kFLIPqc);
+
+        //  Normalization.
+        float perceptualCutoff = kFLIPpc * mMaxDistance;
+        if (error < perceptualCutoff)
+            error *= (kFLIPpt / perceptualCutoff);
+        else
+            error = kFLIPpt + ((error - perceptualCutoff) / (mMaxDistance - perceptualCutoff)) * (1.f - kFLIPpt);
+
+        return std::pow(error, (1.f - featureDifference));
+    }
+
+    const float* mpImages[2];
+    uint32_t mWidth;
+    uint32_t mHeight;
+    const FLIP::Options& mOptions;
+    Filters mFilters;
+    FLIPToneMapperCoefficients mToneMapperCoefficients;
+    float mMaxDistance;
+    FLIP::ExposureParameters mExposure;
+};
+
+void solveSecondDegree(const float a, const float b, float c, float& xMin, float& xMax)
+{
+    //  Solve a * x^2 + b * x + c = 0.
+    if (a == 0.0f)
+    {
+        xMin = xMax = -c / b;
+        return;
+    }
+
+    float d1 = -0.5f * (b / a);
+    float d2 = std::sqrt((d1 * d1) - (c / a));
+    xMin = d1 - d2;
+    xMax = d1 + d2;
+}
+} // namespace
+
+FLIP::Result FLIP::compute(
+    const float* pReference,
+    const float* pTest,
+    uint32_t width,
+    uint32_t height,
+    const Options& options,
+    float* pErrorMap,
+    float* pExposureMap
+)
+{
+    FALCOR_CHECK(pReference && pTest, "Missing image data.");
+    FALCOR_CHECK(width > 0 && height > 0, "Invalid image size {}x{}.", width, height);
+    FALCOR_CHECK(options.tileHeight > 0, "Tile height must be larger than zero.");
+    for (float p : options.percentiles)
+        FALCOR_CHECK(p >= 0.f && p <= 1.f, "Percentile {} is outside [0,1].", p);
+
+    const size_t pixelCount = (size_t)width * height;
+    Result result;
+
+    FLIPEvaluator evaluator(pReference, pTest, width, height, options);
+
+    if (options.isHDR)
+    {
+        if (options.useCustomExposureParameters)
+        {
+            FALCOR_CHECK(options.numExposures > 0, "Number of exposures must be larger than zero.");
+            result.exposure.startExposure = options.startExposure;
+            result.exposure.numExposures = options.numExposures;
+            result.exposure.exposureDelta =
+                options.numExposures > 1 ? (options.stopExposure - options.startExposure) / (options.numExposures - 1.f) : 0.f;
+        }
+        else
+        {
+            // Compute the exposure range from the luminance of the reference image.
+            std::vector<float> luminances(pixelCount);
+            for (size_t i = 0; i < pixelCount; i++)
+                luminances[i] = luminance(float3(pReference[4 * i + 0], pReference[4 * i + 1], pReference[4 * i + 2]));
+            auto mid = luminances.begin() + pixelCount / 2;
+            std::nth_element(luminances.begin(), mid, luminances.end());
+            float Ymedian = *mid;
+            if ((pixelCount & 1) == 0)
+                Ymedian = 0.5f * (Ymedian + *std::max_element(luminances.begin(), mid));
+            float Ymax = *std::max_element(mid, luminances.end());
+            result.exposure = computeExposureParameters(options.toneMapper, Ymedian, Ymax);
+        }
+        evaluator.setExposures(result.exposure);
+    }
+
+    std::vector<float> errors(pixelCount);
+    std::vector<uint32_t> exposureIndices(options.isHDR && pExposureMap ? pixelCount : 0);
+
+    const uint32_t bandCount = (height + options.tileHeight - 1) / options.tileHeight;
+    auto processBand = [&](uint32_t band)
+    {
+        uint32_t y0 = band * options.tileHeight;
+        uint32_t y1 = std::min(y0 + options.tileHeight, height);
+        evaluator.processBand(y0, y1, errors.data(), exposureIndices.empty() ? nullptr : exposureIndices.data());
+    };
+    auto range = NumericRange<uint32_t>(0, bandCount);
+    if (options.parallel)
+        std::for_each(std::execution::par, range.begin(), range.end(), processBand);
+    else
+        std::for_each(range.begin(), range.end(), processBand);
+
+    // Invalid values are treated as maximum error, as in FLIPPass.
+    double sum = 0.0;
+    result.min = std::numeric_limits<float>::max();
+    result.max = 0.f;
+    for (float& value : errors)
+    {
+        if (std::isnan(value) || std::isinf(value) || value < 0.f || value > 1.f)
+            value = 1.f;
+        sum += value;
+        result.min = std::min(result.min, value);
+        result.max = std::max(result.max, value);
+    }
+    result.mean = sum / pixelCount;
+
+    if (pErrorMap)
+        std::copy(errors.begin(), errors.end(), pErrorMap);
+    if (!exposureIndices.empty())
+    {
+        const float scale = result.exposure.numExposures > 1 ? 1.f / (result.exposure.numExposures - 1.f) : 0.f;
+        for (size_t i = 0; i < pixelCount; i++)
+            pExposureMap[i] = exposureIndices[i] * scale;
+    }
+
+    // Percentiles with linear interpolation between the closest ranks.
+    if (!options.percentiles.empty())
+    {
+        std::sort(errors.begin(), errors.end());
+        for (float p : options.percentiles)
+        {
+            float position = p * (pixelCount - 1);
+            size_t lo = (size_t)std::floor(position);
+            size_t hi = std::min(lo + 1, pixelCount - 1);
+            float t = position - lo;
+            result.percentiles.push_back(errors[lo] + t * (errors[hi] - errors[lo]));
+        }
+    }
+
+    return result;
+}
+
+FLIP::ExposureParameters FLIP::computeExposureParameters(FLIPToneMapperType toneMapper, float Ymedian, float Ymax)
+{
+    const FLIPToneMapperCoefficients k = getFLIPToneMapperCoefficients(toneMapper);
+
+    const float t = kFLIPExposureToneMapTarget;
+    const float a = k.k0 - t * k.k3;
+    const float b = k.k1 - t * k.k4;
+    const float c = k.k2 - t * k.k5;
+
+    float xMin = 0.0f;
+    float xMax = 0.0f;
+    solveSecondDegree(a, b, c, xMin, xMax);
+
+    ExposureParameters exposure;
+    exposure.startExposure = std::log2(xMax / Ymax);
+    float stopExposure = std::log2(xMax / Ymedian);
+
+    exposure.numExposures = uint32_t(std::max(2.0f, std::ceil(stopExposure - exposure.startExposure)));
+    exposure.exposureDelta = (stopExposure - exposure.startExposure) / (exposure.numExposures - 1.0f);
+    return exposure;
+}
+
+float FLIP::computePixelsPerDegree(uint32_t monitorWidthPixels, float monitorWidthMeters, float monitorDistanceMeters)
+{
+    return monitorDistanceMeters * (monitorWidthPixels / monitorWidthMeters) * ((float)M_PI / 180.f);
+}
+
+FALCOR_SCRIPT_BINDING(FLIP)
+{
+    using namespace pybind11::literals;
+
+    pybind11::falcor_enum<FLIPToneMapperType>(m, "FLIPToneMapperType");
+
+    using FloatArray = pybind11::ndarray<pybind11::numpy, float, pybind11::c_contig>;
+
+    // Convert a (height, width, 3|4) array to RGBA32F.
+    auto toRGBA = [](const FloatArray& image, const char* name, uint32_t& width, uint32_t& height)
+    {
+        FALCOR_CHECK(image.ndim() == 3, "'{}' must be an array of shape (height, width, channels).", name);
+        const size_t channels = image.shape(2);
+        FALCOR_CHECK(channels == 3 || channels == 4, "'{}' must have 3 or 4 channels.", name);
+        height = (uint32_t)image.shape(0);
+        width = (uint32_t)image.shape(1);
+        const float* pSrc = image.data();
+        std::vector<float> rgba((size_t)width * height * 4, 1.f);
+        for (size_t i = 0; i < (size_t)width * height; i++)
+            std::copy(pSrc + i * channels, pSrc + i * channels + 3, rgba.data() + i * 4);
+        return rgba;
+    };
+
+    m.def(
+        "compute_flip",
+        [toRGBA](
+            FloatArray reference,
+            FloatArray test,
+            bool hdr,
+            FLIPToneMapperType toneMapper,
+            bool clampInput,
+            std::optional<std::pair<float, float>> exposureRange,
+            uint32_t numExposures,
+            uint32_t monitorWidthPixels,
+            float monitorWidthMeters,
+            float monitorDistanceMeters,
+            std::vector<float> percentiles,
+            bool returnErrorMap
+        )
+        {
+            uint32_t width, height, testWidth, testHeight;
+            auto referenceData = toRGBA(reference, "reference", width, height);
+            auto testData = toRGBA(test, "test", testWidth, testHeight);
+            FALCOR_CHECK(width == testWidth && height == testHeight, "Cannot compare images with different resolutions.");
+
+            FLIP::Options options;
+            options.isHDR = hdr;
+            options.toneMapper = toneMapper;
+            options.clampInput = clampInput;
+            if (exposureRange)
+            {
+                options.useCustomExposureParameters = true;
+                options.startExposure = exposureRange->first;
+                options.stopExposure = exposureRange->second;
+                options.numExposures = numExposures;
+            }
+            options.monitorWidthPixels = monitorWidthPixels;
+            options.monitorWidthMeters = monitorWidthMeters;
+            options.monitorDistanceMeters = monitorDistanceMeters;
+            options.percentiles = percentiles;
+
+            std::unique_ptr<float[]> errorMap(returnErrorMap ? new float[(size_t)width * height] : nullptr);
+            FLIP::Result result;
+            {
+                pybind11::gil_scoped_release release;
+                result = FLIP::compute(referenceData.data(), testData.data(), width, height, options, errorMap.get());
+            }
+
+            pybind11::dict dict;
+            dict["mean"] = result.mean;
+            dict["min"] = result.min;
+            dict["max"] = result.max;
+            pybind11::dict percentileDict;
+            for (size_t i = 0; i < percentiles.size(); i++)
+                percentileDict[pybind11::float_(percentiles[i])] = result.percentiles[i];
+            dict["percentiles"] = percentileDict;
+            if (hdr)
+            {
+                dict["start_exposure"] = result.exposure.startExposure;
+                dict["exposure_delta"] = result.exposure.exposureDelta;
+                dict["num_exposures"] = result.exposure.numExposures;
+            }
+            if (errorMap)
+            {
+                float* pErrorMap = errorMap.release();
+                pybind11::capsule owner(pErrorMap, [](void* p) noexcept { delete[] reinterpret_cast<float*>(p); });
+                size_t shape[2] = {height, width};
+                dict["error_map"] = pybind11::ndarray<pybind11::numpy, float>(pErrorMap, 2, shape, owner);
+            }
+            return dict;
+        },
+        "reference"_a,
+        "test"_a,
+        "hdr"_a = false,
+        "tone_mapper"_a = FLIPToneMapperType::ACES,
+        "clamp_input"_a = false,
+        "exposure_range"_a = std::optional<std::pair<float, float>>(),
+        "num_exposures"_a = 2,
+        "monitor_width_pixels"_a = 3840,
+        "monitor_width_meters"_a = 0.7f,
+        "monitor_distance_meters"_a = 0.7f,
+        "percentiles"_a = FLIP::Options().percentiles,
+        "return_error_map"_a = false,
+        "Compute the FLIP error between two images given as float32 numpy arrays of shape (height, width, 3|4).\n"
+        "Returns a dictionary with the mean, min, max and percentile FLIP values and optionally the per-pixel error map.\n"
+        "For HDR-FLIP, the exposure range is computed from the reference image unless 'exposure_range' is given."
+    );
+}
+} // namespace Falcor
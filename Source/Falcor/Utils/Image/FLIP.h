@@ -0,0 +1,131 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "FLIPShared.slangh"
+#include "Core/Macros.h"
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * CPU implementation of the FLIP image difference evaluator.
+ *
+ * Computes the same per-pixel LDR-FLIP and HDR-FLIP error as the FLIPPass render pass, which allows
+ * image quality gating without a GPU. The spatial filters are evaluated separably on bands of rows,
+ * which are processed in parallel. The inner filter loops are written to be auto-vectorized.
+ *
+ * See the FLIP papers for details:
+ * FLIP: A Difference Evaluator for Alternating Images, HPG 2020.
+ * Visualizing Errors in Rendered High Dynamic Range Images, Eurographics 2021.
+ */
+class FALCOR_API FLIP
+{
+public:
+    struct Options
+    {
+        /// Compute HDR-FLIP instead of LDR-FLIP.
+        bool isHDR = false;
+        /// Tone mapper used for HDR-FLIP.
+        FLIPToneMapperType toneMapper = FLIPToneMapperType::ACES;
+        /// Clamp the input to the expected range ([0,1] for LDR-FLIP and [0, inf) for HDR-FLIP).
+        bool clampInput = false;
+        /// Use startExposure/stopExposure/numExposures instead of computing them from the reference image.
+        bool useCustomExposureParameters = false;
+        float startExposure = 0.f;
+        float stopExposure = 0.f;
+        uint32_t numExposures = 2;
+        /// Viewing conditions used for computing the pixels per degree.
+        uint32_t monitorWidthPixels = 3840;
+        float monitorWidthMeters = 0.7f;
+        float monitorDistanceMeters = 0.7f;
+        /// Percentiles (in [0,1]) of the error distribution to report.
+        std::vector<float> percentiles = {0.25f, 0.5f, 0.75f, 0.95f, 0.99f};
+        /// Number of image rows per band.
+        uint32_t tileHeight = 64;
+        /// Process bands in parallel.
+        bool parallel = true;
+    };
+
+    struct ExposureParameters
+    {
+        float startExposure = 0.f;
+        float exposureDelta = 0.f;
+        uint32_t numExposures = 2;
+    };
+
+    struct Result
+    {
+        /// Mean FLIP error.
+        double mean = 0.0;
+        float min = 0.f;
+        float max = 0.f;
+        /// Error values at the requested percentiles (same order as Options::percentiles).
+        std::vector<float> percentiles;
+        /// Exposure parameters used for HDR-FLIP.
+        ExposureParameters exposure;
+    };
+
+    /**
+     * Compute the FLIP error between two images.
+     * Invalid error values (NaN, inf or outside [0,1]) are set to 1, as in FLIPPass.
+     * @param[in] pReference Reference image in RGBA32F format.
+     * @param[in] pTest Test image in RGBA32F format.
+     * @param[in] width Image width in pixels.
+     * @param[in] height Image height in pixels.
+     * @param[in] options FLIP options.
+     * @param[out] pErrorMap Optional per-pixel FLIP error output (width * height values).
+     * @param[out] pExposureMap Optional per-pixel HDR-FLIP exposure output (width * height values). Stores the
+     * index of the exposure with the largest error, normalized to [0,1]. Left untouched for LDR-FLIP.
+     * @return The pooled FLIP values.
+     */
+    static Result compute(
+        const float* pReference,
+        const float* pTest,
+        uint32_t width,
+        uint32_t height,
+        const Options& options,
+        float* pErrorMap = nullptr,
+        float* pExposureMap = nullptr
+    );
+
+    /**
+     * Compute the HDR-FLIP exposure range from the luminance of the reference image.
+     * @param[in] toneMapper Tone mapper used for HDR-FLIP.
+     * @param[in] Ymedian Median luminance of the reference image.
+     * @param[in] Ymax Maximum luminance of the reference image.
+     * @return The exposure parameters.
+     */
+    static ExposureParameters computeExposureParameters(FLIPToneMapperType toneMapper, float Ymedian, float Ymax);
+
+    /**
+     * Compute the number of pixels per degree for given viewing conditions.
+     */
+    static float computePixelsPerDegree(uint32_t monitorWidthPixels, float monitorWidthMeters, float monitorDistanceMeters);
+};
+} // namespace Falcor
@@ -0,0 +1,348 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "ImageDiff.h"
+#include "Core/Error.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <execution>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(__x86_64__)
+#define IMAGE_DIFF_USE_SSE 1
+#include <emmintrin.h>
+#else
+#define IMAGE_DIFF_USE_SSE 0
+#endif
+
+namespace Falcor
+{
+namespace
+{
+using Metric = ImageDiff::Metric;
+
+const float kEpsilon = 1e-3f;
+
+/// Sum and maximum of the per-channel errors of a range of pixels.
+struct Accumulator
+{
+    double sum = 0.0;
+    float max = 0.f;
+};
+
+template<Metric M>
+float channelError(float a, float b)
+{
+    float d = a - b;
+    if constexpr (M == Metric::MSE)
+        return d * d;
+    else if constexpr (M == Metric::RelMSE)
+        return d * d / (a * a + kEpsilon);
+    else if constexpr (M == Metric::MAE || M == Metric::MaxAbs)
+        return std::fabs(d);
+    else if constexpr (M == Metric::MAPE)
+        return std::fabs(d / (a + kEpsilon));
+}
+
+#if IMAGE_DIFF_USE_SSE
+template<Metric M>
+__m128 channelError(__m128 a, __m128 b)
+{
+    const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+    __m128 d = _mm_sub_ps(a, b);
+    if constexpr (M == Metric::MSE)
+        return _mm_mul_ps(d, d);
+    else if constexpr (M == Metric::RelMSE)
+        return _mm_div_ps(_mm_mul_ps(d, d), _mm_add_ps(_mm_mul_ps(a, a), _mm_set1_ps(kEpsilon)));
+    else if constexpr (M == Metric::MAE || M == Metric::MaxAbs)
+        return _mm_and_ps(d, absMask);
+    else if constexpr (M == Metric::MAPE)
+        return _mm_and_ps(_mm_div_ps(d, _mm_add_ps(a, _mm_set1_ps(kEpsilon))), absMask);
+}
+#endif
+
+/**
+ * Accumulate the errors of a row of pixels.
+ * Per-pixel errors written to the error map are the mean (or maximum) over the compared channels.
+ */
+template<Metric M>
+void processRow(const float* pA, const float* pB, uint32_t width, bool alpha, float pixelScale, Accumulator& acc, float* pErrorMap)
+{
+    const uint32_t channels = alpha ? 4 : 3;
+
+#if IMAGE_DIFF_USE_SSE
+    // One RGBA pixel per instruction. The alpha lane is masked out after computing the error to get rid of NaNs.
+    const __m128 mask = alpha ? _mm_castsi128_ps(_mm_set1_epi32(-1)) : _mm_castsi128_ps(_mm_set_epi32(0, -1, -1, -1));
+    __m128d sumLo = _mm_setzero_pd();
+    __m128d sumHi = _mm_setzero_pd();
+    __m128 max = _mm_setzero_ps();
+    for (uint32_t x = 0; x < width; ++x)
+    {
+        __m128 e = _mm_and_ps(channelError<M>(_mm_loadu_ps(pA + 4 * x), _mm_loadu_ps(pB + 4 * x)), mask);
+        sumLo = _mm_add_pd(sumLo, _mm_cvtps_pd(e));
+        sumHi = _mm_add_pd(sumHi, _mm_cvtps_pd(_mm_movehl_ps(e, e)));
+        if constexpr (M == Metric::MaxAbs)
+            max = _mm_max_ps(max, e);
+        if (pErrorMap)
+        {
+            alignas(16) float v[4];
+            _mm_store_ps(v, e);
+            if constexpr (M == Metric::MaxAbs)
+                pErrorMap[x] = std::max(std::max(v[0], v[1]), std::max(v[2], v[3]));
+            else
+                pErrorMap[x] = (v[0] + v[1] + v[2] + v[3]) * pixelScale / channels;
+        }
+    }
+    alignas(16) double s[2];
+    _mm_store_pd(s, _mm_add_pd(sumLo, sumHi));
+    acc.sum += s[0] + s[1];
+    if constexpr (M == Metric::MaxAbs)
+    {
+        alignas(16) float m[4];
+        _mm_store_ps(m, max);
+        acc.max = std::max({acc.max, m[0], m[1], m[2], m[3]});
+    }
+#else
+    double sum = 0.0;
+    for (uint32_t x = 0; x < width; ++x)
+    {
+        float pixelSum = 0.f;
+        float pixelMax = 0.f;
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            float e = channelError<M>(pA[4 * x + c], pB[4 * x + c]);
+            pixelSum += e;
+            pixelMax = std::max(pixelMax, e);
+        }
+        sum += pixelSum;
+        acc.max = std::max(acc.max, pixelMax);
+        if (pErrorMap)
+            pErrorMap[x] = M == Metric::MaxAbs ? pixelMax : pixelSum * pixelScale / channels;
+    }
+    acc.sum += sum;
+#endif
+}
+
+/// Atomically add to a floating point value (std::atomic<double>::fetch_add is C++20).
+void atomicAdd(std::atomic<double>& value, double add)
+{
+    double expected = value.load(std::memory_order_relaxed);
+    while (!value.compare_exchange_weak(expected, expected + add, std::memory_order_relaxed))
+        ;
+}
+
+void atomicMax(std::atomic<float>& value, float other)
+{
+    float expected = value.load(std::memory_order_relaxed);
+    while (expected < other && !value.compare_exchange_weak(expected, other, std::memory_order_relaxed))
+        ;
+}
+
+template<Metric M>
+ImageDiff::Result compareImpl(
+    const float* pA,
+    const float* pB,
+    uint32_t width,
+    uint32_t height,
+    const ImageDiff::Options& options,
+    float* pErrorMap
+)
+{
+    const uint32_t channels = options.alpha ? 4 : 3;
+    const double pixelScale = M == Metric::MAPE ? 100.0 : 1.0;
+    const double sumScale = pixelScale / (double(channels) * width * height);
+    const uint32_t tileHeight = std::max(1u, options.tileHeight);
+    const uint32_t tileCount = (height + tileHeight - 1) / tileHeight;
+
+    // Early-out works because all per-channel errors are non-negative, i.e. the partial sum (maximum)
+    // is a lower bound of the final sum (maximum). Disabled when a full error map is requested.
+    const bool earlyOut = options.threshold.has_value() && pErrorMap == nullptr;
+    const double threshold = options.threshold.value_or(0.0);
+    std::atomic<bool> abort = false;
+    std::atomic<double> partialSum = 0.0;
+    std::atomic<float> partialMax = 0.f;
+
+    std::vector<Accumulator> tiles(tileCount);
+
+    auto processTile = [&](uint32_t tileIndex)
+    {
+        Accumulator& acc = tiles[tileIndex];
+        const uint32_t y0 = tileIndex * tileHeight;
+        const uint32_t y1 = std::min(height, y0 + tileHeight);
+        for (uint32_t y = y0; y < y1; ++y)
+        {
+            if (earlyOut && abort.load(std::memory_order_relaxed))
+                return;
+            const size_t offset = size_t(y) * width;
+            processRow<M>(pA + 4 * offset, pB + 4 * offset, width, options.alpha, float(pixelScale), acc, pErrorMap ? pErrorMap + offset : nullptr);
+        }
+
+        if (earlyOut)
+        {
+            bool exceeded;
+            if constexpr (M == Metric::MaxAbs)
+            {
+                atomicMax(partialMax, acc.max);
+                exceeded = partialMax.load(std::memory_order_relaxed) > threshold;
+            }
+            else
+            {
+                atomicAdd(partialSum, acc.sum);
+                exceeded = partialSum.load(std::memory_order_relaxed) * sumScale > threshold;
+            }
+            // NaNs always fail the comparison.
+            if (exceeded || std::isnan(acc.sum))
+                abort.store(true, std::memory_order_relaxed);
+        }
+    };
+
+    auto range = NumericRange<uint32_t>(0, tileCount);
+    if (options.parallel)
+        std::for_each(std::execution::par, range.begin(), range.end(), processTile);
+    else
+        std::for_each(range.begin(), range.end(), processTile);
+
+    ImageDiff::Result result;
+    if (abort)
+    {
+        result.earlyOut = true;
+        result.passed = false;
+        result.error = M == Metric::MaxAbs ? double(partialMax.load()) : partialSum.load() * sumScale;
+        return result;
+    }
+
+    // Reduce in tile order to get deterministic results.
+    double sum = 0.0;
+    float max = 0.f;
+    for (const auto& tile : tiles)
+    {
+        sum += tile.sum;
+        max = std::max(max, tile.max);
+    }
+
+    result.error = sum * sumScale;
+    if constexpr (M == Metric::MaxAbs)
+        result.error = std::isnan(sum) ? sum : double(max);
+    result.passed = std::isfinite(result.error) && (!options.threshold || result.error <= *options.threshold);
+    return result;
+}
+} // namespace
+
+const std::string& ImageDiff::getMetricDesc(Metric metric)
+{
+    static const std::string kDescs[] = {
+        "Mean Squared Error",
+        "Relative Mean Squared Error",
+        "Mean Absolute Error",
+        "Mean Absolute Percentage Error",
+        "Maximum Absolute Error",
+    };
+    FALCOR_CHECK(uint32_t(metric) < std::size(kDescs), "Invalid metric.");
+    return kDescs[uint32_t(metric)];
+}
+
+ImageDiff::Result ImageDiff::compare(
+    const float* pA,
+    const float* pB,
+    uint32_t width,
+    uint32_t height,
+    const Options& options,
+    float* pErrorMap
+)
+{
+    FALCOR_CHECK(width > 0 && height > 0, "Image size must be non-zero.");
+    FALCOR_CHECK(pA && pB, "Image data must not be null.");
+
+    switch (options.metric)
+    {
+    case Metric::MSE:
+        return compareImpl<Metric::MSE>(pA, pB, width, height, options, pErrorMap);
+    case Metric::RelMSE:
+        return compareImpl<Metric::RelMSE>(pA, pB, width, height, options, pErrorMap);
+    case Metric::MAE:
+        return compareImpl<Metric::MAE>(pA, pB, width, height, options, pErrorMap);
+    case Metric::MAPE:
+        return compareImpl<Metric::MAPE>(pA, pB, width, height, options, pErrorMap);
+    case Metric::MaxAbs:
+        return compareImpl<Metric::MaxAbs>(pA, pB, width, height, options, pErrorMap);
+    default:
+        FALCOR_THROW("Invalid metric.");
+    }
+}
+
+std::vector<ImageDiff::BatchResult> ImageDiff::compareBatch(
+    const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& pairs,
+    const LoadFunction& load,
+    const Options& options,
+    uint32_t maxConcurrentPairs
+)
+{
+    std::vector<BatchResult> results(pairs.size());
+    if (pairs.empty())
+        return results;
+
+    // Each worker holds at most one pair of images at a time, which bounds memory usage.
+    Options pairOptions = options;
+    pairOptions.parallel = false;
+    std::atomic<size_t> nextPair = 0;
+
+    auto worker = [&]()
+    {
+        for (size_t i = nextPair++; i < pairs.size(); i = nextPair++)
+        {
+            BatchResult& result = results[i];
+            try
+            {
+                ImageData a = load(pairs[i].first);
+                ImageData b = load(pairs[i].second);
+                if (a.width != b.width || a.height != b.height)
+                    result.error = "Cannot compare images with different resolutions.";
+                else
+                    result.result = compare(a.pData.get(), b.pData.get(), a.width, a.height, pairOptions);
+            }
+            catch (const std::exception& e)
+            {
+                result.error = e.what();
+            }
+            if (!result.error.empty())
+                result.result.passed = false;
+        }
+    };
+
+    const size_t threadCount = std::clamp<size_t>(maxConcurrentPairs, 1, pairs.size());
+    std::vector<std::thread> threads;
+    for (size_t i = 1; i < threadCount; ++i)
+        threads.emplace_back(worker);
+    worker();
+    for (auto& thread : threads)
+        thread.join();
+
+    return results;
+}
+} // namespace Falcor
@@ -0,0 +1,160 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Core/Macros.h"
+#include "Core/Enum.h"
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * CPU image comparison engine.
+ *
+ * Compares two RGBA32F images using a scalar error metric. The images are split into
+ * tiles of rows that are processed in parallel, each using SIMD kernels processing one
+ * RGBA pixel per instruction. If only a pass/fail decision against a threshold is needed,
+ * tiles stop early as soon as the threshold is known to be exceeded.
+ *
+ * A batch mode compares many image pairs in parallel with a bounded number of images
+ * held in memory at any time.
+ */
+class FALCOR_API ImageDiff
+{
+public:
+    enum class Metric
+    {
+        MSE,    ///< Mean squared error.
+        RelMSE, ///< Relative mean squared error.
+        MAE,    ///< Mean absolute error.
+        MAPE,   ///< Mean absolute percentage error.
+        MaxAbs, ///< Maximum absolute error.
+    };
+
+    FALCOR_ENUM_INFO(
+        Metric,
+        {
+            {Metric::MSE, "mse"},
+            {Metric::RelMSE, "rmse"},
+            {Metric::MAE, "mae"},
+            {Metric::MAPE, "mape"},
+            {Metric::MaxAbs, "max"},
+        }
+    );
+
+    struct Options
+    {
+        Metric metric = Metric::MSE;
+        /// Include the alpha channel in the comparison.
+        bool alpha = false;
+        /// Error threshold. If set, the comparison stops as soon as the threshold is known to be exceeded.
+        std::optional<double> threshold;
+        /// Number of image rows per tile.
+        uint32_t tileHeight = 32;
+        /// Process tiles in parallel.
+        bool parallel = true;
+    };
+
+    struct Result
+    {
+        /// Error value. If the comparison stopped early, this is a lower bound of the actual error.
+        double error = 0.0;
+        /// True if the error is finite and within the threshold (if set).
+        bool passed = true;
+        /// True if the comparison stopped before processing all pixels.
+        bool earlyOut = false;
+    };
+
+    /// RGBA32F image data with rows stored consecutively.
+    struct ImageData
+    {
+        uint32_t width = 0;
+        uint32_t height = 0;
+        std::shared_ptr<const float> pData;
+    };
+
+    using LoadFunction = std::function<ImageData(const std::filesystem::path& path)>;
+
+    struct BatchResult
+    {
+        Result result;
+        /// Error message if the images could not be loaded or compared. The result is invalid in this case.
+        std::string error;
+    };
+
+    /**
+     * Get a description of an error metric.
+     */
+    static const std::string& getMetricDesc(Metric metric);
+
+    /**
+     * Compare two images.
+     * @param[in] pA First (reference) image in RGBA32F format.
+     * @param[in] pB Second image in RGBA32F format.
+     * @param[in] width Image width in pixels.
+     * @param[in] height Image height in pixels.
+     * @param[in] options Comparison options.
+     * @param[out] pErrorMap Optional per-pixel error output (width * height values). Disables early-out.
+     * @return The comparison result.
+     */
+    static Result compare(
+        const float* pA,
+        const float* pB,
+        uint32_t width,
+        uint32_t height,
+        const Options& options,
+        float* pErrorMap = nullptr
+    );
+
+    /**
+     * Compare a list of image pairs in parallel.
+     * At most maxConcurrentPairs pairs are loaded at the same time. Each pair is compared on a single
+     * thread, as parallelism is achieved across pairs. Loader exceptions are reported per pair.
+     * @param[in] pairs List of image pairs (reference, result).
+     * @param[in] load Function loading an image from a file. Expected to throw on failure.
+     * @param[in] options Comparison options.
+     * @param[in] maxConcurrentPairs Maximum number of pairs in flight.
+     * @return Result per pair.
+     */
+    static std::vector<BatchResult> compareBatch(
+        const std::vector<std::pair<std::filesystem::path, std::filesystem::path>>& pairs,
+        const LoadFunction& load,
+        const Options& options,
+        uint32_t maxConcurrentPairs = std::thread::hardware_concurrency()
+    );
+};
+
+FALCOR_ENUM_REGISTER(ImageDiff::Metric);
+} // namespace Falcor
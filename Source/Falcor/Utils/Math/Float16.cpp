@@ -33,6 +33,18 @@
  */
 
 #include "Float16.h"
+#include "Core/Error.h"
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define FALCOR_FLOAT16_F16C 1
+#include <immintrin.h>
+#if FALCOR_MSVC
+#include <intrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define FALCOR_FLOAT16_NEON 1
+#include <arm_neon.h>
+#endif
 
 namespace Falcor
 {
@@ -261,5 +273,192 @@ float float16ToFloat32(uint16_t value)
     return result.f;
 }
 
+// Batch conversion.
+//
+// The hardware conversions round float to half ties to even and quiet signaling NaNs, whereas the scalar
+// conversion above rounds ties up in magnitude and preserves NaN payloads. To be bit-exact, the vector loops
+// detect the lanes where the results can differ and convert those with the scalar code. These are NaNs,
+// exact ties and the half denormal range, so the fallback is rare for typical data.
+
+namespace
+{
+/// Returns true if the hardware conversion of a half to float may differ from float16ToFloat32().
+inline bool needsScalarFloat16ToFloat32(uint16_t bits)
+{
+    return (bits & 0x7fff) > 0x7c00;
+}
+
+#if FALCOR_FLOAT16_F16C
+
+#if FALCOR_MSVC
+#define FALCOR_TARGET_F16C
+#else
+#define FALCOR_TARGET_F16C __attribute__((target("avx2,f16c")))
+#endif
+
+bool hasF16C()
+{
+    static const bool result = []()
+    {
+#if FALCOR_MSVC
+        int info[4];
+        __cpuid(info, 0);
+        if (info[0] < 7)
+            return false;
+        __cpuid(info, 1);
+        const bool f16c = (info[2] & (1 << 29)) != 0;
+        const bool avx = (info[2] & (1 << 28)) != 0;
+        const bool osxsave = (info[2] & (1 << 27)) != 0;
+        // Check that the OS preserves the AVX register state.
+        if (!f16c || !avx || !osxsave || (_xgetbv(0) & 0x6) != 0x6)
+            return false;
+        __cpuidex(info, 7, 0);
+        return (info[1] & (1 << 5)) != 0;
+#else
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("f16c") && __builtin_cpu_supports("avx2");
+#endif
+    }();
+    return result;
+}
+
+/// Convert floats to halfs 8 at a time. Returns the number of converted values.
+FALCOR_TARGET_F16C size_t float32ToFloat16Simd(const float* src, uint16_t* dst, size_t count)
+{
+    const __m256i kAbsMask = _mm256_set1_epi32(0x7fffffff);
+    const __m256i kInf = _mm256_set1_epi32(0x7f800000);
+    const __m256i kDenormMin = _mm256_set1_epi32((102 << 23) - 1);
+    const __m256i kDenormMax = _mm256_set1_epi32(113 << 23);
+    const __m256i kRoundMask = _mm256_set1_epi32(0x1fff);
+    const __m256i kTie = _mm256_set1_epi32(0x1000);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m256 value = _mm256_loadu_ps(src + i);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtps_ph(value, _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+
+        __m256i bits = _mm256_castps_si256(value);
+        __m256i abs = _mm256_and_si256(bits, kAbsMask);
+        __m256i isNan = _mm256_cmpgt_epi32(abs, kInf);
+        __m256i isDenorm = _mm256_and_si256(_mm256_cmpgt_epi32(abs, kDenormMin), _mm256_cmpgt_epi32(kDenormMax, abs));
+        __m256i isTie = _mm256_cmpeq_epi32(_mm256_and_si256(bits, kRoundMask), kTie);
+        int mask = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_or_si256(_mm256_or_si256(isNan, isDenorm), isTie)));
+        if (mask != 0)
+        {
+            for (size_t j = 0; j < 8; ++j)
+                if (mask & (1 << j))
+                    dst[i + j] = float32ToFloat16(src[i + j]);
+        }
+    }
+    return i;
+}
+
+/// Convert halfs to floats 8 at a time. Returns the number of converted values.
+FALCOR_TARGET_F16C size_t float16ToFloat32Simd(const uint16_t* src, float* dst, size_t count)
+{
+    const __m128i kAbsMask = _mm_set1_epi16(0x7fff);
+    const __m128i kInf = _mm_set1_epi16(0x7c00);
+
+    size_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        __m128i bits = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(bits));
+
+        __m128i isNan = _mm_cmpgt_epi16(_mm_and_si128(bits, kAbsMask), kInf);
+        if (_mm_movemask_epi8(isNan) != 0)
+        {
+            for (size_t j = i; j < i + 8; ++j)
+                if (needsScalarFloat16ToFloat32(src[j]))
+                    dst[j] = float16ToFloat32(src[j]);
+        }
+    }
+    return i;
+}
+
+#elif FALCOR_FLOAT16_NEON
+
+bool hasF16C()
+{
+    return false;
+}
+
+/// Convert floats to halfs 4 at a time. Returns the number of converted values.
+size_t float32ToFloat16Simd(const float* src, uint16_t* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t value = vld1q_f32(src + i);
+        vst1_u16(dst + i, vreinterpret_u16_f16(vcvt_f16_f32(value)));
+
+        uint32x4_t bits = vreinterpretq_u32_f32(value);
+        uint32x4_t abs = vandq_u32(bits, vdupq_n_u32(0x7fffffff));
+        uint32x4_t isNan = vcgtq_u32(abs, vdupq_n_u32(0x7f800000));
+        uint32x4_t isDenorm = vandq_u32(vcgeq_u32(abs, vdupq_n_u32(102u << 23)), vcltq_u32(abs, vdupq_n_u32(113u << 23)));
+        uint32x4_t isTie = vceqq_u32(vandq_u32(bits, vdupq_n_u32(0x1fff)), vdupq_n_u32(0x1000));
+        if (vmaxvq_u32(vorrq_u32(vorrq_u32(isNan, isDenorm), isTie)) != 0)
+        {
+            for (size_t j = i; j < i + 4; ++j)
+                dst[j] = float32ToFloat16(src[j]);
+        }
+    }
+    return i;
+}
+
+/// Convert halfs to floats 4 at a time. Returns the number of converted values.
+size_t float16ToFloat32Simd(const uint16_t* src, float* dst, size_t count)
+{
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        uint16x4_t bits = vld1_u16(src + i);
+        vst1q_f32(dst + i, vcvt_f32_f16(vreinterpret_f16_u16(bits)));
+
+        uint16x4_t isNan = vcgt_u16(vand_u16(bits, vdup_n_u16(0x7fff)), vdup_n_u16(0x7c00));
+        if (vmaxv_u16(isNan) != 0)
+        {
+            for (size_t j = i; j < i + 4; ++j)
+                if (needsScalarFloat16ToFloat32(src[j]))
+                    dst[j] = float16ToFloat32(src[j]);
+        }
+    }
+    return i;
+}
+
+#endif
+} // namespace
+
+void float32ToFloat16(fstd::span<const float> src, fstd::span<uint16_t> dst)
+{
+    FALCOR_CHECK(src.size() == dst.size(), "Source and destination must have the same size.");
+
+    size_t i = 0;
+#if FALCOR_FLOAT16_F16C
+    if (hasF16C())
+        i = float32ToFloat16Simd(src.data(), dst.data(), src.size());
+#elif FALCOR_FLOAT16_NEON
+    i = float32ToFloat16Simd(src.data(), dst.data(), src.size());
+#endif
+    for (; i < src.size(); ++i)
+        dst[i] = float32ToFloat16(src[i]);
+}
+
+void float16ToFloat32(fstd::span<const uint16_t> src, fstd::span<float> dst)
+{
+    FALCOR_CHECK(src.size() == dst.size(), "Source and destination must have the same size.");
+
+    size_t i = 0;
+#if FALCOR_FLOAT16_F16C
+    if (hasF16C())
+        i = float16ToFloat32Simd(src.data(), dst.data(), src.size());
+#elif FALCOR_FLOAT16_NEON
+    i = float16ToFloat32Simd(src.data(), dst.data(), src.size());
+#endif
+    for (; i < src.size(); ++i)
+        dst[i] = float16ToFloat32(src[i]);
+}
+
 } // namespace math
 } // namespace Falcor
@@ -29,6 +29,8 @@
 
 #include "Core/Macros.h"
 
+#include <fstd/span.h> // TODO C++20: Replace with <span>
+
 #include <cstdint>
 #include <limits>
 
@@ -40,6 +42,24 @@ namespace math
 FALCOR_API uint16_t float32ToFloat16(float value);
 FALCOR_API float float16ToFloat32(uint16_t value);
 
+/**
+ * Convert an array of floats to half floats.
+ * The results are bit-exact with the scalar float32ToFloat16(), including rounding and NaN payloads.
+ * Uses F16C/AVX2 instructions on x86 CPUs that support them and NEON on ARM, otherwise the scalar conversion.
+ * @param[in] src Source values.
+ * @param[out] dst Destination half float bit patterns. Must have the same size as src.
+ */
+FALCOR_API void float32ToFloat16(fstd::span<const float> src, fstd::span<uint16_t> dst);
+
+/**
+ * Convert an array of half floats to floats.
+ * The results are bit-exact with the scalar float16ToFloat32(), including NaN payloads.
+ * Uses F16C/AVX2 instructions on x86 CPUs that support them and NEON on ARM, otherwise the scalar conversion.
+ * @param[in] src Source half float bit patterns.
+ * @param[out] dst Destination values. Must have the same size as src.
+ */
+FALCOR_API void float16ToFloat32(fstd::span<const uint16_t> src, fstd::span<float> dst);
+
 struct float16_t
 {
     float16_t() = default;
@@ -28,6 +28,7 @@
 #pragma once
 #include "Vector.h"
 #include "FormatConversion.h"
+#include <algorithm>
 #include <cmath>
 
 /**
@@ -75,6 +76,24 @@ inline float3 oct_to_ndir_snorm(float2 p)
     return normalize(n);
 }
 
+/**
+ * Encode a normal packed as 2x 8-bit snorms in the octahedral mapping. The high 16 bits are unused.
+ */
+inline uint32_t encodeNormal2x8(float3 normal)
+{
+    float2 octNormal = ndir_to_oct_snorm(normal);
+    return packSnorm2x8(octNormal);
+}
+
+/**
+ * Decode a normal packed as 2x 8-bit snorms in the octahedral mapping.
+ */
+inline float3 decodeNormal2x8(uint32_t packedNormal)
+{
+    float2 octNormal = unpackSnorm2x8(packedNormal);
+    return oct_to_ndir_snorm(octNormal);
+}
+
 /**
  * Encode a normal packed as 2x 16-bit snorms in the octahedral mapping.
  */
@@ -92,4 +111,42 @@ inline float3 decodeNormal2x16(uint32_t packedNormal)
     float2 octNormal = unpackSnorm2x16(packedNormal);
     return oct_to_ndir_snorm(octNormal);
 }
+/**
+ * Encode an RGB color into the 32-bit shared-exponent RGB9E5 format.
+ * The format stores a 9-bit mantissa per channel and a 5-bit shared exponent, matching R9G9B9E5_SHAREDEXP.
+ * The precision is relative to the largest channel. Negative values and NaNs are encoded as zero and
+ * values above the largest representable value (65408) are clamped.
+ */
+inline uint32_t encodeRGB9E5(float3 color)
+{
+    const float kMaxValue = 65408.f;
+    auto clampChannel = [&](float v) { return v > 0.f ? std::min(v, kMaxValue) : 0.f; };
+    float3 c = float3(clampChannel(color.x), clampChannel(color.y), clampChannel(color.z));
+    float maxChannel = std::max(c.x, std::max(c.y, c.z));
+
+    // Compute the shared exponent from the float exponent of the largest channel.
+    int exponent = std::max(-16, int((math::asuint(maxChannel) >> 23) & 0xff) - 127) + 16;
+    float scale = math::asfloat(uint32_t(exponent + 103) << 23); // 2^(exponent - 24)
+
+    // Rounding may overflow the mantissa of the largest channel. Use the next exponent in that case.
+    if (uint32_t(std::floor(maxChannel / scale + 0.5f)) == 512)
+    {
+        exponent++;
+        scale *= 2.f;
+    }
+
+    uint3 m = uint3(math::floor(c / scale + 0.5f));
+    return m.x | (m.y << 9) | (m.z << 18) | (uint32_t(exponent) << 27);
+}
+
+/**
+ * Decode an RGB color stored in the 32-bit shared-exponent RGB9E5 format.
+ * See encodeRGB9E5() for details.
+ */
+inline float3 decodeRGB9E5(uint32_t packedColor)
+{
+    uint3 m = uint3(packedColor, packedColor >> 9, packedColor >> 18) & 0x1ffu;
+    float scale = math::asfloat(((packedColor >> 27) + 103) << 23);
+    return float3(m) * scale;
+}
 } // namespace Falcor
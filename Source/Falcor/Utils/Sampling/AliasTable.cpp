@@ -28,9 +28,15 @@
 #include "AliasTable.h"
 #include "Core/Error.h"
 #include "Core/API/Device.h"
+#include "Utils/NumericRange.h"
+#include <algorithm>
+#include <cstring>
+#include <execution>
 
 namespace Falcor
 {
+namespace
+{
 // This builds an alias table via the O(N) algorithm from Vose 1991, "A linear algorithm for generating random
 // numbers with a given distribution," IEEE Transactions on Software Engineering 17(9), 972-975.
 //
@@ -39,111 +45,233 @@ namespace Falcor
 //
 // By first separating all inputs into 2 temporary buffer (one overweighted set, with weights above the
 // average; one underweighted set, with weights below average), we can simply walk through the lists once,
-// merging the first elements in each temporary buffer.  The residual sample is interted into either the
-// overweighted or underweighted set, depending on its residual weight.
+// merging the last elements in each temporary buffer.  The residual sample is inserted into either the
+// overweighted or underweighted set, depending on its residual weight. Each underweighted sample is stored
+// at its own index in the table, so the table entry index implicitly identifies the sample.
 //
 // The main complexity is dealing with corner cases, thanks to numerical precision issues, where you don't
 // have 2 valid entries to combine.  By definition, in these corner cases, all remaining unhandled samples
-// actually have the average weight (within numerical precision limits)
-AliasTable::AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt19937& rng) : mCount((uint32_t)weights.size())
+// actually have the average weight (within numerical precision limits), and are picked with 100% probability.
+template<typename T>
+double buildTable(const T* weights, uint32_t count, uint32_t indexOffset, AliasTable::Item* items)
 {
-    // Use >= since we reserve 0xFFFFFFFFu as an invalid flag marker during construction.
-    if (weights.size() >= std::numeric_limits<uint32_t>::max())
-        FALCOR_THROW("Too many entries for alias table.");
-
-    std::uniform_int_distribution<uint32_t> rngDist;
-
-    mpWeights =
-        pDevice->createStructuredBuffer(sizeof(float), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, weights.data());
-
-    // Our working set / intermediate buffers (underweight & overweight); initialize to "invalid"
-    std::vector<uint32_t> lowIdx(mCount, 0xFFFFFFFFu);
-    std::vector<uint32_t> highIdx(mCount, 0xFFFFFFFFu);
-
     // Sum element weights, use double to minimize precision issues
-    mWeightSum = 0.0;
-    for (float f : weights)
-        mWeightSum += f;
+    double weightSum = 0.0;
+    for (uint32_t i = 0; i < count; ++i)
+        weightSum += weights[i];
+
+    // A table with zero total weight is never sampled; fill it with valid entries.
+    if (!(weightSum > 0.0))
+    {
+        for (uint32_t i = 0; i < count; ++i)
+            items[i] = {1.f, indexOffset + i};
+        return weightSum;
+    }
 
     // Find the average weight
-    float avgWeight = float(mWeightSum / double(mCount));
+    T avgWeight = T(weightSum / double(count));
 
-    // Initialize working set. Inset inputs into our lists of above-average or below-average weight elements.
-    int lowCount = 0;
-    int highCount = 0;
-    for (uint32_t i = 0; i < mCount; ++i)
+    // Initialize working set. Insert inputs into our lists of above-average or below-average weight elements.
+    std::vector<T> residual(weights, weights + count);
+    std::vector<uint32_t> lowIdx(count);
+    std::vector<uint32_t> highIdx(count);
+    uint32_t lowCount = 0;
+    uint32_t highCount = 0;
+    for (uint32_t i = 0; i < count; ++i)
     {
-        if (weights[i] < avgWeight)
+        if (residual[i] < avgWeight)
             lowIdx[lowCount++] = i;
         else
             highIdx[highCount++] = i;
     }
 
     // Create alias table entries by merging above- and below-average samples
-    std::vector<AliasTable::Item> items(mCount);
-    for (uint32_t i = 0; i < mCount; ++i)
+    while (lowCount > 0 && highCount > 0)
     {
-        // Usual case:  We have an above-average and below-average sample we can combine into one alias table entry
-        if ((lowIdx[i] != 0xFFFFFFFFu) && (highIdx[i] != 0xFFFFFFFFu))
-        {
-            // Create an alias table tuple:
-            items[i] = {weights[lowIdx[i]] / avgWeight, highIdx[i], lowIdx[i], 0};
-
-            // We've removed some weight from element highIdx[i]; update it's weight, then re-enter it
-            // on the end of either the above-average or below-average lists.
-            float updatedWeight = (weights[lowIdx[i]] + weights[highIdx[i]]) - avgWeight;
-            weights[highIdx[i]] = updatedWeight;
-            if (updatedWeight < avgWeight)
-                lowIdx[lowCount++] = highIdx[i];
-            else
-                highIdx[highCount++] = highIdx[i];
-        }
+        uint32_t low = lowIdx[--lowCount];
+        uint32_t high = highIdx[highCount - 1];
+        items[low] = {float(residual[low] / avgWeight), indexOffset + high};
 
-        // The next two cases can only occur towards the end of table creation, because either:
-        //    (a) all the remaining possible alias table entries have weight *exactly* equal to avgWeight,
-        //        which means these alias table entries only have one input item that is selected
-        //        with 100% probability
-        //    (b) all the remaining alias table entires have *almost* avgWeight, but due to (compounding)
-        //        precision issues throughout the process, they don't have *quite* that value.  In this case
-        //        treating these entries as having exactly avgWeight (as in case (a)) is the only right
-        //        thing to do mathematically (other than re-generating the alias table using higher precision
-        //        or trying to reduce catasrophic numerical cancellation in the "updatedWeight" computation above).
-        else if (highIdx[i] != 0xFFFFFFFFu)
+        // We've removed some weight from element high; update its weight, then move it
+        // to the below-average list if necessary.
+        residual[high] = (residual[low] + residual[high]) - avgWeight;
+        if (residual[high] < avgWeight)
         {
-            items[i] = {1.0f, highIdx[i], highIdx[i], 0};
-        }
-        else if (lowIdx[i] != 0xFFFFFFFFu)
-        {
-            items[i] = {1.0f, lowIdx[i], lowIdx[i], 0};
+            highCount--;
+            lowIdx[lowCount++] = high;
         }
+    }
 
-        // If there is neither a highIdx[i] or lowIdx[i] for some array element(s).  By construction,
-        // this cannot occur (without some logic bug above).
-        else
-        {
-            FALCOR_ASSERT(false); // Should not occur
-        }
+    // Remaining samples have (almost) the average weight.
+    while (lowCount > 0)
+    {
+        uint32_t i = lowIdx[--lowCount];
+        items[i] = {1.f, indexOffset + i};
+    }
+    while (highCount > 0)
+    {
+        uint32_t i = highIdx[--highCount];
+        items[i] = {1.f, indexOffset + i};
+    }
+
+    return weightSum;
+}
+} // namespace
+
+AliasTable::AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt19937& rng, uint32_t blockSize)
+    : mCount((uint32_t)weights.size()), mBlockSize(blockSize), mWeights(std::move(weights)), mpDevice(pDevice)
+{
+    if (mWeights.size() >= std::numeric_limits<uint32_t>::max())
+        FALCOR_THROW("Too many entries for alias table.");
+    FALCOR_CHECK(mCount > 0, "Alias table requires at least one weight.");
+    FALCOR_CHECK(mBlockSize > 0, "Alias table block size must be positive.");
+
+    uint32_t blockCount = (mCount + mBlockSize - 1) / mBlockSize;
+    mItems.resize(mCount);
+    mBlockWeights.resize(blockCount);
+    mBlocks.resize(blockCount);
+
+    std::vector<uint32_t> blocks(blockCount);
+    for (uint32_t i = 0; i < blockCount; ++i)
+        blocks[i] = i;
+    buildBlocks(blocks);
+    buildTopLevel();
+
+    if (mpDevice)
+    {
+        mpWeights = mpDevice->createStructuredBuffer(
+            sizeof(float), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mWeights.data()
+        );
+        mpItems = mpDevice->createStructuredBuffer(
+            sizeof(AliasTable::Item), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mItems.data()
+        );
+        mpBlocks = mpDevice->createStructuredBuffer(
+            sizeof(AliasTable::Item), blockCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, mBlocks.data()
+        );
     }
+}
 
-    // TODO: We can simplify the alias table to implicitly store indexB (aka lowIdx[i]), so the AliasTable::Item
-    // structure would be 1 float + 1 uint32_t, rather than 128 bits.  This, of course, would change usage in shaders
-    // and elsewhere.  To do this, here you'd need to sort elements by indexB so that when looking up mpItems[j],
-    // indexB==j.  This works since, by construction, only one element in the table has indexB==j (for any j
-    // in [0...mCount-1]).  Alternatively, during the loop above, you could directly enter elements into the
-    // correct location in the alias table.
+uint32_t AliasTable::updateWeights(const std::vector<float>& weights)
+{
+    FALCOR_CHECK(weights.size() == mCount, "Expected {} weights, got {}.", mCount, weights.size());
 
-    // Stash the alias table in our GPU buffer
-    mpItems = pDevice->createStructuredBuffer(
-        sizeof(AliasTable::Item), mCount, ResourceBindFlags::ShaderResource, MemoryType::DeviceLocal, items.data()
+    // Find and copy blocks with changed weights.
+    std::vector<uint8_t> dirty(getBlockCount(), 0);
+    auto range = NumericRange<uint32_t>(0, getBlockCount());
+    std::for_each(
+        std::execution::par,
+        range.begin(),
+        range.end(),
+        [&](uint32_t blockIndex)
+        {
+            uint32_t first = blockIndex * mBlockSize;
+            uint32_t size = std::min(mBlockSize, mCount - first);
+            if (std::memcmp(&mWeights[first], &weights[first], size * sizeof(float)) != 0)
+            {
+                std::memcpy(&mWeights[first], &weights[first], size * sizeof(float));
+                dirty[blockIndex] = 1;
+            }
+        }
     );
+
+    std::vector<uint32_t> blocks;
+    for (uint32_t i = 0; i < getBlockCount(); ++i)
+        if (dirty[i])
+            blocks.push_back(i);
+    if (blocks.empty())
+        return 0;
+
+    buildBlocks(blocks);
+    buildTopLevel();
+    uploadBlocks(blocks);
+
+    return (uint32_t)blocks.size();
 }
 
 void AliasTable::bindShaderData(const ShaderVar& var) const
 {
+    FALCOR_CHECK(mpDevice, "Alias table was created without a GPU device.");
+
     var["items"] = mpItems;
+    var["blocks"] = mpBlocks;
     var["weights"] = mpWeights;
     var["count"] = mCount;
+    var["blockSize"] = mBlockSize;
+    var["blockCount"] = getBlockCount();
     var["weightSum"] = (float)mWeightSum;
 }
 
+uint32_t AliasTable::sample(float2 rnd) const
+{
+    // Select a block. The fractional part of rnd.x and the rescaled rnd.y are reused for the second level.
+    uint32_t blockCount = getBlockCount();
+    float u = rnd.x * blockCount;
+    uint32_t blockIndex = std::min(blockCount - 1, (uint32_t)u);
+    u -= blockIndex;
+    float v = rnd.y;
+    const Item& block = mBlocks[blockIndex];
+    if (v < block.threshold)
+    {
+        v = v / block.threshold;
+    }
+    else
+    {
+        blockIndex = block.alias;
+        v = (v - block.threshold) / (1.f - block.threshold);
+    }
+
+    // Select an item within the block.
+    uint32_t first = blockIndex * mBlockSize;
+    uint32_t size = std::min(mBlockSize, mCount - first);
+    uint32_t index = first + std::min(size - 1, (uint32_t)(u * size));
+    const Item& item = mItems[index];
+    return v < item.threshold ? index : item.alias;
+}
+
+void AliasTable::buildBlocks(const std::vector<uint32_t>& blocks)
+{
+    // Blocks are independent alias tables and are built in parallel.
+    std::for_each(
+        std::execution::par,
+        blocks.begin(),
+        blocks.end(),
+        [&](uint32_t blockIndex)
+        {
+            uint32_t first = blockIndex * mBlockSize;
+            uint32_t size = std::min(mBlockSize, mCount - first);
+            mBlockWeights[blockIndex] = buildTable(&mWeights[first], size, first, &mItems[first]);
+        }
+    );
+}
+
+void AliasTable::buildTopLevel()
+{
+    buildTable(mBlockWeights.data(), getBlockCount(), 0, mBlocks.data());
+
+    // Sum element weights in order to be independent of the block size.
+    mWeightSum = 0.0;
+    for (float f : mWeights)
+        mWeightSum += f;
+}
+
+void AliasTable::uploadBlocks(const std::vector<uint32_t>& blocks)
+{
+    if (!mpDevice)
+        return;
+
+    // Upload consecutive runs of blocks with a single copy each.
+    for (size_t i = 0; i < blocks.size();)
+    {
+        size_t j = i + 1;
+        while (j < blocks.size() && blocks[j] == blocks[j - 1] + 1)
+            ++j;
+        uint32_t first = blocks[i] * mBlockSize;
+        uint32_t last = std::min(mCount, (blocks[j - 1] + 1) * mBlockSize);
+        mpItems->setBlob(&mItems[first], first * sizeof(Item), (last - first) * sizeof(Item));
+        mpWeights->setBlob(&mWeights[first], first * sizeof(float), (last - first) * sizeof(float));
+        i = j;
+    }
+    mpBlocks->setBlob(mBlocks.data(), 0, mBlocks.size() * sizeof(Item));
+}
+
 } // namespace Falcor
@@ -29,25 +29,53 @@
 #include "Core/Macros.h"
 #include "Core/API/Buffer.h"
 #include "Core/Program/ShaderVar.h"
+#include "Utils/Math/Vector.h"
 #include <memory>
 #include <random>
+#include <vector>
 
 namespace Falcor
 {
 /**
  * Implements the alias method for sampling from a discrete probability distribution.
+ *
+ * The table is organized in two levels to allow parallel construction and incremental updates.
+ * The weights are split into blocks of consecutive entries. Each block stores an independent
+ * alias table over its own weights, and a small top-level alias table selects a block
+ * proportional to the block's total weight. The resulting distribution is identical to a
+ * single-level table, but blocks can be built in parallel and only the blocks containing
+ * changed weights need to be rebuilt when weights are updated.
  */
 class FALCOR_API AliasTable
 {
 public:
+    /// Default number of weights per block.
+    static constexpr uint32_t kDefaultBlockSize = 4096;
+
+    /// Table entry. Entry i picks i itself if rand() < threshold, or the alias entry otherwise.
+    struct Item
+    {
+        float threshold; ///< Probability of picking the entry itself.
+        uint32_t alias;  ///< The "redirect" index, if uniform sampling would overweight the entry.
+    };
+
     /**
      * Create an alias table.
      * The weights don't need to be normalized to sum up to 1.
-     * @param[in] pDevice GPU device.
+     * @param[in] pDevice GPU device. If nullptr, only the CPU-side table is created (see sample()).
      * @param[in] weights The weights we'd like to sample each entry proportional to.
      * @param[in] rng The random number generator to use when creating the table.
+     * @param[in] blockSize Number of weights per block.
+     */
+    AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt19937& rng, uint32_t blockSize = kDefaultBlockSize);
+
+    /**
+     * Update the weights of the table.
+     * Only the blocks containing changed weights are rebuilt and uploaded to the GPU.
+     * @param[in] weights New weights. Must have the same number of entries as the table.
+     * @return Returns the number of rebuilt blocks.
      */
-    AliasTable(ref<Device> pDevice, std::vector<float> weights, std::mt19937& rng);
+    uint32_t updateWeights(const std::vector<float>& weights);
 
     /**
      * Bind the alias table data to a given shader var.
@@ -55,6 +83,14 @@ public:
      */
     void bindShaderData(const ShaderVar& var) const;
 
+    /**
+     * Sample from the table proportional to the weights on the CPU.
+     * This matches the sampling in AliasTable.slang.
+     * @param[in] rnd Two uniform random numbers in [0..1).
+     * @return Returns the sampled item index.
+     */
+    uint32_t sample(float2 rnd) const;
+
     /**
      * Get the number of weights in the table.
      */
@@ -65,19 +101,37 @@ public:
      */
     double getWeightSum() const { return mWeightSum; }
 
+    /**
+     * Get the weights used to create the table.
+     */
+    const std::vector<float>& getWeights() const { return mWeights; }
+
+    /**
+     * Get the number of weights per block.
+     */
+    uint32_t getBlockSize() const { return mBlockSize; }
+
+    /**
+     * Get the number of blocks.
+     */
+    uint32_t getBlockCount() const { return (uint32_t)mBlockWeights.size(); }
+
 private:
-    // Item structure for the mpItems buffer.
-    struct Item
-    {
-        float threshold; ///< If rand() < threshold, pick indexB (else pick indexA)
-        uint32_t indexA; ///< The "redirect" index, if uniform sampling would overweight indexB.
-        uint32_t indexB; ///< The original / permutation index, sampled uniformly in [0...mCount-1]
-        uint32_t _pad;
-    };
+    void buildBlocks(const std::vector<uint32_t>& blocks);
+    void buildTopLevel();
+    void uploadBlocks(const std::vector<uint32_t>& blocks);
+
+    uint32_t mCount;                   ///< Number of items in the alias table.
+    uint32_t mBlockSize;               ///< Number of items per block.
+    double mWeightSum;                 ///< Total weight of all elements used to create the alias table.
+    std::vector<float> mWeights;       ///< Item weights.
+    std::vector<Item> mItems;          ///< Per-block alias tables (one entry per item).
+    std::vector<double> mBlockWeights; ///< Total weight per block.
+    std::vector<Item> mBlocks;         ///< Top-level alias table selecting blocks.
 
-    uint32_t mCount;       ///< Number of items in the alias table.
-    double mWeightSum;     ///< Total weight of all elements used to create the alias table.
+    ref<Device> mpDevice;
     ref<Buffer> mpItems;   ///< Buffer containing table items.
+    ref<Buffer> mpBlocks;  ///< Buffer containing top-level table items.
     ref<Buffer> mpWeights; ///< Buffer containing item weights.
 };
 } // namespace Falcor
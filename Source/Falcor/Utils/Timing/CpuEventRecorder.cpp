@@ -0,0 +1,276 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "CpuEventRecorder.h"
+#include "Core/Error.h"
+#include <nlohmann/json.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace Falcor
+{
+namespace
+{
+/// Ring buffer of records written by a single thread.
+/// Slots are stored as relaxed atomics so that concurrent collection is race-free.
+/// The write index is published with release semantics after a slot is written.
+struct ThreadBuffer
+{
+    struct Slot
+    {
+        std::atomic<uint32_t> eventId{CpuEventRecorder::kInvalidEventId};
+        std::atomic<uint64_t> startTime{0};
+        std::atomic<uint64_t> endTime{0};
+    };
+
+    uint32_t threadIndex = 0;
+    std::string threadName; ///< Protected by the registry mutex.
+    std::unique_ptr<Slot[]> slots{new Slot[CpuEventRecorder::kRecordsPerThread]};
+    std::atomic<uint64_t> writeIndex{0};
+    std::atomic<bool> threadExited{false};
+};
+
+struct Registry
+{
+    std::mutex mutex;
+    std::vector<std::shared_ptr<ThreadBuffer>> threads;
+    uint32_t nextThreadIndex = 0;
+    std::deque<std::string> eventNames;
+    std::unordered_map<std::string, CpuEventRecorder::EventId> eventIds;
+    std::atomic<bool> enabled{false};
+    const CpuTimer::TimePoint epoch = CpuTimer::getCurrentTimePoint();
+};
+
+Registry& getRegistry()
+{
+    static Registry registry;
+    return registry;
+}
+
+/// Per-thread recorder state.
+/// The ring buffer is only allocated when the thread records its first event, so threads that never record
+/// while recording is enabled cost nothing. When the thread exits, its buffer is kept by the registry
+/// until its records have been collected.
+struct ThreadState
+{
+    std::string threadName;
+    std::shared_ptr<ThreadBuffer> pBuffer;
+
+    ~ThreadState()
+    {
+        if (pBuffer)
+            pBuffer->threadExited.store(true, std::memory_order_release);
+    }
+};
+
+ThreadState& getThreadState()
+{
+    thread_local ThreadState state;
+    return state;
+}
+
+ThreadBuffer& getThreadBuffer()
+{
+    auto& state = getThreadState();
+    if (!state.pBuffer)
+    {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        auto buffer = std::make_shared<ThreadBuffer>();
+        buffer->threadIndex = registry.nextThreadIndex++;
+        buffer->threadName = state.threadName.empty() ? fmt::format("Thread {}", buffer->threadIndex) : state.threadName;
+        registry.threads.push_back(buffer);
+        state.pBuffer = std::move(buffer);
+    }
+    return *state.pBuffer;
+}
+} // namespace
+
+void CpuEventRecorder::setEnabled(bool enabled)
+{
+    getRegistry().enabled.store(enabled, std::memory_order_relaxed);
+}
+
+bool CpuEventRecorder::isEnabled()
+{
+    return getRegistry().enabled.load(std::memory_order_relaxed);
+}
+
+CpuEventRecorder::EventId CpuEventRecorder::registerEvent(std::string_view name)
+{
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    auto [it, inserted] = registry.eventIds.try_emplace(std::string(name), (EventId)registry.eventNames.size());
+    if (inserted)
+        registry.eventNames.emplace_back(name);
+    return it->second;
+}
+
+std::string CpuEventRecorder::getEventName(EventId eventId)
+{
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    FALCOR_CHECK(eventId < registry.eventNames.size(), "Invalid event ID {}.", eventId);
+    return registry.eventNames[eventId];
+}
+
+void CpuEventRecorder::setThreadName(std::string_view name)
+{
+    auto& state = getThreadState();
+    state.threadName = name;
+    if (state.pBuffer)
+    {
+        std::lock_guard<std::mutex> lock(getRegistry().mutex);
+        state.pBuffer->threadName = name;
+    }
+}
+
+uint64_t CpuEventRecorder::getTimestamp()
+{
+    return toTimestamp(CpuTimer::getCurrentTimePoint());
+}
+
+uint64_t CpuEventRecorder::toTimestamp(CpuTimer::TimePoint timePoint)
+{
+    auto duration = std::chrono::duration_cast<std::chrono::nanoseconds>(timePoint - getRegistry().epoch);
+    return (uint64_t)std::max<int64_t>(0, duration.count());
+}
+
+void CpuEventRecorder::record(EventId eventId, uint64_t startTime, uint64_t endTime)
+{
+    if (!isEnabled())
+        return;
+
+    auto& buffer = getThreadBuffer();
+    uint64_t index = buffer.writeIndex.load(std::memory_order_relaxed);
+    auto& slot = buffer.slots[index % kRecordsPerThread];
+    slot.eventId.store(eventId, std::memory_order_relaxed);
+    slot.startTime.store(startTime, std::memory_order_relaxed);
+    slot.endTime.store(endTime, std::memory_order_relaxed);
+    buffer.writeIndex.store(index + 1, std::memory_order_release);
+}
+
+std::vector<CpuEventRecorder::ThreadTrack> CpuEventRecorder::collect(uint64_t startTime, uint64_t endTime)
+{
+    auto& registry = getRegistry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    std::vector<ThreadTrack> tracks;
+    std::vector<std::shared_ptr<ThreadBuffer>> activeThreads;
+    for (auto& pBuffer : registry.threads)
+    {
+        // Buffers of exited threads are freed after collecting their records.
+        // The exit flag is read first, so an exited thread cannot record anything after this point.
+        if (!pBuffer->threadExited.load(std::memory_order_acquire))
+            activeThreads.push_back(pBuffer);
+
+        ThreadTrack track;
+        track.threadIndex = pBuffer->threadIndex;
+        track.threadName = pBuffer->threadName;
+
+        uint64_t end = pBuffer->writeIndex.load(std::memory_order_acquire);
+        uint64_t begin = end > kRecordsPerThread ? end - kRecordsPerThread : 0;
+
+        std::vector<std::pair<uint64_t, Record>> records;
+        records.reserve(end - begin);
+        for (uint64_t i = begin; i < end; ++i)
+        {
+            const auto& slot = pBuffer->slots[i % kRecordsPerThread];
+            Record record;
+            record.eventId = slot.eventId.load(std::memory_order_relaxed);
+            record.startTime = slot.startTime.load(std::memory_order_relaxed);
+            record.endTime = slot.endTime.load(std::memory_order_relaxed);
+            records.emplace_back(i, record);
+        }
+
+        // Discard records that the owning thread may have overwritten while we were reading.
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t newEnd = pBuffer->writeIndex.load(std::memory_order_relaxed);
+        uint64_t firstValid = newEnd > kRecordsPerThread ? newEnd - kRecordsPerThread : 0;
+
+        for (const auto& [i, record] : records)
+        {
+            if (i < firstValid || record.startTime < startTime || record.startTime > endTime)
+                continue;
+            track.records.push_back(record);
+        }
+
+        if (track.records.empty())
+            continue;
+
+        std::stable_sort(
+            track.records.begin(), track.records.end(), [](const Record& a, const Record& b) { return a.startTime < b.startTime; }
+        );
+        tracks.push_back(std::move(track));
+    }
+
+    registry.threads = std::move(activeThreads);
+
+    return tracks;
+}
+
+void CpuEventRecorder::appendChromeTraceEvents(nlohmann::json& traceEvents, const std::vector<ThreadTrack>& tracks, uint32_t pid)
+{
+    // Resolve event names once.
+    std::vector<std::string> eventNames;
+    {
+        auto& registry = getRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        eventNames.assign(registry.eventNames.begin(), registry.eventNames.end());
+    }
+
+    for (const auto& track : tracks)
+    {
+        traceEvents.push_back({
+            {"name", "thread_name"},
+            {"ph", "M"},
+            {"pid", pid},
+            {"tid", track.threadIndex},
+            {"args", {{"name", track.threadName}}},
+        });
+
+        for (const auto& record : track.records)
+        {
+            // Chrome trace timestamps and durations are in microseconds.
+            traceEvents.push_back({
+                {"name", record.eventId < eventNames.size() ? eventNames[record.eventId] : "unknown"},
+                {"cat", "cpu"},
+                {"ph", "X"},
+                {"pid", pid},
+                {"tid", track.threadIndex},
+                {"ts", record.startTime * 1e-3},
+                {"dur", (record.endTime - std::min(record.startTime, record.endTime)) * 1e-3},
+            });
+        }
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,177 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "CpuTimer.h"
+#include "Core/Macros.h"
+#include <nlohmann/json_fwd.hpp>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Low-overhead recorder for CPU events on any thread.
+ *
+ * Events are identified by interned IDs (see registerEvent()), so recording an event does not involve any string operations.
+ * Each thread records into its own fixed-size ring buffer, which is written without locks. The ring buffer is allocated
+ * when the thread records its first event and released after the thread has exited and its records were collected.
+ * When the ring buffer is full, the oldest records are overwritten. Records can be collected at any time from any thread and exported as Chrome trace
+ * event JSON (chrome://tracing, https://ui.perfetto.dev), with one track per thread.
+ *
+ * Recording is disabled by default. The Profiler enables it while a capture is running.
+ * Use the FALCOR_PROFILE_CPU macro to record a scoped event.
+ */
+class FALCOR_API CpuEventRecorder
+{
+public:
+    using EventId = uint32_t;
+    static constexpr EventId kInvalidEventId = std::numeric_limits<EventId>::max();
+
+    /// Number of records kept per thread.
+    static constexpr size_t kRecordsPerThread = 1 << 16;
+
+    /// A single recorded event. Times are in nanoseconds since the recorder epoch.
+    struct Record
+    {
+        EventId eventId = kInvalidEventId;
+        uint64_t startTime = 0;
+        uint64_t endTime = 0;
+    };
+
+    /// Records of a single thread.
+    struct ThreadTrack
+    {
+        uint32_t threadIndex = 0;
+        std::string threadName;
+        std::vector<Record> records; ///< Records sorted by start time.
+    };
+
+    /**
+     * Enable/disable recording.
+     */
+    static void setEnabled(bool enabled);
+
+    /**
+     * Check if recording is enabled.
+     */
+    static bool isEnabled();
+
+    /**
+     * Intern an event name. Registering the same name twice returns the same ID.
+     * This function is thread-safe, but takes a lock. Call sites should cache the returned ID.
+     * @param[in] name Event name.
+     * @return Returns the event ID.
+     */
+    static EventId registerEvent(std::string_view name);
+
+    /**
+     * Get the name of a registered event.
+     */
+    static std::string getEventName(EventId eventId);
+
+    /**
+     * Set the name of the calling thread. The name is used for the thread's track in the exported trace.
+     * This only stores the name and is cheap to call when recording is disabled.
+     */
+    static void setThreadName(std::string_view name);
+
+    /**
+     * Get the current time in nanoseconds since the recorder epoch.
+     */
+    static uint64_t getTimestamp();
+
+    /**
+     * Convert a CPU time point to nanoseconds since the recorder epoch.
+     */
+    static uint64_t toTimestamp(CpuTimer::TimePoint timePoint);
+
+    /**
+     * Record an event on the calling thread. Does nothing if recording is disabled.
+     * @param[in] eventId Event ID returned by registerEvent().
+     * @param[in] startTime Start time in nanoseconds since the recorder epoch.
+     * @param[in] endTime End time in nanoseconds since the recorder epoch.
+     */
+    static void record(EventId eventId, uint64_t startTime, uint64_t endTime);
+
+    /**
+     * Collect the records of all threads that started within a time range.
+     * Records that are overwritten while collecting are skipped.
+     * The buffers of threads that have exited are released, so their records are only returned once.
+     * @param[in] startTime Start of the time range (inclusive).
+     * @param[in] endTime End of the time range (inclusive).
+     * @return Returns one track per thread that has records within the time range.
+     */
+    static std::vector<ThreadTrack> collect(uint64_t startTime = 0, uint64_t endTime = std::numeric_limits<uint64_t>::max());
+
+    /**
+     * Append Chrome trace events for the given tracks to a JSON array.
+     * @param[in,out] traceEvents JSON array of trace events.
+     * @param[in] tracks Thread tracks.
+     * @param[in] pid Process ID used for the tracks in the trace.
+     */
+    static void appendChromeTraceEvents(nlohmann::json& traceEvents, const std::vector<ThreadTrack>& tracks, uint32_t pid);
+};
+
+/**
+ * Helper class for recording a scoped CPU event using RAII.
+ * Use the FALCOR_PROFILE_CPU macro instead of creating objects directly.
+ */
+class ScopedCpuEvent
+{
+public:
+    ScopedCpuEvent(CpuEventRecorder::EventId eventId)
+        : mEventId(CpuEventRecorder::isEnabled() ? eventId : CpuEventRecorder::kInvalidEventId)
+        , mStartTime(mEventId != CpuEventRecorder::kInvalidEventId ? CpuEventRecorder::getTimestamp() : 0)
+    {}
+
+    ~ScopedCpuEvent()
+    {
+        if (mEventId != CpuEventRecorder::kInvalidEventId)
+            CpuEventRecorder::record(mEventId, mStartTime, CpuEventRecorder::getTimestamp());
+    }
+
+    ScopedCpuEvent(const ScopedCpuEvent&) = delete;
+    ScopedCpuEvent& operator=(const ScopedCpuEvent&) = delete;
+
+private:
+    CpuEventRecorder::EventId mEventId;
+    uint64_t mStartTime;
+};
+} // namespace Falcor
+
+#if FALCOR_ENABLE_PROFILER
+#define FALCOR_PROFILE_CPU(_name)                                                                                     \
+    static const ::Falcor::CpuEventRecorder::EventId FALCOR_CONCAT_STRINGS(_cpuEventId, __LINE__) =                   \
+        ::Falcor::CpuEventRecorder::registerEvent(_name);                                                             \
+    ::Falcor::ScopedCpuEvent FALCOR_CONCAT_STRINGS(_cpuEvent, __LINE__)(FALCOR_CONCAT_STRINGS(_cpuEventId, __LINE__))
+#else
+#define FALCOR_PROFILE_CPU(_name)
+#endif
@@ -31,6 +31,9 @@
 #include "Utils/Logger.h"
 #include "Utils/Scripting/ScriptBindings.h"
 
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
 #include <fstream>
 
 namespace Falcor
@@ -131,7 +134,11 @@ Profiler::Stats Profiler::Stats::compute(const float* data, size_t len)
 
 // Profiler::Event
 
-Profiler::Event::Event(const std::string& name) : mName(name), mCpuTimeHistory(kMaxHistorySize, 0.f), mGpuTimeHistory(kMaxHistorySize, 0.f)
+Profiler::Event::Event(const std::string& name)
+    : mName(name)
+    , mCpuEventId(CpuEventRecorder::registerEvent(name.substr(name.find_last_of('/') + 1)))
+    , mCpuTimeHistory(kMaxHistorySize, 0.f)
+    , mGpuTimeHistory(kMaxHistorySize, 0.f)
 {}
 
 Profiler::Stats Profiler::Event::computeCpuTimeStats() const
@@ -183,7 +190,14 @@ void Profiler::Event::end(uint32_t frameIndex)
     auto& frameData = mFrameData[frameIndex % 2];
 
     // Update CPU time.
-    frameData.cpuTotalTime += (float)CpuTimer::calcDuration(frameData.cpuStartTime, CpuTimer::getCurrentTimePoint());
+    auto cpuEndTime = CpuTimer::getCurrentTimePoint();
+    frameData.cpuTotalTime += (float)CpuTimer::calcDuration(frameData.cpuStartTime, cpuEndTime);
+    if (CpuEventRecorder::isEnabled())
+    {
+        CpuEventRecorder::record(
+            mCpuEventId, CpuEventRecorder::toTimestamp(frameData.cpuStartTime), CpuEventRecorder::toTimestamp(cpuEndTime)
+        );
+    }
 
     // Update GPU time.
     FALCOR_ASSERT(frameData.pActiveTimer != nullptr);
@@ -250,7 +264,63 @@ void Profiler::Capture::writeToFile(const std::filesystem::path& path) const
     ofs.write(json.data(), json.size());
 }
 
-Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames) : mReservedFrames(reservedFrames)
+std::string Profiler::Capture::toChromeTraceJsonString() const
+{
+    const uint32_t kCpuPid = 1;
+    const uint32_t kGpuPid = 2;
+
+    nlohmann::json traceEvents = nlohmann::json::array();
+    traceEvents.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", kCpuPid}, {"args", {{"name", "CPU"}}}});
+    traceEvents.push_back({{"name", "process_name"}, {"ph", "M"}, {"pid", kGpuPid}, {"args", {{"name", "GPU"}}}});
+    traceEvents.push_back({{"name", "thread_name"}, {"ph", "M"}, {"pid", kGpuPid}, {"tid", 0}, {"args", {{"name", "GPU timers"}}}});
+
+    CpuEventRecorder::appendChromeTraceEvents(traceEvents, mCpuTracks, kCpuPid);
+
+    // GPU lanes. Events are ordered by their first start, so a parent always precedes its children.
+    // Each event is placed after its previous sibling, children start at their parent's start.
+    for (size_t frame = 0; frame < mFrameCount && frame < mFrameTimestamps.size(); ++frame)
+    {
+        std::vector<double> cursor; // Next start time per nesting depth in microseconds.
+        for (size_t i = 0; i < mEvents.size(); ++i)
+        {
+            const std::string& name = mEvents[i]->getName();
+            size_t depth = std::count(name.begin(), name.end(), '/') - 1;
+            if (cursor.size() < depth + 2)
+                cursor.resize(depth + 2, mFrameTimestamps[frame] * 1e-3);
+
+            double start = cursor[depth];
+            double duration = mLanes[i * 2 + 1].records[frame] * 1e3;
+            cursor[depth] = start + duration;
+            cursor[depth + 1] = start;
+            for (size_t d = depth + 2; d < cursor.size(); ++d)
+                cursor[d] = start;
+
+            traceEvents.push_back({
+                {"name", name.substr(name.find_last_of('/') + 1)},
+                {"cat", "gpu"},
+                {"ph", "X"},
+                {"pid", kGpuPid},
+                {"tid", 0},
+                {"ts", start},
+                {"dur", duration},
+                {"args", {{"event", name}, {"frame", frame}}},
+            });
+        }
+    }
+
+    nlohmann::json trace = {{"traceEvents", std::move(traceEvents)}, {"displayTimeUnit", "ms"}};
+    return trace.dump();
+}
+
+void Profiler::Capture::writeChromeTraceToFile(const std::filesystem::path& path) const
+{
+    auto json = toChromeTraceJsonString();
+    std::ofstream ofs(path);
+    ofs.write(json.data(), json.size());
+}
+
+Profiler::Capture::Capture(size_t reservedEvents, size_t reservedFrames)
+    : mReservedFrames(reservedFrames), mStartTime(CpuEventRecorder::getTimestamp())
 {
     // Speculativly allocate event record storage.
     mLanes.resize(reservedEvents * 2);
@@ -287,6 +357,7 @@ void Profiler::Capture::captureEvents(const std::vector<Event*>& events)
         mLanes[i * 2 + 1].records.push_back(pEvent->getGpuTime());
     }
 
+    mFrameTimestamps.push_back(CpuEventRecorder::getTimestamp());
     ++mFrameCount;
 }
 
@@ -299,6 +370,8 @@ void Profiler::Capture::finalize()
         lane.stats = Stats::compute(lane.records.data(), lane.records.size());
     }
 
+    mCpuTracks = CpuEventRecorder::collect(mStartTime);
+
     mFinalized = true;
 }
 
@@ -306,6 +379,9 @@ void Profiler::Capture::finalize()
 
 Profiler::Profiler(ref<Device> pDevice) : mpDevice(pDevice)
 {
+    // The profiler is created and used on the rendering thread.
+    CpuEventRecorder::setThreadName("Main");
+
     mpFence = mpDevice->createFence();
     mpFence->breakStrongReferenceToDevice();
 }
@@ -371,6 +447,12 @@ Profiler::Event* Profiler::getEvent(const std::string& name)
 
 void Profiler::endFrame(RenderContext* pRenderContext)
 {
+    // The counters are always updated so they are available when the profiler is paused or disabled.
+    mLastFrameCounters.uniformBytesUploaded = mUniformBytesUploaded.exchange(0, std::memory_order_relaxed);
+    mLastFrameCounters.uniformWritesSkipped = mUniformWritesSkipped.exchange(0, std::memory_order_relaxed);
+    mLastFrameCounters.descriptorWrites = mDescriptorWrites.exchange(0, std::memory_order_relaxed);
+    mLastFrameCounters.descriptorWritesSkipped = mDescriptorWritesSkipped.exchange(0, std::memory_order_relaxed);
+
     if (mPaused)
         return;
 
@@ -399,6 +481,9 @@ void Profiler::endFrame(RenderContext* pRenderContext)
 void Profiler::startCapture(size_t reservedFrames)
 {
     setEnabled(true);
+    if (!mpCapture)
+        mCpuEventRecorderWasEnabled = CpuEventRecorder::isEnabled();
+    CpuEventRecorder::setEnabled(true);
     mpCapture = std::make_shared<Capture>(mLastFrameEvents.size(), reservedFrames);
 }
 
@@ -407,7 +492,10 @@ std::shared_ptr<Profiler::Capture> Profiler::endCapture()
     std::shared_ptr<Capture> pCapture;
     std::swap(pCapture, mpCapture);
     if (pCapture)
+    {
         pCapture->finalize();
+        CpuEventRecorder::setEnabled(mCpuEventRecorderWasEnabled);
+    }
     return pCapture;
 }
 
@@ -465,12 +553,16 @@ FALCOR_SCRIPT_BINDING(Profiler)
 
     using namespace pybind11::literals;
 
-    auto endCapture = [](Profiler* pProfiler)
+    auto endCapture = [](Profiler* pProfiler, std::optional<std::filesystem::path> chromeTracePath)
     {
         std::optional<pybind11::dict> result;
         auto pCapture = pProfiler->endCapture();
         if (pCapture)
+        {
             result = toPython(*pCapture);
+            if (chromeTracePath)
+                pCapture->writeChromeTraceToFile(*chromeTracePath);
+        }
         return result;
     };
 
@@ -479,8 +571,21 @@ FALCOR_SCRIPT_BINDING(Profiler)
     profiler.def_property("paused", &Profiler::isPaused, &Profiler::setPaused);
     profiler.def_property_readonly("is_capturing", &Profiler::isCapturing);
     profiler.def_property_readonly("events", [](const Profiler& profiler) { return toPython(profiler.getEvents()); });
+    profiler.def_property_readonly(
+        "frame_counters",
+        [](const Profiler& profiler)
+        {
+            const auto& counters = profiler.getFrameCounters();
+            pybind11::dict d;
+            d["uniform_bytes_uploaded"] = counters.uniformBytesUploaded;
+            d["uniform_writes_skipped"] = counters.uniformWritesSkipped;
+            d["descriptor_writes"] = counters.descriptorWrites;
+            d["descriptor_writes_skipped"] = counters.descriptorWritesSkipped;
+            return d;
+        }
+    );
     profiler.def("start_capture", &Profiler::startCapture, "reserved_frames"_a = 1000);
-    profiler.def("end_capture", endCapture);
+    profiler.def("end_capture", endCapture, "chrome_trace_path"_a = std::nullopt);
 
     pybind11::class_<PythonProfilerEvent>(m, "ProfilerEvent")
         .def(pybind11::init<RenderContext*, std::string_view>())
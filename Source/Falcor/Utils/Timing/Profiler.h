@@ -27,9 +27,11 @@
  **************************************************************************/
 #pragma once
 #include "CpuTimer.h"
+#include "CpuEventRecorder.h"
 #include "Core/Macros.h"
 #include "Core/API/GpuTimer.h"
 #include "Core/API/Fence.h"
+#include <atomic>
 #include <filesystem>
 #include <memory>
 #include <string>
@@ -46,6 +48,8 @@ class RenderContext;
  * It automatically creates event hierarchies based on the order and nesting of the calls made.
  * This class uses a double-buffering scheme for GPU profiling to avoid GPU stalls.
  * ProfilerEvent is a wrapper class which together with scoping can simplify event profiling.
+ * While a capture is running, CPU events are also recorded by the CpuEventRecorder, which allows exporting
+ * them together with CPU events from worker threads as a Chrome trace.
  */
 class FALCOR_API Profiler
 {
@@ -90,7 +94,8 @@ public:
         void end(uint32_t frameIndex);
         void endFrame(uint32_t frameIndex);
 
-        std::string mName; ///< Nested event name.
+        std::string mName;                       ///< Nested event name.
+        CpuEventRecorder::EventId mCpuEventId;   ///< Event ID used for recording with the CpuEventRecorder.
 
         float mCpuTime = 0.0; ///< CPU time (previous frame).
         float mGpuTime = 0.0; ///< GPU time (previous frame).
@@ -121,6 +126,17 @@ public:
         friend class Profiler;
     };
 
+    /**
+     * Per-frame counters of the CPU work for submitting shader parameters.
+     */
+    struct FrameCounters
+    {
+        uint64_t uniformBytesUploaded = 0;    ///< Bytes of uniform data uploaded for parameter blocks with modified uniforms.
+        uint64_t uniformWritesSkipped = 0;    ///< Number of uniform writes skipped because the data was unchanged.
+        uint64_t descriptorWrites = 0;        ///< Number of resource bindings written to parameter blocks.
+        uint64_t descriptorWritesSkipped = 0; ///< Number of resource bindings skipped because the binding was unchanged.
+    };
+
     class Capture
     {
     public:
@@ -139,6 +155,15 @@ public:
         std::string toJsonString() const;
         void writeToFile(const std::filesystem::path& path) const;
 
+        /**
+         * Convert the capture to Chrome trace event JSON (chrome://tracing, https://ui.perfetto.dev).
+         * The trace contains one track per CPU thread with the events recorded by the CpuEventRecorder,
+         * and a GPU track with the per-frame GPU times of the profiler events. GPU events are placed
+         * sequentially within their parent event as their actual start times are not measured.
+         */
+        std::string toChromeTraceJsonString() const;
+        void writeChromeTraceToFile(const std::filesystem::path& path) const;
+
     private:
         void captureEvents(const std::vector<Event*>& events);
         void finalize();
@@ -149,6 +174,10 @@ public:
         std::vector<Lane> mLanes;
         bool mFinalized = false;
 
+        uint64_t mStartTime = 0;                                ///< Capture start time (CpuEventRecorder timestamp).
+        std::vector<uint64_t> mFrameTimestamps;                 ///< Time of each captured frame (CpuEventRecorder timestamp).
+        std::vector<CpuEventRecorder::ThreadTrack> mCpuTracks;  ///< CPU events recorded on all threads during the capture.
+
         friend class Profiler;
     };
 
@@ -237,6 +266,31 @@ public:
      */
     const std::vector<Event*>& getEvents() const { return mLastFrameEvents; }
 
+    /**
+     * Get the parameter submission counters (previous frame).
+     */
+    const FrameCounters& getFrameCounters() const { return mLastFrameCounters; }
+
+    /**
+     * Record an upload of uniform data. Thread-safe.
+     * @param[in] byteSize Number of bytes uploaded.
+     */
+    void recordUniformUpload(size_t byteSize) { mUniformBytesUploaded.fetch_add(byteSize, std::memory_order_relaxed); }
+
+    /**
+     * Record a uniform write that was skipped because the data was unchanged. Thread-safe.
+     */
+    void recordUniformWriteSkipped() { mUniformWritesSkipped.fetch_add(1, std::memory_order_relaxed); }
+
+    /**
+     * Record a resource binding write. Thread-safe.
+     * @param[in] skipped True if the write was skipped because the binding was unchanged.
+     */
+    void recordDescriptorWrite(bool skipped)
+    {
+        (skipped ? mDescriptorWritesSkipped : mDescriptorWrites).fetch_add(1, std::memory_order_relaxed);
+    }
+
     void breakStrongReferenceToDevice();
 
 private:
@@ -266,7 +320,14 @@ private:
     uint32_t mCurrentLevel = 0;                                      ///< Current nesting level.
     uint32_t mFrameIndex = 0;                                        ///< Current frame index.
 
+    std::atomic<uint64_t> mUniformBytesUploaded{0};    ///< Counters for the current frame.
+    std::atomic<uint64_t> mUniformWritesSkipped{0};
+    std::atomic<uint64_t> mDescriptorWrites{0};
+    std::atomic<uint64_t> mDescriptorWritesSkipped{0};
+    FrameCounters mLastFrameCounters;                   ///< Counters from last frame.
+
     std::shared_ptr<Capture> mpCapture; ///< Currently active capture.
+    bool mCpuEventRecorderWasEnabled = false; ///< CpuEventRecorder state before the capture was started.
 
     ref<Fence> mpFence;
     uint64_t mFenceValue = uint64_t(-1);
@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "ProfilerUI.h"
 #include "Core/Platform/OS.h"
+#include "Utils/StringUtils.h"
 
 #include <imgui.h>
 
@@ -287,6 +288,15 @@ void ProfilerUI::renderOptions()
             mpProfiler->startCapture();
     }
 
+    const auto& counters = mpProfiler->getFrameCounters();
+    ImGui::Text(
+        "Uniforms: %s uploaded, %llu writes skipped. Descriptors: %llu writes, %llu skipped.",
+        formatByteSize(counters.uniformBytesUploaded).c_str(),
+        (unsigned long long)counters.uniformWritesSkipped,
+        (unsigned long long)counters.descriptorWrites,
+        (unsigned long long)counters.descriptorWritesSkipped
+    );
+
     ImGui::Separator();
 }
 
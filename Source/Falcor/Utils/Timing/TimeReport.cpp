@@ -72,6 +72,6 @@ void TimeReport::measure(const std::string& name)
 void TimeReport::addTotal(const std::string name)
 {
     mTotal = std::accumulate(mMeasurements.begin(), mMeasurements.end(), 0.0, [](double t, auto&& m) { return t + m.second; });
-    mMeasurements.push_back({"Total", mTotal});
+    mMeasurements.push_back({name, mTotal});
 }
 } // namespace Falcor
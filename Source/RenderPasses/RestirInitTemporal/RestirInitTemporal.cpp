@@ -28,6 +28,10 @@
 #include "RestirInitTemporal.h"
 
 #include "RenderGraph/RenderPassHelpers.h"
+#include "Rendering/Lights/EmissivePowerSampler.h"
+#include "Rendering/Lights/EmissiveUniformSampler.h"
+#include "Rendering/Lights/LightBVHSampler.h"
+#include "Rendering/Utils/PackedReservoirs.slang"
 
 namespace
 {
@@ -104,6 +108,19 @@ const ChannelList kUpdateShadeInputChannels = {
     {"viewW", "gViewW", "World-space view direction", true},
 };
 
+// Serialized parameters
+const char* kUsePowerLightSelection = "usePowerLightSelection";
+const char* kEmissiveSampler = "emissiveSampler";
+const char* kPreset = "preset";
+const char* kMaxTemporalM = "maxTemporalM";
+const char* kTemporalMClampFactor = "temporalMClampFactor";
+const char* kCheckerboardTemporal = "checkerboardTemporal";
+const char* kSpatialNeighborCount = "spatialNeighborCount";
+const char* kSpatialRadius = "spatialRadius";
+const char* kHalfResSpatial = "halfResSpatial";
+
+const uint32_t kMaxSpatialNeighborCount = 32;
+
 const char* kReservoirCurrent = "reservoirCurrent";
 const char* kReservoirPrevious = "reservoirPrevious";
 const char* kReservoirSpatial = "reservoirSpatial";
@@ -128,17 +145,122 @@ const ChannelList kUpdateShadeOutputChannels = {
 extern "C" FALCOR_API_EXPORT void registerPlugin(Falcor::PluginRegistry& registry)
 {
     registry.registerClass<RenderPass, RestirInitTemporal>();
+    ScriptBindings::registerBinding(RestirInitTemporal::registerBindings);
+}
+
+void RestirInitTemporal::registerBindings(pybind11::module& m)
+{
+    pybind11::class_<RestirInitTemporal, RenderPass, ref<RestirInitTemporal>> pass(m, "RestirInitTemporal");
+
+    pass.def_property("preset",
+        [](const RestirInitTemporal* p) { return enumToString(p->getPreset()); },
+        [](RestirInitTemporal* p, const std::string& value) { p->setPreset(stringToEnum<Preset>(value)); }
+    );
+
+    // Expose the individual reuse parameters. Setting any of them updates the preset.
+#define reuse_option(name)                                                     \
+    pass.def_property(                                                         \
+        #name,                                                                 \
+        [](const RestirInitTemporal* p) { return p->getReuseOptions().name; }, \
+        [](RestirInitTemporal* p, decltype(ReuseOptions::name) value)          \
+        {                                                                      \
+            ReuseOptions options = p->getReuseOptions();                       \
+            options.name = value;                                              \
+            p->setReuseOptions(options);                                       \
+        }                                                                      \
+    )
+    reuse_option(maxTemporalM);
+    reuse_option(temporalMClampFactor);
+    reuse_option(checkerboardTemporal);
+    reuse_option(spatialNeighborCount);
+    reuse_option(spatialRadius);
+    reuse_option(halfResSpatial);
+#undef reuse_option
+}
+
+RestirInitTemporal::ReuseOptions RestirInitTemporal::getPresetOptions(Preset preset)
+{
+    ReuseOptions options;
+    switch (preset)
+    {
+    case Preset::Low:
+        options.maxTemporalM = 20;
+        options.temporalMClampFactor = 10;
+        options.checkerboardTemporal = true;
+        options.spatialNeighborCount = 2;
+        options.spatialRadius = 16.f;
+        options.halfResSpatial = true;
+        break;
+    case Preset::Medium:
+        break;
+    case Preset::High:
+        options.spatialNeighborCount = 8;
+        break;
+    default:
+        FALCOR_THROW("Preset '{}' has no reuse parameters.", enumToString(preset));
+    }
+    return options;
 }
 
 RestirInitTemporal::RestirInitTemporal(ref<Device> pDevice, const Properties& props)
     : RenderPass(pDevice)
 {
     mpSampleGenerator = SampleGenerator::create(mpDevice, SAMPLE_GENERATOR_UNIFORM);
+
+    // Apply the preset first so that individual parameters override it.
+    if (props.has(kPreset)) setPreset(props.get<Preset>(kPreset));
+
+    ReuseOptions options = mReuseOptions;
+    for (const auto& [key, value] : props)
+    {
+        if (key == kUsePowerLightSelection) mUsePowerLightSelection = value;
+        else if (key == kEmissiveSampler) mEmissiveSampler = value;
+        else if (key == kPreset) continue;
+        else if (key == kMaxTemporalM) options.maxTemporalM = value;
+        else if (key == kTemporalMClampFactor) options.temporalMClampFactor = value;
+        else if (key == kCheckerboardTemporal) options.checkerboardTemporal = value;
+        else if (key == kSpatialNeighborCount) options.spatialNeighborCount = value;
+        else if (key == kSpatialRadius) options.spatialRadius = value;
+        else if (key == kHalfResSpatial) options.halfResSpatial = value;
+        else logWarning("Unknown property '{}' in RestirInitTemporal properties.", key);
+    }
+    if (options != mReuseOptions) setReuseOptions(options);
 }
 
 Properties RestirInitTemporal::getProperties() const
 {
-    return {};
+    Properties props;
+    props[kUsePowerLightSelection] = mUsePowerLightSelection;
+    props[kEmissiveSampler] = mEmissiveSampler;
+    props[kPreset] = mPreset;
+    props[kMaxTemporalM] = mReuseOptions.maxTemporalM;
+    props[kTemporalMClampFactor] = mReuseOptions.temporalMClampFactor;
+    props[kCheckerboardTemporal] = mReuseOptions.checkerboardTemporal;
+    props[kSpatialNeighborCount] = mReuseOptions.spatialNeighborCount;
+    props[kSpatialRadius] = mReuseOptions.spatialRadius;
+    props[kHalfResSpatial] = mReuseOptions.halfResSpatial;
+    return props;
+}
+
+void RestirInitTemporal::setPreset(Preset preset)
+{
+    mPreset = preset;
+    if (preset != Preset::Custom) mReuseOptions = getPresetOptions(preset);
+}
+
+void RestirInitTemporal::setReuseOptions(const ReuseOptions& options)
+{
+    mReuseOptions = options;
+    mReuseOptions.maxTemporalM = std::clamp(mReuseOptions.maxTemporalM, 1u, kMaxPackedReservoirM);
+    mReuseOptions.temporalMClampFactor = std::max(mReuseOptions.temporalMClampFactor, 1u);
+    mReuseOptions.spatialNeighborCount = std::min(mReuseOptions.spatialNeighborCount, kMaxSpatialNeighborCount);
+    mReuseOptions.spatialRadius = std::max(mReuseOptions.spatialRadius, 1.f);
+
+    mPreset = Preset::Custom;
+    for (Preset preset : {Preset::Low, Preset::Medium, Preset::High})
+    {
+        if (mReuseOptions == getPresetOptions(preset)) mPreset = preset;
+    }
 }
 
 RenderPassReflection RestirInitTemporal::reflect(const CompileData& compileData)
@@ -170,6 +292,8 @@ void RestirInitTemporal::execute(RenderContext* pRenderContext, const RenderData
         mpScene->getLightCollection(pRenderContext);
     }
 
+    updateLightSelection(pRenderContext);
+
     mTracerInit.pProgram->addDefines(getValidResourceDefines(kInputChannels, renderData));
     //mTracerTemporal.pProgram->addDefines(getValidResourceDefines(kInputChannels, renderData));
     mTracerSpatial.pProgram->addDefines(getValidResourceDefines(kInputChannels, renderData));
@@ -211,6 +335,34 @@ void RestirInitTemporal::renderUI(Gui::Widgets& widget)
     widget.checkbox("Temporal Reuse", mTemporalReuse);
     widget.checkbox("Spatial Reuse", mSpatialReuse);
 
+    widget.checkbox("Power light selection", mUsePowerLightSelection);
+    widget.tooltip("Select analytic light candidates proportional to their power instead of uniformly.");
+    widget.dropdown("Emissive sampler", mEmissiveSampler);
+    widget.tooltip("Selects which light sampler to use for emissive triangle candidates. Null disables emissive candidates.");
+
+    if (auto group = widget.group("Reuse parameters", true))
+    {
+        Preset preset = mPreset;
+        if (group.dropdown("Preset", preset)) setPreset(preset);
+        group.tooltip("Quality versus cost preset. Low runs temporal and spatial reuse on half of the pixels with 2 neighbors, "
+                      "Medium uses 5 and High 8 neighbors on all pixels.");
+
+        ReuseOptions options = mReuseOptions;
+        bool changed = false;
+        changed |= group.var("Max temporal M", options.maxTemporalM, 1u, kMaxPackedReservoirM);
+        group.tooltip("Maximum history length M of the previous GI reservoir.");
+        changed |= group.var("Temporal M clamp factor", options.temporalMClampFactor, 1u, 100u);
+        group.tooltip("Maximum history length M of the previous DI reservoir relative to the current M.");
+        changed |= group.checkbox("Checkerboard temporal", options.checkerboardTemporal);
+        group.tooltip("Run temporal reuse on an alternating checkerboard of half of the pixels. The other pixels carry their history forward without resampling.");
+        changed |= group.var("Spatial neighbors", options.spatialNeighborCount, 0u, kMaxSpatialNeighborCount);
+        changed |= group.var("Spatial radius", options.spatialRadius, 1.f, 100.f);
+        group.tooltip("Radius in pixels of the spatial reuse neighborhood.");
+        changed |= group.checkbox("Half-res spatial", options.halfResSpatial);
+        group.tooltip("Run spatial reuse on alternating columns of half of the pixels.");
+        if (changed) setReuseOptions(options);
+    }
+
     if(widget.button("Clear Buffers"))
     {
         if (!mClearBuffers)
@@ -225,6 +377,8 @@ void RestirInitTemporal::setScene(RenderContext* pRenderContext, const ref<Scene
 {
     mpScene = pScene;
     mInitLights = true;
+    mpAnalyticSampler = mpScene ? std::make_unique<AnalyticPowerSampler>(mpDevice) : nullptr;
+    mpEmissiveSampler = nullptr;
     prepareInitSamplesAndTemporalProgram();
     prepareSpatialResamplingAndFinalizeProgram();
     prepareCopyTemporalProgram();
@@ -342,10 +496,13 @@ void RestirInitTemporal::prepareCopyTemporalProgram()
 void RestirInitTemporal::executeInitSamplesAndTemporalProgram(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerInit.pVars->getRootVar();
-    var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gInitialSamples"] = mInitLights;
-    var["CB"]["gEnableTemporal"] = mTemporalReuse;
-    var["CB"]["gClearBuffers"] = mClearBuffers;
+    var[mTracerInit.cb.frameCount] = mFrameCount;
+    var[mTracerInit.cb.initialSamples] = mInitLights;
+    var[mTracerInit.cb.enableTemporal] = mTemporalReuse;
+    var[mTracerInit.cb.clearBuffers] = mClearBuffers;
+    var[mTracerInit.cb.maxTemporalM] = mReuseOptions.maxTemporalM;
+    var[mTracerInit.cb.temporalMClampFactor] = mReuseOptions.temporalMClampFactor;
+    var[mTracerInit.cb.checkerboardTemporal] = mReuseOptions.checkerboardTemporal;
 
     bindChannels(kInputChannels, var, renderData);
 
@@ -355,6 +512,8 @@ void RestirInitTemporal::executeInitSamplesAndTemporalProgram(RenderContext* pRe
     var["gSpatialReservoir_DI"] = mpSpatialReservoir_DI;
     var["gSpatialReservoir_GI"] = mpSpatialReservoir_GI;
 
+    bindLightSelection(var["gLightSelection"]);
+
     uint2 targetDim = renderData.getDefaultTextureDims();
     mpScene->raytrace(pRenderContext, mTracerInit.pProgram.get(), mTracerInit.pVars, uint3(targetDim, 1));
     mInitLights = false;
@@ -363,13 +522,16 @@ void RestirInitTemporal::executeInitSamplesAndTemporalProgram(RenderContext* pRe
 void RestirInitTemporal::executeSpatialResamplingAndFinalizeProgram(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerSpatial.pVars->getRootVar();
-    var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gEnableSpatial"] = mSpatialReuse;
+    var[mTracerSpatial.cb.frameCount] = mFrameCount;
+    var[mTracerSpatial.cb.enableSpatial] = mSpatialReuse;
 
-    var["CB"]["gDirectLight"] = mDirectLight;
-    var["CB"]["gIndirectLight"] = mIndirectLight;
+    var[mTracerSpatial.cb.directLight] = mDirectLight;
+    var[mTracerSpatial.cb.indirectLight] = mIndirectLight;
 
-    var["CB"]["gClearBuffers"] = mClearBuffers;
+    var[mTracerSpatial.cb.clearBuffers] = mClearBuffers;
+    var[mTracerSpatial.cb.spatialNeighborCount] = mReuseOptions.spatialNeighborCount;
+    var[mTracerSpatial.cb.spatialRadius] = mReuseOptions.spatialRadius;
+    var[mTracerSpatial.cb.halfResSpatial] = mReuseOptions.halfResSpatial;
 
     bindChannels(kInputChannels, var, renderData);
     bindChannels(kOutputChannels, var, renderData);
@@ -380,6 +542,8 @@ void RestirInitTemporal::executeSpatialResamplingAndFinalizeProgram(RenderContex
     var["gSpatialReservoir_DI"] = mpSpatialReservoir_DI;
     var["gSpatialReservoir_GI"] = mpSpatialReservoir_GI;
 
+    bindLightSelection(var["gLightSelection"]);
+
     uint2 targetDim = renderData.getDefaultTextureDims();
     mpScene->raytrace(pRenderContext, mTracerSpatial.pProgram.get(), mTracerSpatial.pVars, uint3(targetDim, 1));
 }
@@ -387,7 +551,7 @@ void RestirInitTemporal::executeSpatialResamplingAndFinalizeProgram(RenderContex
 void RestirInitTemporal::executeCopyTemporalProgram(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerFinalize.pVars->getRootVar();
-    var["CB"]["gClearBuffers"] = mClearBuffers;
+    var[mTracerFinalize.cb.clearBuffers] = mClearBuffers;
     mClearBuffers = false;
 
     var["gTemporalReservoir_DI"] = mpTemporalReservoirOld_DI;
@@ -403,7 +567,7 @@ void RestirInitTemporal::executeCopyTemporalProgram(RenderContext* pRenderContex
 void RestirInitTemporal::executeInitSamples(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerInit.pVars->getRootVar();
-    var["CB"]["gFrameCount"] = mFrameCount;
+    var[mTracerInit.cb.frameCount] = mFrameCount;
 
     bindChannels(kInputChannels, var, renderData);
 
@@ -452,9 +616,9 @@ void RestirInitTemporal::prepareInitSamplesProgram()
 void RestirInitTemporal::executeTemporal(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerTemporal.pVars->getRootVar();
-    var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gInitialSamples"] = mInitLights;
-    var["CB"]["gEnableTemporal"] = mTemporalReuse;
+    var[mTracerTemporal.cb.frameCount] = mFrameCount;
+    var[mTracerTemporal.cb.initialSamples] = mInitLights;
+    var[mTracerTemporal.cb.enableTemporal] = mTemporalReuse;
 
     bindChannels(kInputChannels, var, renderData);
 
@@ -502,8 +666,8 @@ void RestirInitTemporal::prepareTemporalProgram()
 void RestirInitTemporal::executeSpatial(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerSpatial.pVars->getRootVar();
-    var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gEnableSpatial"] = mSpatialReuse;
+    var[mTracerSpatial.cb.frameCount] = mFrameCount;
+    var[mTracerSpatial.cb.enableSpatial] = mSpatialReuse;
 
     bindChannels(kInputChannels, var, renderData);
 
@@ -547,11 +711,11 @@ void RestirInitTemporal::prepareSpatialProgram()
 void RestirInitTemporal::executeFinalize(RenderContext* pRenderContext, const RenderData& renderData)
 {
     ShaderVar var = mTracerFinalize.pVars->getRootVar();
-    var["CB"]["gFrameCount"] = mFrameCount;
-    var["CB"]["gDirectLight"] = mDirectLight;
-    var["CB"]["gIndirectLight"] = mIndirectLight;
+    var[mTracerFinalize.cb.frameCount] = mFrameCount;
+    var[mTracerFinalize.cb.directLight] = mDirectLight;
+    var[mTracerFinalize.cb.indirectLight] = mIndirectLight;
 
-    var["CB"]["gClearBuffers"] = mClearBuffers;
+    var[mTracerFinalize.cb.clearBuffers] = mClearBuffers;
     mClearBuffers = false;
 
     bindChannels(kInputChannels, var, renderData);
@@ -751,3 +915,83 @@ void RestirInitTemporal::prepareVars()
         mpSampleGenerator->bindShaderData(var);
     }
 }
+
+void RestirInitTemporal::updateLightSelection(RenderContext* pRenderContext)
+{
+    FALCOR_ASSERT(mpAnalyticSampler);
+    mpAnalyticSampler->update(mpScene);
+
+    // Create or destroy the emissive sampler.
+    const bool useEmissive = mEmissiveSampler != EmissiveLightSamplerType::Null && mpScene->useEmissiveLights();
+    if (!useEmissive)
+    {
+        mpEmissiveSampler = nullptr;
+    }
+    else if (!mpEmissiveSampler || mpEmissiveSampler->getType() != mEmissiveSampler)
+    {
+        switch (mEmissiveSampler)
+        {
+        case EmissiveLightSamplerType::Uniform:
+            mpEmissiveSampler = std::make_unique<EmissiveUniformSampler>(pRenderContext, mpScene);
+            break;
+        case EmissiveLightSamplerType::LightBVH:
+            mpEmissiveSampler = std::make_unique<LightBVHSampler>(pRenderContext, mpScene);
+            break;
+        case EmissiveLightSamplerType::Power:
+            mpEmissiveSampler = std::make_unique<EmissivePowerSampler>(pRenderContext, mpScene);
+            break;
+        default:
+            FALCOR_THROW("Unknown emissive light sampler type");
+        }
+        mEmissivePower = -1.0;
+    }
+
+    mAnalyticSelectionProb = 1.f;
+    if (mpEmissiveSampler)
+    {
+        mpEmissiveSampler->update(pRenderContext);
+
+        if (mEmissivePower < 0.0 || is_set(mpScene->getUpdates(), Scene::UpdateFlags::LightCollectionChanged))
+        {
+            mEmissivePower = 0.0;
+            for (const auto& tri : mpScene->getLightCollection(pRenderContext)->getMeshLightTriangles(pRenderContext))
+                mEmissivePower += tri.flux;
+        }
+
+        // Split the candidates between analytic and emissive lights proportional to their power.
+        // The uniform fraction keeps both light types selectable, as for the analytic lights themselves.
+        const double analyticPower = mpAnalyticSampler->getTotalPower();
+        if (mpAnalyticSampler->getLightCount() == 0)
+        {
+            mAnalyticSelectionProb = 0.f;
+        }
+        else if (analyticPower + mEmissivePower > 0.0)
+        {
+            const float uniformFraction = mpAnalyticSampler->getUniformFraction();
+            const float powerProb = (float)(analyticPower / (analyticPower + mEmissivePower));
+            mAnalyticSelectionProb = (1.f - uniformFraction) * powerProb + uniformFraction * 0.5f;
+        }
+        else
+        {
+            mAnalyticSelectionProb = 0.5f;
+        }
+    }
+
+    DefineList defines;
+    defines.add("USE_POWER_LIGHT_SELECTION", mUsePowerLightSelection && mpAnalyticSampler->getLightCount() > 0 ? "1" : "0");
+    defines.add("USE_EMISSIVE_LIGHTS", mpEmissiveSampler ? "1" : "0");
+    if (mpEmissiveSampler) defines.add(mpEmissiveSampler->getDefines());
+    else defines.add("_EMISSIVE_LIGHT_SAMPLER_TYPE", std::to_string((uint32_t)EmissiveLightSamplerType::Null));
+
+    for (PassTrace* trace : {&mTracerInit, &mTracerSpatial, &mTracerFinalize})
+    {
+        if (trace->pProgram) trace->pProgram->addDefines(defines);
+    }
+}
+
+void RestirInitTemporal::bindLightSelection(const ShaderVar& var) const
+{
+    if (mUsePowerLightSelection) mpAnalyticSampler->bindShaderData(var["analytic"]);
+    if (mpEmissiveSampler) mpEmissiveSampler->bindShaderData(var["emissive"]);
+    var["analyticProb"] = mAnalyticSelectionProb;
+}
@@ -28,6 +28,9 @@
 #pragma once
 #include "Falcor.h"
 #include "RenderGraph/RenderPass.h"
+#include "Rendering/Lights/AnalyticPowerSampler.h"
+#include "Rendering/Lights/EmissiveLightSampler.h"
+#include <memory>
 
 using namespace Falcor;
 
@@ -36,6 +39,61 @@ class RestirInitTemporal : public RenderPass
 public:
     FALCOR_PLUGIN_CLASS(RestirInitTemporal, "RestirInitTemporal", "Insert pass description here.");
 
+    /** Quality versus cost presets for the reservoir reuse parameters.
+        The cost of each pass is given per pixel in target function evaluations (DI: BSDF times light
+        radiance, GI: BSDF times sample radiance), which dominate the resampling passes. Candidate
+        generation and final shading do not depend on the preset.
+        - Low: temporal reuse on half of the pixels (DI 1.5, GI 1), spatial reuse on half of the pixels
+          with 2 neighbors (DI 2, GI 1.5). About a third of the Medium resampling cost.
+        - Medium: temporal reuse (DI 3, GI 2), spatial reuse with 5 neighbors (DI 7, GI 6).
+        - High: temporal reuse (DI 3, GI 2), spatial reuse with 8 neighbors (DI 10, GI 9). About 4/3 of the Medium resampling cost.
+        - Custom: set when any of the parameters are changed individually.
+    */
+    enum class Preset : uint32_t
+    {
+        Custom,
+        Low,
+        Medium,
+        High,
+    };
+
+    FALCOR_ENUM_INFO(
+        Preset,
+        {
+            {Preset::Custom, "Custom"},
+            {Preset::Low, "Low"},
+            {Preset::Medium, "Medium"},
+            {Preset::High, "High"},
+        }
+    );
+
+    /** Reservoir reuse parameters.
+    */
+    struct ReuseOptions
+    {
+        uint32_t maxTemporalM = 30;         ///< Maximum history length M of the previous GI reservoir.
+        uint32_t temporalMClampFactor = 20; ///< Maximum history length M of the previous DI reservoir relative to the current M.
+        bool checkerboardTemporal = false;  ///< Run temporal reuse on an alternating checkerboard of half of the pixels.
+        uint32_t spatialNeighborCount = 5;  ///< Number of neighbors for spatial reuse.
+        float spatialRadius = 30.f;         ///< Radius in pixels of the spatial reuse neighborhood.
+        bool halfResSpatial = false;        ///< Run spatial reuse on alternating columns of half of the pixels.
+
+        bool operator==(const ReuseOptions& other) const
+        {
+            return maxTemporalM == other.maxTemporalM && temporalMClampFactor == other.temporalMClampFactor &&
+                   checkerboardTemporal == other.checkerboardTemporal && spatialNeighborCount == other.spatialNeighborCount &&
+                   spatialRadius == other.spatialRadius && halfResSpatial == other.halfResSpatial;
+        }
+        bool operator!=(const ReuseOptions& other) const { return !(*this == other); }
+    };
+
+    /** Get the reuse parameters of a preset.
+        \param[in] preset Preset, must not be Custom.
+        \return Reuse parameters.
+    */
+    static ReuseOptions getPresetOptions(Preset preset);
+
+
     static ref<RestirInitTemporal> create(ref<Device> pDevice, const Properties& props)
     {
         return make_ref<RestirInitTemporal>(pDevice, props);
@@ -52,12 +110,43 @@ public:
     virtual bool onMouseEvent(const MouseEvent& mouseEvent) override { return false; }
     virtual bool onKeyEvent(const KeyboardEvent& keyEvent) override { return false; }
 
+    static void registerBindings(pybind11::module& m);
+
+    /** Apply a quality versus cost preset. Applying Custom keeps the current parameters.
+    */
+    void setPreset(Preset preset);
+    Preset getPreset() const { return mPreset; }
+
+    /** Set the reuse parameters. The preset is set to the matching preset or Custom.
+    */
+    void setReuseOptions(const ReuseOptions& options);
+    const ReuseOptions& getReuseOptions() const { return mReuseOptions; }
+
 private:
+    /// Cached handles to the constant buffer variables. These are resolved on first use for each program.
+    struct ConstantBufferVars
+    {
+        ShaderVarHandle frameCount{"CB.gFrameCount"};
+        ShaderVarHandle initialSamples{"CB.gInitialSamples"};
+        ShaderVarHandle enableTemporal{"CB.gEnableTemporal"};
+        ShaderVarHandle enableSpatial{"CB.gEnableSpatial"};
+        ShaderVarHandle directLight{"CB.gDirectLight"};
+        ShaderVarHandle indirectLight{"CB.gIndirectLight"};
+        ShaderVarHandle clearBuffers{"CB.gClearBuffers"};
+        ShaderVarHandle maxTemporalM{"CB.gMaxTemporalM"};
+        ShaderVarHandle temporalMClampFactor{"CB.gTemporalMClampFactor"};
+        ShaderVarHandle checkerboardTemporal{"CB.gCheckerboardTemporal"};
+        ShaderVarHandle spatialNeighborCount{"CB.gSpatialNeighborCount"};
+        ShaderVarHandle spatialRadius{"CB.gSpatialRadius"};
+        ShaderVarHandle halfResSpatial{"CB.gHalfResSpatial"};
+    };
+
     struct PassTrace
     {
         ref<Program> pProgram;
         ref<RtBindingTable> pBindingTable;
         ref<RtProgramVars> pVars;
+        ConstantBufferVars cb;
     };
 
     /* >> ReSTIR 3 >>*/
@@ -84,6 +173,8 @@ private:
 
     void allocateReservoir(uint bufferX, uint bufferY);
     void prepareVars();
+    void updateLightSelection(RenderContext* pRenderContext);
+    void bindLightSelection(const ShaderVar& var) const;
 
     bool mClearBuffers = false;
 
@@ -94,9 +185,20 @@ private:
     bool mIndirectLight = true;
     uint mFrameCount = 0;
 
+    Preset mPreset = Preset::Medium;
+    ReuseOptions mReuseOptions = getPresetOptions(Preset::Medium);
+
     ref<Scene> mpScene;
     ref<SampleGenerator> mpSampleGenerator;
 
+    // Light selection for the initial candidates.
+    bool mUsePowerLightSelection = true;                                        ///< Select analytic lights proportional to their power instead of uniformly.
+    EmissiveLightSamplerType mEmissiveSampler = EmissiveLightSamplerType::Null; ///< Sampler for emissive triangle candidates. Null disables emissive candidates.
+    std::unique_ptr<AnalyticPowerSampler> mpAnalyticSampler;
+    std::unique_ptr<EmissiveLightSampler> mpEmissiveSampler;
+    double mEmissivePower = -1.0;                                               ///< Total flux of the emissive triangles. Negative if not yet computed.
+    float mAnalyticSelectionProb = 1.f;                                         ///< Probability of picking an analytic light rather than an emissive triangle.
+
     ref<Texture> mpDirectLightRadiance;
 
     // >> Direct Illumination >> //
@@ -131,3 +233,5 @@ private:
 
     /* << ReSTIR 3 <<*/
 };
+
+FALCOR_ENUM_REGISTER(RestirInitTemporal::Preset);
@@ -188,6 +188,32 @@ CPU_TEST(AssetResolver)
         EXPECT_EQ(resolver.resolvePath("asset1"), kTestRoot / "media3/asset1");
     }
 
+    // Test resolve callback.
+    {
+        AssetResolver resolver;
+        std::vector<std::filesystem::path> recorded;
+        resolver.setResolveCallback([&](const std::filesystem::path& path) { recorded.push_back(path); });
+
+        resolver.addSearchPath(kTestRoot / "media1");
+        resolver.addSearchPath(kTestRoot / "media4");
+        resolver.resolvePath("asset1");
+        resolver.resolvePath("asset4");
+        // Copies of the resolver keep the callback.
+        AssetResolver copy = resolver;
+        copy.resolvePathPattern("textures", R"(mip[0-1]\.png)");
+
+        ASSERT_EQ(recorded.size(), 3);
+        EXPECT_EQ(recorded[0], kTestRoot / "media1/asset1");
+        std::sort(recorded.begin() + 1, recorded.end());
+        EXPECT_EQ(recorded[1], kTestRoot / "media4/textures/mip0.png");
+        EXPECT_EQ(recorded[2], kTestRoot / "media4/textures/mip1.png");
+
+        recorded.clear();
+        resolver.setResolveCallback({});
+        resolver.resolvePath("asset1");
+        EXPECT(recorded.empty());
+    }
+
     removeTestFiles(ctx);
 }
 
@@ -0,0 +1,78 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/Profiler.h"
+
+namespace Falcor
+{
+/** Test that unchanged uniforms and resource bindings are not written to the shader object again.
+ */
+GPU_TEST(ParamBlockDirtyTracking)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    Profiler* pProfiler = pDevice->getProfiler();
+
+    ctx.createProgram("Tests/Core/ParamBlockCB.cs.slang", "main");
+    ctx.allocateStructuredBuffer("result", 1);
+
+    auto pBlockReflection = ctx.getProgram()->getReflector()->getParameterBlock("gParamBlock");
+    auto pParamBlock = ParameterBlock::create(pDevice, pBlockReflection);
+    ctx["gParamBlock"] = pParamBlock;
+    ref<Buffer> pResult = ctx.vars().getRootVar()["result"].getBuffer();
+
+    // Reset the counters.
+    pProfiler->endFrame(ctx.getRenderContext());
+
+    auto var = pParamBlock->getRootVar();
+    var["a"] = 1.5f;
+    var["a"] = 1.5f; // Unchanged, skipped.
+    ctx["result"] = pResult; // Unchanged, skipped.
+    ctx["gParamBlock"] = pParamBlock; // Unchanged, skipped.
+
+    pProfiler->endFrame(ctx.getRenderContext());
+    const auto& counters = pProfiler->getFrameCounters();
+    EXPECT_EQ(counters.uniformWritesSkipped, 1u);
+    EXPECT_EQ(counters.descriptorWrites, 0u);
+    EXPECT_EQ(counters.descriptorWritesSkipped, 2u);
+
+    // The skipped writes must not affect the results.
+    ctx.runProgram(1, 1, 1);
+    std::vector<float> result = ctx.readBuffer<float>("result");
+    EXPECT_EQ(result[0], 1.5f);
+
+    // Changing the value must upload the uniform data again.
+    pProfiler->endFrame(ctx.getRenderContext());
+    var["a"] = 2.5f;
+    ctx.runProgram(1, 1, 1);
+    pProfiler->endFrame(ctx.getRenderContext());
+    EXPECT_GT(pProfiler->getFrameCounters().uniformBytesUploaded, 0u);
+
+    result = ctx.readBuffer<float>("result");
+    EXPECT_EQ(result[0], 2.5f);
+}
+} // namespace Falcor
@@ -0,0 +1,85 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+
+namespace Falcor
+{
+CPU_TEST(ShaderVarHandle_Path)
+{
+    EXPECT_EQ(ShaderVarHandle("CB.inner.c").getPath(), "CB.inner.c");
+    EXPECT_THROW(ShaderVarHandle(""));
+    EXPECT_THROW(ShaderVarHandle("CB..a"));
+    EXPECT(!ShaderVarHandle().find(ShaderVar()).isValid());
+}
+
+GPU_TEST(ShaderVarHandle)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    ctx.createProgram("Tests/Core/ShaderVarHandleTests.cs.slang", "main");
+    ctx.allocateStructuredBuffer("result", 7);
+
+    auto pBlockReflection = ctx.getProgram()->getReflector()->getParameterBlock("gParamBlock");
+    auto pParamBlock = ParameterBlock::create(pDevice, pBlockReflection);
+    ctx["gParamBlock"] = pParamBlock;
+
+    ShaderVarHandle a("CB.a");
+    ShaderVarHandle b("CB.b");
+    ShaderVarHandle c("CB.inner.c");
+    ShaderVarHandle d("gParamBlock.d");
+    ShaderVarHandle innerC("gParamBlock.inner.c");
+    ShaderVarHandle missing("CB.missing");
+
+    ShaderVar var = ctx.vars().getRootVar();
+
+    // The handles must resolve to the same variables as lookups by name.
+    EXPECT(var[a].getType() == var["CB"]["a"].getType());
+    EXPECT_EQ(var[c].getByteOffset(), var["CB"]["inner"]["c"].getByteOffset());
+    EXPECT_EQ(var[innerC].getByteOffset(), var["gParamBlock"]["inner"]["c"].getByteOffset());
+    EXPECT(!missing.find(var).isValid());
+    EXPECT_THROW(var[missing]);
+
+    // Once resolved, using the handles must not look up any names.
+    ShaderVar::resetStringLookupCount();
+    var[a] = 7u;
+    var[b] = 1.5f;
+    var[c] = float3(2.f, 3.f, 4.f);
+    var[d] = 5.f;
+    var[innerC] = float3(0.f, 6.f, 0.f);
+    EXPECT_EQ(ShaderVar::getStringLookupCount(), uint64_t(0));
+
+    ctx.runProgram(1, 1, 1);
+
+    std::vector<float> result = ctx.readBuffer<float>("result");
+    const float expected[] = {7.f, 1.5f, 2.f, 3.f, 4.f, 5.f, 6.f};
+    for (size_t i = 0; i < std::size(expected); ++i)
+    {
+        EXPECT_EQ(result[i], expected[i]) << "i = " << i;
+    }
+}
+} // namespace Falcor
@@ -92,4 +92,17 @@ CPU_TEST(GetEnvironmentVariable)
     EXPECT_NE(getEnvironmentVariable("PATH"), std::optional<std::string>{});
 #endif
 }
+
+CPU_TEST(ReadFileFromZip)
+{
+    // The Sibenik scene ships both the archive and its extracted copyright notice.
+    const std::filesystem::path archivePath = getProjectDirectory() / "scenes/Sibenik/sibenik.zip";
+    const std::filesystem::path extractedPath = getProjectDirectory() / "scenes/Sibenik/copyright.txt";
+    if (!std::filesystem::exists(archivePath) || !std::filesystem::exists(extractedPath))
+        ctx.skip("Sibenik scene not found");
+
+    EXPECT_EQ(readFileFromZip(archivePath, "copyright.txt"), readFile(extractedPath));
+    EXPECT_THROW(readFileFromZip(archivePath, "missing.txt"));
+    EXPECT_THROW(readFileFromZip(extractedPath, "copyright.txt"));
+}
 } // namespace Falcor
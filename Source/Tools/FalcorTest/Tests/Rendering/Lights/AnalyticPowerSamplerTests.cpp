@@ -0,0 +1,173 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Lights/AnalyticPowerSampler.h"
+#include "Scene/Lights/Light.h"
+#include "Utils/Color/ColorHelpers.slang"
+
+#include <hypothesis/hypothesis.h>
+
+#include <cmath>
+#include <iostream>
+#include <limits>
+
+namespace Falcor
+{
+namespace
+{
+const std::vector<float> kPowers = {100.f, 0.f, 1.f, 25.f, 0.5f, 0.f, 1000.f, 3.f};
+
+bool testSelectionHistogram(const AnalyticPowerSampler& sampler, std::mt19937& rng)
+{
+    const uint32_t N = sampler.getLightCount();
+    const uint32_t samplesPerLight = 10000;
+    std::uniform_real_distribution<float> uniform;
+
+    std::vector<double> obsFrequencies(N, 0.0);
+    for (uint32_t i = 0; i < N * samplesPerLight; ++i)
+    {
+        uint32_t lightIndex = sampler.getTable()->sample(float2(uniform(rng), uniform(rng)));
+        if (lightIndex >= N)
+            return false;
+        obsFrequencies[lightIndex] += 1.0;
+    }
+
+    std::vector<double> expFrequencies(N);
+    for (uint32_t i = 0; i < N; ++i)
+        expFrequencies[i] = sampler.getSelectionPdf(i) * N * samplesPerLight;
+
+    const auto& [success, report] =
+        hypothesis::chi2_test(N, obsFrequencies.data(), expFrequencies.data(), N * samplesPerLight, 5, 0.01);
+    if (!success)
+        std::cout << report << std::endl;
+    return success;
+}
+} // namespace
+
+CPU_TEST(AnalyticPowerSamplerWeights)
+{
+    for (float uniformFraction : {0.f, 0.1f, 0.5f, 1.f})
+    {
+        auto weights = AnalyticPowerSampler::computeSelectionWeights(kPowers, uniformFraction);
+        ASSERT_EQ(weights.size(), kPowers.size());
+
+        double totalPower = 0.0;
+        for (float power : kPowers)
+            totalPower += power;
+
+        double weightSum = 0.0;
+        for (size_t i = 0; i < weights.size(); ++i)
+        {
+            const double expected = (1.0 - uniformFraction) * kPowers[i] / totalPower + uniformFraction / kPowers.size();
+            EXPECT_LE(std::abs(weights[i] - expected), 1e-6);
+            EXPECT_GE(weights[i], uniformFraction / kPowers.size() * (1.f - 1e-6f));
+            weightSum += weights[i];
+        }
+        EXPECT_LE(std::abs(weightSum - 1.0), 1e-6);
+    }
+
+    // Without any power the selection falls back to uniform.
+    auto weights = AnalyticPowerSampler::computeSelectionWeights({0.f, 0.f, 0.f, 0.f}, 0.1f);
+    for (float weight : weights)
+        EXPECT_EQ(weight, 0.25f);
+
+    EXPECT(AnalyticPowerSampler::computeSelectionWeights({}, 0.1f).empty());
+}
+
+CPU_TEST(AnalyticPowerSamplerPdf)
+{
+    std::mt19937 rng;
+
+    AnalyticPowerSampler sampler(nullptr);
+    EXPECT_EQ(sampler.getLightCount(), 0u);
+    EXPECT_EQ(sampler.getSelectionPdf(0), 0.f);
+
+    sampler.setLightPowers(kPowers);
+    ASSERT_EQ(sampler.getLightCount(), kPowers.size());
+
+    // The pdfs must match the selection weights and the frequencies the table produces.
+    auto weights = AnalyticPowerSampler::computeSelectionWeights(kPowers, sampler.getUniformFraction());
+    for (uint32_t i = 0; i < sampler.getLightCount(); ++i)
+    {
+        EXPECT_LE(std::abs(sampler.getSelectionPdf(i) - weights[i]), 1e-6f);
+        EXPECT_GT(sampler.getSelectionPdf(i), 0.f);
+    }
+    EXPECT_EQ(sampler.getSelectionPdf(sampler.getLightCount()), 0.f);
+    EXPECT(testSelectionHistogram(sampler, rng));
+
+    // The RIS estimate of the total contribution using the selection pdf is unbiased.
+    {
+        std::uniform_real_distribution<float> uniform;
+        const uint32_t sampleCount = 1000000;
+        double estimate = 0.0;
+        for (uint32_t i = 0; i < sampleCount; ++i)
+        {
+            uint32_t lightIndex = sampler.getTable()->sample(float2(uniform(rng), uniform(rng)));
+            estimate += kPowers[lightIndex] / sampler.getSelectionPdf(lightIndex);
+        }
+        estimate /= sampleCount;
+        EXPECT_LE(std::abs(estimate - sampler.getTotalPower()) / sampler.getTotalPower(), 0.01);
+    }
+
+    // Changing the powers keeps the table consistent.
+    auto powers = kPowers;
+    powers[1] = 500.f;
+    powers[6] = 0.f;
+    sampler.setLightPowers(powers);
+    weights = AnalyticPowerSampler::computeSelectionWeights(powers, sampler.getUniformFraction());
+    for (uint32_t i = 0; i < sampler.getLightCount(); ++i)
+        EXPECT_LE(std::abs(sampler.getSelectionPdf(i) - weights[i]), 1e-6f);
+    EXPECT(testSelectionHistogram(sampler, rng));
+
+    // Without a uniform fraction, lights without power are never selected.
+    sampler.setUniformFraction(0.f);
+    EXPECT_EQ(sampler.getSelectionPdf(6), 0.f);
+    EXPECT(testSelectionHistogram(sampler, rng));
+
+    // Invalid powers are treated as zero.
+    sampler.setLightPowers({1.f, -1.f, std::numeric_limits<float>::infinity()});
+    EXPECT_EQ(sampler.getLightPowers()[1], 0.f);
+    EXPECT_EQ(sampler.getLightPowers()[2], 0.f);
+    EXPECT_EQ(sampler.getSelectionPdf(0), 1.f);
+
+    EXPECT_THROW(sampler.setUniformFraction(2.f));
+}
+
+CPU_TEST(AnalyticPowerSamplerEstimatePower)
+{
+    ref<PointLight> pPointLight = PointLight::create();
+    pPointLight->setIntensity(float3(2.f));
+    EXPECT_EQ(AnalyticPowerSampler::estimatePower(*pPointLight, 10.f), pPointLight->getPower());
+
+    // Lights at infinity are weighted by the irradiance onto the scene.
+    ref<DirectionalLight> pDirectionalLight = DirectionalLight::create();
+    pDirectionalLight->setIntensity(float3(2.f));
+    const float expected = luminance(float3(2.f)) * (float)M_PI * 100.f;
+    EXPECT_LE(std::abs(AnalyticPowerSampler::estimatePower(*pDirectionalLight, 10.f) - expected), 1e-3f * expected);
+}
+} // namespace Falcor
@@ -0,0 +1,146 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Rendering/Utils/PackedReservoirs.slang"
+
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+float3 randomDirection(std::mt19937& rng)
+{
+    std::uniform_real_distribution<float> u(-1.f, 1.f);
+    float3 d;
+    do
+    {
+        d = float3(u(rng), u(rng), u(rng));
+    } while (dot(d, d) > 1.f || dot(d, d) < 1e-6f);
+    return normalize(d);
+}
+
+float relativeError(float value, float reference)
+{
+    return std::abs(value - reference) / std::max(std::abs(reference), 1e-6f);
+}
+} // namespace
+
+CPU_TEST(PackedDIReservoir)
+{
+    static_assert(sizeof(PackedDIReservoir) == 12);
+
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> u;
+
+    for (int lightIndex : {-1, 0, 1, 12345, 0x7fffffff})
+    {
+        for (uint32_t M : {0u, 1u, 30u, 65535u})
+        {
+            const float W = std::pow(2.f, u(rng) * 30.f - 15.f);
+            const float2 lightUV = float2(u(rng), u(rng));
+            PackedDIReservoir packed = PackedDIReservoir::pack(lightIndex, lightUV, W, M);
+            EXPECT_EQ(packed.getLightIndex(), lightIndex);
+            EXPECT_LE(std::abs(packed.getLightUV().x - lightUV.x), 0.5f / 65535.f + 1e-7f);
+            EXPECT_LE(std::abs(packed.getLightUV().y - lightUV.y), 0.5f / 65535.f + 1e-7f);
+            EXPECT_EQ(packed.getM(), M);
+            EXPECT_LE(relativeError(packed.getW(), W), 1.f / 2048.f) << "W = " << W;
+        }
+    }
+
+    // Quantized light samples are stored exactly, so resampling evaluates the same point on the light.
+    for (uint32_t i = 0; i < 1000; ++i)
+    {
+        const float2 lightUV = quantizeReservoirLightUV(float2(u(rng), u(rng)));
+        PackedDIReservoir packed = PackedDIReservoir::pack(0, lightUV, 1.f, 1);
+        EXPECT_EQ(packed.getLightUV().x, lightUV.x);
+        EXPECT_EQ(packed.getLightUV().y, lightUV.y);
+    }
+
+    // Out of range values are clamped.
+    PackedDIReservoir packed = PackedDIReservoir::pack(0, float2(-1.f, 2.f), 1e10f, 100000);
+    EXPECT_EQ(packed.getW(), kMaxPackedReservoirWeight);
+    EXPECT_EQ(packed.getM(), kMaxPackedReservoirM);
+    EXPECT_EQ(packed.getLightUV().x, 0.f);
+    EXPECT_EQ(packed.getLightUV().y, 1.f);
+
+    packed = PackedDIReservoir::pack(0, float2(0.f), -1.f, 1);
+    EXPECT_EQ(packed.getW(), 0.f);
+}
+
+CPU_TEST(PackedGIReservoir)
+{
+    static_assert(sizeof(PackedGIReservoir) == 32);
+
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> u;
+
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        const float3 visiblePoint = (float3(u(rng), u(rng), u(rng)) - 0.5f) * 200.f;
+        const float3 visibleNormal = randomDirection(rng);
+        const float distance = std::pow(2.f, u(rng) * 20.f - 10.f);
+        const float3 samplePoint = visiblePoint + randomDirection(rng) * distance;
+        const float3 sampleNormal = randomDirection(rng);
+        const float3 sampleRadiance = float3(u(rng), u(rng), u(rng)) * std::pow(2.f, u(rng) * 20.f - 10.f);
+        const float weightSum = std::pow(2.f, u(rng) * 20.f - 10.f);
+        const uint32_t M = (uint32_t)(u(rng) * 1000.f);
+
+        PackedGIReservoir packed =
+            PackedGIReservoir::pack(visiblePoint, visibleNormal, samplePoint, sampleNormal, sampleRadiance, weightSum, M);
+
+        // The visible point and sample count are exact.
+        EXPECT(all(packed.getVisiblePoint() == visiblePoint));
+        EXPECT_EQ(packed.getM(), M);
+
+        // 8-bit octahedral normals are accurate to about a degree, 16-bit ones to a fraction of a milliradian.
+        EXPECT_GE(dot(packed.getVisibleNormal(), visibleNormal), std::cos(0.03f)) << "i = " << i;
+        EXPECT_GE(dot(packed.getSampleNormal(), sampleNormal), std::cos(0.001f)) << "i = " << i;
+
+        // The sample point error is relative to the distance from the visible point.
+        EXPECT_LE(length(packed.getSamplePoint() - samplePoint), distance * 2e-3f) << "i = " << i;
+
+        // The radiance error is relative to the largest channel.
+        const float radianceThreshold = std::max(std::max(sampleRadiance.x, sampleRadiance.y), sampleRadiance.z) / 511.f;
+        const float3 radiance = packed.getSampleRadiance();
+        EXPECT_LE(std::abs(radiance.x - sampleRadiance.x), radianceThreshold) << "i = " << i;
+        EXPECT_LE(std::abs(radiance.y - sampleRadiance.y), radianceThreshold) << "i = " << i;
+        EXPECT_LE(std::abs(radiance.z - sampleRadiance.z), radianceThreshold) << "i = " << i;
+
+        EXPECT_LE(relativeError(packed.getWeightSum(), weightSum), 1.f / 2048.f) << "i = " << i;
+    }
+
+    // An empty reservoir stays empty.
+    PackedGIReservoir packed = PackedGIReservoir::pack(float3(0.f), float3(0.f), float3(0.f), float3(0.f), float3(0.f), 0.f, 0);
+    EXPECT(all(packed.getSamplePoint() == float3(0.f)));
+    EXPECT(all(packed.getSampleRadiance() == float3(0.f)));
+    EXPECT_EQ(packed.getWeightSum(), 0.f);
+    EXPECT_EQ(packed.getM(), 0u);
+}
+} // namespace Falcor
@@ -30,17 +30,15 @@
 
 #include <hypothesis/hypothesis.h>
 
+#include <functional>
 #include <iostream>
 
 namespace Falcor
 {
 namespace
 {
-void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> specificWeights = {})
+std::vector<float> generateWeights(std::mt19937& rng, uint32_t N, std::vector<float> specificWeights = {})
 {
-    ref<Device> pDevice = ctx.getDevice();
-
-    std::mt19937 rng;
     std::uniform_real_distribution<float> uniform;
 
     // Use specificed weights or generate pseudo-random weights.
@@ -55,6 +53,54 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
             weights[(size_t)(uniform(rng) * N)] = 0.f;
     }
 
+    return weights;
+}
+
+bool testDistribution(const std::vector<float>& weights, const std::function<uint32_t(float2)>& sample, std::mt19937& rng)
+{
+    const uint32_t N = (uint32_t)weights.size();
+    const uint32_t samplesPerWeight = 1000;
+    std::uniform_real_distribution<float> uniform;
+
+    double weightSum = 0.0;
+    for (const auto& weight : weights)
+        weightSum += weight;
+
+    // Build histogram.
+    std::vector<double> obsFrequencies(N, 0.0);
+    for (uint32_t i = 0; i < N * samplesPerWeight; ++i)
+    {
+        uint32_t item = sample(float2(uniform(rng), uniform(rng)));
+        if (item >= N)
+            return false;
+        obsFrequencies[item] += 1.0;
+    }
+
+    // Verify histogram using a chi-square test.
+    std::vector<double> expFrequencies(N);
+    for (uint32_t i = 0; i < N; ++i)
+        expFrequencies[i] = (weights[i] / weightSum) * N * samplesPerWeight;
+
+    if (N == 1)
+        return obsFrequencies[0] == samplesPerWeight;
+
+    // Use a lower significance level than the GPU test as many distributions are tested.
+    const auto& [success, report] =
+        hypothesis::chi2_test(N, obsFrequencies.data(), expFrequencies.data(), N * samplesPerWeight, 5, 0.01);
+    if (!success)
+        std::cout << report << std::endl;
+    return success;
+}
+
+void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> specificWeights = {})
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> uniform;
+
+    std::vector<float> weights = generateWeights(rng, N, specificWeights);
+
     // Create alias table.
     AliasTable aliasTable(pDevice, weights, rng);
 
@@ -139,6 +185,72 @@ void testAliasTable(GPUUnitTestContext& ctx, uint32_t N, std::vector<float> spec
 }
 } // namespace
 
+CPU_TEST(AliasTableCPU)
+{
+    std::mt19937 rng;
+
+    for (uint32_t blockSize : {1u, 7u, 64u, AliasTable::kDefaultBlockSize})
+    {
+        for (uint32_t N : {1u, 2u, 100u, 1000u})
+        {
+            auto weights = generateWeights(rng, N, N == 2 ? std::vector<float>{1.f, 2.f} : std::vector<float>{});
+            AliasTable aliasTable(nullptr, weights, rng, blockSize);
+
+            double weightSum = 0.0;
+            for (const auto& weight : weights)
+                weightSum += weight;
+
+            EXPECT_EQ(aliasTable.getCount(), N);
+            EXPECT_EQ(aliasTable.getWeightSum(), weightSum);
+            EXPECT_EQ(aliasTable.getBlockCount(), (N + blockSize - 1) / blockSize);
+            EXPECT(testDistribution(weights, [&](float2 u) { return aliasTable.sample(u); }, rng))
+                << "N=" << N << " blockSize=" << blockSize;
+        }
+    }
+
+    // Zero weights in a whole block are never sampled.
+    {
+        std::vector<float> weights = {0.f, 0.f, 0.f, 0.f, 1.f, 2.f, 3.f, 4.f};
+        AliasTable aliasTable(nullptr, weights, rng, 4);
+        EXPECT(testDistribution(weights, [&](float2 u) { return aliasTable.sample(u); }, rng));
+    }
+}
+
+CPU_TEST(AliasTableUpdateWeights)
+{
+    std::mt19937 rng;
+    const uint32_t N = 1000;
+    const uint32_t blockSize = 64;
+
+    auto weights = generateWeights(rng, N);
+    AliasTable aliasTable(nullptr, weights, rng, blockSize);
+
+    // No changes.
+    EXPECT_EQ(aliasTable.updateWeights(weights), 0u);
+
+    // Change weights in two blocks.
+    weights[10] = 5.f;
+    weights[20] = 0.f;
+    weights[N - 1] = 3.f;
+    EXPECT_EQ(aliasTable.updateWeights(weights), 2u);
+
+    double weightSum = 0.0;
+    for (const auto& weight : weights)
+        weightSum += weight;
+    EXPECT_EQ(aliasTable.getWeightSum(), weightSum);
+    EXPECT(aliasTable.getWeights() == weights);
+    EXPECT(testDistribution(weights, [&](float2 u) { return aliasTable.sample(u); }, rng));
+
+    // The updated table samples the same as a table built from scratch.
+    AliasTable rebuilt(nullptr, weights, rng, blockSize);
+    std::uniform_real_distribution<float> uniform;
+    for (uint32_t i = 0; i < 10000; ++i)
+    {
+        float2 u(uniform(rng), uniform(rng));
+        EXPECT_EQ(aliasTable.sample(u), rebuilt.sample(u));
+    }
+}
+
 GPU_TEST(AliasTable)
 {
     testAliasTable(ctx, 1, {1.f});
@@ -0,0 +1,193 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/BlasBuildPlanner.h"
+
+#include <random>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+using Record = BlasBuildPlanner::BlasRecord;
+
+void validatePlan(CPUUnitTestContext& ctx, const std::vector<Record>& records, const BlasBuildPlanner::Plan& plan)
+{
+    ASSERT_EQ(plan.blasGroupIndex.size(), records.size());
+    ASSERT_EQ(plan.resultByteOffset.size(), records.size());
+    ASSERT_EQ(plan.scratchByteOffset.size(), records.size());
+
+    std::set<uint32_t> blasIDs;
+    uint64_t resultBufferSize = 0;
+    uint64_t scratchBufferSize = 0;
+
+    for (uint32_t groupIndex = 0; groupIndex < plan.groups.size(); groupIndex++)
+    {
+        const auto& group = plan.groups[groupIndex];
+        EXPECT(!group.blasIndices.empty());
+
+        uint64_t resultOffset = 0;
+        uint64_t scratchOffset = 0;
+        for (uint32_t blasId : group.blasIndices)
+        {
+            ASSERT_LT(blasId, records.size());
+            EXPECT(blasIDs.insert(blasId).second);
+            EXPECT_EQ(plan.blasGroupIndex[blasId], groupIndex);
+            EXPECT_EQ(plan.resultByteOffset[blasId], resultOffset);
+            EXPECT_EQ(plan.scratchByteOffset[blasId], scratchOffset);
+            resultOffset += records[blasId].resultByteSize;
+            scratchOffset += records[blasId].scratchByteSize;
+        }
+        EXPECT_EQ(group.resultByteSize, resultOffset);
+        EXPECT_EQ(group.scratchByteSize, scratchOffset);
+
+        resultBufferSize = std::max(resultBufferSize, group.resultByteSize);
+        scratchBufferSize = std::max(scratchBufferSize, group.scratchByteSize);
+    }
+
+    EXPECT_EQ(blasIDs.size(), records.size());
+    EXPECT_EQ(plan.resultBufferSize, resultBufferSize);
+    EXPECT_EQ(plan.scratchBufferSize, scratchBufferSize);
+}
+} // namespace
+
+CPU_TEST(BlasBuildPlanner_Empty)
+{
+    auto plan = BlasBuildPlanner::plan({}, {});
+    EXPECT(plan.groups.empty());
+    EXPECT_EQ(plan.plannedPeakMemory, 0);
+}
+
+CPU_TEST(BlasBuildPlanner_SingleGroup)
+{
+    std::vector<Record> records = {
+        {100, 50, true, false},
+        {200, 80, false, false},
+        {10, 10, true, false},
+    };
+
+    BlasBuildPlanner::Options options;
+    options.memoryBudget = 1000;
+    options.compactionRatio = 0.5;
+    auto plan = BlasBuildPlanner::plan(records, options);
+    validatePlan(ctx, records, plan);
+
+    ASSERT_EQ(plan.groups.size(), 1);
+    EXPECT_EQ(plan.resultBufferSize, 310);
+    EXPECT_EQ(plan.scratchBufferSize, 140);
+    EXPECT_EQ(plan.estimatedFinalByteSize, 50 + 200 + 5);
+    EXPECT(plan.releaseScratchBeforeLastGroup);
+    // Scratch is released before the final buffer is allocated.
+    EXPECT_EQ(plan.plannedPeakMemory, std::max<uint64_t>(310 + 140, 310 + 255));
+}
+
+CPU_TEST(BlasBuildPlanner_Budget)
+{
+    // Four equal BLASes with a budget that fits two of them per group.
+    std::vector<Record> records(4, Record{30, 20, true, false});
+
+    BlasBuildPlanner::Options options;
+    options.memoryBudget = 100;
+    options.compactionRatio = 0.5;
+    auto plan = BlasBuildPlanner::plan(records, options);
+    validatePlan(ctx, records, plan);
+
+    ASSERT_EQ(plan.groups.size(), 2);
+    EXPECT_EQ(plan.resultBufferSize, 60);
+    EXPECT_EQ(plan.scratchBufferSize, 40);
+    EXPECT_EQ(plan.estimatedFinalByteSize, 60);
+    // Peak is reached after compacting the first group while building the second.
+    EXPECT_EQ(plan.plannedPeakMemory, 130);
+
+    // Retaining the scratch buffer raises the peak at the end of the build.
+    records[2].needsScratchAfterBuild = true;
+    plan = BlasBuildPlanner::plan(records, options);
+    validatePlan(ctx, records, plan);
+    EXPECT(!plan.releaseScratchBeforeLastGroup);
+    EXPECT_EQ(plan.plannedPeakMemory, 160);
+}
+
+CPU_TEST(BlasBuildPlanner_LargestGroupLast)
+{
+    // One large BLAS that exceeds the budget on its own and several small ones.
+    std::vector<Record> records = {
+        {1000, 100, true, false},
+        {50, 10, true, false},
+        {50, 10, true, false},
+        {50, 10, true, false},
+    };
+
+    BlasBuildPlanner::Options options;
+    options.memoryBudget = 200;
+    auto plan = BlasBuildPlanner::plan(records, options);
+    validatePlan(ctx, records, plan);
+
+    ASSERT_GE(plan.groups.size(), 2);
+    const auto& last = plan.groups.back();
+    EXPECT_EQ(last.blasIndices.size(), 1);
+    EXPECT_EQ(last.blasIndices[0], 0);
+
+    std::vector<uint64_t> finalSizes;
+    for (const auto& group : plan.groups)
+        finalSizes.push_back(group.estimatedFinalByteSize);
+    EXPECT_EQ(plan.plannedPeakMemory, BlasBuildPlanner::computePeakMemory(plan, finalSizes));
+}
+
+CPU_TEST(BlasBuildPlanner_Randomized)
+{
+    std::mt19937 rng(1234);
+    std::uniform_int_distribution<uint64_t> resultDist(1, 1000);
+    std::uniform_int_distribution<uint64_t> scratchDist(1, 500);
+
+    for (int run = 0; run < 20; run++)
+    {
+        std::vector<Record> records(1 + rng() % 200);
+        for (auto& record : records)
+        {
+            record.resultByteSize = resultDist(rng);
+            record.scratchByteSize = scratchDist(rng);
+            record.useCompaction = (rng() % 4) != 0;
+            record.needsScratchAfterBuild = (rng() % 10) == 0;
+        }
+
+        BlasBuildPlanner::Options options;
+        options.memoryBudget = 4000;
+        auto plan = BlasBuildPlanner::plan(records, options);
+        validatePlan(ctx, records, plan);
+
+        // No single BLAS exceeds its share of the budget, so the shared buffers must stay within it.
+        EXPECT_LE(plan.resultBufferSize + plan.scratchBufferSize, options.memoryBudget) << fmt::format("Run: {}", run);
+
+        // Planning is deterministic.
+        auto plan2 = BlasBuildPlanner::plan(records, options);
+        EXPECT(plan.blasGroupIndex == plan2.blasGroupIndex);
+        EXPECT_EQ(plan.plannedPeakMemory, plan2.plannedPeakMemory);
+    }
+}
+} // namespace Falcor
@@ -0,0 +1,199 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/Material/MaterialSystem.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Scene/Material/ClothMaterial.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <algorithm>
+
+namespace Falcor
+{
+namespace
+{
+/// Create a standard material with one of a number of distinct parameter sets.
+ref<StandardMaterial> createMaterial(ref<Device> pDevice, uint32_t variant, uint32_t index)
+{
+    auto pMaterial = StandardMaterial::create(pDevice, fmt::format("Material{}", index));
+    pMaterial->setBaseColor(float4((variant % 10) / 10.f, (variant / 10 % 10) / 10.f, (variant / 100 % 10) / 10.f, 1.f));
+    pMaterial->setRoughness((variant / 1000 % 10) / 10.f);
+    return pMaterial;
+}
+
+/// Check the ID map against a linear search over the unique materials in order.
+void verifyIdMap(GPUUnitTestContext& ctx, const std::vector<ref<Material>>& materials, const std::vector<MaterialID>& idMap, uint32_t expectedUniqueCount)
+{
+    ASSERT_EQ(idMap.size(), materials.size());
+    std::vector<ref<Material>> uniqueMaterials;
+    for (size_t i = 0; i < materials.size(); i++)
+    {
+        auto it = std::find_if(uniqueMaterials.begin(), uniqueMaterials.end(), [&](const auto& m) { return m->isEqual(materials[i]); });
+        size_t expectedID = std::distance(uniqueMaterials.begin(), it);
+        if (it == uniqueMaterials.end()) uniqueMaterials.push_back(materials[i]);
+        EXPECT_EQ(idMap[i].get(), expectedID) << "i = " << i;
+    }
+    EXPECT_EQ(uniqueMaterials.size(), expectedUniqueCount);
+}
+} // namespace
+
+GPU_TEST(MaterialHash)
+{
+    ref<Device> pDevice = ctx.getDevice();
+
+    // Equal materials have equal hashes. The name is not included.
+    auto pA = createMaterial(pDevice, 123, 0);
+    auto pB = createMaterial(pDevice, 123, 1);
+    EXPECT(pA->isEqual(pB));
+    EXPECT_EQ(pA->getHash(), pB->getHash());
+
+    // Negative zero compares equal to zero and must hash the same.
+    pA->setEmissiveColor(float3(0.f));
+    pB->setEmissiveColor(float3(-0.f));
+    EXPECT(pA->isEqual(pB));
+    EXPECT_EQ(pA->getHash(), pB->getHash());
+
+    // Differences in parameters are reflected in the hash.
+    pB->setRoughness(0.9f);
+    EXPECT(!pA->isEqual(pB));
+    EXPECT_NE(pA->getHash(), pB->getHash());
+
+    // Materials of different types are not equal.
+    auto pCloth = ClothMaterial::create(pDevice, "Cloth");
+    EXPECT(!pA->isEqual(pCloth));
+    EXPECT_NE(pA->getHash(), pCloth->getHash());
+}
+
+GPU_TEST(MaterialSystem_RemoveDuplicates)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    MaterialSystem materialSystem(pDevice);
+
+    // Interleave duplicates of 50 distinct materials with a few materials of another type.
+    std::vector<ref<Material>> materials;
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        materials.push_back(i % 100 == 99 ? ref<Material>(ClothMaterial::create(pDevice, "Cloth")) : ref<Material>(createMaterial(pDevice, (i * 7) % 50, i)));
+        EXPECT_EQ(materialSystem.addMaterial(materials.back()).get(), i);
+    }
+
+    // Adding a material again returns its existing ID.
+    EXPECT_EQ(materialSystem.addMaterial(materials[42]).get(), 42);
+
+    std::vector<MaterialID> idMap;
+    size_t removed = materialSystem.removeDuplicateMaterials(idMap);
+    EXPECT_EQ(removed, 500 - 51);
+    EXPECT_EQ(materialSystem.getMaterialCount(), 51);
+    verifyIdMap(ctx, materials, idMap, 51);
+
+    // The first occurrence of each material is kept.
+    for (size_t i = 0; i < materials.size(); i++)
+    {
+        const auto& pMaterial = materialSystem.getMaterial(idMap[i]);
+        EXPECT(pMaterial->isEqual(materials[i])) << "i = " << i;
+        EXPECT_EQ(materialSystem.addMaterial(pMaterial).get(), idMap[i].get()) << "i = " << i;
+    }
+}
+
+CPU_TEST(MaterialSystem_Headless)
+{
+    // Materials and the material system work without a device. Textures are recorded by path only.
+    MaterialSystem materialSystem(nullptr);
+
+    auto pA = createMaterial(nullptr, 1, 0);
+    auto pB = createMaterial(nullptr, 1, 1);
+    auto pC = createMaterial(nullptr, 1, 2);
+    auto pD = createMaterial(nullptr, 1, 3);
+    pA->setTextureSourcePath(Material::TextureSlot::BaseColor, "a.png");
+    pB->setTextureSourcePath(Material::TextureSlot::BaseColor, "a.png");
+    pC->setTextureSourcePath(Material::TextureSlot::BaseColor, "b.png");
+
+    EXPECT(pA->hasTextureSlotData(Material::TextureSlot::BaseColor));
+    EXPECT(pA->getTexture(Material::TextureSlot::BaseColor) == nullptr);
+    EXPECT_EQ(pA->getTextureSourcePath(Material::TextureSlot::BaseColor), std::filesystem::path("a.png"));
+    EXPECT(!pD->hasTextureSlotData(Material::TextureSlot::BaseColor));
+
+    // Texture paths take part in material equality and hashing.
+    EXPECT(pA->isEqual(pB));
+    EXPECT_EQ(pA->getHash(), pB->getHash());
+    EXPECT(!pA->isEqual(pC));
+    EXPECT_NE(pA->getHash(), pC->getHash());
+    EXPECT(!pA->isEqual(pD));
+
+    // Loading a texture without a device records its path. Clearing the slot removes it.
+    EXPECT(pD->loadTexture(Material::TextureSlot::Normal, "n.png"));
+    EXPECT_EQ(pD->getTextureSourcePath(Material::TextureSlot::Normal), std::filesystem::path("n.png"));
+    pD->clearTexture(Material::TextureSlot::Normal);
+    EXPECT(!pD->hasTextureSlotData(Material::TextureSlot::Normal));
+
+    for (const auto& pMaterial : { pA, pB, pC, pD }) materialSystem.addMaterial(pMaterial);
+
+    std::vector<MaterialID> idMap;
+    EXPECT_EQ(materialSystem.removeDuplicateMaterials(idMap), 1);
+    EXPECT_EQ(materialSystem.getMaterialCount(), 3);
+    ASSERT_EQ(idMap.size(), 4);
+    EXPECT_EQ(idMap[0].get(), 0);
+    EXPECT_EQ(idMap[1].get(), 0);
+    EXPECT_EQ(idMap[2].get(), 1);
+    EXPECT_EQ(idMap[3].get(), 2);
+}
+
+GPU_TEST(MaterialSystem_RemoveDuplicatesBenchmark)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    MaterialSystem materialSystem(pDevice);
+
+    const uint32_t kMaterialCount = 100000;
+    const uint32_t kVariantCount = 10000;
+
+    std::vector<ref<Material>> materials(kMaterialCount);
+    for (uint32_t i = 0; i < kMaterialCount; i++) materials[i] = createMaterial(pDevice, (i * 7919) % kVariantCount, i);
+
+    auto startTime = CpuTimer::getCurrentTimePoint();
+    for (const auto& pMaterial : materials) materialSystem.addMaterial(pMaterial);
+    auto addTime = CpuTimer::getCurrentTimePoint();
+
+    std::vector<MaterialID> idMap;
+    size_t removed = materialSystem.removeDuplicateMaterials(idMap);
+    auto endTime = CpuTimer::getCurrentTimePoint();
+
+    EXPECT_EQ(removed, kMaterialCount - kVariantCount);
+    EXPECT_EQ(materialSystem.getMaterialCount(), kVariantCount);
+    for (uint32_t i = 0; i < kMaterialCount; i++)
+    {
+        EXPECT_EQ(idMap[i].get(), i < kVariantCount ? i : idMap[i % kVariantCount].get()) << "i = " << i;
+    }
+
+    logInfo(
+        "Added {} materials in {:.1f} ms, removed {} duplicates in {:.1f} ms.",
+        kMaterialCount,
+        CpuTimer::calcDuration(startTime, addTime),
+        removed,
+        CpuTimer::calcDuration(addTime, endTime)
+    );
+}
+} // namespace Falcor
@@ -0,0 +1,260 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/MeshDeduplicator.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+/// Create a random point set in the box [-1,1]^3 shifted by an offset.
+std::vector<float3> createPoints(uint32_t count, float3 offset, uint32_t seed = 1)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-1.f, 1.f);
+    std::vector<float3> positions(count);
+    for (auto& p : positions) p = float3(dist(rng), dist(rng), dist(rng)) + offset;
+    return positions;
+}
+
+std::vector<float3> transformPoints(const float4x4& transform, const std::vector<float3>& positions)
+{
+    std::vector<float3> result;
+    for (const auto& p : positions) result.push_back(transformPoint(transform, p));
+    return result;
+}
+
+void verifyTransform(CPUUnitTestContext& ctx, const float4x4& transform, const std::vector<float3>& a, const std::vector<float3>& b, float tolerance)
+{
+    for (size_t i = 0; i < a.size(); i++)
+    {
+        EXPECT_LE(length(transformPoint(transform, a[i]) - b[i]), tolerance) << "i = " << i;
+    }
+    // The upper 3x3 part must be a rotation.
+    float3x3 R(transform);
+    float3x3 RRt = mul(R, transpose(R));
+    for (int j = 0; j < 3; j++)
+        for (int k = 0; k < 3; k++)
+            EXPECT_LT(std::abs(RRt[j][k] - (j == k ? 1.f : 0.f)), 1e-5f);
+    EXPECT_GT(determinant(R), 0.f);
+}
+} // namespace
+
+CPU_TEST(MeshDeduplicator_FindDuplicates)
+{
+    // Items 0, 2, 5 are equal and items 1, 4 are equal. Item 3 collides with the hash of item 0 but differs.
+    const std::vector<int> values = {7, 3, 7, 8, 3, 7, 9};
+    const std::vector<uint64_t> hashes = {1, 2, 1, 1, 2, 1, 3};
+
+    auto classes = MeshDeduplicator::findDuplicates(hashes, [&](uint32_t a, uint32_t b) { return a < b && values[a] == values[b]; });
+
+    ASSERT_EQ(classes.size(), values.size());
+    const std::vector<uint32_t> expected = {0, 1, 0, 3, 1, 0, 6};
+    for (size_t i = 0; i < classes.size(); i++) EXPECT_EQ(classes[i], expected[i]) << "i = " << i;
+
+    EXPECT(MeshDeduplicator::findDuplicates({}, [](uint32_t, uint32_t) { return true; }).empty());
+}
+
+CPU_TEST(MeshDeduplicator_RigidTransform)
+{
+    const std::vector<float3> a = createPoints(100, float3(100.f, -50.f, 20.f));
+    const float tolerance = 1e-3f;
+
+    // Identity.
+    float4x4 transform;
+    ASSERT(MeshDeduplicator::findRigidTransform(a, a, tolerance, transform));
+    verifyTransform(ctx, transform, a, a, tolerance);
+
+    // Rotations about several axes, including a half turn, combined with translations.
+    const std::vector<std::pair<float, float3>> rotations = {
+        {0.3f, float3(0.f, 0.f, 1.f)},
+        {float(M_PI), float3(1.f, 0.f, 0.f)},
+        {2.f, normalize(float3(1.f, -2.f, 3.f))},
+    };
+    for (const auto& [angle, axis] : rotations)
+    {
+        float4x4 expected = mul(math::matrixFromTranslation(float3(-5.f, 30.f, 2.f)), math::matrixFromRotation(angle, axis));
+        const std::vector<float3> b = transformPoints(expected, a);
+        ASSERT(MeshDeduplicator::findRigidTransform(a, b, tolerance, transform));
+        verifyTransform(ctx, transform, a, b, tolerance);
+    }
+
+    // Points in a plane.
+    std::vector<float3> planar = a;
+    for (auto& p : planar) p.z = 0.f;
+    float4x4 expected = math::matrixFromRotation(1.f, normalize(float3(1.f, 1.f, 0.f)));
+    ASSERT(MeshDeduplicator::findRigidTransform(planar, transformPoints(expected, planar), tolerance, transform));
+    verifyTransform(ctx, transform, planar, transformPoints(expected, planar), tolerance);
+}
+
+CPU_TEST(MeshDeduplicator_RigidTransformMismatch)
+{
+    const std::vector<float3> a = createPoints(100, float3(0.f));
+    const float tolerance = 1e-3f;
+    float4x4 transform;
+
+    // Mirrored points.
+    std::vector<float3> mirrored = a;
+    for (auto& p : mirrored) p.x = -p.x;
+    EXPECT(!MeshDeduplicator::findRigidTransform(a, mirrored, tolerance, transform));
+
+    // Scaled points.
+    EXPECT(!MeshDeduplicator::findRigidTransform(a, transformPoints(math::matrixFromScaling(float3(1.01f)), a), tolerance, transform));
+
+    // A single displaced point.
+    std::vector<float3> displaced = a;
+    displaced[50].y += 0.01f;
+    EXPECT(!MeshDeduplicator::findRigidTransform(a, displaced, tolerance, transform));
+
+    // Unrelated points, and points with a different correspondence.
+    EXPECT(!MeshDeduplicator::findRigidTransform(a, createPoints(100, float3(0.f), 2), tolerance, transform));
+    std::vector<float3> swapped = a;
+    std::swap(swapped[0], swapped[1]);
+    EXPECT(!MeshDeduplicator::findRigidTransform(a, swapped, tolerance, transform));
+
+    EXPECT(!MeshDeduplicator::findRigidTransform({}, {}, tolerance, transform));
+    EXPECT_THROW(MeshDeduplicator::findRigidTransform(a, createPoints(10, float3(0.f)), tolerance, transform));
+}
+
+CPU_TEST(MeshDeduplicator_RigidInvariantHash)
+{
+    const std::vector<float3> a = createPoints(1000, float3(100.f, -50.f, 20.f));
+    const uint64_t hash = MeshDeduplicator::computeRigidInvariantHash(a);
+
+    // Rigidly transformed and mirrored points have equal hashes.
+    float4x4 transform = mul(math::matrixFromTranslation(float3(-5.f, 30.f, 2.f)), math::matrixFromRotation(2.f, normalize(float3(1.f, -2.f, 3.f))));
+    EXPECT_EQ(MeshDeduplicator::computeRigidInvariantHash(transformPoints(transform, a)), hash);
+    std::vector<float3> mirrored = a;
+    for (auto& p : mirrored) p.x = -p.x;
+    EXPECT_EQ(MeshDeduplicator::computeRigidInvariantHash(mirrored), hash);
+
+    // Scaled and different points have different hashes.
+    EXPECT_NE(MeshDeduplicator::computeRigidInvariantHash(transformPoints(math::matrixFromScaling(float3(1.1f)), a)), hash);
+    EXPECT_NE(MeshDeduplicator::computeRigidInvariantHash(createPoints(1000, float3(0.f), 2)), hash);
+
+    // Height fields on the same grid, like terrain tiles sharing topology and texture coordinates, have different hashes.
+    auto createHeightField = [](uint32_t seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> dist(0.f, 1.f);
+        std::vector<float3> positions;
+        for (uint32_t y = 0; y < 16; y++)
+            for (uint32_t x = 0; x < 16; x++) positions.push_back(float3(float(x), float(y), dist(rng)));
+        return positions;
+    };
+    std::set<uint64_t> hashes;
+    for (uint32_t seed = 0; seed < 100; seed++) hashes.insert(MeshDeduplicator::computeRigidInvariantHash(createHeightField(seed)));
+    EXPECT_GE(hashes.size(), 95);
+
+    EXPECT_EQ(MeshDeduplicator::computeRigidInvariantHash({}), MeshDeduplicator::computeRigidInvariantHash({float3(1.f), float3(1.f)}));
+}
+
+GPU_TEST(MeshDeduplicator_SceneBuilder)
+{
+    ref<Device> pDevice = ctx.getDevice();
+    ref<Material> pMaterial = StandardMaterial::create(pDevice, "Material");
+
+    // Mesh B is an exact duplicate of mesh A and mesh C is a rotated copy. Mesh D is unique and is added last,
+    // so its mesh ID changes when the duplicates are removed.
+    const float4x4 rotation = math::matrixFromRotation(1.f, normalize(float3(1.f, 2.f, 3.f)));
+    ref<TriangleMesh> pCube = TriangleMesh::createCube(float3(1.f, 2.f, 3.f));
+    ref<TriangleMesh> pRotatedCube = TriangleMesh::createCube(float3(1.f, 2.f, 3.f));
+    pRotatedCube->applyTransform(rotation);
+    ref<TriangleMesh> pSphere = TriangleMesh::createSphere();
+    pCube->setName("A");
+    pRotatedCube->setName("C");
+    pSphere->setName("D");
+
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::DeduplicateMeshesRigid | SceneBuilder::Flags::DontOptimizeGraph);
+    const float4x4 transforms[4] =
+    {
+        math::matrixFromTranslation(float3(0.f, 0.f, 0.f)),
+        math::matrixFromTranslation(float3(10.f, 0.f, 0.f)),
+        math::matrixFromTranslation(float3(0.f, 10.f, 0.f)),
+        math::matrixFromTranslation(float3(0.f, 0.f, 10.f)),
+    };
+    const ref<TriangleMesh> meshes[4] = { pCube, pCube, pRotatedCube, pSphere };
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        MeshID meshID = builder.addTriangleMesh(meshes[i], pMaterial);
+        NodeID nodeID = builder.addNode(SceneBuilder::Node{ "Node" + std::to_string(i), transforms[i], float4x4::identity() });
+        builder.addMeshInstance(nodeID, meshID);
+    }
+
+    // The scene update requires a camera.
+    builder.addCamera(Camera::create("Camera"));
+
+    ref<Scene> pScene = builder.getScene();
+    ASSERT(pScene);
+    pScene->update(ctx.getRenderContext(), 0.0);
+
+    EXPECT_EQ(pScene->getSceneStats().deduplicatedMeshCount, 2u);
+
+    // The remaining meshes are remapped to contiguous IDs.
+    ASSERT_EQ(pScene->getMeshCount(), 2u);
+    std::map<std::string, uint32_t> meshIDs;
+    for (uint32_t meshID = 0; meshID < pScene->getMeshCount(); meshID++) meshIDs[pScene->getMeshName(meshID)] = meshID;
+    ASSERT_EQ(meshIDs.count("A"), 1u);
+    ASSERT_EQ(meshIDs.count("D"), 1u);
+    EXPECT_EQ(pScene->getMesh(MeshID{ meshIDs["D"] }).indexCount, pSphere->getIndices().size());
+
+    // The nodes are the four added nodes, the child node with the rotation of mesh C and the identity node of the pretransformed mesh D.
+    const auto& globalMatrices = pScene->getAnimationController()->getGlobalMatrices();
+    EXPECT_EQ(globalMatrices.size(), 6u);
+
+    // Mesh A is instanced by its own node, the node of mesh B and the child node of mesh C.
+    std::vector<uint32_t> instanceNodes;
+    for (uint32_t i = 0; i < pScene->getGeometryInstanceCount(); i++)
+    {
+        const auto& instance = pScene->getGeometryInstance(i);
+        if (instance.geometryID == meshIDs["A"]) instanceNodes.push_back(instance.globalMatrixID);
+    }
+    std::sort(instanceNodes.begin(), instanceNodes.end());
+    ASSERT_EQ(instanceNodes.size(), 3u);
+    EXPECT_EQ(instanceNodes[0], 0u);
+    EXPECT_EQ(instanceNodes[1], 1u);
+    EXPECT_EQ(instanceNodes[2], 4u);
+
+    auto expectMatrixNear = [&](const float4x4& a, const float4x4& b)
+    {
+        for (int j = 0; j < 4; j++)
+            for (int k = 0; k < 4; k++)
+                EXPECT_LT(std::abs(a[j][k] - b[j][k]), 1e-4f) << "j = " << j << ", k = " << k;
+    };
+    expectMatrixNear(globalMatrices[instanceNodes[0]], transforms[0]);
+    expectMatrixNear(globalMatrices[instanceNodes[1]], transforms[1]);
+    expectMatrixNear(globalMatrices[instanceNodes[2]], mul(transforms[2], rotation));
+}
+} // namespace Falcor
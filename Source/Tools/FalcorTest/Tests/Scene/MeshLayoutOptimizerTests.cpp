@@ -0,0 +1,162 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "MeshTestUtils.h"
+#include "Scene/MeshLayoutOptimizer.h"
+
+#include <algorithm>
+#include <array>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<uint32_t> shuffleTriangles(const std::vector<uint32_t>& indices, uint32_t seed)
+{
+    std::vector<uint32_t> order(indices.size() / 3);
+    for (uint32_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::shuffle(order.begin(), order.end(), std::mt19937(seed));
+
+    std::vector<uint32_t> result;
+    for (uint32_t t : order)
+        result.insert(result.end(), indices.begin() + t * 3, indices.begin() + t * 3 + 3);
+    return result;
+}
+} // namespace
+
+CPU_TEST(MeshLayoutOptimizer_ACMR)
+{
+    // Disjoint triangles miss the cache on every vertex.
+    std::vector<uint32_t> disjoint = {0, 1, 2, 3, 4, 5, 6, 7, 8};
+    EXPECT_EQ(MeshLayoutOptimizer::countCacheMisses(disjoint, 9), 9);
+    EXPECT_EQ(MeshLayoutOptimizer::computeACMR(disjoint, 9), 3.f);
+
+    // A strip of triangles misses once per triangle after the first.
+    std::vector<uint32_t> strip = {0, 1, 2, 2, 1, 3, 2, 3, 4, 4, 3, 5};
+    EXPECT_EQ(MeshLayoutOptimizer::countCacheMisses(strip, 6), 6);
+    EXPECT_EQ(MeshLayoutOptimizer::computeACMR(strip, 6), 1.5f);
+
+    // With a cache of three entries, the vertex 0 is evicted before it is reused.
+    std::vector<uint32_t> evicted = {0, 1, 2, 3, 4, 5, 0, 4, 5};
+    EXPECT_EQ(MeshLayoutOptimizer::countCacheMisses(evicted, 6, 3), 7);
+    EXPECT_EQ(MeshLayoutOptimizer::countCacheMisses(evicted, 6, 6), 6);
+
+    EXPECT_EQ(MeshLayoutOptimizer::computeACMR({}, 0), 0.f);
+}
+
+CPU_TEST(MeshLayoutOptimizer_VertexCache)
+{
+    const uint32_t n = 64;
+    const uint32_t vertexCount = (n + 1) * (n + 1);
+    std::vector<uint32_t> indices = shuffleTriangles(createGridIndices(n), 1);
+
+    std::vector<uint32_t> optimized = MeshLayoutOptimizer::optimizeVertexCache(indices, vertexCount);
+
+    // The optimized list contains the same triangles with the same winding.
+    ASSERT_EQ(optimized.size(), indices.size());
+    EXPECT(getTriangles(optimized) == getTriangles(indices));
+
+    // A shuffled grid has an ACMR close to 3. Tipsify should get it well below 1.
+    float acmrBefore = MeshLayoutOptimizer::computeACMR(indices, vertexCount);
+    float acmrAfter = MeshLayoutOptimizer::computeACMR(optimized, vertexCount);
+    EXPECT_GT(acmrBefore, 2.f);
+    EXPECT_LT(acmrAfter, 1.f);
+
+    // Smaller caches give a worse but still improved order.
+    std::vector<uint32_t> optimizedSmall = MeshLayoutOptimizer::optimizeVertexCache(indices, vertexCount, 8);
+    EXPECT(getTriangles(optimizedSmall) == getTriangles(indices));
+    EXPECT_LT(MeshLayoutOptimizer::computeACMR(optimizedSmall, vertexCount, 8), acmrBefore);
+
+    // The result is deterministic.
+    EXPECT(MeshLayoutOptimizer::optimizeVertexCache(indices, vertexCount) == optimized);
+}
+
+CPU_TEST(MeshLayoutOptimizer_VertexCacheDegenerate)
+{
+    // Degenerate triangles and unreferenced vertices are handled.
+    std::vector<uint32_t> indices = {0, 0, 1, 2, 3, 4, 4, 4, 4, 1, 2, 0};
+    std::vector<uint32_t> optimized = MeshLayoutOptimizer::optimizeVertexCache(indices, 8);
+    EXPECT(getTriangles(optimized) == getTriangles(indices));
+
+    EXPECT(MeshLayoutOptimizer::optimizeVertexCache({}, 0).empty());
+}
+
+CPU_TEST(MeshLayoutOptimizer_VertexFetch)
+{
+    std::vector<uint32_t> indices = {4, 2, 0, 0, 2, 5};
+    std::vector<uint32_t> remap = MeshLayoutOptimizer::computeVertexFetchRemap(indices, 7);
+
+    // Referenced vertices are numbered in order of first use, unreferenced vertices last.
+    std::vector<uint32_t> expected = {2, 4, 1, 5, 0, 3, 6};
+    EXPECT(remap == expected);
+
+    std::vector<uint32_t> vertices = {10, 11, 12, 13, 14, 15, 16};
+    MeshLayoutOptimizer::remapVertices(vertices, remap);
+    for (uint32_t i = 0; i < 7; i++)
+        EXPECT_EQ(vertices[remap[i]], 10 + i);
+
+    // Remapping the indices of an optimized grid makes vertex fetches sequential.
+    const uint32_t n = 16;
+    const uint32_t vertexCount = (n + 1) * (n + 1);
+    std::vector<uint32_t> grid = MeshLayoutOptimizer::optimizeVertexCache(shuffleTriangles(createGridIndices(n), 2), vertexCount);
+    remap = MeshLayoutOptimizer::computeVertexFetchRemap(grid, vertexCount);
+    uint32_t maxIndex = 0;
+    for (uint32_t index : grid)
+    {
+        EXPECT_LE(remap[index], maxIndex + 1);
+        maxIndex = std::max(maxIndex, remap[index]);
+    }
+}
+
+CPU_TEST(MeshLayoutOptimizer_Morton)
+{
+    EXPECT_EQ(MeshLayoutOptimizer::computeMortonCode(float3(0.f)), 0u);
+    EXPECT_EQ(MeshLayoutOptimizer::computeMortonCode(float3(1.f)), 0x3fffffffu);
+    EXPECT_EQ(MeshLayoutOptimizer::computeMortonCode(float3(1.f, 0.f, 0.f)), 0x24924924u);
+    EXPECT_EQ(MeshLayoutOptimizer::computeMortonCode(float3(0.f, 1.f, 0.f)), 0x12492492u);
+    EXPECT_EQ(MeshLayoutOptimizer::computeMortonCode(float3(0.f, 0.f, 1.f)), 0x09249249u);
+    EXPECT_EQ(MeshLayoutOptimizer::computeMortonCode(float3(-1.f, 2.f, 0.f)), 0x12492492u);
+
+    // The corners of a cube are visited in Morton order.
+    std::vector<float3> points = {
+        {5.f, 5.f, 5.f}, {5.f, 5.f, 1.f}, {1.f, 1.f, 1.f}, {5.f, 1.f, 1.f},
+        {1.f, 5.f, 1.f}, {1.f, 1.f, 5.f}, {5.f, 1.f, 5.f}, {1.f, 5.f, 5.f},
+    };
+    std::vector<uint32_t> order = MeshLayoutOptimizer::computeMortonOrder(points);
+    std::vector<uint32_t> expected = {2, 5, 4, 7, 3, 6, 1, 0};
+    EXPECT(order == expected);
+
+    // Identical points keep their order.
+    order = MeshLayoutOptimizer::computeMortonOrder({float3(1.f), float3(1.f), float3(1.f)});
+    expected = {0, 1, 2};
+    EXPECT(order == expected);
+    EXPECT(MeshLayoutOptimizer::computeMortonOrder({}).empty());
+}
+} // namespace Falcor
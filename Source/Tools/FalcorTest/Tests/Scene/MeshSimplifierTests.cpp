@@ -0,0 +1,259 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "MeshTestUtils.h"
+#include "Scene/MeshSimplifier.h"
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+/// Create a closed torus with n x m quads of two triangles each, with outward-facing counter-clockwise winding.
+void createTorus(uint32_t n, uint32_t m, std::vector<uint32_t>& indices, std::vector<float3>& positions)
+{
+    const float R = 1.f, r = 0.3f;
+    for (uint32_t j = 0; j < m; j++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            float u = 2.f * float(M_PI) * i / n, v = 2.f * float(M_PI) * j / m;
+            positions.push_back(float3((R + r * std::cos(v)) * std::cos(u), (R + r * std::cos(v)) * std::sin(u), r * std::sin(v)));
+        }
+    }
+    for (uint32_t j = 0; j < m; j++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            uint32_t v0 = j * n + i;
+            uint32_t v1 = j * n + (i + 1) % n;
+            uint32_t v2 = ((j + 1) % m) * n + i;
+            uint32_t v3 = ((j + 1) % m) * n + (i + 1) % n;
+            indices.insert(indices.end(), {v0, v1, v2, v2, v1, v3});
+        }
+    }
+}
+
+/// Check that all triangles are non-degenerate and face the same way as the reference direction, if given.
+void verifyTriangles(CPUUnitTestContext& ctx, const std::vector<uint32_t>& indices, const std::vector<float3>& positions, float3 direction = float3(0.f))
+{
+    EXPECT_EQ(indices.size() % 3, 0);
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        EXPECT(indices[i] != indices[i + 1] && indices[i] != indices[i + 2] && indices[i + 1] != indices[i + 2]) << "i = " << i;
+        float3 n = cross(positions[indices[i + 1]] - positions[indices[i]], positions[indices[i + 2]] - positions[indices[i]]);
+        if (any(direction != float3(0.f))) EXPECT_GT(dot(n, direction), 0.f) << "i = " << i;
+    }
+}
+
+/// Get the number of directed edges without exactly one opposite edge.
+size_t countOpenEdges(const std::vector<uint32_t>& indices)
+{
+    std::map<std::pair<uint32_t, uint32_t>, int> edges;
+    for (size_t i = 0; i < indices.size(); i += 3)
+        for (size_t e = 0; e < 3; e++)
+            edges[{indices[i + e], indices[i + (e + 1) % 3]}]++;
+
+    size_t count = 0;
+    for (const auto& [edge, edgeCount] : edges)
+    {
+        auto it = edges.find({edge.second, edge.first});
+        if (edgeCount != 1 || it == edges.end() || it->second != 1) count++;
+    }
+    return count;
+}
+
+float computeArea(const std::vector<uint32_t>& indices, const std::vector<float3>& positions)
+{
+    float area = 0.f;
+    for (size_t i = 0; i < indices.size(); i += 3)
+        area += 0.5f * length(cross(positions[indices[i + 1]] - positions[indices[i]], positions[indices[i + 2]] - positions[indices[i]]));
+    return area;
+}
+} // namespace
+
+CPU_TEST(MeshSimplifier_ClosedMesh)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createTorus(64, 32, indices, positions);
+    const float extent = length(float3(2.6f, 2.6f, 0.6f));
+
+    float error = 0.f;
+    std::vector<uint32_t> result = MeshSimplifier::simplify(indices, positions, (uint32_t)indices.size() / 4, 1.f, &error);
+    EXPECT_LE(result.size(), indices.size() / 4);
+    EXPECT_GT(result.size(), indices.size() / 8);
+    EXPECT_GT(error, 0.f);
+    EXPECT_LT(error, 0.05f);
+    verifyTriangles(ctx, result, positions);
+
+    // The simplified torus is still a closed manifold.
+    EXPECT_EQ(countOpenEdges(result), 0);
+
+    // All triangle centroids are close to the torus.
+    for (size_t i = 0; i < result.size(); i += 3)
+    {
+        float3 c = (positions[result[i]] + positions[result[i + 1]] + positions[result[i + 2]]) / 3.f;
+        float d = std::abs(length(float3(length(float2(c.x, c.y)) - 1.f, c.z, 0.f)) - 0.3f);
+        EXPECT_LE(d, 2.f * error * extent) << "i = " << i;
+    }
+
+    // Nothing is collapsed with zero error tolerance on a curved surface.
+    result = MeshSimplifier::simplify(indices, positions, 0, 0.f, &error);
+    EXPECT_EQ(result.size(), indices.size());
+    EXPECT_EQ(error, 0.f);
+}
+
+CPU_TEST(MeshSimplifier_Borders)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(16, indices, positions);
+
+    // Interior vertices of a flat grid collapse without error, while the border is preserved.
+    float error = 1.f;
+    std::vector<uint32_t> result = MeshSimplifier::simplify(indices, positions, 0, 1e-4f, &error);
+    EXPECT_LT(result.size(), indices.size() / 4);
+    EXPECT_LT(error, 1e-4f);
+    verifyTriangles(ctx, result, positions, float3(0.f, 0.f, 1.f));
+    EXPECT_LT(std::abs(computeArea(result, positions) - 256.f), 1e-3f);
+
+    std::set<uint32_t> vertices(result.begin(), result.end());
+    for (uint32_t i = 0; i <= 16; i++)
+    {
+        EXPECT(vertices.count(i) == 1);                 // Bottom
+        EXPECT(vertices.count(16 * 17 + i) == 1);       // Top
+        EXPECT(vertices.count(i * 17) == 1);            // Left
+        EXPECT(vertices.count(i * 17 + 16) == 1);       // Right
+    }
+}
+
+CPU_TEST(MeshSimplifier_Seams)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(16, indices, positions, 8);
+
+    std::vector<uint32_t> result = MeshSimplifier::simplify(indices, positions, 0, 1e-4f);
+    EXPECT_LT(result.size(), indices.size() / 2);
+    verifyTriangles(ctx, result, positions, float3(0.f, 0.f, 1.f));
+    EXPECT_LT(std::abs(computeArea(result, positions) - 256.f), 1e-3f);
+
+    // Both sides of the seam are preserved.
+    std::set<uint32_t> vertices(result.begin(), result.end());
+    for (uint32_t y = 0; y <= 16; y++)
+    {
+        EXPECT(vertices.count(y * 17 + 8) == 1) << "y = " << y;
+        EXPECT(vertices.count(17 * 17 + y) == 1) << "y = " << y;
+    }
+}
+
+CPU_TEST(MeshSimplifier_Lods)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createTorus(64, 32, indices, positions);
+
+    MeshSimplifier::Options options;
+    options.maxLodCount = 8;
+    options.minTriangleCount = 100;
+
+    // Append to existing data to test the offsets.
+    MeshSimplifier::Lods lods;
+    lods.indices = {0, 1, 2};
+    uint32_t lodCount = MeshSimplifier::buildLods(indices, positions, options, lods);
+    EXPECT_GE(lodCount, 3u);
+    EXPECT_LE(lodCount, options.maxLodCount);
+    ASSERT_EQ(lods.lods.size(), lodCount);
+
+    uint32_t indexOffset = 3;
+    uint32_t prevIndexCount = (uint32_t)indices.size();
+    float prevError = 0.f;
+    for (uint32_t i = 0; i < lodCount; i++)
+    {
+        const MeshLodDesc& lod = lods.lods[i];
+        EXPECT_EQ(lod.indexOffset, indexOffset) << "i = " << i;
+        EXPECT_LT(lod.indexCount, prevIndexCount) << "i = " << i;
+        EXPECT_GE(lod.indexCount, options.minTriangleCount * 3) << "i = " << i;
+        EXPECT_GE(lod.error, prevError) << "i = " << i;
+        EXPECT_LE(lod.error, options.maxError) << "i = " << i;
+
+        std::vector<uint32_t> lodIndices(lods.indices.begin() + lod.indexOffset, lods.indices.begin() + lod.indexOffset + lod.indexCount);
+        verifyTriangles(ctx, lodIndices, positions);
+        EXPECT_EQ(countOpenEdges(lodIndices), 0) << "i = " << i;
+        EXPECT_EQ(lod.vertexCount, std::set<uint32_t>(lodIndices.begin(), lodIndices.end()).size()) << "i = " << i;
+
+        indexOffset += lod.indexCount;
+        prevIndexCount = lod.indexCount;
+        prevError = lod.error;
+    }
+    EXPECT_EQ(indexOffset, lods.indices.size());
+
+    // No LODs are generated for meshes below the minimum triangle count.
+    MeshSimplifier::Lods smallLods;
+    options.minTriangleCount = (uint32_t)indices.size();
+    EXPECT_EQ(MeshSimplifier::buildLods(indices, positions, options, smallLods), 0);
+    EXPECT(smallLods.lods.empty());
+}
+
+CPU_TEST(MeshSimplifier_SelectLod)
+{
+    std::vector<MeshLodDesc> lods(3);
+    lods[0].error = 0.001f;
+    lods[1].error = 0.01f;
+    lods[2].error = 0.1f;
+
+    EXPECT_EQ(MeshSimplifier::selectLod(lods.data(), 3, 2000.f), 0);
+    EXPECT_EQ(MeshSimplifier::selectLod(lods.data(), 3, 1000.f), 1);
+    EXPECT_EQ(MeshSimplifier::selectLod(lods.data(), 3, 100.f), 2);
+    EXPECT_EQ(MeshSimplifier::selectLod(lods.data(), 3, 10.f), 3);
+    EXPECT_EQ(MeshSimplifier::selectLod(lods.data(), 3, 1000.f, 10.f), 2);
+    EXPECT_EQ(MeshSimplifier::selectLod(lods.data(), 0, 1.f), 0);
+}
+
+CPU_TEST(MeshSimplifier_InvalidOptions)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(2, indices, positions);
+
+    MeshSimplifier::Lods lods;
+    MeshSimplifier::Options options;
+    options.maxLodCount = MeshSimplifier::kMaxLodCount + 1;
+    EXPECT_THROW(MeshSimplifier::buildLods(indices, positions, options, lods));
+    options = {};
+    options.reductionFactor = 1.f;
+    EXPECT_THROW(MeshSimplifier::buildLods(indices, positions, options, lods));
+    EXPECT_THROW(MeshSimplifier::simplify({0, 1}, positions, 0, 1.f));
+    EXPECT_THROW(MeshSimplifier::simplify({0, 1, 100}, positions, 0, 1.f));
+    EXPECT_THROW(MeshSimplifier::simplify(indices, positions, 0, -1.f));
+}
+} // namespace Falcor
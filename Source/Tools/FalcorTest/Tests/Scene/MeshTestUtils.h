@@ -0,0 +1,89 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#pragma once
+#include "Utils/Math/Vector.h"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace Falcor
+{
+/**
+ * Create a flat grid of n x n quads with two triangles each in the xy-plane, facing +z with counter-clockwise winding.
+ * Vertices in the column x = seam are duplicated for the quads to the right of it if seam > 0, which creates a seam
+ * of coincident but disconnected vertices.
+ */
+inline void createGrid(uint32_t n, std::vector<uint32_t>& indices, std::vector<float3>& positions, uint32_t seam = 0)
+{
+    for (uint32_t y = 0; y <= n; y++)
+        for (uint32_t x = 0; x <= n; x++)
+            positions.push_back(float3(float(x), float(y), 0.f));
+
+    std::vector<uint32_t> seamVertices(n + 1);
+    for (uint32_t y = 0; y <= n && seam > 0; y++)
+    {
+        seamVertices[y] = (uint32_t)positions.size();
+        positions.push_back(float3(float(seam), float(y), 0.f));
+    }
+
+    auto vertex = [&](uint32_t x, uint32_t y, uint32_t quadX)
+    { return (seam > 0 && x == seam && quadX >= seam) ? seamVertices[y] : y * (n + 1) + x; };
+    for (uint32_t y = 0; y < n; y++)
+    {
+        for (uint32_t x = 0; x < n; x++)
+        {
+            uint32_t v0 = vertex(x, y, x), v1 = vertex(x + 1, y, x), v2 = vertex(x, y + 1, x), v3 = vertex(x + 1, y + 1, x);
+            indices.insert(indices.end(), {v0, v1, v2, v2, v1, v3});
+        }
+    }
+}
+
+/// Create the indices of a grid of n x n quads, see createGrid().
+inline std::vector<uint32_t> createGridIndices(uint32_t n)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(n, indices, positions);
+    return indices;
+}
+
+/// Get the sorted list of triangles, with each triangle rotated to start at its smallest index to preserve the winding.
+inline std::vector<std::array<uint32_t, 3>> getTriangles(const std::vector<uint32_t>& indices)
+{
+    std::vector<std::array<uint32_t, 3>> triangles;
+    for (size_t i = 0; i < indices.size(); i += 3)
+    {
+        std::array<uint32_t, 3> t = {indices[i], indices[i + 1], indices[i + 2]};
+        std::rotate(t.begin(), std::min_element(t.begin(), t.end()), t.end());
+        triangles.push_back(t);
+    }
+    std::sort(triangles.begin(), triangles.end());
+    return triangles;
+}
+} // namespace Falcor
@@ -0,0 +1,242 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "MeshTestUtils.h"
+#include "Scene/MeshletBuilder.h"
+#include "Scene/TriangleMesh.h"
+#include "Core/Platform/OS.h"
+#include <algorithm>
+#include <array>
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+/// Get the mesh-local triangle list indices of a meshlet.
+std::vector<uint32_t> getMeshletIndices(const MeshletBuilder::Meshlets& meshlets, const MeshletDesc& desc)
+{
+    std::vector<uint32_t> indices;
+    for (uint32_t t = 0; t < desc.triangleCount; t++)
+    {
+        uint32_t triangle = meshlets.triangles[desc.triangleOffset + t];
+        for (uint32_t c = 0; c < 3; c++)
+            indices.push_back(meshlets.vertices[desc.vertexOffset + MeshletBuilder::unpackTriangle(triangle, c)]);
+    }
+    return indices;
+}
+
+/// Check that the meshlets cover the mesh, respect the limits and contain their vertices in the bounding sphere.
+void verifyMeshlets(
+    CPUUnitTestContext& ctx,
+    const std::vector<uint32_t>& indices,
+    const std::vector<float3>& positions,
+    const MeshletBuilder::Options& options,
+    const MeshletBuilder::Meshlets& meshlets
+)
+{
+    std::vector<uint32_t> allIndices;
+    uint32_t vertexOffset = 0;
+    uint32_t triangleOffset = 0;
+
+    for (size_t i = 0; i < meshlets.meshlets.size(); i++)
+    {
+        const MeshletDesc& desc = meshlets.meshlets[i];
+        EXPECT_EQ(desc.vertexOffset, vertexOffset) << "i = " << i;
+        EXPECT_EQ(desc.triangleOffset, triangleOffset) << "i = " << i;
+        EXPECT_GT(desc.triangleCount, 0u) << "i = " << i;
+        EXPECT_LE(desc.vertexCount, options.maxVertices) << "i = " << i;
+        EXPECT_LE(desc.triangleCount, options.maxTriangles) << "i = " << i;
+        vertexOffset += desc.vertexCount;
+        triangleOffset += desc.triangleCount;
+
+        for (uint32_t t = 0; t < desc.triangleCount; t++)
+        {
+            uint32_t triangle = meshlets.triangles[desc.triangleOffset + t];
+            for (uint32_t c = 0; c < 3; c++)
+                EXPECT_LT(MeshletBuilder::unpackTriangle(triangle, c), desc.vertexCount) << "i = " << i;
+        }
+
+        std::vector<uint32_t> meshletIndices = getMeshletIndices(meshlets, desc);
+        allIndices.insert(allIndices.end(), meshletIndices.begin(), meshletIndices.end());
+
+        // Allow for rounding in the sphere computation relative to the meshlet size.
+        float epsilon = 1e-4f * std::max(desc.radius, 1.f);
+        for (uint32_t v = 0; v < desc.vertexCount; v++)
+        {
+            float3 p = positions[meshlets.vertices[desc.vertexOffset + v]];
+            EXPECT_LE(length(p - desc.center), desc.radius + epsilon) << "i = " << i;
+        }
+        EXPECT_LE(desc.coneCutoff, 1.f) << "i = " << i;
+    }
+
+    EXPECT_EQ(vertexOffset, meshlets.vertices.size());
+    EXPECT_EQ(triangleOffset, meshlets.triangles.size());
+    EXPECT(getTriangles(allIndices) == getTriangles(indices));
+}
+
+/// Build meshlets for a mesh from one of the bundled scene archives. The mesh is extracted to a temporary file for loading.
+void testBundledMesh(CPUUnitTestContext& ctx, const std::filesystem::path& archivePath, std::string_view name)
+{
+    if (!std::filesystem::exists(archivePath))
+        ctx.skip(fmt::format("Scene archive '{}' not found", archivePath.string()).c_str());
+
+    auto dir = std::filesystem::temp_directory_path() / "falcor_meshlet_test";
+    std::filesystem::create_directories(dir);
+    auto path = dir / name;
+    {
+        std::string content = readFileFromZip(archivePath, name);
+        std::ofstream fs(path, std::ios_base::binary);
+        fs.write(content.data(), content.size());
+    }
+    ref<TriangleMesh> pMesh = TriangleMesh::createFromFile(path);
+    std::filesystem::remove_all(dir);
+    ASSERT(pMesh);
+
+    std::vector<float3> positions;
+    for (const auto& vertex : pMesh->getVertices())
+        positions.push_back(vertex.position);
+    const std::vector<uint32_t>& indices = pMesh->getIndices();
+
+    MeshletBuilder::Options options;
+    MeshletBuilder::Meshlets meshlets;
+    uint32_t count = MeshletBuilder::build(indices, positions, options, meshlets);
+    EXPECT_EQ(count, meshlets.meshlets.size());
+    EXPECT_GE(count, (uint32_t)(indices.size() / 3 + options.maxTriangles - 1) / options.maxTriangles);
+    verifyMeshlets(ctx, indices, positions, options, meshlets);
+}
+} // namespace
+
+CPU_TEST(MeshletBuilder_Grid)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(32, indices, positions);
+
+    for (auto [maxVertices, maxTriangles] : {std::pair(64u, 124u), std::pair(32u, 32u), std::pair(256u, 512u), std::pair(3u, 1u)})
+    {
+        MeshletBuilder::Options options;
+        options.maxVertices = maxVertices;
+        options.maxTriangles = maxTriangles;
+
+        MeshletBuilder::Meshlets meshlets;
+        uint32_t count = MeshletBuilder::build(indices, positions, options, meshlets);
+        EXPECT_EQ(count, meshlets.meshlets.size());
+        verifyMeshlets(ctx, indices, positions, options, meshlets);
+
+        // All meshlets of a flat grid face +z.
+        for (const MeshletDesc& desc : meshlets.meshlets)
+        {
+            EXPECT_GT(desc.coneAxis.z, 0.999f);
+            EXPECT_LT(desc.coneCutoff, 1e-3f);
+        }
+    }
+
+    // Building appends to existing meshlets with offsets relative to the existing data.
+    MeshletBuilder::Options options;
+    MeshletBuilder::Meshlets meshlets;
+    uint32_t first = MeshletBuilder::build(indices, positions, options, meshlets);
+    size_t vertexCount = meshlets.vertices.size();
+    size_t triangleCount = meshlets.triangles.size();
+    uint32_t second = MeshletBuilder::build(indices, positions, options, meshlets);
+    EXPECT_EQ(first, second);
+    ASSERT_EQ(meshlets.meshlets.size(), first + second);
+    EXPECT_EQ(meshlets.meshlets[first].vertexOffset, vertexCount);
+    EXPECT_EQ(meshlets.meshlets[first].triangleOffset, triangleCount);
+    EXPECT(getMeshletIndices(meshlets, meshlets.meshlets[0]) == getMeshletIndices(meshlets, meshlets.meshlets[first]));
+}
+
+CPU_TEST(MeshletBuilder_Bounds)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(4, indices, positions);
+
+    // A flat patch has the cone axis along the normal and is back-facing only when seen from behind.
+    MeshletDesc desc;
+    MeshletBuilder::computeBounds(indices, positions, false, desc);
+    EXPECT_LT(length(desc.coneAxis - float3(0.f, 0.f, 1.f)), 1e-5f);
+    EXPECT_LT(desc.coneCutoff, 1e-3f);
+    EXPECT_LT(length(desc.center - float3(2.f, 2.f, 0.f)), 1e-5f);
+    EXPECT_LT(std::abs(desc.radius - std::sqrt(8.f)), 1e-4f);
+    EXPECT(desc.isBackFacing(float3(2.f, 2.f, -10.f)));
+    EXPECT(!desc.isBackFacing(float3(2.f, 2.f, 10.f)));
+    // The test is conservative for views close to the plane of the patch.
+    EXPECT(!desc.isBackFacing(float3(100.f, 2.f, -0.5f)));
+
+    // Clockwise front faces flip the cone.
+    MeshletBuilder::computeBounds(indices, positions, true, desc);
+    EXPECT_LT(length(desc.coneAxis - float3(0.f, 0.f, -1.f)), 1e-5f);
+    EXPECT(desc.isBackFacing(float3(2.f, 2.f, 10.f)));
+
+    // Opposite-facing triangles cannot be culled.
+    std::vector<uint32_t> doubleSided = {0, 1, 5, 0, 5, 1};
+    MeshletBuilder::computeBounds(doubleSided, positions, false, desc);
+    EXPECT_EQ(desc.coneCutoff, 1.f);
+    EXPECT(!desc.isBackFacing(float3(0.f, 0.f, -10.f)));
+    EXPECT(!desc.isBackFacing(float3(0.f, 0.f, 10.f)));
+
+    // Degenerate triangles do not contribute to the cone.
+    std::vector<uint32_t> degenerate = {0, 1, 5, 0, 1, 1, 0, 1, 2, 3, 3, 3};
+    MeshletBuilder::computeBounds(degenerate, positions, false, desc);
+    EXPECT_LT(length(desc.coneAxis - float3(0.f, 0.f, 1.f)), 1e-5f);
+    EXPECT_LT(desc.coneCutoff, 1e-3f);
+}
+
+CPU_TEST(MeshletBuilder_InvalidOptions)
+{
+    std::vector<uint32_t> indices;
+    std::vector<float3> positions;
+    createGrid(2, indices, positions);
+
+    MeshletBuilder::Meshlets meshlets;
+    MeshletBuilder::Options options;
+    options.maxVertices = MeshletBuilder::kMaxVertexLimit + 1;
+    EXPECT_THROW(MeshletBuilder::build(indices, positions, options, meshlets));
+    options = {};
+    options.maxVertices = 2;
+    EXPECT_THROW(MeshletBuilder::build(indices, positions, options, meshlets));
+    options = {};
+    options.maxTriangles = 0;
+    EXPECT_THROW(MeshletBuilder::build(indices, positions, options, meshlets));
+    options = {};
+    options.maxTriangles = MeshletBuilder::kMaxTriangleLimit + 1;
+    EXPECT_THROW(MeshletBuilder::build(indices, positions, options, meshlets));
+    EXPECT(meshlets.meshlets.empty());
+}
+
+CPU_TEST(MeshletBuilder_Sponza)
+{
+    testBundledMesh(ctx, getProjectDirectory() / "scenes/Sponza_min/sponza.zip", "sponza.obj");
+}
+
+CPU_TEST(MeshletBuilder_Sibenik)
+{
+    testBundledMesh(ctx, getProjectDirectory() / "scenes/Sibenik/sibenik.zip", "sibenik.obj");
+}
+} // namespace Falcor
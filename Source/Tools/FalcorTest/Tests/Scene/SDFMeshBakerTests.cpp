@@ -0,0 +1,158 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SDFs/SDFMeshBaker.h"
+#include "Scene/TriangleMesh.h"
+
+namespace Falcor
+{
+namespace
+{
+float3 getValuePosition(uint32_t index, uint32_t gridWidth)
+{
+    uint32_t w = gridWidth + 1;
+    return float3(index % w, (index / w) % w, index / (w * w)) / float(gridWidth) - 0.5f;
+}
+} // namespace
+
+CPU_TEST(SDFMeshBaker_Sphere)
+{
+    const float radius = 0.3f;
+    const uint32_t gridWidth = 32;
+    ref<TriangleMesh> pMesh = TriangleMesh::createSphere(radius, 128, 64);
+
+    SDFMeshBaker::Options options;
+    options.fitToGrid = false;
+    auto result = SDFMeshBaker::bake(*pMesh, gridWidth, options);
+    ASSERT_EQ(result.cornerValues.size(), (gridWidth + 1) * (gridWidth + 1) * (gridWidth + 1));
+    EXPECT(result.meshToGrid == float4x4::identity());
+
+    const float narrowBand = options.narrowBand / gridWidth;
+    for (uint32_t i = 0; i < result.cornerValues.size(); i++)
+    {
+        float3 p = getValuePosition(i, gridWidth);
+        float expected = length(p) - radius;
+        float value = result.cornerValues[i];
+        if (std::abs(expected) < narrowBand)
+        {
+            // Exact distances inside the narrow band, up to the tessellation error.
+            EXPECT_LE(std::abs(value - expected), 2e-3f) << "i = " << i;
+        }
+        else
+        {
+            // Conservative distances with the correct sign outside the narrow band.
+            EXPECT_EQ(value < 0.f, expected < 0.f) << "i = " << i;
+            EXPECT_LE(std::abs(value), std::abs(expected) + 2e-3f) << "i = " << i;
+        }
+    }
+}
+
+CPU_TEST(SDFMeshBaker_NarrowBand)
+{
+    // Values inside the narrow band do not depend on the band width, values outside are lower bounds.
+    const uint32_t gridWidth = 40;
+    ref<TriangleMesh> pMesh = TriangleMesh::createCube(float3(0.5f, 0.3f, 0.2f));
+
+    SDFMeshBaker::Options options;
+    auto result = SDFMeshBaker::bake(*pMesh, gridWidth, options);
+    options.narrowBand = float(gridWidth);
+    auto exact = SDFMeshBaker::bake(*pMesh, gridWidth, options);
+
+    uint32_t mismatchCount = 0;
+    for (uint32_t i = 0; i < result.cornerValues.size(); i++)
+    {
+        float value = result.cornerValues[i];
+        float exactValue = exact.cornerValues[i];
+        if (std::abs(exactValue) * gridWidth < 4.f)
+            mismatchCount += value != exactValue;
+        else
+            mismatchCount += (value < 0.f) != (exactValue < 0.f) || std::abs(value) > std::abs(exactValue) + 1e-5f;
+    }
+    EXPECT_EQ(mismatchCount, 0);
+}
+
+CPU_TEST(SDFMeshBaker_FitToGrid)
+{
+    const uint32_t gridWidth = 16;
+    ref<TriangleMesh> pMesh = TriangleMesh::createCube(float3(4.f));
+    pMesh->applyTransform(math::matrixFromTranslation(float3(10.f, 0.f, -3.f)));
+
+    SDFMeshBaker::Options options;
+    options.padding = 2.f;
+    auto result = SDFMeshBaker::bake(*pMesh, gridWidth, options);
+
+    // The cube is scaled to leave two voxels on each side.
+    float3 minPoint = transformPoint(result.meshToGrid, float3(8.f, -2.f, -5.f));
+    float3 maxPoint = transformPoint(result.meshToGrid, float3(12.f, 2.f, -1.f));
+    EXPECT_LE(length(minPoint - float3(-0.375f)), 1e-5f);
+    EXPECT_LE(length(maxPoint - float3(0.375f)), 1e-5f);
+
+    // Center value is the distance to the faces, corners are outside.
+    uint32_t w = gridWidth + 1;
+    EXPECT_LE(std::abs(result.cornerValues[gridWidth / 2 * (1 + w + w * w)] + 0.375f), 1e-5f);
+    EXPECT_GT(result.cornerValues[0], 0.f);
+    EXPECT_GT(result.cornerValues.back(), 0.f);
+
+    // The padding must leave room for the mesh.
+    options.padding = 8.f;
+    EXPECT_THROW(SDFMeshBaker::bake(*pMesh, gridWidth, options));
+    options.padding = -1.f;
+    EXPECT_THROW(SDFMeshBaker::bake(*pMesh, gridWidth, options));
+    options.padding = 2.f;
+    EXPECT_THROW(SDFMeshBaker::bake(*pMesh, 4, options));
+    options.padding = 1.f;
+    result = SDFMeshBaker::bake(*pMesh, 4, options);
+    EXPECT_LE(length(transformPoint(result.meshToGrid, float3(12.f, 2.f, -1.f)) - float3(0.25f)), 1e-5f);
+}
+
+CPU_TEST(SDFMeshBaker_OpenMesh)
+{
+    // A cube with a missing face is still inside/outside classified by the winding number.
+    ref<TriangleMesh> pMesh = TriangleMesh::createCube(float3(0.5f));
+    std::vector<float3> positions;
+    for (const auto& v : pMesh->getVertices())
+        positions.push_back(v.position);
+    std::vector<uint32_t> indices(pMesh->getIndices().begin() + 6, pMesh->getIndices().end());
+
+    const uint32_t gridWidth = 16;
+    SDFMeshBaker::Options options;
+    options.fitToGrid = false;
+    auto result = SDFMeshBaker::bake(positions, indices, gridWidth, options);
+
+    uint32_t w = gridWidth + 1;
+    EXPECT_LT(result.cornerValues[gridWidth / 2 * (1 + w + w * w)], 0.f);
+    EXPECT_GT(result.cornerValues[0], 0.f);
+
+    // Clockwise winding flips the orientation of all triangles, but not the sign convention.
+    options.frontFaceCW = true;
+    for (size_t i = 0; i < indices.size(); i += 3)
+        std::swap(indices[i + 1], indices[i + 2]);
+    auto flipped = SDFMeshBaker::bake(positions, indices, gridWidth, options);
+    EXPECT(flipped.cornerValues == result.cornerValues);
+}
+} // namespace Falcor
@@ -0,0 +1,86 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuildReport.h"
+#include "Core/Platform/OS.h"
+#include <nlohmann/json.hpp>
+#include <memory>
+#include <vector>
+
+namespace Falcor
+{
+CPU_TEST(SceneBuildReport_Stages)
+{
+    SceneBuildReport report;
+    report.setScenePath("test.pyscene");
+
+    std::vector<std::unique_ptr<int>> ptrs;
+    for (int i = 0; i < 100; i++)
+        ptrs.push_back(std::make_unique<int>(i));
+    report.measure("Allocate");
+    ptrs.clear();
+    report.measure("Free");
+
+    const auto& stages = report.getStages();
+    ASSERT_EQ(stages.size(), 2);
+    EXPECT_EQ(stages[0].name, "Allocate");
+    EXPECT_EQ(stages[1].name, "Free");
+    for (const auto& stage : stages)
+    {
+        EXPECT_GE(stage.wallTime, 0.0);
+        EXPECT_GE(stage.cpuTime, 0.0);
+    }
+    if (SceneBuildReport::isAllocationTrackingEnabled())
+        EXPECT_GE(stages[0].allocationCount, 100);
+
+    auto total = report.getTotal();
+    EXPECT_EQ(total.wallTime, stages[0].wallTime + stages[1].wallTime);
+    EXPECT_EQ(total.allocationCount, stages[0].allocationCount + stages[1].allocationCount);
+
+    auto json = nlohmann::json::parse(report.toJsonString());
+    EXPECT_EQ(json["scene"].get<std::string>(), "test.pyscene");
+    ASSERT_EQ(json["stages"].size(), 2);
+    EXPECT_EQ(json["stages"][0]["name"].get<std::string>(), "Allocate");
+    EXPECT_EQ(json["stages"][0]["allocationCount"].is_null(), !SceneBuildReport::isAllocationTrackingEnabled());
+
+    report.reset();
+    EXPECT_EQ(report.getStages().size(), 0);
+}
+
+CPU_TEST(SceneBuildReport_ProcessStats)
+{
+    EXPECT_GT(getCurrentRSS(), 0);
+    EXPECT_GE(getPeakRSS(), getCurrentRSS());
+
+    double start = getProcessCpuTime();
+    volatile double sum = 0.0;
+    for (int i = 0; i < 1000000; i++)
+        sum = sum + i;
+    EXPECT_GE(getProcessCpuTime(), start);
+}
+}
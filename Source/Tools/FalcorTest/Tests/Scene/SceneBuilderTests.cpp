@@ -0,0 +1,136 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneBuilder.h"
+#include "Scene/Material/StandardMaterial.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include <cstring>
+#include <iterator>
+#include <random>
+#include <set>
+
+namespace Falcor
+{
+namespace
+{
+/// Build a scene with a random node hierarchy. Nodes share a few transforms, so that the scene graph optimization
+/// collapses chains and merges identical nodes, and some meshes are large enough to be pretransformed in parallel over vertices.
+ref<Scene> buildRandomScene(ref<Device> pDevice)
+{
+    const uint32_t kNodeCount = 400;
+    const uint32_t kMeshCount = 100;
+
+    std::mt19937 rng(1);
+    auto randomIndex = [&](uint32_t count) { return std::uniform_int_distribution<uint32_t>(0, count - 1)(rng); };
+
+    SceneBuilder builder(pDevice, Settings(), SceneBuilder::Flags::None);
+
+    const float4x4 transforms[] = {
+        float4x4::identity(),
+        math::matrixFromTranslation(float3(1.f, 0.f, 0.f)),
+        math::matrixFromRotation(0.5f, float3(0.f, 1.f, 0.f)),
+        math::matrixFromScaling(float3(2.f)),
+        math::matrixFromScaling(float3(-1.f, 1.f, 1.f)),
+    };
+    std::vector<NodeID> nodeIDs;
+    for (uint32_t i = 0; i < kNodeCount; i++)
+    {
+        NodeID parent = i == 0 || randomIndex(10) == 0 ? NodeID::Invalid() : nodeIDs[randomIndex(i)];
+        nodeIDs.push_back(builder.addNode(SceneBuilder::Node{ "Node" + std::to_string(i), transforms[randomIndex(std::size(transforms))], float4x4::identity(), float4x4::identity(), parent }));
+    }
+
+    for (uint32_t i = 0; i < 10; i++)
+    {
+        auto pAnimation = Animation::create("Animation" + std::to_string(i), nodeIDs[randomIndex(kNodeCount)], 1.0);
+        pAnimation->addKeyframe(Animation::Keyframe{ 0.0, float3(0.f) });
+        pAnimation->addKeyframe(Animation::Keyframe{ 1.0, float3(1.f) });
+        builder.addAnimation(pAnimation);
+    }
+
+    const ref<Material> materials[] = {
+        StandardMaterial::create(pDevice, "Material0"),
+        StandardMaterial::create(pDevice, "Material1"),
+    };
+    const ref<TriangleMesh> triangleMeshes[] = {
+        TriangleMesh::createCube(),
+        TriangleMesh::createSphere(0.5f, 16, 8),
+        TriangleMesh::createSphere(0.5f, 512, 256),
+    };
+    for (uint32_t i = 0; i < kMeshCount; i++)
+    {
+        // Only a few meshes are large to keep the test fast.
+        const uint32_t meshType = i % 20 == 0 ? 2 : randomIndex(2);
+        MeshID meshID = builder.addTriangleMesh(triangleMeshes[meshType], materials[randomIndex(std::size(materials))]);
+        std::set<NodeID> instances;
+        const uint32_t instanceCount = randomIndex(4) == 0 ? 3 : 1;
+        while (instances.size() < instanceCount) instances.insert(nodeIDs[randomIndex(kNodeCount)]);
+        for (NodeID nodeID : instances) builder.addMeshInstance(nodeID, meshID);
+    }
+
+    builder.addCamera(Camera::create("Camera"));
+    return builder.getScene();
+}
+} // namespace
+
+GPU_TEST(SceneBuilder_ParallelMatchesSerial)
+{
+    // The build stages run in parallel by default. Building the same scene serially must produce the same
+    // scene graph, the same allocation of meshes in the vertex and index buffers, and the same instance bindings.
+    ref<Scene> pParallel = buildRandomScene(ctx.getDevice());
+    ref<Scene> pSerial;
+    {
+        parallel::ScopedSerialExecution serial;
+        pSerial = buildRandomScene(ctx.getDevice());
+    }
+    ASSERT(pParallel && pSerial);
+    pParallel->update(ctx.getRenderContext(), 0.0);
+    pSerial->update(ctx.getRenderContext(), 0.0);
+
+    // Scene graph.
+    const auto& parallelMatrices = pParallel->getAnimationController()->getGlobalMatrices();
+    const auto& serialMatrices = pSerial->getAnimationController()->getGlobalMatrices();
+    ASSERT_EQ(parallelMatrices.size(), serialMatrices.size());
+    EXPECT(std::memcmp(parallelMatrices.data(), serialMatrices.data(), parallelMatrices.size() * sizeof(float4x4)) == 0);
+
+    // Mesh order and allocation in the global buffers.
+    ASSERT_EQ(pParallel->getMeshCount(), pSerial->getMeshCount());
+    for (uint32_t i = 0; i < pParallel->getMeshCount(); i++)
+    {
+        EXPECT_EQ(pParallel->getMeshName(i), pSerial->getMeshName(i)) << "mesh = " << i;
+        EXPECT(std::memcmp(&pParallel->getMesh(MeshID{ i }), &pSerial->getMesh(MeshID{ i }), sizeof(MeshDesc)) == 0) << "mesh = " << i;
+        EXPECT(std::memcmp(&pParallel->getMeshBounds(i), &pSerial->getMeshBounds(i), sizeof(AABB)) == 0) << "mesh = " << i;
+    }
+
+    // Instance bindings to nodes, meshes and materials.
+    ASSERT_EQ(pParallel->getGeometryInstanceCount(), pSerial->getGeometryInstanceCount());
+    for (uint32_t i = 0; i < pParallel->getGeometryInstanceCount(); i++)
+    {
+        EXPECT(std::memcmp(&pParallel->getGeometryInstance(i), &pSerial->getGeometryInstance(i), sizeof(GeometryInstanceData)) == 0) << "instance = " << i;
+    }
+}
+} // namespace Falcor
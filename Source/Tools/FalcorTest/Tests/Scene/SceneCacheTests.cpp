@@ -0,0 +1,82 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Scene/SceneCache.h"
+#include <fstream>
+
+namespace Falcor
+{
+namespace
+{
+void writeFile(const std::filesystem::path& path, const std::string& content)
+{
+    std::ofstream fs(path, std::ios_base::binary);
+    fs.write(content.data(), content.size());
+}
+} // namespace
+
+CPU_TEST(SceneCacheDependencies)
+{
+    auto dir = std::filesystem::temp_directory_path() / "falcor_scene_cache_test";
+    std::filesystem::create_directories(dir);
+    auto pathA = dir / "a.txt";
+    auto pathB = dir / "b.txt";
+    writeFile(pathA, "scene file");
+    writeFile(pathB, "texture file");
+
+    // Missing files are skipped.
+    auto dependencies = SceneCache::collectDependencies({pathA, pathB, dir / "missing.txt"});
+    ASSERT_EQ(dependencies.size(), 2u);
+    EXPECT_EQ(dependencies[0].path, std::filesystem::absolute(pathA));
+    EXPECT_EQ(dependencies[0].size, 10u);
+    EXPECT_EQ(dependencies[1].hash, ContentHash::compute("texture file", 12));
+    EXPECT(SceneCache::validateDependencies(dependencies));
+    EXPECT(SceneCache::validateDependencies({}));
+
+    // Touching a file without changing its content keeps the dependencies valid.
+    std::filesystem::last_write_time(pathA, std::filesystem::last_write_time(pathA) + std::chrono::seconds(10));
+    EXPECT(SceneCache::validateDependencies(dependencies));
+
+    // Changing the content with the same size invalidates the dependencies.
+    writeFile(pathB, "TEXTURE FILE");
+    std::filesystem::last_write_time(pathB, std::filesystem::last_write_time(pathB) + std::chrono::seconds(10));
+    EXPECT(!SceneCache::validateDependencies(dependencies));
+
+    // Changing the size invalidates the dependencies.
+    writeFile(pathB, "texture");
+    EXPECT(!SceneCache::validateDependencies(dependencies));
+
+    // Removing a file invalidates the dependencies.
+    writeFile(pathB, "texture file");
+    EXPECT(SceneCache::validateDependencies(dependencies));
+    std::filesystem::remove(pathA);
+    EXPECT(!SceneCache::validateDependencies(dependencies));
+
+    std::filesystem::remove_all(dir);
+}
+} // namespace Falcor
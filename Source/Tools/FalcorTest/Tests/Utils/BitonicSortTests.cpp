@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Algorithm/BitonicSort.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
 #include <random>
 
 namespace Falcor
@@ -63,6 +64,18 @@ void testGpuSort(GPUUnitTestContext& ctx, BitonicSort& bitonicSort, const uint32
     bool retval = bitonicSort.execute(ctx.getRenderContext(), pTestDataBuffer, n, chunkSize, groupSize);
     EXPECT_EQ(retval, true);
 
+    // Sort the chunks on the host with the parallel radix sort.
+    std::vector<uint32_t> hostResult = testData;
+    parallel::forEach(
+        (n + chunkSize - 1) / chunkSize,
+        [&](size_t chunk)
+        {
+            size_t first = chunk * chunkSize;
+            parallel::radixSort(hostResult.data() + first, std::min<size_t>(chunkSize, n - first));
+        },
+        1
+    );
+
     // Sort the test data on the CPU for comparison.
     bitonicSortRef(testData, chunkSize);
 
@@ -71,6 +84,7 @@ void testGpuSort(GPUUnitTestContext& ctx, BitonicSort& bitonicSort, const uint32
     for (uint32_t i = 0; i < n; i++)
     {
         EXPECT_EQ(testData[i], result[i]) << "i = " << i;
+        EXPECT_EQ(hostResult[i], result[i]) << "i = " << i;
     }
 }
 } // namespace
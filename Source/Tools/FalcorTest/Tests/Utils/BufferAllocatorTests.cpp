@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/BufferAllocator.h"
+#include <algorithm>
 
 namespace Falcor
 {
@@ -313,4 +314,114 @@ GPU_TEST(BufferAllocatorStructAlign)
     }
 }
 
+CPU_TEST(BufferAllocatorDirtyRanges)
+{
+    using Range = BufferAllocator::Range;
+
+    BufferAllocator buf(0, 0, 0);
+    buf.allocate(4096);
+    EXPECT_EQ(buf.getDirtyRanges().size(), 0);
+
+    // Disjoint ranges are kept separate and sorted.
+    buf.modified(1000, 8);
+    buf.modified(0, 4);
+    buf.modified(4092, 4);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 4}, {1000, 1008}, {4092, 4096}}));
+
+    // Overlapping and adjacent ranges are merged.
+    buf.modified(1004, 8);
+    buf.modified(996, 4);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 4}, {996, 1012}, {4092, 4096}}));
+
+    // A range spanning several dirty ranges merges them all.
+    buf.modified(2, 1000);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 1012}, {4092, 4096}}));
+
+    // Ranges contained in a dirty range don't change anything.
+    buf.modified(100, 10);
+    buf.modified(4092, 4);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 1012}, {4092, 4096}}));
+
+    // Empty ranges are ignored.
+    buf.modified(2000, 0);
+    EXPECT(buf.getDirtyRanges() == std::vector<Range>({{0, 1012}, {4092, 4096}}));
+
+    buf.clear();
+    EXPECT_EQ(buf.getDirtyRanges().size(), 0);
+}
+
+CPU_TEST(BufferAllocatorUploadRanges)
+{
+    using Range = BufferAllocator::Range;
+
+    BufferAllocator buf(0, 0, 0);
+    buf.allocate(4096);
+    EXPECT_EQ(buf.getUploadGapThreshold(), BufferAllocator::kDefaultUploadGapThreshold);
+    EXPECT_EQ(buf.getUploadRanges().size(), 0);
+
+    buf.modified(0, 16);
+    buf.modified(64, 16);   // Gap of 48 bytes to the previous range.
+    buf.modified(1024, 16); // Gap of 944 bytes.
+    buf.modified(1104, 16); // Gap of 64 bytes.
+    buf.modified(4080, 16); // Gap of 2960 bytes.
+
+    // Ranges with gaps below the threshold are coalesced.
+    buf.setUploadGapThreshold(64);
+    EXPECT(buf.getUploadRanges() == std::vector<Range>({{0, 80}, {1024, 1040}, {1104, 1120}, {4080, 4096}}));
+    buf.setUploadGapThreshold(65);
+    EXPECT(buf.getUploadRanges() == std::vector<Range>({{0, 80}, {1024, 1120}, {4080, 4096}}));
+    buf.setUploadGapThreshold(1024);
+    EXPECT(buf.getUploadRanges() == std::vector<Range>({{0, 1120}, {4080, 4096}}));
+    buf.setUploadGapThreshold(4096);
+    EXPECT(buf.getUploadRanges() == std::vector<Range>({{0, 4096}}));
+
+    // A threshold of zero only keeps the merged dirty ranges.
+    buf.setUploadGapThreshold(0);
+    EXPECT(buf.getUploadRanges() == buf.getDirtyRanges());
+
+    // Coalescing doesn't change the tracked dirty ranges.
+    EXPECT_EQ(buf.getDirtyRanges().size(), 5);
+}
+
+GPU_TEST(BufferAllocatorSparseUpload)
+{
+    BufferAllocator buf(0, 0, 0);
+    buf.setUploadGapThreshold(64);
+
+    const size_t count = 16384;
+    size_t offset = buf.allocate<uint32_t>(count);
+    EXPECT_EQ(offset, 0);
+    for (uint32_t i = 0; i < count; i++)
+        buf.set<uint32_t>(i * sizeof(uint32_t), i);
+
+    // The first update uploads the whole buffer.
+    ref<Buffer> pBuffer = buf.getGPUBuffer(ctx.getDevice());
+    EXPECT_EQ(buf.getStats().uploadCount, 1);
+    EXPECT_EQ(buf.getStats().bytesUploaded, count * sizeof(uint32_t));
+    EXPECT_EQ(buf.getDirtyRanges().size(), 0);
+    buf.resetStats();
+
+    // Modify the first and last element and a few elements in between.
+    const std::vector<uint32_t> modified = {0, 5, 8, 1000, 1001, count - 1};
+    for (uint32_t i : modified)
+        buf.set<uint32_t>(i * sizeof(uint32_t), i + 1000000);
+
+    pBuffer = buf.getGPUBuffer(ctx.getDevice());
+
+    // Only the coalesced dirty ranges are uploaded: [0,36), [4000,4008) and the last element.
+    const BufferAllocator::Stats& stats = buf.getStats();
+    EXPECT_EQ(stats.uploadCount, 1);
+    EXPECT_EQ(stats.regionCount, 3);
+    EXPECT_EQ(stats.bytesDirty, modified.size() * sizeof(uint32_t));
+    EXPECT_EQ(stats.bytesUploaded, 36 + 8 + 4);
+    EXPECT_EQ(buf.getDirtyRanges().size(), 0);
+
+    std::vector<uint32_t> data = pBuffer->getElements<uint32_t>(0, count);
+    for (uint32_t i = 0; i < count; i++)
+    {
+        bool isModified = std::find(modified.begin(), modified.end(), i) != modified.end();
+        EXPECT_EQ(data[i], isModified ? i + 1000000 : i) << "i=" << i;
+    }
+}
+
 } // namespace Falcor
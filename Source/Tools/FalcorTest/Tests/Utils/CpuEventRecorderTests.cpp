@@ -0,0 +1,191 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Timing/CpuEventRecorder.h"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <thread>
+
+namespace Falcor
+{
+CPU_TEST(CpuEventRecorder_RegisterEvent)
+{
+    auto id0 = CpuEventRecorder::registerEvent("CpuEventRecorderTest_A");
+    auto id1 = CpuEventRecorder::registerEvent("CpuEventRecorderTest_B");
+    EXPECT_NE(id0, id1);
+    EXPECT_EQ(CpuEventRecorder::registerEvent("CpuEventRecorderTest_A"), id0);
+    EXPECT_EQ(CpuEventRecorder::getEventName(id0), "CpuEventRecorderTest_A");
+    EXPECT_EQ(CpuEventRecorder::getEventName(id1), "CpuEventRecorderTest_B");
+}
+
+CPU_TEST(CpuEventRecorder_Threads)
+{
+    const uint32_t kThreadCount = 4;
+    const uint32_t kEventsPerThread = 100;
+
+    bool wasEnabled = CpuEventRecorder::isEnabled();
+    CpuEventRecorder::setEnabled(true);
+    uint64_t startTime = CpuEventRecorder::getTimestamp();
+
+    auto eventId = CpuEventRecorder::registerEvent("CpuEventRecorderTest_Work");
+
+    std::vector<std::thread> threads;
+    for (uint32_t i = 0; i < kThreadCount; ++i)
+    {
+        threads.emplace_back(
+            [=]()
+            {
+                CpuEventRecorder::setThreadName(fmt::format("CpuEventRecorderTest {}", i));
+                for (uint32_t j = 0; j < kEventsPerThread; ++j)
+                {
+                    ScopedCpuEvent event(eventId);
+                }
+            }
+        );
+    }
+    for (auto& thread : threads)
+        thread.join();
+
+    auto tracks = CpuEventRecorder::collect(startTime);
+    CpuEventRecorder::setEnabled(wasEnabled);
+
+    uint32_t testThreadCount = 0;
+    for (const auto& track : tracks)
+    {
+        if (track.threadName.rfind("CpuEventRecorderTest", 0) != 0)
+            continue;
+        testThreadCount++;
+        EXPECT_EQ(track.records.size(), kEventsPerThread);
+        for (size_t i = 0; i < track.records.size(); ++i)
+        {
+            const auto& record = track.records[i];
+            EXPECT_EQ(record.eventId, eventId);
+            EXPECT_GE(record.startTime, startTime);
+            EXPECT_LE(record.startTime, record.endTime);
+            if (i > 0)
+                EXPECT_LE(track.records[i - 1].startTime, record.startTime);
+        }
+    }
+    EXPECT_EQ(testThreadCount, kThreadCount);
+
+    // Export to Chrome trace events.
+    nlohmann::json traceEvents = nlohmann::json::array();
+    CpuEventRecorder::appendChromeTraceEvents(traceEvents, tracks, 1);
+    size_t completeEvents = 0;
+    for (const auto& event : traceEvents)
+    {
+        if (event["ph"] == "X" && event["name"] == "CpuEventRecorderTest_Work")
+            completeEvents++;
+    }
+    EXPECT_EQ(completeEvents, kThreadCount * kEventsPerThread);
+}
+
+CPU_TEST(CpuEventRecorder_Disabled)
+{
+    bool wasEnabled = CpuEventRecorder::isEnabled();
+    CpuEventRecorder::setEnabled(false);
+    uint64_t startTime = CpuEventRecorder::getTimestamp();
+
+    auto eventId = CpuEventRecorder::registerEvent("CpuEventRecorderTest_Disabled");
+    std::thread(
+        [=]()
+        {
+            CpuEventRecorder::setThreadName("CpuEventRecorderTest_Disabled");
+            ScopedCpuEvent event(eventId);
+        }
+    ).join();
+
+    auto tracks = CpuEventRecorder::collect(startTime);
+    CpuEventRecorder::setEnabled(wasEnabled);
+
+    for (const auto& track : tracks)
+        EXPECT_NE(track.threadName, "CpuEventRecorderTest_Disabled");
+}
+
+CPU_TEST(CpuEventRecorder_RingBuffer)
+{
+    bool wasEnabled = CpuEventRecorder::isEnabled();
+    CpuEventRecorder::setEnabled(true);
+
+    auto eventId = CpuEventRecorder::registerEvent("CpuEventRecorderTest_RingBuffer");
+    const size_t kCount = CpuEventRecorder::kRecordsPerThread + 100;
+    std::thread(
+        [=]()
+        {
+            CpuEventRecorder::setThreadName("CpuEventRecorderTest_RingBuffer");
+            for (size_t i = 0; i < kCount; ++i)
+                CpuEventRecorder::record(eventId, i, i + 1);
+        }
+    ).join();
+
+    auto tracks = CpuEventRecorder::collect();
+    CpuEventRecorder::setEnabled(wasEnabled);
+
+    bool found = false;
+    for (const auto& track : tracks)
+    {
+        if (track.threadName != "CpuEventRecorderTest_RingBuffer")
+            continue;
+        found = true;
+        // Only the most recent records are kept.
+        ASSERT_EQ(track.records.size(), CpuEventRecorder::kRecordsPerThread);
+        EXPECT_EQ(track.records.front().startTime, kCount - CpuEventRecorder::kRecordsPerThread);
+        EXPECT_EQ(track.records.back().startTime, kCount - 1);
+    }
+    EXPECT(found);
+}
+
+CPU_TEST(CpuEventRecorder_ExitedThreads)
+{
+    bool wasEnabled = CpuEventRecorder::isEnabled();
+    CpuEventRecorder::setEnabled(true);
+    uint64_t startTime = CpuEventRecorder::getTimestamp();
+
+    auto eventId = CpuEventRecorder::registerEvent("CpuEventRecorderTest_ExitedThreads");
+    std::thread(
+        [=]()
+        {
+            CpuEventRecorder::setThreadName("CpuEventRecorderTest_ExitedThreads");
+            ScopedCpuEvent event(eventId);
+        }
+    ).join();
+
+    auto countTracks = [](const std::vector<CpuEventRecorder::ThreadTrack>& tracks)
+    {
+        return std::count_if(
+            tracks.begin(), tracks.end(), [](const auto& track) { return track.threadName == "CpuEventRecorderTest_ExitedThreads"; }
+        );
+    };
+
+    // The records of an exited thread are returned once, after which its buffer is released.
+    EXPECT_EQ(countTracks(CpuEventRecorder::collect(startTime)), 1);
+    EXPECT_EQ(countTracks(CpuEventRecorder::collect(startTime)), 0);
+
+    CpuEventRecorder::setEnabled(wasEnabled);
+}
+} // namespace Falcor
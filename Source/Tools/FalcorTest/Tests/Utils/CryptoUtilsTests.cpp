@@ -27,7 +27,9 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/CryptoUtils.h"
+#include <fstream>
 #include <random>
+#include <set>
 
 namespace Falcor
 {
@@ -59,4 +61,60 @@ CPU_TEST(SHA1)
         EXPECT(SHA1::compute(str.data(), str.size()) == md);
     }
 }
+
+CPU_TEST(ContentHash)
+{
+    std::mt19937 rng(0);
+    std::vector<uint8_t> data(5 * ContentHash::kChunkSize + 123);
+    for (auto& v : data)
+        v = (uint8_t)rng();
+
+    // Hashes of different lengths (crossing lane, stripe and chunk boundaries) are distinct.
+    std::set<uint64_t> hashes;
+    const size_t lengths[] = {0, 1, 3, 4, 7, 8, 31, 32, 33, 1000, ContentHash::kChunkSize, ContentHash::kChunkSize + 1, data.size()};
+    for (size_t len : lengths)
+    {
+        uint64_t hash = ContentHash::compute(data.data(), len);
+        EXPECT_EQ(hash, ContentHash::compute(data.data(), len));
+        hashes.insert(hash);
+    }
+    EXPECT_EQ(hashes.size(), std::size(lengths));
+
+    // Flipping a single bit in any chunk changes the hash.
+    const uint64_t hash = ContentHash::compute(data.data(), data.size());
+    for (size_t offset : {size_t(0), ContentHash::kChunkSize - 1, 3 * ContentHash::kChunkSize + 17, data.size() - 1})
+    {
+        data[offset] ^= 0x10;
+        EXPECT_NE(ContentHash::compute(data.data(), data.size()), hash) << "offset=" << offset;
+        data[offset] ^= 0x10;
+    }
+
+    // Swapping two chunks changes the hash.
+    std::vector<uint8_t> swapped = data;
+    std::swap_ranges(swapped.begin(), swapped.begin() + ContentHash::kChunkSize, swapped.begin() + ContentHash::kChunkSize);
+    EXPECT_NE(ContentHash::compute(swapped.data(), swapped.size()), hash);
+
+    EXPECT_EQ(ContentHash::toString(0x0123456789abcdefull), "0123456789abcdef");
+}
+
+CPU_TEST(ContentHashFile)
+{
+    std::mt19937 rng(1);
+    std::vector<uint8_t> data(70 * ContentHash::kChunkSize + 5);
+    for (auto& v : data)
+        v = (uint8_t)rng();
+
+    auto path = std::filesystem::temp_directory_path() / "falcor_content_hash_test.bin";
+    for (size_t len : {size_t(0), size_t(100), 64 * ContentHash::kChunkSize, data.size()})
+    {
+        {
+            std::ofstream fs(path, std::ios_base::binary);
+            fs.write(reinterpret_cast<const char*>(data.data()), len);
+        }
+        EXPECT_EQ(ContentHash::computeFile(path), ContentHash::compute(data.data(), len)) << "len=" << len;
+    }
+    std::filesystem::remove(path);
+
+    EXPECT_THROW(ContentHash::computeFile(path));
+}
 } // namespace Falcor
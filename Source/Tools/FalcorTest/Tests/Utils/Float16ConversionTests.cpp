@@ -0,0 +1,157 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Logger.h"
+#include "Utils/Math/Float16.h"
+#include "Utils/Timing/CpuTimer.h"
+#include <fstd/bit.h> // TODO C++20: Replace with <bit>
+#include <cstring>
+#include <limits>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+/// Checks that the batch conversion of floats to halfs matches the scalar conversion bit-exactly.
+void testFloat32ToFloat16(CPUUnitTestContext& ctx, const std::vector<float>& values)
+{
+    std::vector<uint16_t> result(values.size());
+    math::float32ToFloat16(values, result);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        EXPECT_EQ(result[i], math::float32ToFloat16(values[i])) << "value = 0x" << std::hex << fstd::bit_cast<uint32_t>(values[i]);
+    }
+}
+} // namespace
+
+CPU_TEST(Float16Conversion_Float16ToFloat32)
+{
+    // Test all half floats, including denormals, infinities and NaNs.
+    std::vector<uint16_t> values(65536);
+    for (uint32_t i = 0; i < values.size(); ++i)
+        values[i] = uint16_t(i);
+
+    std::vector<float> result(values.size());
+    math::float16ToFloat32(values, result);
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        uint32_t expected = fstd::bit_cast<uint32_t>(math::float16ToFloat32(values[i]));
+        EXPECT_EQ(fstd::bit_cast<uint32_t>(result[i]), expected) << "value = 0x" << std::hex << values[i];
+    }
+}
+
+CPU_TEST(Float16Conversion_Float32ToFloat16)
+{
+    // Test the float value of each half float, the rounding ties halfway to the next half and their neighbors.
+    std::vector<float> values;
+    for (uint32_t i = 0; i < 65536; ++i)
+    {
+        uint32_t bits = fstd::bit_cast<uint32_t>(math::float16ToFloat32(uint16_t(i)));
+        for (uint32_t b : {bits, bits + 0x1000, bits + 0x0fff, bits + 0x1001, bits - 1, bits + 1})
+            values.push_back(fstd::bit_cast<float>(b));
+    }
+    testFloat32ToFloat16(ctx, values);
+
+    // Test special values.
+    testFloat32ToFloat16(
+        ctx,
+        {
+            0.f,
+            -0.f,
+            std::numeric_limits<float>::infinity(),
+            -std::numeric_limits<float>::infinity(),
+            std::numeric_limits<float>::quiet_NaN(),
+            std::numeric_limits<float>::signaling_NaN(),
+            std::numeric_limits<float>::max(),
+            std::numeric_limits<float>::lowest(),
+            std::numeric_limits<float>::min(),
+            std::numeric_limits<float>::denorm_min(),
+            65504.f,
+            65519.f,
+            65520.f,
+            -65520.f,
+            fstd::bit_cast<float>(0x7f800001u),
+            fstd::bit_cast<float>(0xffc12345u),
+        }
+    );
+
+    // Test random bit patterns.
+    std::mt19937 rng;
+    std::vector<float> randomValues(1 << 20);
+    for (auto& v : randomValues)
+        v = fstd::bit_cast<float>(uint32_t(rng()));
+    testFloat32ToFloat16(ctx, randomValues);
+}
+
+CPU_TEST(Float16Conversion_Benchmark)
+{
+    const size_t kCount = 1 << 22;
+    const int kIterations = 4;
+
+    std::mt19937 rng;
+    std::uniform_real_distribution<float> dist(-1000.f, 1000.f);
+    std::vector<float> values(kCount);
+    for (auto& v : values)
+        v = dist(rng);
+
+    std::vector<uint16_t> scalarHalfs(kCount);
+    std::vector<uint16_t> batchHalfs(kCount);
+    std::vector<float> scalarFloats(kCount);
+    std::vector<float> batchFloats(kCount);
+
+    auto t0 = CpuTimer::getCurrentTimePoint();
+    for (int iter = 0; iter < kIterations; ++iter)
+    {
+        for (size_t i = 0; i < kCount; ++i)
+            scalarHalfs[i] = math::float32ToFloat16(values[i]);
+        for (size_t i = 0; i < kCount; ++i)
+            scalarFloats[i] = math::float16ToFloat32(scalarHalfs[i]);
+    }
+    auto t1 = CpuTimer::getCurrentTimePoint();
+    for (int iter = 0; iter < kIterations; ++iter)
+    {
+        math::float32ToFloat16(values, batchHalfs);
+        math::float16ToFloat32(batchHalfs, batchFloats);
+    }
+    auto t2 = CpuTimer::getCurrentTimePoint();
+
+    EXPECT(scalarHalfs == batchHalfs);
+    EXPECT(std::memcmp(scalarFloats.data(), batchFloats.data(), kCount * sizeof(float)) == 0);
+
+    double scalarTime = CpuTimer::calcDuration(t0, t1) / kIterations;
+    double batchTime = CpuTimer::calcDuration(t1, t2) / kIterations;
+    logInfo(
+        "Converted {} values to fp16 and back: scalar {:.2f} ms, batch {:.2f} ms ({:.1f}x).",
+        kCount,
+        scalarTime,
+        batchTime,
+        scalarTime / batchTime
+    );
+}
+} // namespace Falcor
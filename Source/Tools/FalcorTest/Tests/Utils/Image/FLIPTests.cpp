@@ -0,0 +1,302 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/FLIP.h"
+#include "Utils/Color/ColorHelpers.slang"
+#include "Utils/Math/MathConstants.slangh"
+#include <cmath>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<float> createImage(uint32_t width, uint32_t height, uint32_t seed, float maxValue)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, maxValue);
+    std::vector<float> data(size_t(width) * height * 4);
+    for (auto& v : data)
+        v = dist(rng);
+    return data;
+}
+
+/// Straightforward port of the non-separable 2D filters in FLIPPass.cs.slang.
+class ReferenceFLIP
+{
+public:
+    ReferenceFLIP(const std::vector<float>& ref, const std::vector<float>& test, uint32_t width, uint32_t height, const FLIP::Options& options)
+        : mRef(ref), mTest(test), mWidth(width), mHeight(height), mOptions(options)
+    {}
+
+    float compute(int px, int py, float exposure) const
+    {
+        const float ppd = FLIP::computePixelsPerDegree(mOptions.monitorWidthPixels, mOptions.monitorWidthMeters, mOptions.monitorDistanceMeters);
+        const float dx = 1.f / ppd;
+        const float sigma = 0.5f * kFLIPw * ppd;
+        const float sigma2 = sigma * sigma;
+        const int radius = int(std::ceil(3.f * std::sqrt(0.04f / (2.f * float(M_PI) * float(M_PI))) * ppd));
+
+        double positiveKernelSum = 0.0, negativeKernelSum = 0.0, edgeKernelSum = 0.0;
+        for (int y = -radius; y <= radius; y++)
+        {
+            for (int x = -radius; x <= radius; x++)
+            {
+                double g = std::exp(-(x * x + y * y) / (2.0 * sigma2));
+                double pw = (x * x / sigma2 - 1.0) * g;
+                (pw >= 0.0 ? positiveKernelSum : negativeKernelSum) += std::abs(pw);
+                edgeKernelSum += std::max(-x * g, 0.0);
+            }
+        }
+
+        double csfSum[3] = {}, refSum[3] = {}, testSum[3] = {};
+        double refPoint[2] = {}, refEdge[2] = {}, testPoint[2] = {}, testEdge[2] = {};
+        for (int y = -radius; y <= radius; y++)
+        {
+            for (int x = -radius; x <= radius; x++)
+            {
+                int sx = std::clamp(px + x, 0, int(mWidth) - 1);
+                int sy = std::clamp(py + y, 0, int(mHeight) - 1);
+                float3 refColor = getPixel(mRef, sx, sy, exposure);
+                float3 testColor = getPixel(mTest, sx, sy, exposure);
+
+                double p2 = (x * x + y * y) * dx * dx;
+                double dist2 = -p2 * M_PI * M_PI;
+                const float4 ab[3] = {kFLIPCSFParamsA, kFLIPCSFParamsRG, kFLIPCSFParamsBY};
+                for (int c = 0; c < 3; c++)
+                {
+                    double w = ab[c].x * std::sqrt(M_PI / ab[c].z) * std::exp(dist2 / ab[c].z) +
+                               ab[c].y * std::sqrt(M_PI / ab[c].w) * std::exp(dist2 / ab[c].w);
+                    csfSum[c] += w;
+                    refSum[c] += w * refColor[c];
+                    testSum[c] += w * testColor[c];
+                }
+
+                double g = std::exp(-(x * x + y * y) / (2.0 * sigma2));
+                double pw[2] = {(x * x / sigma2 - 1.0) * g, (y * y / sigma2 - 1.0) * g};
+                double ew[2] = {-x * g, -y * g};
+                double refL = (refColor.x + 16.0) / 116.0;
+                double testL = (testColor.x + 16.0) / 116.0;
+                for (int i = 0; i < 2; i++)
+                {
+                    double pn = pw[i] / (pw[i] >= 0.0 ? positiveKernelSum : negativeKernelSum);
+                    double en = ew[i] / edgeKernelSum;
+                    refPoint[i] += refL * pn;
+                    testPoint[i] += testL * pn;
+                    refEdge[i] += refL * en;
+                    testEdge[i] += testL * en;
+                }
+            }
+        }
+
+        float3 refFiltered(float(refSum[0] / csfSum[0]), float(refSum[1] / csfSum[1]), float(refSum[2] / csfSum[2]));
+        float3 testFiltered(float(testSum[0] / csfSum[0]), float(testSum[1] / csfSum[1]), float(testSum[2] / csfSum[2]));
+        refFiltered = clamp(YCxCzToLinearRGB(refFiltered), float3(0.f), float3(1.f));
+        testFiltered = clamp(YCxCzToLinearRGB(testFiltered), float3(0.f), float3(1.f));
+        double colorDiff = HyAB(Hunt(linearRGBToCIELab(refFiltered)), Hunt(linearRGBToCIELab(testFiltered)));
+
+        double edgeDiff = std::abs(std::hypot(refEdge[0], refEdge[1]) - std::hypot(testEdge[0], testEdge[1]));
+        double pointDiff = std::abs(std::hypot(refPoint[0], refPoint[1]) - std::hypot(testPoint[0], testPoint[1]));
+        double featureDiff = std::pow(std::max(pointDiff, edgeDiff) * M_SQRT1_2, kFLIPqf);
+
+        double maxDistance = std::pow(HyAB(Hunt(linearRGBToCIELab(float3(0, 1, 0))), Hunt(linearRGBToCIELab(float3(0, 0, 1)))), kFLIPqc);
+        double error = std::pow(colorDiff, kFLIPqc);
+        double cutoff = kFLIPpc * maxDistance;
+        if (error < cutoff)
+            error *= kFLIPpt / cutoff;
+        else
+            error = kFLIPpt + (error - cutoff) / (maxDistance - cutoff) * (1.0 - kFLIPpt);
+        return float(std::pow(error, 1.0 - featureDiff));
+    }
+
+private:
+    float3 getPixel(const std::vector<float>& image, int x, int y, float exposure) const
+    {
+        const float* p = &image[(size_t(y) * mWidth + x) * 4];
+        float3 color(p[0], p[1], p[2]);
+        if (mOptions.isHDR)
+        {
+            // Reference ACES tone mapper.
+            color = std::pow(2.f, exposure) * color;
+            for (int i = 0; i < 3; i++)
+            {
+                float c = color[i] * 0.6f;
+                color[i] = std::clamp((c * (2.51f * c + 0.03f)) / (c * (2.43f * c + 0.59f) + 0.14f), 0.f, 1.f);
+            }
+        }
+        return linearRGBToYCxCz(color);
+    }
+
+    static double HyAB(float3 a, float3 b)
+    {
+        float3 d = a - b;
+        return std::abs(d.x) + std::sqrt(d.y * d.y + d.z * d.z);
+    }
+
+    static float3 Hunt(float3 c) { return float3(c.x, 0.01f * c.x * c.y, 0.01f * c.x * c.z); }
+
+    const std::vector<float>& mRef;
+    const std::vector<float>& mTest;
+    uint32_t mWidth;
+    uint32_t mHeight;
+    const FLIP::Options& mOptions;
+};
+} // namespace
+
+CPU_TEST(FLIP_ToneMapperCoefficients)
+{
+    // Coefficients previously hardcoded in FLIPPass for computing the exposure range.
+    FLIPToneMapperCoefficients k = getFLIPToneMapperCoefficients(FLIPToneMapperType::Hable);
+    EXPECT_LE(std::abs(k.k0 - 0.231683f), 1e-5f);
+    EXPECT_LE(std::abs(k.k1 - 0.013791f), 1e-5f);
+    EXPECT_EQ(k.k2, 0.f);
+    EXPECT_LE(std::abs(k.k3 - 0.18f), 1e-6f);
+    EXPECT_LE(std::abs(k.k4 - 0.3f), 1e-6f);
+    EXPECT_LE(std::abs(k.k5 - 0.018f), 1e-6f);
+
+    FLIP::ExposureParameters exposure = FLIP::computeExposureParameters(FLIPToneMapperType::ACES, 0.18f, 20.f);
+    EXPECT_GE(exposure.numExposures, 2u);
+    EXPECT_GT(exposure.exposureDelta, 0.f);
+    EXPECT_LT(exposure.startExposure, 0.f);
+}
+
+CPU_TEST(FLIP_IdenticalImages)
+{
+    const uint32_t width = 40, height = 30;
+    auto image = createImage(width, height, 1, 1.f);
+    std::vector<float> errorMap(width * height, -1.f);
+
+    FLIP::Options options;
+    FLIP::Result result = FLIP::compute(image.data(), image.data(), width, height, options, errorMap.data());
+    EXPECT_EQ(result.mean, 0.0);
+    EXPECT_EQ(result.max, 0.f);
+    for (float v : errorMap)
+        EXPECT_EQ(v, 0.f);
+
+    options.isHDR = true;
+    result = FLIP::compute(image.data(), image.data(), width, height, options);
+    EXPECT_EQ(result.mean, 0.0);
+    EXPECT_GE(result.exposure.numExposures, 2u);
+}
+
+CPU_TEST(FLIP_MatchesReference)
+{
+    const uint32_t width = 37, height = 29;
+    auto ref = createImage(width, height, 2, 1.f);
+    auto test = createImage(width, height, 3, 1.f);
+    // Smooth region to exercise the low error range.
+    for (size_t i = 0; i < test.size() / 2; i++)
+        test[i] = ref[i] + 0.02f;
+
+    for (bool isHDR : {false, true})
+    {
+        FLIP::Options options;
+        options.isHDR = isHDR;
+        options.tileHeight = 7;
+        options.useCustomExposureParameters = true;
+        options.startExposure = -2.f;
+        options.stopExposure = 1.f;
+        options.numExposures = 3;
+
+        std::vector<float> errorMap(width * height);
+        std::vector<float> exposureMap(width * height);
+        FLIP::Result result = FLIP::compute(ref.data(), test.data(), width, height, options, errorMap.data(), exposureMap.data());
+
+        ReferenceFLIP reference(ref, test, width, height, options);
+        double sum = 0.0;
+        for (uint32_t y = 0; y < height; y++)
+        {
+            for (uint32_t x = 0; x < width; x++)
+            {
+                float expected = 0.f;
+                uint32_t exposureIndex = 0;
+                for (uint32_t i = 0; i < (isHDR ? options.numExposures : 1); i++)
+                {
+                    float value = reference.compute(x, y, isHDR ? options.startExposure + i * 1.5f : 0.f);
+                    if (!isHDR || value > expected)
+                    {
+                        expected = value;
+                        exposureIndex = i;
+                    }
+                }
+                float actual = errorMap[y * width + x];
+                EXPECT_LE(std::abs(actual - expected), 2e-4f) << "x=" << x << " y=" << y << " hdr=" << isHDR;
+                if (isHDR && std::abs(actual - expected) < 2e-4f)
+                    EXPECT_EQ(exposureMap[y * width + x], exposureIndex * 0.5f);
+                sum += actual;
+            }
+        }
+        EXPECT_LE(std::abs(result.mean - sum / (width * height)), 1e-6);
+        EXPECT_GT(result.mean, 0.0);
+        EXPECT_LE(result.max, 1.f);
+    }
+}
+
+CPU_TEST(FLIP_ParallelAndStatistics)
+{
+    const uint32_t width = 64, height = 50;
+    auto ref = createImage(width, height, 4, 4.f);
+    auto test = createImage(width, height, 5, 4.f);
+
+    FLIP::Options options;
+    options.isHDR = true;
+    options.toneMapper = FLIPToneMapperType::Hable;
+    options.percentiles = {0.f, 0.5f, 1.f};
+
+    std::vector<float> parallelMap(width * height);
+    std::vector<float> serialMap(width * height);
+    FLIP::Result parallel = FLIP::compute(ref.data(), test.data(), width, height, options, parallelMap.data());
+    options.parallel = false;
+    options.tileHeight = height;
+    FLIP::Result serial = FLIP::compute(ref.data(), test.data(), width, height, options, serialMap.data());
+
+    EXPECT(parallelMap == serialMap);
+    EXPECT_EQ(parallel.mean, serial.mean);
+
+    ASSERT_EQ(serial.percentiles.size(), 3u);
+    EXPECT_EQ(serial.percentiles[0], serial.min);
+    EXPECT_EQ(serial.percentiles[2], serial.max);
+    EXPECT_LE(serial.min, serial.percentiles[1]);
+    EXPECT_LE(serial.percentiles[1], serial.max);
+    EXPECT_GE(serial.min, 0.f);
+    EXPECT_LE(serial.max, 1.f);
+}
+
+CPU_TEST(FLIP_InvalidValues)
+{
+    const uint32_t width = 16, height = 16;
+    auto ref = createImage(width, height, 6, 1.f);
+    auto test = ref;
+    test[0] = std::numeric_limits<float>::quiet_NaN();
+
+    std::vector<float> errorMap(width * height);
+    FLIP::Result result = FLIP::compute(ref.data(), test.data(), width, height, FLIP::Options(), errorMap.data());
+    EXPECT_EQ(result.max, 1.f);
+    EXPECT_EQ(errorMap[0], 1.f);
+}
+} // namespace Falcor
@@ -0,0 +1,262 @@
+/***************************************************************************
+ # Copyright (c) 2015-22, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Image/ImageDiff.h"
+#include <cmath>
+#include <limits>
+#include <atomic>
+#include <map>
+#include <random>
+
+namespace Falcor
+{
+namespace
+{
+std::vector<float> createImage(uint32_t width, uint32_t height, uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(0.f, 2.f);
+    std::vector<float> data(size_t(width) * height * 4);
+    for (auto& v : data)
+        v = dist(rng);
+    return data;
+}
+
+double referenceError(const std::vector<float>& a, const std::vector<float>& b, ImageDiff::Metric metric, bool alpha)
+{
+    const uint32_t channels = alpha ? 4 : 3;
+    const size_t pixelCount = a.size() / 4;
+    double sum = 0.0;
+    double max = 0.0;
+    for (size_t i = 0; i < pixelCount; ++i)
+    {
+        for (uint32_t c = 0; c < channels; ++c)
+        {
+            double va = a[4 * i + c];
+            double d = va - b[4 * i + c];
+            switch (metric)
+            {
+            case ImageDiff::Metric::MSE:
+                sum += d * d;
+                break;
+            case ImageDiff::Metric::RelMSE:
+                sum += d * d / (va * va + 1e-3);
+                break;
+            case ImageDiff::Metric::MAE:
+                sum += std::fabs(d);
+                break;
+            case ImageDiff::Metric::MAPE:
+                sum += 100.0 * std::fabs(d / (va + 1e-3));
+                break;
+            case ImageDiff::Metric::MaxAbs:
+                max = std::max(max, std::fabs(d));
+                break;
+            }
+        }
+    }
+    return metric == ImageDiff::Metric::MaxAbs ? max : sum / (double(channels) * pixelCount);
+}
+
+const ImageDiff::Metric kMetrics[] = {
+    ImageDiff::Metric::MSE,
+    ImageDiff::Metric::RelMSE,
+    ImageDiff::Metric::MAE,
+    ImageDiff::Metric::MAPE,
+    ImageDiff::Metric::MaxAbs,
+};
+} // namespace
+
+CPU_TEST(ImageDiff_Metrics)
+{
+    const uint32_t width = 37;
+    const uint32_t height = 29;
+    auto a = createImage(width, height, 1);
+    auto b = createImage(width, height, 2);
+
+    for (auto metric : kMetrics)
+    {
+        for (bool alpha : {false, true})
+        {
+            ImageDiff::Options options;
+            options.metric = metric;
+            options.alpha = alpha;
+            options.tileHeight = 4;
+            double ref = referenceError(a, b, metric, alpha);
+
+            auto result = ImageDiff::compare(a.data(), b.data(), width, height, options);
+            EXPECT_LE(std::fabs(result.error - ref), 1e-5 * ref) << enumToString(metric) << " alpha=" << alpha;
+            EXPECT(result.passed);
+            EXPECT(!result.earlyOut);
+
+            // Identical images.
+            auto same = ImageDiff::compare(a.data(), a.data(), width, height, options);
+            EXPECT_EQ(same.error, 0.0) << enumToString(metric);
+        }
+    }
+}
+
+CPU_TEST(ImageDiff_ErrorMap)
+{
+    const uint32_t width = 16;
+    const uint32_t height = 8;
+    auto a = createImage(width, height, 3);
+    auto b = createImage(width, height, 4);
+
+    for (auto metric : kMetrics)
+    {
+        ImageDiff::Options options;
+        options.metric = metric;
+        std::vector<float> errorMap(width * height);
+        auto result = ImageDiff::compare(a.data(), b.data(), width, height, options, errorMap.data());
+
+        double sum = 0.0;
+        float max = 0.f;
+        for (float e : errorMap)
+        {
+            sum += e;
+            max = std::max(max, e);
+        }
+        double expected = metric == ImageDiff::Metric::MaxAbs ? max : sum / errorMap.size();
+        EXPECT_LE(std::fabs(result.error - expected), 1e-5 * expected) << enumToString(metric);
+    }
+}
+
+CPU_TEST(ImageDiff_Threshold)
+{
+    const uint32_t width = 64;
+    const uint32_t height = 256;
+    auto a = createImage(width, height, 5);
+    auto b = a;
+
+    // Introduce a large error in the first rows.
+    for (size_t i = 0; i < width * 4 * 4; ++i)
+        b[i] += 10.f;
+
+    for (auto metric : kMetrics)
+    {
+        ImageDiff::Options options;
+        options.metric = metric;
+        options.tileHeight = 4;
+        options.parallel = false;
+        double ref = referenceError(a, b, metric, false);
+
+        // Threshold above the error passes without early-out.
+        options.threshold = ref * 1.01;
+        auto pass = ImageDiff::compare(a.data(), b.data(), width, height, options);
+        EXPECT(pass.passed) << enumToString(metric);
+        EXPECT(!pass.earlyOut) << enumToString(metric);
+
+        // Threshold below the error of the first tile stops after it.
+        options.threshold = ref * 0.5;
+        auto fail = ImageDiff::compare(a.data(), b.data(), width, height, options);
+        EXPECT(!fail.passed) << enumToString(metric);
+        EXPECT(fail.earlyOut) << enumToString(metric);
+        EXPECT_LE(fail.error, ref * (1.0 + 1e-5)) << enumToString(metric);
+        EXPECT_GT(fail.error, *options.threshold) << enumToString(metric);
+
+        // Same decision with parallel tiles.
+        options.parallel = true;
+        EXPECT(!ImageDiff::compare(a.data(), b.data(), width, height, options).passed) << enumToString(metric);
+    }
+}
+
+CPU_TEST(ImageDiff_NaN)
+{
+    const uint32_t width = 8;
+    const uint32_t height = 8;
+    auto a = createImage(width, height, 6);
+    auto b = a;
+    b[4 * 10 + 1] = std::numeric_limits<float>::quiet_NaN();
+
+    for (auto metric : kMetrics)
+    {
+        ImageDiff::Options options;
+        options.metric = metric;
+        auto result = ImageDiff::compare(a.data(), b.data(), width, height, options);
+        EXPECT(std::isnan(result.error)) << enumToString(metric);
+        EXPECT(!result.passed) << enumToString(metric);
+
+        options.threshold = 1.0;
+        EXPECT(!ImageDiff::compare(a.data(), b.data(), width, height, options).passed) << enumToString(metric);
+    }
+
+    // NaN in the alpha channel is ignored unless alpha is compared.
+    auto c = a;
+    c[4 * 5 + 3] = std::numeric_limits<float>::quiet_NaN();
+    ImageDiff::Options options;
+    EXPECT(ImageDiff::compare(a.data(), c.data(), width, height, options).passed);
+    options.alpha = true;
+    EXPECT(!ImageDiff::compare(a.data(), c.data(), width, height, options).passed);
+}
+
+CPU_TEST(ImageDiff_Batch)
+{
+    const uint32_t width = 16;
+    const uint32_t height = 16;
+    std::map<std::string, std::vector<float>> images;
+    images["a"] = createImage(width, height, 7);
+    images["b"] = createImage(width, height, 8);
+    images["small"] = createImage(4, 4, 9);
+
+    std::atomic<uint32_t> loaded = 0;
+    auto load = [&](const std::filesystem::path& path)
+    {
+        auto it = images.find(path.string());
+        if (it == images.end())
+            FALCOR_THROW("Image '{}' not found.", path.string());
+        loaded++;
+        uint32_t size = path == "small" ? 4 : width;
+        return ImageDiff::ImageData{size, size, std::shared_ptr<const float>(it->second.data(), [](const float*) {})};
+    };
+
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> pairs = {
+        {"a", "a"},
+        {"a", "b"},
+        {"a", "missing"},
+        {"a", "small"},
+    };
+    for (uint32_t i = 0; i < 32; ++i)
+        pairs.push_back({"b", "a"});
+
+    ImageDiff::Options options;
+    options.threshold = 0.0;
+    auto results = ImageDiff::compareBatch(pairs, load, options, 4);
+    ASSERT_EQ(results.size(), pairs.size());
+
+    EXPECT(results[0].result.passed);
+    EXPECT(results[0].error.empty());
+    EXPECT(!results[1].result.passed);
+    EXPECT(results[1].error.empty());
+    EXPECT(!results[2].result.passed);
+    EXPECT(!results[2].error.empty());
+    EXPECT(!results[3].result.passed);
+    EXPECT(!results[3].error.empty());
+    for (size_t i = 4; i < results.size(); ++i)
+        EXPECT(!results[i].result.passed && results[i].error.empty());
+}
+} // namespace Falcor
@@ -26,6 +26,7 @@
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
 #include "Testing/UnitTest.h"
+#include "Utils/Math/PackedFormats.h"
 #include <random>
 
 namespace Falcor
@@ -43,6 +44,81 @@ std::vector<float3> testData = {
     // clang-format on
     // We'll append random data here at runtime.
 };
+
+std::vector<float3> generateRGB9E5TestData()
+{
+    std::mt19937 rng;
+    auto dist = std::uniform_real_distribution<float>();
+    auto u = [&]() { return dist(rng); };
+
+    std::vector<float3> data = {
+        // clang-format off
+        {0.f, 0.f, 0.f},
+        {1.f, 1.f, 1.f},
+        {1.f, 0.5f, 0.25f},
+        {-1.f, 2.f, -3.f},
+        {1e10f, 1.f, 0.f},
+        {1e-30f, 1e-30f, 1e-30f},
+        // clang-format on
+    };
+
+    // Generate random colors within the supported dynamic range.
+    for (size_t i = 0; i < 10000; i++)
+    {
+        float scale = std::pow(2.f, u() * 30.f - 15.f);
+        data.push_back(float3(u(), u(), u()) * scale);
+    }
+    return data;
+}
+
+void verifyRGB9E5(UnitTestContext& ctx, const std::vector<float3>& data, const std::vector<float3>& result)
+{
+    // Exactly representable values.
+    EXPECT_EQ(result[0], float3(0.f));
+    EXPECT_EQ(result[1], float3(1.f));
+    EXPECT_EQ(result[2], float3(1.f, 0.5f, 0.25f));
+
+    // Negative values are encoded as zero and out of range values are clamped.
+    EXPECT_EQ(result[3], float3(0.f, 2.f, 0.f));
+    EXPECT_EQ(result[4].x, 65408.f);
+    EXPECT_EQ(result[5], float3(0.f));
+
+    // The error is bounded by half a mantissa step of the shared exponent.
+    for (size_t i = 6; i < data.size(); i++)
+    {
+        float threshold = std::max(std::max(data[i].x, data[i].y), data[i].z) / 511.f + 1e-7f;
+        EXPECT_LE(std::abs(result[i].x - data[i].x), threshold) << "i = " << i;
+        EXPECT_LE(std::abs(result[i].y - data[i].y), threshold) << "i = " << i;
+        EXPECT_LE(std::abs(result[i].z - data[i].z), threshold) << "i = " << i;
+    }
+}
+} // namespace
+
+CPU_TEST(RGB9E5)
+{
+    std::vector<float3> data = generateRGB9E5TestData();
+    std::vector<float3> result(data.size());
+    for (size_t i = 0; i < data.size(); i++)
+        result[i] = decodeRGB9E5(encodeRGB9E5(data[i]));
+    verifyRGB9E5(ctx, data, result);
+}
+
+GPU_TEST(RGB9E5)
+{
+    std::vector<float3> data = generateRGB9E5TestData();
+
+    ctx.createProgram("Tests/Utils/PackedFormatsTests.cs.slang", "testRGB9E5");
+    ctx.allocateStructuredBuffer("testData", (uint32_t)data.size(), data.data(), data.size() * sizeof(data[0]));
+    ctx.allocateStructuredBuffer("result", (uint32_t)data.size());
+    ctx.allocateStructuredBuffer("packedResult", (uint32_t)data.size());
+    ctx.runProgram((uint32_t)data.size());
+
+    verifyRGB9E5(ctx, data, ctx.readBuffer<float3>("result"));
+
+    // The host and device encodings should match.
+    std::vector<uint32_t> packedResult = ctx.readBuffer<uint32_t>("packedResult");
+    for (size_t i = 0; i < data.size(); i++)
+        EXPECT_EQ(packedResult[i], encodeRGB9E5(data[i])) << "i = " << i;
 }
 
 GPU_TEST(LogLuvHDR)
@@ -0,0 +1,249 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Testing/UnitTest.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
+#include <algorithm>
+#include <atomic>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <thread>
+
+namespace Falcor
+{
+namespace
+{
+const size_t kCounts[] = {0, 1, 27, 4096, 4097, 231917, 1088921};
+
+std::vector<uint32_t> createRandomData(size_t count, uint32_t maxValue, uint32_t seed = 1)
+{
+    std::mt19937 r(seed);
+    std::vector<uint32_t> data(count);
+    for (auto& it : data)
+        it = r() % maxValue;
+    return data;
+}
+
+/// Interleave the low 21 bits of x, y and z into a 63-bit Morton code.
+uint64_t mortonCode63(uint32_t x, uint32_t y, uint32_t z)
+{
+    auto expandBits = [](uint64_t v)
+    {
+        v &= 0x1fffff;
+        v = (v | v << 32) & 0x1f00000000ffffull;
+        v = (v | v << 16) & 0x1f0000ff0000ffull;
+        v = (v | v << 8) & 0x100f00f00f00f00full;
+        v = (v | v << 4) & 0x10c30c30c30c30c3ull;
+        v = (v | v << 2) & 0x1249249249249249ull;
+        return v;
+    };
+    return expandBits(x) | (expandBits(y) << 1) | (expandBits(z) << 2);
+}
+} // namespace
+
+CPU_TEST(ParallelAlgorithms_ForEach)
+{
+    for (size_t count : kCounts)
+    {
+        std::vector<std::atomic<uint32_t>> visits(count);
+        parallel::forEach(count, [&](size_t i) { visits[i]++; });
+        uint32_t errors = 0;
+        for (const auto& v : visits)
+            errors += v.load() != 1;
+        EXPECT_EQ(errors, 0) << "count = " << count;
+    }
+
+    // Nested calls run serially on the calling thread.
+    std::vector<uint32_t> sums(64);
+    parallel::forEach(
+        sums.size(),
+        [&](size_t i)
+        {
+            std::vector<uint32_t> data(10000, 1);
+            sums[i] = parallel::reduce(data.data(), data.size(), 0u);
+        },
+        1
+    );
+    for (uint32_t sum : sums)
+        EXPECT_EQ(sum, 10000);
+
+    // Exceptions are forwarded to the caller.
+    bool caught = false;
+    try
+    {
+        parallel::forEach(100000, [](size_t i) { if (i == 54321) throw std::runtime_error("test"); });
+    }
+    catch (const std::runtime_error&)
+    {
+        caught = true;
+    }
+    EXPECT(caught);
+
+    EXPECT_GE(parallel::getThreadCount(), 2);
+
+    // Calls in a serial execution scope run on the calling thread.
+    {
+        parallel::ScopedSerialExecution serial;
+        std::vector<std::thread::id> threads(100000);
+        parallel::forEach(threads.size(), [&](size_t i) { threads[i] = std::this_thread::get_id(); }, 1000);
+        EXPECT_EQ(std::count(threads.begin(), threads.end(), std::this_thread::get_id()), (std::ptrdiff_t)threads.size());
+    }
+}
+
+CPU_TEST(ParallelAlgorithms_Reduce)
+{
+    for (size_t count : kCounts)
+    {
+        auto data = createRandomData(count, 1000);
+        uint64_t sum = parallel::transformReduce(count, uint64_t(7), [&](size_t i) { return uint64_t(data[i]); }, std::plus<uint64_t>());
+        EXPECT_EQ(sum, std::accumulate(data.begin(), data.end(), uint64_t(7))) << "count = " << count;
+
+        uint32_t maxValue = parallel::reduce(data.data(), count, 0u, [](uint32_t a, uint32_t b) { return std::max(a, b); });
+        EXPECT_EQ(maxValue, count > 0 ? *std::max_element(data.begin(), data.end()) : 0u) << "count = " << count;
+    }
+
+    // Floating-point sums are independent of the number of threads.
+    std::vector<float> values(1000000);
+    std::mt19937 r;
+    std::uniform_real_distribution<float> dist(0.f, 1.f);
+    for (auto& v : values)
+        v = dist(r);
+    float sum0 = parallel::reduce(values.data(), values.size(), 0.f);
+    float sum1 = parallel::reduce(values.data(), values.size(), 0.f);
+    EXPECT_EQ(sum0, sum1);
+}
+
+CPU_TEST(ParallelAlgorithms_ExclusiveScan)
+{
+    for (size_t count : kCounts)
+    {
+        auto data = createRandomData(count, std::numeric_limits<uint32_t>::max());
+
+        // Reference with wrap-around on overflow, like PrefixSum on the GPU.
+        std::vector<uint32_t> ref(count);
+        uint32_t refSum = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            ref[i] = refSum;
+            refSum += data[i];
+        }
+
+        std::vector<uint32_t> result(count);
+        EXPECT_EQ(parallel::exclusiveScan(data.data(), result.data(), count), refSum);
+        EXPECT(result == ref) << "count = " << count;
+
+        EXPECT_EQ(parallel::exclusiveScan(data.data(), count), refSum);
+        EXPECT(data == ref) << "count = " << count;
+    }
+}
+
+CPU_TEST(ParallelAlgorithms_Compact)
+{
+    for (size_t count : kCounts)
+    {
+        auto data = createRandomData(count, 100);
+        auto pred = [](uint32_t v) { return v % 3 == 0; };
+        std::vector<uint32_t> ref;
+        std::copy_if(data.begin(), data.end(), std::back_inserter(ref), pred);
+        EXPECT(parallel::compact(data, pred) == ref) << "count = " << count;
+    }
+}
+
+CPU_TEST(ParallelAlgorithms_Histogram)
+{
+    for (uint32_t binCount : {1u, 16u, 10000u})
+    {
+        for (size_t count : kCounts)
+        {
+            auto data = createRandomData(count, binCount);
+            std::vector<uint32_t> ref(binCount, 0);
+            for (uint32_t v : data)
+                ref[v]++;
+            EXPECT(parallel::histogram(count, binCount, [&](size_t i) { return data[i]; }) == ref)
+                << "count = " << count << ", binCount = " << binCount;
+        }
+    }
+}
+
+CPU_TEST(ParallelAlgorithms_RadixSort)
+{
+    for (size_t count : kCounts)
+    {
+        auto keys = createRandomData(count, std::numeric_limits<uint32_t>::max());
+        auto ref = keys;
+        std::sort(ref.begin(), ref.end());
+        parallel::radixSort(keys.data(), count);
+        EXPECT(keys == ref) << "count = " << count;
+    }
+
+    // Sort by the low bits only. Keys with equal low bits keep their order.
+    {
+        auto keys = createRandomData(100000, std::numeric_limits<uint32_t>::max());
+        auto ref = keys;
+        std::stable_sort(ref.begin(), ref.end(), [](uint32_t a, uint32_t b) { return (a & 0xfff) < (b & 0xfff); });
+        parallel::radixSort(keys.data(), keys.size(), 12);
+        EXPECT(keys == ref);
+    }
+
+    // Float keys.
+    {
+        std::vector<float> values = {3.f, -1.f, 0.f, -0.5f, 1e-30f, -1e30f, 2.f, 1e30f, -1e-30f};
+        std::vector<uint32_t> keys(values.size());
+        std::vector<float> sorted = values;
+        for (size_t i = 0; i < values.size(); i++)
+            keys[i] = parallel::floatToRadixKey(values[i]);
+        parallel::radixSortKeyValue(keys.data(), sorted.data(), sorted.size());
+        auto ref = values;
+        std::sort(ref.begin(), ref.end());
+        EXPECT(sorted == ref);
+    }
+}
+
+CPU_TEST(ParallelAlgorithms_RadixSortMorton)
+{
+    // Sort point indices by 63-bit Morton codes. The result must match std::stable_sort.
+    for (size_t count : kCounts)
+    {
+        std::mt19937 r(count);
+        std::vector<uint64_t> codes(count);
+        for (auto& code : codes)
+            code = mortonCode63(r() % 1024, r() % 1024, r() % 4); // Few distinct coordinates to get duplicate keys.
+
+        std::vector<uint32_t> ref(count);
+        std::iota(ref.begin(), ref.end(), 0);
+        std::stable_sort(ref.begin(), ref.end(), [&](uint32_t a, uint32_t b) { return codes[a] < codes[b]; });
+
+        std::vector<uint32_t> order(count);
+        std::iota(order.begin(), order.end(), 0);
+        auto keys = codes;
+        parallel::radixSortKeyValue(keys.data(), order.data(), count, 63);
+        EXPECT(order == ref) << "count = " << count;
+        EXPECT(std::is_sorted(keys.begin(), keys.end())) << "count = " << count;
+    }
+}
+} // namespace Falcor
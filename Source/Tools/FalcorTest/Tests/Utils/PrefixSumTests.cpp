@@ -27,6 +27,7 @@
  **************************************************************************/
 #include "Testing/UnitTest.h"
 #include "Utils/Algorithm/PrefixSum.h"
+#include "Utils/Algorithm/ParallelAlgorithms.h"
 #include <random>
 
 namespace Falcor
@@ -71,11 +72,16 @@ void testPrefixSum(GPUUnitTestContext& ctx, PrefixSum& prefixSum, uint32_t numEl
     uint32_t sum = 0;
     prefixSum.execute(ctx.getRenderContext(), pTestDataBuffer, numElems, &sum, pSumBuffer, 0);
 
+    // Compute prefix sum on the host with the parallel implementation.
+    std::vector<uint32_t> hostResult(numElems);
+    const uint32_t hostSum = parallel::exclusiveScan(testData.data(), hostResult.data(), numElems);
+
     // Compute prefix sum on the CPU for comparison.
     const uint32_t refSum = prefixSumRef(testData);
 
     // Compare results.
     EXPECT_EQ(sum, refSum);
+    EXPECT_EQ(hostSum, refSum);
 
     uint32_t resultSum = pSumBuffer->getElement<uint32_t>(0);
     EXPECT_EQ(resultSum, refSum);
@@ -84,6 +90,7 @@ void testPrefixSum(GPUUnitTestContext& ctx, PrefixSum& prefixSum, uint32_t numEl
     for (uint32_t i = 0; i < numElems; i++)
     {
         EXPECT_EQ(testData[i], result[i]) << "i = " << i;
+        EXPECT_EQ(hostResult[i], result[i]) << "i = " << i;
     }
 }
 } // namespace
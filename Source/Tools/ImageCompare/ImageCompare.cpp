@@ -25,6 +25,9 @@
  # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
  # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  **************************************************************************/
+#include "Utils/Image/ImageDiff.h"
+#include "Utils/Image/FLIP.h"
+
 #include <FreeImage.h>
 #include <args.hxx>
 
@@ -36,16 +39,13 @@
 #include <map>
 #include <functional>
 #include <filesystem>
+#include <thread>
+#include <algorithm>
+#include <optional>
 
 #include <cmath>
 #include <cstring>
 
-template<typename T>
-T sqr(T x)
-{
-    return x * x;
-}
-
 template<typename T>
 T lerp(T a, T b, T t)
 {
@@ -188,83 +188,56 @@ private:
     std::unique_ptr<float[]> mData;
 };
 
-struct MSE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]);
-        return error / count;
-    }
-};
+using Falcor::FLIP;
+using Falcor::ImageDiff;
 
-struct RMSE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += sqr(a[i] - b[i]) / (sqr(a[i]) + 1e-3);
-        return error / count;
-    }
-};
+static const auto& errorMetrics = ImageDiff::Metric_info::items();
 
-struct MAE
-{
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs(sqr(a[i] - b[i]));
-        return error / count;
-    }
+// FLIP metrics are handled separately from the ImageDiff metrics.
+static const std::vector<std::pair<std::string, std::string>> flipMetrics = {
+    {"flip", "Mean LDR-FLIP error"},
+    {"hdrflip", "Mean HDR-FLIP error"},
 };
 
-struct MAPE
+struct CompareOptions
 {
-    double operator()(const float* a, const float* b, size_t count) const
-    {
-        double error = 0.0;
-        for (size_t i = 0; i < count; ++i)
-            error += std::fabs((a[i] - b[i]) / (a[i] + 1e-3));
-        return 100.0 * error / count;
-    }
+    ImageDiff::Options diff;
+    /// Set if comparing with a FLIP metric.
+    std::optional<FLIP::Options> flip;
+    /// Print FLIP statistics (min, max and percentiles).
+    bool printStats = false;
 };
 
-template<typename Metric>
-double compare(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)
+/// Compare images using FLIP. The error is the mean FLIP value.
+static ImageDiff::Result compareFLIP(
+    const float* pA,
+    const float* pB,
+    uint32_t width,
+    uint32_t height,
+    const CompareOptions& options,
+    float* pErrorMap
+)
 {
-    Metric metric;
-    double sum = 0.0;
-    const float* a = imageA.getData();
-    const float* b = imageB.getData();
-    size_t count = imageA.getWidth() * imageA.getHeight();
-    for (size_t i = 0; i < count; ++i)
+    auto flip = FLIP::compute(pA, pB, width, height, *options.flip, pErrorMap);
+    if (options.printStats)
     {
-        double error = metric(a, b, alpha ? 4 : 3);
-        if (errorMap)
-            *errorMap++ = float(error);
-        sum += error;
-        a += 4;
-        b += 4;
+        std::cout << "min " << flip.min << ", max " << flip.max;
+        for (size_t i = 0; i < flip.percentiles.size(); ++i)
+            std::cout << ", p" << options.flip->percentiles[i] * 100.f << " " << flip.percentiles[i];
+        std::cout << std::endl;
     }
-    return sum / count;
+
+    ImageDiff::Result result;
+    result.error = flip.mean;
+    result.passed = std::isfinite(flip.mean) && (!options.diff.threshold || flip.mean <= *options.diff.threshold);
+    return result;
 }
 
-struct ErrorMetric
+static ImageDiff::ImageData toImageData(const std::shared_ptr<Image>& image)
 {
-    std::string name;
-    std::string desc;
-    std::function<double(const Image& imageA, const Image& imageB, bool alpha, float* errorMap)> compare;
-};
-
-static const std::vector<ErrorMetric> errorMetrics = {
-    {"mse", "Mean Squared Error", compare<MSE>},
-    {"rmse", "Relative Mean Squared Error", compare<RMSE>},
-    {"mae", "Mean Absolute Error", compare<MAE>},
-    {"mape", "Mean Absolute Percentage Error", compare<MAPE>},
-};
+    // Alias the image data, keeping the image alive.
+    return {image->getWidth(), image->getHeight(), std::shared_ptr<const float>(image, image->getData())};
+}
 
 static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, const float* errorMap)
 {
@@ -301,9 +274,7 @@ static std::shared_ptr<Image> generateHeatMap(uint32_t width, uint32_t height, c
 static bool compareImages(
     const std::filesystem::path& pathA,
     const std::filesystem::path& pathB,
-    ErrorMetric metric,
-    float threshold,
-    bool alpha,
+    const CompareOptions& options,
     const std::filesystem::path& heatMapPath
 )
 {
@@ -351,8 +322,19 @@ static bool compareImages(
     uint32_t height = imageB->getHeight();
 
     // Compare images.
+    // The threshold is only applied afterwards, as the full error value is reported (no early-out).
     std::unique_ptr<float[]> errorMap = heatMapPath.empty() ? nullptr : std::make_unique<float[]>(width * height);
-    double error = metric.compare(*imageA, *imageB, alpha, errorMap.get());
+    ImageDiff::Result result;
+    if (options.flip)
+    {
+        result = compareFLIP(imageA->getData(), imageB->getData(), width, height, options, errorMap.get());
+    }
+    else
+    {
+        ImageDiff::Options fullOptions = options.diff;
+        fullOptions.threshold.reset();
+        result = ImageDiff::compare(imageA->getData(), imageB->getData(), width, height, fullOptions, errorMap.get());
+    }
 
     // Generate heat map.
     if (errorMap)
@@ -361,21 +343,103 @@ static bool compareImages(
         saveImage(*heatMap, heatMapPath);
     }
 
-    std::cout << error << std::endl;
+    std::cout << result.error << std::endl;
 
     // Treat nans and infs as errors.
-    if (std::isnan(error) || std::isinf(error))
+    return result.passed && result.error <= options.diff.threshold.value_or(0.0);
+}
+
+static bool compareDirectories(
+    const std::filesystem::path& dirA,
+    const std::filesystem::path& dirB,
+    const CompareOptions& options,
+    uint32_t jobs
+)
+{
+    // Collect all images in the first directory and match them with the second one by relative path.
+    std::vector<std::pair<std::filesystem::path, std::filesystem::path>> pairs;
+    bool success = true;
+    try
+    {
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(dirA))
+        {
+            if (!entry.is_regular_file() || FreeImage_GetFIFFromFilename(entry.path().string().c_str()) == FIF_UNKNOWN)
+                continue;
+            auto relativePath = std::filesystem::relative(entry.path(), dirA);
+            auto pathB = dirB / relativePath;
+            if (!std::filesystem::exists(pathB))
+            {
+                std::cerr << "Missing image '" << pathB.string() << "'." << std::endl;
+                success = false;
+                continue;
+            }
+            pairs.emplace_back(entry.path(), pathB);
+        }
+    }
+    catch (const std::filesystem::filesystem_error& e)
+    {
+        std::cerr << e.what() << std::endl;
         return false;
+    }
+    std::sort(pairs.begin(), pairs.end());
+
+    auto load = [](const std::filesystem::path& path) { return toImageData(Image::loadFromFile(path)); };
+    std::vector<ImageDiff::BatchResult> results;
+    if (options.flip)
+    {
+        // FLIP parallelizes within each image, so pairs are processed one at a time.
+        // Statistics are only printed when comparing single images.
+        CompareOptions flipOptions = options;
+        flipOptions.printStats = false;
+        for (const auto& [pathA, pathB] : pairs)
+        {
+            auto& result = results.emplace_back();
+            try
+            {
+                auto imageA = load(pathA);
+                auto imageB = load(pathB);
+                if (imageA.width != imageB.width || imageA.height != imageB.height)
+                    throw std::runtime_error("Cannot compare images with different resolutions");
+                result.result = compareFLIP(imageA.pData.get(), imageB.pData.get(), imageA.width, imageA.height, flipOptions, nullptr);
+            }
+            catch (const std::exception& e)
+            {
+                result.result.passed = false;
+                result.error = e.what();
+            }
+        }
+    }
+    else
+    {
+        results = ImageDiff::compareBatch(pairs, load, options.diff, jobs);
+    }
 
-    return error <= threshold;
+    for (size_t i = 0; i < pairs.size(); ++i)
+    {
+        const auto& result = results[i];
+        std::cout << std::filesystem::relative(pairs[i].first, dirA).string() << ": ";
+        // Failing comparisons stop early, their error value is a lower bound (marked with '+').
+        if (!result.error.empty())
+            std::cout << "error (" << result.error << ")";
+        else
+            std::cout << result.result.error << (result.result.earlyOut ? "+" : "") << (result.result.passed ? "" : " FAILED");
+        std::cout << std::endl;
+        success &= result.result.passed;
+    }
+
+    return success;
 }
 
 static void printMetrics(std::ostream& stream = std::cout)
 {
     stream << "Available error metrics:" << std::endl;
-    for (const auto& metric : errorMetrics)
+    for (const auto& [metric, name] : errorMetrics)
+    {
+        stream << "  " << name << " - " << ImageDiff::getMetricDesc(metric) << std::endl;
+    }
+    for (const auto& [name, desc] : flipMetrics)
     {
-        stream << "  " << metric.name << " - " << metric.desc << std::endl;
+        stream << "  " << name << " - " << desc << std::endl;
     }
 }
 
@@ -389,8 +453,11 @@ int main(int argc, char** argv)
     args::ValueFlag<float> thresholdFlag(parser, "threshold", "The error threshold.", {'t'});
     args::Flag alphaFlag(parser, "", "Include alpha channel.", {'a'});
     args::ValueFlag<std::string> heatMapFlag(parser, "filename", "Generate error heat map.", {'e'});
-    args::Positional<std::string> image1(parser, "image1", "The first image.", args::Options::Required);
-    args::Positional<std::string> image2(parser, "image2", "The second image.", args::Options::Required);
+    args::Flag directoryFlag(parser, "", "Compare all images in two directories.", {'d'});
+    args::Flag statsFlag(parser, "", "Print FLIP error statistics.", {'s'});
+    args::ValueFlag<uint32_t> jobsFlag(parser, "jobs", "Number of image pairs compared in parallel in directory mode.", {'j'});
+    args::Positional<std::string> image1(parser, "image1", "The first image (or directory).", args::Options::Required);
+    args::Positional<std::string> image2(parser, "image2", "The second image (or directory).", args::Options::Required);
     args::CompletionFlag completionFlag(parser, {"complete"});
 
     try
@@ -426,28 +493,41 @@ int main(int argc, char** argv)
         return 0;
     }
 
-    ErrorMetric metric = errorMetrics.front();
+    CompareOptions options;
     if (metricFlag)
     {
         auto name = args::get(metricFlag);
-        auto it =
-            std::find_if(errorMetrics.begin(), errorMetrics.end(), [&name](const ErrorMetric& metric) { return metric.name == name; });
-        if (it == errorMetrics.end())
+        auto it = std::find_if(errorMetrics.begin(), errorMetrics.end(), [&name](const auto& item) { return item.second == name; });
+        auto flipIt = std::find_if(flipMetrics.begin(), flipMetrics.end(), [&name](const auto& item) { return item.first == name; });
+        if (it != errorMetrics.end())
+        {
+            options.diff.metric = it->first;
+        }
+        else if (flipIt != flipMetrics.end())
+        {
+            options.flip = FLIP::Options();
+            options.flip->isHDR = flipIt->first == "hdrflip";
+        }
+        else
         {
             std::cerr << "Unknown error metric '" << args::get(metricFlag) << "'." << std::endl;
             printMetrics(std::cerr);
             return 1;
         }
-        metric = *it;
     }
+    options.diff.threshold = thresholdFlag ? args::get(thresholdFlag) : 0.f;
+    options.diff.alpha = alphaFlag ? args::get(alphaFlag) : false;
+    options.printStats = statsFlag;
 
-    bool success = compareImages(
-        args::get(image1),
-        args::get(image2),
-        metric,
-        thresholdFlag ? args::get(thresholdFlag) : 0.f,
-        alphaFlag ? args::get(alphaFlag) : false,
-        heatMapFlag ? args::get(heatMapFlag) : ""
-    );
+    bool success;
+    if (directoryFlag)
+    {
+        uint32_t jobs = jobsFlag ? std::max(1u, args::get(jobsFlag)) : std::max(1u, std::thread::hardware_concurrency());
+        success = compareDirectories(args::get(image1), args::get(image2), options, jobs);
+    }
+    else
+    {
+        success = compareImages(args::get(image1), args::get(image2), options, heatMapFlag ? args::get(heatMapFlag) : "");
+    }
     return success ? 0 : 1;
 }
@@ -0,0 +1,141 @@
+/***************************************************************************
+ # Copyright (c) 2015-23, NVIDIA CORPORATION. All rights reserved.
+ #
+ # Redistribution and use in source and binary forms, with or without
+ # modification, are permitted provided that the following conditions
+ # are met:
+ #  * Redistributions of source code must retain the above copyright
+ #    notice, this list of conditions and the following disclaimer.
+ #  * Redistributions in binary form must reproduce the above copyright
+ #    notice, this list of conditions and the following disclaimer in the
+ #    documentation and/or other materials provided with the distribution.
+ #  * Neither the name of NVIDIA CORPORATION nor the names of its
+ #    contributors may be used to endorse or promote products derived
+ #    from this software without specific prior written permission.
+ #
+ # THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS "AS IS" AND ANY
+ # EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
+ # IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR
+ # PURPOSE ARE DISCLAIMED.  IN NO EVENT SHALL THE COPYRIGHT OWNER OR
+ # CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL,
+ # EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED TO,
+ # PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR
+ # PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED AND ON ANY THEORY
+ # OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ # (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
+ # OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ **************************************************************************/
+#include "Core/Error.h"
+#include "Core/Plugin.h"
+#include "Core/AssetResolver.h"
+#include "Core/Platform/OS.h"
+#include "Scene/SceneBuilder.h"
+#include "Utils/Logger.h"
+#include "Utils/Settings.h"
+#include "Utils/Threading.h"
+#include "Utils/Scripting/Scripting.h"
+
+#include <args.hxx>
+
+#include <filesystem>
+#include <iostream>
+#include <string>
+
+using namespace Falcor;
+
+/** Command line tool to prebuild scene caches without a GPU device.
+
+    The scene is imported and processed by a headless SceneBuilder and written to the scene cache.
+    The cache is keyed by the resolved scene path and build flags. Render nodes pick it up when loading
+    the scene from the same path with the same build flags and SceneBuilder::Flags::UseCache set,
+    after the cache file has been copied to their scene cache directory.
+    Material texture optimization needs a device and runs when the cache is loaded.
+*/
+int runMain(int argc, char** argv)
+{
+    args::ArgumentParser parser("Build a scene cache file from a scene file without a GPU device.");
+    parser.helpParams.programName = "SceneCacheBuilder";
+    args::HelpFlag helpFlag(parser, "help", "Display this help menu.", {'h', "help"});
+    args::ValueFlag<uint32_t> flagsFlag(parser, "flags", "Scene builder flags (SceneBuilder::Flags value, default: Default).", {'f', "flags"});
+    args::ValueFlag<std::string> outputFlag(parser, "path", "Copy the scene cache file to this path.", {'o', "output"});
+    args::ValueFlag<std::string> reportFlag(parser, "path", "Write the scene build report (JSON) to this path.", {'r', "report"});
+    args::Flag verboseFlag(parser, "", "Print log messages to the console.", {'v', "verbose"});
+    args::Positional<std::string> sceneFlag(parser, "scene", "Scene file.", args::Options::Required);
+    args::CompletionFlag completionFlag(parser, {"complete"});
+
+    try
+    {
+        parser.ParseCLI(argc, argv);
+    }
+    catch (const args::Completion& e)
+    {
+        std::cout << e.what();
+        return 0;
+    }
+    catch (const args::Help&)
+    {
+        std::cout << parser;
+        return 0;
+    }
+    catch (const args::ParseError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+    catch (const args::RequiredError& e)
+    {
+        std::cerr << e.what() << std::endl;
+        std::cerr << parser;
+        return 1;
+    }
+
+    if (!verboseFlag)
+        Logger::setOutputs(Logger::OutputFlags::File | Logger::OutputFlags::DebugWindow);
+
+    SceneBuilder::Flags buildFlags = flagsFlag ? SceneBuilder::Flags(args::get(flagsFlag)) : SceneBuilder::Flags::Default;
+
+    OSServices::start();
+    Threading::start();
+    Scripting::start();
+
+    // Setup asset search paths.
+    AssetResolver& resolver = AssetResolver::getDefaultResolver();
+    resolver.addSearchPath(getProjectDirectory() / "media");
+    for (auto& path : Settings::getGlobalSettings().getSearchDirectories("media"))
+        resolver.addSearchPath(path);
+
+    PluginManager::instance().loadAllPlugins();
+
+    // Import and build the scene without a device.
+    std::filesystem::path cachePath;
+    {
+        SceneBuilder builder(nullptr, args::get(sceneFlag), Settings(), buildFlags);
+        cachePath = builder.writeSceneCache();
+        if (reportFlag)
+            builder.getBuildReport().writeToFile(args::get(reportFlag));
+    }
+
+    if (outputFlag)
+    {
+        std::filesystem::path outputPath = args::get(outputFlag);
+        if (outputPath.has_parent_path())
+            std::filesystem::create_directories(outputPath.parent_path());
+        std::filesystem::copy_file(cachePath, outputPath, std::filesystem::copy_options::overwrite_existing);
+        cachePath = outputPath;
+    }
+
+    std::cout << cachePath.string() << std::endl;
+
+    Scripting::shutdown();
+    PluginManager::instance().releaseAllPlugins();
+    Threading::shutdown();
+    OSServices::stop();
+
+    return 0;
+}
+
+int main(int argc, char** argv)
+{
+    return catchAndReportAllExceptions([&]() { return runMain(argc, argv); });
+}
@@ -32,6 +32,7 @@
 #include "Utils/StringUtils.h"
 #include "Utils/NumericRange.h"
 #include "Utils/Timing/TimeReport.h"
+#include "Utils/Timing/CpuEventRecorder.h"
 #include "Utils/Math/Common.h"
 #include "Utils/Math/FalcorMath.h"
 #include "Scene/Importer.h"
@@ -593,6 +594,8 @@ void createMeshes(ImporterData& data)
         range.end(),
         [&](size_t i)
         {
+            FALCOR_PROFILE_CPU("AssimpImporter::createMesh");
+
             const aiMesh* pAiMesh = meshes[i];
             const uint32_t perFaceIndexCount = pAiMesh->mFaces[0].mNumIndices;
 
@@ -259,7 +259,12 @@ struct BuilderContext
         return pMaterial;
     }
 
-    Resolver resolver = [this](const std::filesystem::path& path) { return scene.resolvePath(path); };
+    Resolver resolver = [this](const std::filesystem::path& path)
+    {
+        auto resolvedPath = scene.resolvePath(path);
+        builder.addDependency(resolvedPath);
+        return resolvedPath;
+    };
 };
 
 inline void warnUnsupportedType(const FileLoc& loc, const std::string_view category, const std::string_view name)
@@ -1920,6 +1925,10 @@ void PBRTImporter::importScene(
     if (!path.is_absolute())
         throw ImporterError(path, "Expected absolute path.");
 
+    // Textures and environment maps are loaded directly onto the GPU by this importer.
+    if (builder.isHeadless())
+        throw ImporterError(path, "Importer does not support headless scene builds.");
+
     try
     {
         TimeReport timeReport;
@@ -33,6 +33,7 @@
 #include "Scene/Material/HairMaterial.h"
 #include "Scene/Material/StandardMaterial.h"
 #include "Utils/Settings.h"
+#include "Utils/Timing/CpuEventRecorder.h"
 #include "USDUtils/USDHelpers.h"
 #include "USDUtils/USDUtils.h"
 #include "USDUtils/USDScene1Utils.h"
@@ -1088,6 +1089,7 @@ namespace Falcor
             tbb::parallel_for<size_t>(0, ctx.meshTasks.size(),
                 [&](size_t i)
                 {
+                    FALCOR_PROFILE_CPU("USDImporter::processMesh");
                     FALCOR_ASSERT(ctx.meshTasks[i].sampleIdx == 0);
                     processMesh(ctx.meshes[ctx.meshTasks[i].meshId], ctx);
                 }
@@ -1123,6 +1125,7 @@ namespace Falcor
                 tbb::parallel_for<size_t>(0, ctx.meshKeyframeTasks.size(),
                     [&](size_t i)
                     {
+                        FALCOR_PROFILE_CPU("USDImporter::processMeshKeyframe");
                         auto& task = ctx.meshKeyframeTasks[i];
                         processMeshKeyframe(ctx.meshes[task.meshId], task.meshId, task.sampleIdx, ctx);
                     }
@@ -313,6 +313,10 @@ namespace Falcor
         if (!path.is_absolute())
             throw ImporterError(path, "Expected absolute path.");
 
+        // Materials are converted and environment maps are loaded on the GPU by this importer.
+        if (builder.isHeadless())
+            throw ImporterError(path, "Importer does not support headless scene builds.");
+
         TimeReport timeReport;
 
         DiagDelegate diagnosticDelegate;
@@ -0,0 +1,103 @@
+import os
+import unittest
+import importlib.util
+from pathlib import Path
+
+PROJECT_DIR = Path(__file__).resolve().parents[2]
+STAT_TOOL_DIR = PROJECT_DIR / "_stat_tool"
+
+# Load the module directly from its file, as 'core' is also the name of a test package here.
+spec = importlib.util.spec_from_file_location(
+    "benchmark_stats", PROJECT_DIR / "tests/testing/core/benchmark_stats.py"
+)
+benchmark_stats = importlib.util.module_from_spec(spec)
+spec.loader.exec_module(benchmark_stats)
+
+
+class TestBenchmarkStats(unittest.TestCase):
+    def test_median_mad(self):
+        self.assertEqual(benchmark_stats.median([3, 1, 2]), 2)
+        self.assertEqual(benchmark_stats.median([4, 1, 3, 2]), 2.5)
+        self.assertEqual(benchmark_stats.mad([1, 1, 2, 2, 4, 6, 9]), 1)
+
+    def test_median_confidence_interval(self):
+        values = list(range(100))
+        lo, hi = benchmark_stats.median_confidence_interval(values, 0.95)
+        self.assertLessEqual(lo, 49.5)
+        self.assertGreaterEqual(hi, 49.5)
+        self.assertEqual((lo, hi), (40, 59))
+
+    def test_mann_whitney_u(self):
+        a = [float(i) for i in range(50)]
+        _, _, p = benchmark_stats.mann_whitney_u(a, a)
+        self.assertAlmostEqual(p, 1.0)
+
+        b = [v + 25.0 for v in a]
+        u, z, p = benchmark_stats.mann_whitney_u(a, b)
+        self.assertGreater(z, 0.0)
+        self.assertLess(p, 1e-3)
+
+        # All values tied.
+        _, z, p = benchmark_stats.mann_whitney_u([1.0] * 10, [1.0] * 10)
+        self.assertEqual(p, 1.0)
+
+    def load(self, name):
+        path = STAT_TOOL_DIR / name
+        if not path.exists():
+            self.skipTest(f"{path} not available")
+        return benchmark_stats.load_capture(path, skip_frames=10, event_filter="/(cpu|gpu)_time$")
+
+    def test_capture_against_itself(self):
+        samples = self.load("restir_static_500p_1.json")
+        self.assertIn("/onFrameRender/cpu_time", samples)
+        baseline = benchmark_stats.make_baseline({"restir": samples})
+        report = benchmark_stats.compare(baseline, {"restir": samples})
+        self.assertTrue(report["passed"])
+        self.assertEqual(report["summary"]["regression"], 0)
+        self.assertEqual(report["summary"]["improvement"], 0)
+
+    def test_detect_regression(self):
+        samples = self.load("restir_static_500p_1.json")
+        baseline = benchmark_stats.make_baseline({"restir": samples})
+        name = "/onFrameRender/RenderGraphExe::execute()/RestirInitTemporal/gpu_time"
+        slow = dict(samples)
+        slow[name] = [v * 1.2 for v in samples[name]]
+        report = benchmark_stats.compare(baseline, {"restir": slow})
+        self.assertFalse(report["passed"])
+        self.assertEqual(report["cases"]["restir"]["events"][name]["status"], benchmark_stats.REGRESSION)
+        self.assertEqual(report["summary"]["regression"], 1)
+
+        fast = dict(samples)
+        fast[name] = [v * 0.8 for v in samples[name]]
+        report = benchmark_stats.compare(baseline, {"restir": fast})
+        self.assertTrue(report["passed"])
+        self.assertEqual(report["summary"]["improvement"], 1)
+
+    def test_missing_event(self):
+        samples = self.load("minpt_static_500p_1.json")
+        baseline = benchmark_stats.make_baseline({"minpt": samples})
+        report = benchmark_stats.compare(baseline, {"minpt": {}})
+        self.assertFalse(report["passed"])
+        self.assertEqual(report["summary"]["missing"], len(samples))
+
+    def test_baseline_without_samples(self):
+        a = self.load("restir_static_500p_1.json")
+        baseline = benchmark_stats.make_baseline({"restir": a}, include_samples=False)
+        report = benchmark_stats.compare(baseline, {"restir": a})
+        self.assertTrue(report["passed"])
+
+        slow = {k: [v * 1.5 for v in s] for k, s in a.items()}
+        report = benchmark_stats.compare(baseline, {"restir": slow})
+        self.assertFalse(report["passed"])
+
+    def test_noise_between_runs(self):
+        # Two runs of the same configuration differ by a few percent on the GPU.
+        a = self.load("restir_static_500p_1.json")
+        b = self.load("restir_static_500p_2.json")
+        baseline = benchmark_stats.make_baseline({"restir": a})
+        report = benchmark_stats.compare(baseline, {"restir": b}, threshold=0.1)
+        self.assertTrue(report["passed"], benchmark_stats.format_report(report))
+
+
+if __name__ == "__main__":
+    unittest.main()
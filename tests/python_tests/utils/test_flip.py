@@ -0,0 +1,39 @@
+import unittest
+import falcor
+import numpy as np
+
+
+class TestFLIP(unittest.TestCase):
+    def test_identical(self):
+        image = np.random.default_rng(0).random((32, 48, 3), dtype=np.float32)
+        result = falcor.compute_flip(image, image, return_error_map=True)
+        self.assertEqual(result["mean"], 0.0)
+        self.assertEqual(result["error_map"].shape, (32, 48))
+        self.assertTrue(np.all(result["error_map"] == 0.0))
+
+    def test_ldr(self):
+        rng = np.random.default_rng(1)
+        reference = rng.random((32, 48, 4), dtype=np.float32)
+        test = rng.random((32, 48, 4), dtype=np.float32)
+        result = falcor.compute_flip(reference, test, percentiles=[0.5, 0.99], return_error_map=True)
+        error_map = result["error_map"]
+        self.assertGreater(result["mean"], 0.0)
+        self.assertAlmostEqual(result["mean"], float(np.mean(error_map, dtype=np.float64)), places=5)
+        self.assertEqual(result["max"], float(error_map.max()))
+        self.assertLessEqual(result["percentiles"][0.5], result["percentiles"][0.99])
+
+    def test_hdr(self):
+        rng = np.random.default_rng(2)
+        reference = 10.0 * rng.random((32, 48, 3), dtype=np.float32)
+        test = reference * 1.5
+        result = falcor.compute_flip(reference, test, hdr=True, tone_mapper=falcor.FLIPToneMapperType.Hable)
+        self.assertGreater(result["mean"], 0.0)
+        self.assertGreaterEqual(result["num_exposures"], 2)
+
+        result = falcor.compute_flip(reference, test, hdr=True, exposure_range=(-2.0, 2.0), num_exposures=5)
+        self.assertEqual(result["start_exposure"], -2.0)
+        self.assertEqual(result["exposure_delta"], 1.0)
+
+
+if __name__ == "__main__":
+    unittest.main()
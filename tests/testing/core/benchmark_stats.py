@@ -0,0 +1,311 @@
+'''
+Statistics and comparison engine for frame-time benchmarks.
+
+Works on profiler captures as returned by `m.profiler.end_capture()`, i.e. JSON
+files of the form:
+
+    {
+        "frame_count": N,
+        "events": {
+            "/onFrameRender/cpu_time": { "name": ..., "stats": { ... }, "records": [ ... ] },
+            ...
+        }
+    }
+
+All times are in milliseconds. The module only depends on the python standard
+library so it can be used (and tested) without a Falcor build.
+'''
+
+import json
+import math
+import re
+from statistics import NormalDist
+
+# Scale factor converting the median absolute deviation to a consistent
+# estimator of the standard deviation for normally distributed data.
+MAD_SCALE = 1.4826
+
+# Default significance level for the regression test.
+DEFAULT_ALPHA = 0.01
+
+# Default relative change of the median that is considered a regression.
+DEFAULT_THRESHOLD = 0.05
+
+# Events with a baseline median below this value (in ms) are too short to be compared reliably.
+DEFAULT_MIN_TIME = 0.01
+
+# Default confidence level of the median confidence interval.
+DEFAULT_CONFIDENCE = 0.95
+
+# Comparison results.
+PASSED = 'passed'
+REGRESSION = 'regression'
+IMPROVEMENT = 'improvement'
+SKIPPED = 'skipped'
+MISSING = 'missing'
+
+# Baseline file format version.
+BASELINE_VERSION = 1
+
+
+def load_capture(path, skip_frames=0, event_filter=None):
+    '''
+    Load a profiler capture from a JSON file.
+    Returns a dictionary mapping event names to lists of samples.
+    The first skip_frames samples of each event are dropped (warm-up).
+    If event_filter is given, only events matching the regular expression are returned.
+    '''
+    with open(path) as f:
+        capture = json.load(f)
+    return capture_samples(capture, skip_frames, event_filter)
+
+
+def capture_samples(capture, skip_frames=0, event_filter=None):
+    '''
+    Extract per-event samples from a profiler capture dictionary.
+    '''
+    pattern = re.compile(event_filter) if event_filter else None
+    samples = {}
+    for name, event in capture['events'].items():
+        if pattern and not pattern.search(name):
+            continue
+        samples[name] = [float(v) for v in event['records'][skip_frames:]]
+    return samples
+
+
+def median(values):
+    '''
+    Compute the median of a list of values.
+    '''
+    s = sorted(values)
+    n = len(s)
+    if n == 0:
+        raise ValueError('median of empty list')
+    mid = n // 2
+    return s[mid] if n % 2 == 1 else 0.5 * (s[mid - 1] + s[mid])
+
+
+def mad(values, center=None):
+    '''
+    Compute the (unscaled) median absolute deviation of a list of values.
+    '''
+    if center is None:
+        center = median(values)
+    return median([abs(v - center) for v in values])
+
+
+def median_confidence_interval(values, confidence=DEFAULT_CONFIDENCE):
+    '''
+    Compute a distribution-free confidence interval for the median.
+    Uses the order statistics whose ranks are given by the normal approximation
+    of the binomial distribution B(n, 0.5). Returns a tuple (low, high).
+    '''
+    s = sorted(values)
+    n = len(s)
+    if n == 0:
+        raise ValueError('confidence interval of empty list')
+    z = NormalDist().inv_cdf(0.5 + 0.5 * confidence)
+    half_width = 0.5 * z * math.sqrt(n)
+    lo = max(0, int(math.floor(0.5 * n - half_width)))
+    hi = min(n - 1, int(math.ceil(0.5 * n + half_width)) - 1)
+    return s[lo], s[max(lo, hi)]
+
+
+def summarize(values, confidence=DEFAULT_CONFIDENCE):
+    '''
+    Compute robust summary statistics for a list of samples.
+    '''
+    m = median(values)
+    ci_low, ci_high = median_confidence_interval(values, confidence)
+    return {
+        'count': len(values),
+        'median': m,
+        'mad': MAD_SCALE * mad(values, m),
+        'ci_low': ci_low,
+        'ci_high': ci_high,
+        'mean': sum(values) / len(values),
+        'min': min(values),
+        'max': max(values),
+    }
+
+
+def mann_whitney_u(a, b):
+    '''
+    Two-sided Mann-Whitney U test using the normal approximation with tie correction.
+    Returns a tuple (u, z, p_value), where u is the statistic of sample a and
+    z is positive if values in b tend to be larger than values in a.
+    '''
+    n1 = len(a)
+    n2 = len(b)
+    if n1 == 0 or n2 == 0:
+        raise ValueError('Mann-Whitney U test requires non-empty samples')
+
+    # Assign average ranks to ties.
+    combined = sorted([(v, 0) for v in a] + [(v, 1) for v in b], key=lambda x: x[0])
+    n = n1 + n2
+    rank_sum_a = 0.0
+    tie_term = 0.0
+    i = 0
+    while i < n:
+        j = i
+        while j + 1 < n and combined[j + 1][0] == combined[i][0]:
+            j += 1
+        rank = 0.5 * (i + j) + 1.0
+        t = j - i + 1
+        tie_term += t * t * t - t
+        for k in range(i, j + 1):
+            if combined[k][1] == 0:
+                rank_sum_a += rank
+        i = j + 1
+
+    u1 = rank_sum_a - n1 * (n1 + 1) / 2.0
+    mean_u = n1 * n2 / 2.0
+    var_u = n1 * n2 / 12.0 * ((n + 1) - tie_term / (n * (n - 1))) if n > 1 else 0.0
+    if var_u <= 0.0:
+        return u1, 0.0, 1.0
+
+    # Continuity correction towards the mean.
+    diff = mean_u - u1
+    diff -= math.copysign(0.5, diff) if abs(diff) >= 0.5 else diff
+    z = diff / math.sqrt(var_u)
+    p = 2.0 * (1.0 - NormalDist().cdf(abs(z)))
+    return u1, z, min(1.0, p)
+
+
+def compare_event(baseline, current, threshold=DEFAULT_THRESHOLD, alpha=DEFAULT_ALPHA, min_time=DEFAULT_MIN_TIME):
+    '''
+    Compare the samples of a single event against a baseline.
+    baseline is a baseline event entry (see make_baseline) and current a list of samples.
+    An event is flagged as regression (improvement) if its median increased (decreased)
+    by more than threshold relative to the baseline median and the change is significant
+    at level alpha. If the baseline has no samples, non-overlapping confidence intervals
+    are used as significance test.
+    '''
+    base_stats = baseline['stats']
+    cur_stats = summarize(current)
+    result = {
+        'baseline': base_stats,
+        'current': cur_stats,
+        'relative_change': None,
+        'p_value': None,
+        'status': PASSED,
+    }
+
+    base_median = base_stats['median']
+    if base_median < min_time and cur_stats['median'] < min_time:
+        result['status'] = SKIPPED
+        return result
+
+    relative_change = (cur_stats['median'] - base_median) / max(base_median, min_time)
+    result['relative_change'] = relative_change
+
+    base_samples = baseline.get('samples')
+    if base_samples:
+        _, _, p_value = mann_whitney_u(base_samples, current)
+        result['p_value'] = p_value
+        significant = p_value < alpha
+    else:
+        significant = cur_stats['ci_low'] > base_stats['ci_high'] or cur_stats['ci_high'] < base_stats['ci_low']
+
+    if significant and relative_change > threshold:
+        result['status'] = REGRESSION
+    elif significant and relative_change < -threshold:
+        result['status'] = IMPROVEMENT
+    return result
+
+
+def make_baseline(cases, include_samples=True):
+    '''
+    Create a baseline dictionary from measured cases.
+    cases maps case names to dictionaries mapping event names to lists of samples.
+    '''
+    baseline = {'version': BASELINE_VERSION, 'cases': {}}
+    for case_name, events in cases.items():
+        entry = {}
+        for event_name, samples in events.items():
+            if len(samples) == 0:
+                continue
+            entry[event_name] = {'stats': summarize(samples)}
+            if include_samples:
+                entry[event_name]['samples'] = samples
+        baseline['cases'][case_name] = {'events': entry}
+    return baseline
+
+
+def load_baseline(path):
+    '''
+    Load a baseline JSON file.
+    '''
+    with open(path) as f:
+        baseline = json.load(f)
+    if baseline.get('version', None) != BASELINE_VERSION:
+        raise Exception(f'Unsupported baseline version in "{path}".')
+    return baseline
+
+
+def save_json(path, data):
+    '''
+    Write a dictionary to a JSON file.
+    '''
+    with open(path, 'w') as f:
+        json.dump(data, f, indent=2)
+
+
+def compare(baseline, cases, threshold=DEFAULT_THRESHOLD, alpha=DEFAULT_ALPHA, min_time=DEFAULT_MIN_TIME):
+    '''
+    Compare measured cases against a baseline and produce a report.
+    cases maps case names to dictionaries mapping event names to lists of samples.
+    The report is marked as failed if any event regressed or is missing from the measurements.
+    Events that only exist in the measurements are ignored.
+    '''
+    report = {
+        'threshold': threshold,
+        'alpha': alpha,
+        'min_time': min_time,
+        'passed': True,
+        'summary': {PASSED: 0, REGRESSION: 0, IMPROVEMENT: 0, SKIPPED: 0, MISSING: 0},
+        'cases': {},
+    }
+
+    def add(case_report, event_name, event_result):
+        case_report['events'][event_name] = event_result
+        report['summary'][event_result['status']] += 1
+        if event_result['status'] in [REGRESSION, MISSING]:
+            case_report['passed'] = False
+            report['passed'] = False
+
+    for case_name, base_case in baseline['cases'].items():
+        case_report = {'passed': True, 'events': {}}
+        report['cases'][case_name] = case_report
+        cur_case = cases.get(case_name, None)
+        for event_name, base_event in base_case['events'].items():
+            samples = cur_case.get(event_name, None) if cur_case is not None else None
+            if not samples:
+                add(case_report, event_name, {'baseline': base_event['stats'], 'status': MISSING})
+            else:
+                add(case_report, event_name, compare_event(base_event, samples, threshold, alpha, min_time))
+
+    return report
+
+
+def format_report(report):
+    '''
+    Format the failing and improved events of a report as a list of human readable lines.
+    '''
+    lines = []
+    for case_name, case_report in report['cases'].items():
+        for event_name, result in case_report['events'].items():
+            status = result['status']
+            if status not in [REGRESSION, IMPROVEMENT, MISSING]:
+                continue
+            if status == MISSING:
+                lines.append(f'{case_name}: {event_name} missing')
+                continue
+            base = result['baseline']
+            cur = result['current']
+            lines.append(
+                f'{case_name}: {event_name} {status} '
+                f'{base["median"]:.3f} ms -> {cur["median"]:.3f} ms ({100.0 * result["relative_change"]:+.1f}%, '
+                f'p={result["p_value"] if result["p_value"] is not None else float("nan"):.2g})'
+            )
+    return lines
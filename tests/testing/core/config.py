@@ -29,6 +29,20 @@ ERROR_IMAGE_SUFFIX = '.error.png'
 
 PYTHON_TESTS_DIR = "tests/python_tests"
 
+BENCHMARKS_DIR = "tests/benchmarks"
+
+# Directory for benchmark results and baselines.
+BENCHMARK_DATA_DIR = "tests/data/benchmarks"
+
+# Default benchmark suite file (in BENCHMARKS_DIR).
+DEFAULT_BENCHMARK_SUITE = "restir.json"
+
+# Default number of benchmark frames rendered before capturing.
+DEFAULT_BENCHMARK_WARMUP_FRAMES = 100
+
+# Default number of captured benchmark frames.
+DEFAULT_BENCHMARK_CAPTURE_FRAMES = 500
+
 # Build configurations.
 BUILD_CONFIGS = {
     # Temporary build configurations combining a CMake preset and build type.
@@ -0,0 +1,272 @@
+'''
+Frontend for running frame-time benchmarks.
+
+A benchmark suite is a JSON file describing a matrix of render graphs, scenes,
+resolutions and settings. Each combination is run in Mogwai: after a number of
+warm-up frames, the profiler captures a fixed number of frames. Robust statistics
+are computed per profiler event and compared against a stored baseline.
+'''
+
+import os
+import sys
+import re
+import json
+import argparse
+import itertools
+import subprocess
+from pathlib import Path
+
+from core import Environment, config, benchmark_stats
+from core.environment import find_most_recent_build_config
+from core.termcolor import colored
+
+
+class Case:
+    '''
+    Represents a single benchmark case (graph x scene x resolution x setting).
+    '''
+
+    def __init__(self, suite, graph, scene, resolution, setting):
+        self.suite = suite
+        self.graph = graph
+        self.scene = scene
+        self.resolution = resolution
+        self.setting = setting
+        self.name = f'{graph}/{scene}/{resolution[0]}x{resolution[1]}/{setting}'
+
+    def __repr__(self):
+        return f'Case(name={self.name})'
+
+    def write_script(self, script_file, capture_file):
+        '''
+        Write the Mogwai script running the benchmark case.
+        '''
+        suite = self.suite
+        settings = suite.settings[self.setting]
+        with open(script_file, 'w') as f:
+            f.write(f'm.script(r"{suite.graphs[self.graph]}")\n')
+            f.write(f'm.loadScene(r"{suite.scenes[self.scene]}")\n')
+            f.write(f'm.resizeFrameBuffer({self.resolution[0]}, {self.resolution[1]})\n')
+            f.write('m.ui = False\n')
+            f.write('g = m.activeGraph\n')
+            for pass_name, props in settings.items():
+                f.write(f'props = g.get_pass("{pass_name}").properties\n')
+                f.write(f'props.update({repr(props)})\n')
+                f.write(f'g.update_pass("{pass_name}", props)\n')
+            f.write(f'm.clock.framerate = {suite.framerate}\n')
+            f.write('m.clock.time = 0\n')
+            f.write('m.clock.pause()\n')
+            f.write('m.profiler.enabled = True\n')
+            f.write('frame = 0\n')
+            f.write(f'for i in range({suite.warmup_frames}):\n')
+            f.write('    frame += 1\n')
+            f.write('    m.clock.frame = frame\n')
+            f.write('    m.renderFrame()\n')
+            f.write(f'm.profiler.start_capture({suite.capture_frames})\n')
+            f.write(f'for i in range({suite.capture_frames}):\n')
+            f.write('    frame += 1\n')
+            f.write('    m.clock.frame = frame\n')
+            f.write('    m.renderFrame()\n')
+            f.write('capture = m.profiler.end_capture()\n')
+            f.write('import json\n')
+            f.write(f'with open(r"{capture_file}", "w") as f:\n')
+            f.write('    json.dump(capture, f, indent=2)\n')
+            f.write('exit()\n')
+
+    def run(self, env, result_dir, device_type):
+        '''
+        Run the benchmark case in Mogwai.
+        Returns a tuple containing the per-event samples (or None on failure) and a list of messages.
+        '''
+        case_dir = result_dir / self.name.replace('/', '_')
+        case_dir.mkdir(parents=True, exist_ok=True)
+        script_file = case_dir / 'benchmark.py'
+        capture_file = case_dir / 'capture.json'
+        if capture_file.exists():
+            capture_file.unlink()
+        self.write_script(script_file, capture_file)
+
+        args = [
+            str(env.mogwai_exe),
+            '--device-type', device_type,
+            '--script', str(script_file),
+            '--logfile', str(case_dir / 'log.txt'),
+            '--headless'
+        ]
+        p = subprocess.Popen(args, cwd=env.project_dir, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+        try:
+            outs, errs = p.communicate(timeout=self.suite.timeout)
+        except subprocess.TimeoutExpired:
+            p.kill()
+            return None, ['Process killed due to timeout']
+
+        if p.returncode != 0:
+            errors = list(map(lambda l: l.rstrip(), errs.decode('utf-8').splitlines()))
+            return None, errors + [f'{env.mogwai_exe} exited with return code {p.returncode}']
+
+        if not capture_file.exists():
+            return None, ['Benchmark did not generate a profiler capture.']
+
+        return benchmark_stats.load_capture(capture_file, event_filter=self.suite.event_filter), []
+
+
+class Suite:
+    '''
+    Benchmark suite loaded from a JSON file.
+    '''
+
+    def __init__(self, suite_file, project_dir):
+        with open(suite_file) as f:
+            suite = json.load(f)
+
+        resolve = lambda p: str((project_dir / p).resolve())
+
+        self.name = suite.get('name', Path(suite_file).stem)
+        self.graphs = {name: resolve(path) for name, path in suite['graphs'].items()}
+        self.scenes = {name: resolve(path) for name, path in suite['scenes'].items()}
+        self.resolutions = suite.get('resolutions', [[1920, 1080]])
+        self.settings = suite.get('settings', {'default': {}})
+        self.warmup_frames = suite.get('warmup_frames', config.DEFAULT_BENCHMARK_WARMUP_FRAMES)
+        self.capture_frames = suite.get('capture_frames', config.DEFAULT_BENCHMARK_CAPTURE_FRAMES)
+        self.framerate = suite.get('framerate', 60)
+        self.timeout = suite.get('timeout', config.DEFAULT_TIMEOUT)
+        self.event_filter = suite.get('event_filter', None)
+        self.threshold = suite.get('threshold', benchmark_stats.DEFAULT_THRESHOLD)
+        self.alpha = suite.get('alpha', benchmark_stats.DEFAULT_ALPHA)
+        self.min_time = suite.get('min_time', benchmark_stats.DEFAULT_MIN_TIME)
+
+    def collect_cases(self, filter_regex=None):
+        '''
+        Build the list of cases from the suite matrix, optionally filtered by a regular expression.
+        '''
+        cases = []
+        for graph, scene, resolution, setting in itertools.product(self.graphs, self.scenes, self.resolutions, self.settings):
+            case = Case(self, graph, scene, resolution, setting)
+            if filter_regex and not re.search(filter_regex, case.name):
+                continue
+            cases.append(case)
+        return cases
+
+
+def run_cases(env, cases, result_dir, device_type):
+    '''
+    Run all benchmark cases sequentially (to avoid interference between measurements).
+    Returns a dictionary mapping case names to per-event samples and a success flag.
+    '''
+    results = {}
+    success = True
+    for case in cases:
+        print(f'  {case.name:<80} : ', end='', flush=True)
+        samples, messages = case.run(env, result_dir, device_type)
+        if samples is None:
+            success = False
+            print(colored('FAILED', 'red'))
+            for message in messages:
+                print('    ' + message)
+        else:
+            results[case.name] = samples
+            print(colored('DONE', 'green'))
+    return results, success
+
+
+def main():
+    default_config = find_most_recent_build_config()
+
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument('--environment', type=str, action='store', help=f'Environment', default=None)
+    parser.add_argument('--config', type=str, action='store', help=f'Build configuration (default: {default_config})', default=default_config)
+    parser.add_argument('--list-configs', action='store_true', help='List available build configurations.')
+    parser.add_argument('--device-type', type=str, action='store', help='Device type', default=config.SUPPORTED_DEVICE_TYPES[0])
+
+    parser.add_argument('-s', '--suite', type=str, action='store', help='Benchmark suite file', default=None)
+    parser.add_argument('-l', '--list', action='store_true', help='List benchmark cases')
+    parser.add_argument('-f', '--filter', type=str, action='store', help='Regular expression for filtering cases to run')
+    parser.add_argument('--baseline', type=str, action='store', help='Baseline file (default: derived from suite and build configuration)')
+    parser.add_argument('--gen-baseline', action='store_true', help='Generate baseline instead of comparing against it')
+    parser.add_argument('--compare', type=str, action='store', help='Compare previously measured results file instead of running benchmarks')
+    parser.add_argument('-r', '--report', type=str, action='store', help='JSON report output file (default: report.json in the result directory)')
+    parser.add_argument('--threshold', type=float, action='store', help='Override relative median change considered a regression')
+    parser.add_argument('--alpha', type=float, action='store', help='Override significance level')
+
+    args = parser.parse_args()
+
+    # Try to load environment.
+    env = None
+    try:
+        env = Environment(args.environment, args.config)
+    except Exception as e:
+        env_error = e
+
+    # List build configurations.
+    if args.list_configs:
+        print('Available build configurations:\n' + '\n'.join(config.BUILD_CONFIGS.keys()))
+        sys.exit(0)
+
+    # Abort if environment is missing.
+    if env == None:
+        print(f"\nFailed to load environment: {env_error}")
+        sys.exit(1)
+
+    suite_file = Path(args.suite) if args.suite else env.project_dir / config.BENCHMARKS_DIR / config.DEFAULT_BENCHMARK_SUITE
+    suite = Suite(suite_file, env.project_dir)
+    cases = suite.collect_cases(args.filter)
+
+    if args.list:
+        for case in cases:
+            print(case.name)
+        sys.exit(0)
+
+    threshold = args.threshold if args.threshold is not None else suite.threshold
+    alpha = args.alpha if args.alpha is not None else suite.alpha
+
+    data_dir = env.project_dir / config.BENCHMARK_DATA_DIR
+    result_dir = data_dir / 'results' / suite.name / f'{env.build_config}_{args.device_type}'
+    baseline_file = Path(args.baseline) if args.baseline else data_dir / 'baselines' / f'{suite.name}_{env.build_config}_{args.device_type}.json'
+    report_file = Path(args.report) if args.report else result_dir / 'report.json'
+    results_file = result_dir / 'results.json'
+
+    if not args.gen_baseline and not baseline_file.exists():
+        print(colored(f'\n!!! Baseline "{baseline_file}" is not available !!!', 'red'))
+        print('\nGenerate it using:\n\n       run_benchmarks --gen-baseline\n')
+        sys.exit(1)
+
+    # Measure (or load previous measurements).
+    if args.compare:
+        with open(args.compare) as f:
+            results = json.load(f)
+        success = True
+    else:
+        print(f'Running {len(cases)} benchmark cases of suite "{suite.name}":')
+        result_dir.mkdir(parents=True, exist_ok=True)
+        results, success = run_cases(env, cases, result_dir, args.device_type)
+        benchmark_stats.save_json(results_file, results)
+
+    if args.gen_baseline:
+        baseline_file.parent.mkdir(parents=True, exist_ok=True)
+        benchmark_stats.save_json(baseline_file, benchmark_stats.make_baseline(results))
+        print(f'Baseline written to {baseline_file}')
+        sys.exit(0 if success else 1)
+
+    # Compare against baseline.
+    baseline = benchmark_stats.load_baseline(baseline_file)
+    baseline['cases'] = {name: case for name, case in baseline['cases'].items() if not args.filter or re.search(args.filter, name)}
+    report = benchmark_stats.compare(baseline, results, threshold, alpha, suite.min_time)
+    report['suite'] = suite.name
+    report['build_config'] = env.build_config
+    report['device_type'] = args.device_type
+    report['passed'] = report['passed'] and success
+
+    report_file.parent.mkdir(parents=True, exist_ok=True)
+    benchmark_stats.save_json(report_file, report)
+
+    for line in benchmark_stats.format_report(report):
+        print('  ' + line)
+    summary = ', '.join(f'{count} {status}' for status, count in report['summary'].items())
+    print(f'\nBenchmark {colored("PASSED", "green") if report["passed"] else colored("FAILED", "red")} ({summary})')
+    print(f'Report written to {report_file}')
+
+    sys.exit(0 if report['passed'] else 1)
+
+
+if __name__ == '__main__':
+    main()